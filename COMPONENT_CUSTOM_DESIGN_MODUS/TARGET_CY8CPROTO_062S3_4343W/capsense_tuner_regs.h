@@ -0,0 +1,194 @@
+/*******************************************************************************
+* File Name: capsense_tuner_regs.h
+*
+* Description:
+*   CapSense Tuner register map of cy_capsense_tuner for CY8CPROTO_062S3_4343W.
+*   This file was automatically generated by tools/tuner_map.py from
+*   GeneratedSource/cycfg_capsense.h and GeneratedSource/cycfg_capsense.c.
+*   Do not modify it; run the tool again after saving design.cycapsense.
+*
+********************************************************************************/
+
+#if !defined(CAPSENSE_TUNER_REGS_H)
+#define CAPSENSE_TUNER_REGS_H
+
+/* Register map: ENTRY(register name, member of cy_stc_capsense_tuner_t) */
+#define CAPSENSE_TUNER_REGS(ENTRY) \
+    ENTRY(CONFIG_ID, commonContext.configId) \
+    ENTRY(TUNER_CMD, commonContext.tunerCmd) \
+    ENTRY(SCAN_COUNTER, commonContext.scanCounter) \
+    ENTRY(TUNER_ST, commonContext.tunerSt) \
+    ENTRY(INITDONE, commonContext.initDone) \
+    ENTRY(PTRSSCALLBACK, commonContext.ptrSSCallback) \
+    ENTRY(PTREOSCALLBACK, commonContext.ptrEOSCallback) \
+    ENTRY(PTRTUNERSENDCALLBACK, commonContext.ptrTunerSendCallback) \
+    ENTRY(PTRTUNERRECEIVECALLBACK, commonContext.ptrTunerReceiveCallback) \
+    ENTRY(STATUS, commonContext.status) \
+    ENTRY(TIMESTAMPINTERVAL, commonContext.timestampInterval) \
+    ENTRY(TIMESTAMP, commonContext.timestamp) \
+    ENTRY(CSD_MOD_CLK_DIVIDER, commonContext.modCsdClk) \
+    ENTRY(CSX_MOD_CLK_DIVIDER, commonContext.modCsxClk) \
+    ENTRY(TUNER_CNT, commonContext.tunerCnt) \
+    ENTRY(BUTTON0_FINGER_CP, widgetContext[0].fingerCap) \
+    ENTRY(BUTTON0_SIGPFC, widgetContext[0].sigPFC) \
+    ENTRY(BUTTON0_RESOLUTION, widgetContext[0].resolution) \
+    ENTRY(BUTTON0_MAXRAWCOUNT, widgetContext[0].maxRawCount) \
+    ENTRY(BUTTON0_FINGER_TH, widgetContext[0].fingerTh) \
+    ENTRY(BUTTON0_PROX_TOUCH_TH, widgetContext[0].proxTh) \
+    ENTRY(BUTTON0_LOW_BSLN_RST, widgetContext[0].lowBslnRst) \
+    ENTRY(BUTTON0_SNS_CLK, widgetContext[0].snsClk) \
+    ENTRY(BUTTON0_ROW_SNS_CLK, widgetContext[0].rowSnsClk) \
+    ENTRY(BUTTON0_GESTURE_DETECTED, widgetContext[0].gestureDetected) \
+    ENTRY(BUTTON0_GESTURE_DIRECTION, widgetContext[0].gestureDirection) \
+    ENTRY(BUTTON0_XDELTA, widgetContext[0].xDelta) \
+    ENTRY(BUTTON0_YDELTA, widgetContext[0].yDelta) \
+    ENTRY(BUTTON0_NOISE_TH, widgetContext[0].noiseTh) \
+    ENTRY(BUTTON0_NNOISE_TH, widgetContext[0].nNoiseTh) \
+    ENTRY(BUTTON0_HYSTERESIS, widgetContext[0].hysteresis) \
+    ENTRY(BUTTON0_ON_DEBOUNCE, widgetContext[0].onDebounce) \
+    ENTRY(BUTTON0_SNS_CLK_SOURCE, widgetContext[0].snsClkSource) \
+    ENTRY(BUTTON0_IDAC_MOD0, widgetContext[0].idacMod[0]) \
+    ENTRY(BUTTON0_IDAC_MOD1, widgetContext[0].idacMod[1]) \
+    ENTRY(BUTTON0_IDAC_MOD2, widgetContext[0].idacMod[2]) \
+    ENTRY(BUTTON0_IDAC_GAIN_INDEX, widgetContext[0].idacGainIndex) \
+    ENTRY(BUTTON0_ROW_IDAC_MOD0, widgetContext[0].rowIdacMod[0]) \
+    ENTRY(BUTTON0_ROW_IDAC_MOD1, widgetContext[0].rowIdacMod[1]) \
+    ENTRY(BUTTON0_ROW_IDAC_MOD2, widgetContext[0].rowIdacMod[2]) \
+    ENTRY(BUTTON0_REGULAR_IIR_BL_N, widgetContext[0].bslnCoeff) \
+    ENTRY(BUTTON0_STATUS, widgetContext[0].status) \
+    ENTRY(BUTTON0_PTRPOSITION, widgetContext[0].wdTouch.ptrPosition) \
+    ENTRY(BUTTON0_NUM_POSITIONS, widgetContext[0].wdTouch.numPosition) \
+    ENTRY(BUTTON1_FINGER_CP, widgetContext[1].fingerCap) \
+    ENTRY(BUTTON1_SIGPFC, widgetContext[1].sigPFC) \
+    ENTRY(BUTTON1_RESOLUTION, widgetContext[1].resolution) \
+    ENTRY(BUTTON1_MAXRAWCOUNT, widgetContext[1].maxRawCount) \
+    ENTRY(BUTTON1_FINGER_TH, widgetContext[1].fingerTh) \
+    ENTRY(BUTTON1_PROX_TOUCH_TH, widgetContext[1].proxTh) \
+    ENTRY(BUTTON1_LOW_BSLN_RST, widgetContext[1].lowBslnRst) \
+    ENTRY(BUTTON1_SNS_CLK, widgetContext[1].snsClk) \
+    ENTRY(BUTTON1_ROW_SNS_CLK, widgetContext[1].rowSnsClk) \
+    ENTRY(BUTTON1_GESTURE_DETECTED, widgetContext[1].gestureDetected) \
+    ENTRY(BUTTON1_GESTURE_DIRECTION, widgetContext[1].gestureDirection) \
+    ENTRY(BUTTON1_XDELTA, widgetContext[1].xDelta) \
+    ENTRY(BUTTON1_YDELTA, widgetContext[1].yDelta) \
+    ENTRY(BUTTON1_NOISE_TH, widgetContext[1].noiseTh) \
+    ENTRY(BUTTON1_NNOISE_TH, widgetContext[1].nNoiseTh) \
+    ENTRY(BUTTON1_HYSTERESIS, widgetContext[1].hysteresis) \
+    ENTRY(BUTTON1_ON_DEBOUNCE, widgetContext[1].onDebounce) \
+    ENTRY(BUTTON1_SNS_CLK_SOURCE, widgetContext[1].snsClkSource) \
+    ENTRY(BUTTON1_IDAC_MOD0, widgetContext[1].idacMod[0]) \
+    ENTRY(BUTTON1_IDAC_MOD1, widgetContext[1].idacMod[1]) \
+    ENTRY(BUTTON1_IDAC_MOD2, widgetContext[1].idacMod[2]) \
+    ENTRY(BUTTON1_IDAC_GAIN_INDEX, widgetContext[1].idacGainIndex) \
+    ENTRY(BUTTON1_ROW_IDAC_MOD0, widgetContext[1].rowIdacMod[0]) \
+    ENTRY(BUTTON1_ROW_IDAC_MOD1, widgetContext[1].rowIdacMod[1]) \
+    ENTRY(BUTTON1_ROW_IDAC_MOD2, widgetContext[1].rowIdacMod[2]) \
+    ENTRY(BUTTON1_REGULAR_IIR_BL_N, widgetContext[1].bslnCoeff) \
+    ENTRY(BUTTON1_STATUS, widgetContext[1].status) \
+    ENTRY(BUTTON1_PTRPOSITION, widgetContext[1].wdTouch.ptrPosition) \
+    ENTRY(BUTTON1_NUM_POSITIONS, widgetContext[1].wdTouch.numPosition) \
+    ENTRY(LINEARSLIDER0_FINGER_CP, widgetContext[2].fingerCap) \
+    ENTRY(LINEARSLIDER0_SIGPFC, widgetContext[2].sigPFC) \
+    ENTRY(LINEARSLIDER0_RESOLUTION, widgetContext[2].resolution) \
+    ENTRY(LINEARSLIDER0_MAXRAWCOUNT, widgetContext[2].maxRawCount) \
+    ENTRY(LINEARSLIDER0_FINGER_TH, widgetContext[2].fingerTh) \
+    ENTRY(LINEARSLIDER0_PROX_TOUCH_TH, widgetContext[2].proxTh) \
+    ENTRY(LINEARSLIDER0_LOW_BSLN_RST, widgetContext[2].lowBslnRst) \
+    ENTRY(LINEARSLIDER0_SNS_CLK, widgetContext[2].snsClk) \
+    ENTRY(LINEARSLIDER0_ROW_SNS_CLK, widgetContext[2].rowSnsClk) \
+    ENTRY(LINEARSLIDER0_GESTURE_DETECTED, widgetContext[2].gestureDetected) \
+    ENTRY(LINEARSLIDER0_GESTURE_DIRECTION, widgetContext[2].gestureDirection) \
+    ENTRY(LINEARSLIDER0_XDELTA, widgetContext[2].xDelta) \
+    ENTRY(LINEARSLIDER0_YDELTA, widgetContext[2].yDelta) \
+    ENTRY(LINEARSLIDER0_NOISE_TH, widgetContext[2].noiseTh) \
+    ENTRY(LINEARSLIDER0_NNOISE_TH, widgetContext[2].nNoiseTh) \
+    ENTRY(LINEARSLIDER0_HYSTERESIS, widgetContext[2].hysteresis) \
+    ENTRY(LINEARSLIDER0_ON_DEBOUNCE, widgetContext[2].onDebounce) \
+    ENTRY(LINEARSLIDER0_SNS_CLK_SOURCE, widgetContext[2].snsClkSource) \
+    ENTRY(LINEARSLIDER0_IDAC_MOD0, widgetContext[2].idacMod[0]) \
+    ENTRY(LINEARSLIDER0_IDAC_MOD1, widgetContext[2].idacMod[1]) \
+    ENTRY(LINEARSLIDER0_IDAC_MOD2, widgetContext[2].idacMod[2]) \
+    ENTRY(LINEARSLIDER0_IDAC_GAIN_INDEX, widgetContext[2].idacGainIndex) \
+    ENTRY(LINEARSLIDER0_ROW_IDAC_MOD0, widgetContext[2].rowIdacMod[0]) \
+    ENTRY(LINEARSLIDER0_ROW_IDAC_MOD1, widgetContext[2].rowIdacMod[1]) \
+    ENTRY(LINEARSLIDER0_ROW_IDAC_MOD2, widgetContext[2].rowIdacMod[2]) \
+    ENTRY(LINEARSLIDER0_REGULAR_IIR_BL_N, widgetContext[2].bslnCoeff) \
+    ENTRY(LINEARSLIDER0_STATUS, widgetContext[2].status) \
+    ENTRY(LINEARSLIDER0_PTRPOSITION, widgetContext[2].wdTouch.ptrPosition) \
+    ENTRY(LINEARSLIDER0_NUM_POSITIONS, widgetContext[2].wdTouch.numPosition) \
+    ENTRY(BUTTON0_SNS0_RAW0, sensorContext[0].raw) \
+    ENTRY(BUTTON0_SNS0_BSLN0, sensorContext[0].bsln) \
+    ENTRY(BUTTON0_SNS0_DIFF0, sensorContext[0].diff) \
+    ENTRY(BUTTON0_SNS0_STATUS0, sensorContext[0].status) \
+    ENTRY(BUTTON0_SNS0_NEG_BSLN_RST_CNT0, sensorContext[0].negBslnRstCnt) \
+    ENTRY(BUTTON0_SNS0_IDAC0, sensorContext[0].idacComp) \
+    ENTRY(BUTTON0_SNS0_BSLN_EXT0, sensorContext[0].bslnExt) \
+    ENTRY(BUTTON1_SNS0_RAW0, sensorContext[1].raw) \
+    ENTRY(BUTTON1_SNS0_BSLN0, sensorContext[1].bsln) \
+    ENTRY(BUTTON1_SNS0_DIFF0, sensorContext[1].diff) \
+    ENTRY(BUTTON1_SNS0_STATUS0, sensorContext[1].status) \
+    ENTRY(BUTTON1_SNS0_NEG_BSLN_RST_CNT0, sensorContext[1].negBslnRstCnt) \
+    ENTRY(BUTTON1_SNS0_IDAC0, sensorContext[1].idacComp) \
+    ENTRY(BUTTON1_SNS0_BSLN_EXT0, sensorContext[1].bslnExt) \
+    ENTRY(LINEARSLIDER0_SNS0_RAW0, sensorContext[2].raw) \
+    ENTRY(LINEARSLIDER0_SNS0_BSLN0, sensorContext[2].bsln) \
+    ENTRY(LINEARSLIDER0_SNS0_DIFF0, sensorContext[2].diff) \
+    ENTRY(LINEARSLIDER0_SNS0_STATUS0, sensorContext[2].status) \
+    ENTRY(LINEARSLIDER0_SNS0_NEG_BSLN_RST_CNT0, sensorContext[2].negBslnRstCnt) \
+    ENTRY(LINEARSLIDER0_SNS0_IDAC0, sensorContext[2].idacComp) \
+    ENTRY(LINEARSLIDER0_SNS0_BSLN_EXT0, sensorContext[2].bslnExt) \
+    ENTRY(LINEARSLIDER0_SNS1_RAW0, sensorContext[3].raw) \
+    ENTRY(LINEARSLIDER0_SNS1_BSLN0, sensorContext[3].bsln) \
+    ENTRY(LINEARSLIDER0_SNS1_DIFF0, sensorContext[3].diff) \
+    ENTRY(LINEARSLIDER0_SNS1_STATUS0, sensorContext[3].status) \
+    ENTRY(LINEARSLIDER0_SNS1_NEG_BSLN_RST_CNT0, sensorContext[3].negBslnRstCnt) \
+    ENTRY(LINEARSLIDER0_SNS1_IDAC0, sensorContext[3].idacComp) \
+    ENTRY(LINEARSLIDER0_SNS1_BSLN_EXT0, sensorContext[3].bslnExt) \
+    ENTRY(LINEARSLIDER0_SNS2_RAW0, sensorContext[4].raw) \
+    ENTRY(LINEARSLIDER0_SNS2_BSLN0, sensorContext[4].bsln) \
+    ENTRY(LINEARSLIDER0_SNS2_DIFF0, sensorContext[4].diff) \
+    ENTRY(LINEARSLIDER0_SNS2_STATUS0, sensorContext[4].status) \
+    ENTRY(LINEARSLIDER0_SNS2_NEG_BSLN_RST_CNT0, sensorContext[4].negBslnRstCnt) \
+    ENTRY(LINEARSLIDER0_SNS2_IDAC0, sensorContext[4].idacComp) \
+    ENTRY(LINEARSLIDER0_SNS2_BSLN_EXT0, sensorContext[4].bslnExt) \
+    ENTRY(LINEARSLIDER0_SNS3_RAW0, sensorContext[5].raw) \
+    ENTRY(LINEARSLIDER0_SNS3_BSLN0, sensorContext[5].bsln) \
+    ENTRY(LINEARSLIDER0_SNS3_DIFF0, sensorContext[5].diff) \
+    ENTRY(LINEARSLIDER0_SNS3_STATUS0, sensorContext[5].status) \
+    ENTRY(LINEARSLIDER0_SNS3_NEG_BSLN_RST_CNT0, sensorContext[5].negBslnRstCnt) \
+    ENTRY(LINEARSLIDER0_SNS3_IDAC0, sensorContext[5].idacComp) \
+    ENTRY(LINEARSLIDER0_SNS3_BSLN_EXT0, sensorContext[5].bslnExt) \
+    ENTRY(LINEARSLIDER0_SNS4_RAW0, sensorContext[6].raw) \
+    ENTRY(LINEARSLIDER0_SNS4_BSLN0, sensorContext[6].bsln) \
+    ENTRY(LINEARSLIDER0_SNS4_DIFF0, sensorContext[6].diff) \
+    ENTRY(LINEARSLIDER0_SNS4_STATUS0, sensorContext[6].status) \
+    ENTRY(LINEARSLIDER0_SNS4_NEG_BSLN_RST_CNT0, sensorContext[6].negBslnRstCnt) \
+    ENTRY(LINEARSLIDER0_SNS4_IDAC0, sensorContext[6].idacComp) \
+    ENTRY(LINEARSLIDER0_SNS4_BSLN_EXT0, sensorContext[6].bslnExt) \
+    ENTRY(LINEARSLIDER0_X0, position[0].x) \
+    ENTRY(LINEARSLIDER0_Y0, position[0].y) \
+    ENTRY(LINEARSLIDER0_Z0, position[0].z) \
+    ENTRY(LINEARSLIDER0_ID0, position[0].id)
+
+#define CAPSENSE_TUNER_REGS_COUNT                    (155u)
+#define CAPSENSE_TUNER_REGS_END                      (262u)
+
+/* Buffer sizes, and indices written by hand in cy_capsense_widgetConfig[] */
+#define CAPSENSE_TUNER_REGS_DEBOUNCE_SIZE            (3u)
+#define CAPSENSE_TUNER_REGS_NOISE_ENVELOPE_SIZE      (7u)
+#define CAPSENSE_TUNER_REGS_ELTD_COUNT               (7u)
+#define CAPSENSE_TUNER_REGS_PIN_COUNT                (7u)
+#define CAPSENSE_TUNER_REGS_RAW_HISTORY_SIZE         (0u)
+#define CAPSENSE_TUNER_REGS_IIR_HISTORY_LOW_SIZE     (0u)
+#define CAPSENSE_TUNER_REGS_POSITION_FILTER_HISTORY_SIZE (0u)
+#define CAPSENSE_TUNER_REGS_NO_INDEX                 (0xFFu)
+
+/* ENTRY(widget ID, sensor context, electrode, debounce, noise envelope) */
+#define CAPSENSE_TUNER_REGS_WIDGETS(ENTRY) \
+    ENTRY(0u, 0u, 0u, 0u, 0u) /* Button0 */ \
+    ENTRY(1u, 1u, 1u, 1u, 1u) /* Button1 */ \
+    ENTRY(2u, 2u, 2u, 2u, 2u) /* LinearSlider0 */
+
+#endif /* CAPSENSE_TUNER_REGS_H */
+
+/* [] END OF FILE */
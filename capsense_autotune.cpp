@@ -0,0 +1,304 @@
+/*******************************************************************************
+* File Name: capsense_autotune.cpp
+*
+* Description:
+*   Threshold auto-tuning, see capsense_autotune.h.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "capsense_autotune.h"
+
+
+/*******************************************************************************
+* Function Name: capsense_autotune_sqrt
+********************************************************************************
+* Summary:
+*   Integer square root, rounded down, in a fixed 16 steps.
+*
+*******************************************************************************/
+static uint32_t capsense_autotune_sqrt(uint32_t value)
+{
+    uint32_t root = 0u;
+
+    for (uint32_t bit = 1uL << 30u; 0u != bit; bit >>= 2u)
+    {
+        if (value >= (root + bit))
+        {
+            value -= root + bit;
+            root = (root >> 1u) + bit;
+        }
+        else
+        {
+            root >>= 1u;
+        }
+    }
+    return root;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_autotune_clamp
+********************************************************************************
+* Summary:
+*   Limits a threshold to its bounds.
+*
+*******************************************************************************/
+static uint16_t capsense_autotune_clamp(uint32_t value, uint16_t min, uint16_t max)
+{
+    return (uint16_t)((value < min) ? min : ((value > max) ? max : value));
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_autotune_sigmas
+********************************************************************************
+* Summary:
+*   Counts of the given number of standard deviations, rounded up.
+*
+* Parameters:
+*  sigma: standard deviation in 1 / 2^(CAPSENSE_AUTOTUNE_FRAC_SHIFT / 2)
+*  counts.
+*  count: number of standard deviations.
+*
+*******************************************************************************/
+static uint32_t capsense_autotune_sigmas(uint32_t sigma, uint32_t count)
+{
+    const uint32_t shift = CAPSENSE_AUTOTUNE_FRAC_SHIFT / 2u;
+
+    return ((count * sigma) + (1uL << shift) - 1u) >> shift;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_autotune_init
+********************************************************************************
+* Summary:
+*   Starts without statistics.
+*
+*******************************************************************************/
+void capsense_autotune_init(capsense_autotune_t *sns)
+{
+    sns->noiseCount = 0u;
+    sns->signalCount = 0u;
+    sns->touchScans = 0u;
+    sns->touchSum = 0u;
+    sns->noiseMean = 0;
+    sns->noiseVar = 0u;
+    sns->signalMean = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_autotune_update
+********************************************************************************
+* Summary:
+*   Adds one scan of a sensor to its statistics, in constant time:
+*
+*   - A scan above the touch level belongs to a touch. The touch level is
+*     CAPSENSE_AUTOTUNE_FINGER_SIGMA standard deviations above the mean
+*     noise, but at least the noise threshold and at most the finger
+*     threshold, so that touches too weak for the current finger threshold
+*     are counted as well. When a touch of at least
+*     CAPSENSE_AUTOTUNE_TOUCH_SCANS scans ends, its mean difference is added
+*     to the signal mean. The mean is taken rather than the peak, which
+*     would add the noise to the signal.
+*   - A scan within the noise threshold of the baseline, while the widget
+*     is not active, is noise. Mean and variance of the noise are updated
+*     with Welford's method. Noise beyond the threshold is cut off, which
+*     lowers the estimate, but the noise threshold derived from it still
+*     rises until it covers the noise.
+*
+*   Both statistics stop counting samples at their window, so they become
+*   exponential averages that follow slow changes of the environment.
+*
+* Parameters:
+*  sns: statistics of the sensor.
+*  delta: raw count minus baseline.
+*  th: current thresholds of the widget.
+*  active: the widget reports a touch.
+*
+*******************************************************************************/
+void capsense_autotune_update(capsense_autotune_t *sns, int32_t delta, const capsense_autotune_thresholds_t *th,
+                              bool active)
+{
+    const int32_t x = delta * (int32_t)(1uL << CAPSENSE_AUTOTUNE_FRAC_SHIFT);
+    const int32_t deviation = x - sns->noiseMean;
+    bool above = (delta >= (int32_t)th->fingerTh);
+
+    /* Compared squared, in 1 / 2^(2 * shift) counts^2, to need no root */
+    if (!above && (sns->noiseCount >= CAPSENSE_AUTOTUNE_NOISE_WARMUP) && (delta >= (int32_t)th->noiseTh))
+    {
+        above = ((int64_t)deviation * deviation) >=
+                ((int64_t)sns->noiseVar * (CAPSENSE_AUTOTUNE_FINGER_SIGMA * CAPSENSE_AUTOTUNE_FINGER_SIGMA) <<
+                 CAPSENSE_AUTOTUNE_FRAC_SHIFT);
+    }
+
+    if (above)
+    {
+        if (sns->touchScans < UINT16_MAX)
+        {
+            sns->touchScans++;
+            sns->touchSum += (uint32_t)((delta > UINT16_MAX) ? UINT16_MAX : delta);
+        }
+        return;
+    }
+
+    if (sns->touchScans >= CAPSENSE_AUTOTUNE_TOUCH_SCANS)
+    {
+        const int32_t signal = (int32_t)(((uint64_t)sns->touchSum << CAPSENSE_AUTOTUNE_FRAC_SHIFT) / sns->touchScans);
+
+        sns->signalCount += (sns->signalCount < CAPSENSE_AUTOTUNE_SIGNAL_WINDOW) ? 1u : 0u;
+        sns->signalMean = (uint32_t)((int32_t)sns->signalMean +
+                                     ((signal - (int32_t)sns->signalMean) / (int32_t)sns->signalCount));
+    }
+    sns->touchScans = 0u;
+    sns->touchSum = 0u;
+
+    if (active || (delta >= (int32_t)th->noiseTh) || (delta <= -(int32_t)th->noiseTh))
+    {
+        return;
+    }
+
+    sns->noiseCount += (sns->noiseCount < CAPSENSE_AUTOTUNE_NOISE_WINDOW) ? 1u : 0u;
+    sns->noiseMean += deviation / (int32_t)sns->noiseCount;
+
+    /* Both deviations have the same sign, so the product is not negative */
+    const int64_t square = ((int64_t)deviation * (x - sns->noiseMean)) >> CAPSENSE_AUTOTUNE_FRAC_SHIFT;
+    const int64_t var = (int64_t)sns->noiseVar + ((square - (int64_t)sns->noiseVar) / sns->noiseCount);
+
+    sns->noiseVar = (var > (int64_t)UINT32_MAX) ? UINT32_MAX : (uint32_t)var;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_autotune_target
+********************************************************************************
+* Summary:
+*   Derives the thresholds of a widget from the statistics of its sensors:
+*   the highest noise and the weakest touch signal count. The finger
+*   threshold, noise threshold and hysteresis are CAPSENSE_AUTOTUNE_*_PCT of
+*   the mean touch signal, or the designed values until every sensor has
+*   seen CAPSENSE_AUTOTUNE_SIGNAL_WARMUP touches. The finger and noise
+*   thresholds are then raised to CAPSENSE_AUTOTUNE_FINGER_SIGMA and
+*   CAPSENSE_AUTOTUNE_NOISE_SIGMA standard deviations of the noise, and all
+*   are limited to the bounds of cfg. The noise threshold finally stays
+*   below the release level, fingerTh - hysteresis, so that the baseline
+*   does not follow a finger that is still reported.
+*
+* Parameters:
+*  cfg: bounds of the widget.
+*  sns: statistics of the sensors of the widget.
+*  numSns: number of sensors.
+*  target: set to the thresholds.
+*
+* Return:
+*  false while a sensor has fewer than CAPSENSE_AUTOTUNE_NOISE_WARMUP noise
+*  scans; target is not set then.
+*
+*******************************************************************************/
+bool capsense_autotune_target(const capsense_autotune_config_t *cfg, const capsense_autotune_t *sns,
+                              uint32_t numSns, capsense_autotune_thresholds_t *target)
+{
+    uint32_t noiseVar = 0u;
+    uint32_t signal = UINT32_MAX;
+    bool touched = true;
+
+    for (uint32_t i = 0u; i < numSns; i++)
+    {
+        if (sns[i].noiseCount < CAPSENSE_AUTOTUNE_NOISE_WARMUP)
+        {
+            return false;
+        }
+        noiseVar = (sns[i].noiseVar > noiseVar) ? sns[i].noiseVar : noiseVar;
+        if (sns[i].signalCount < CAPSENSE_AUTOTUNE_SIGNAL_WARMUP)
+        {
+            touched = false;
+        }
+        else if (sns[i].signalMean < signal)
+        {
+            signal = sns[i].signalMean;
+        }
+    }
+
+    /* Standard deviation in 1 / 2^(shift / 2) counts */
+    const uint32_t sigma = capsense_autotune_sqrt(noiseVar);
+    const uint32_t fingerFloor = capsense_autotune_sigmas(sigma, CAPSENSE_AUTOTUNE_FINGER_SIGMA);
+    const uint32_t noiseFloor = capsense_autotune_sigmas(sigma, CAPSENSE_AUTOTUNE_NOISE_SIGMA);
+    uint32_t fingerTh = cfg->design.fingerTh;
+    uint32_t noiseTh = cfg->design.noiseTh;
+    uint32_t hysteresis = cfg->design.hysteresis;
+
+    if (touched && (0u != numSns))
+    {
+        fingerTh = (signal * CAPSENSE_AUTOTUNE_FINGER_PCT / 100u) >> CAPSENSE_AUTOTUNE_FRAC_SHIFT;
+        noiseTh = (signal * CAPSENSE_AUTOTUNE_NOISE_PCT / 100u) >> CAPSENSE_AUTOTUNE_FRAC_SHIFT;
+        hysteresis = (signal * CAPSENSE_AUTOTUNE_HYSTERESIS_PCT / 100u) >> CAPSENSE_AUTOTUNE_FRAC_SHIFT;
+    }
+
+    target->fingerTh = capsense_autotune_clamp((fingerTh > fingerFloor) ? fingerTh : fingerFloor,
+                                               cfg->min.fingerTh, cfg->max.fingerTh);
+    target->noiseTh = capsense_autotune_clamp((noiseTh > noiseFloor) ? noiseTh : noiseFloor,
+                                              cfg->min.noiseTh, cfg->max.noiseTh);
+    target->hysteresis = capsense_autotune_clamp(hysteresis, cfg->min.hysteresis, cfg->max.hysteresis);
+
+    if ((target->fingerTh > target->hysteresis) && (target->noiseTh >= (target->fingerTh - target->hysteresis)))
+    {
+        target->noiseTh = (uint16_t)(target->fingerTh - target->hysteresis - 1u);
+    }
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_autotune_step
+********************************************************************************
+* Summary:
+*   Moves a threshold by one count towards its target, so that thresholds
+*   change slowly enough to never cut a touch short.
+*
+*******************************************************************************/
+uint16_t capsense_autotune_step(uint16_t value, uint16_t target)
+{
+    return (value < target) ? (uint16_t)(value + 1u) : ((value > target) ? (uint16_t)(value - 1u) : value);
+}
+
+
+/* [] END OF FILE */
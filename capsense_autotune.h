@@ -0,0 +1,173 @@
+/*******************************************************************************
+* File Name: capsense_autotune.h
+*
+* Description:
+*   Threshold auto-tuning: keeps noise and touch signal statistics of every
+*   sensor while scanning and derives the finger threshold, noise thresholds
+*   and hysteresis of a widget from them, within bounds around the designed
+*   values. Used by main.cpp with the capsense-threshold-autotune application
+*   option. Kept free of Mbed OS and the CapSense middleware so that host
+*   tools can use it as well.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_AUTOTUNE_H
+#define CAPSENSE_AUTOTUNE_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Means and variances are kept in 1 / 2^shift counts and counts^2 */
+#define CAPSENSE_AUTOTUNE_FRAC_SHIFT            (8u)
+
+/* Samples after which the statistics become exponential averages: scans
+ * for the noise, touches for the signal.
+ */
+#define CAPSENSE_AUTOTUNE_NOISE_WINDOW          (256u)
+#define CAPSENSE_AUTOTUNE_SIGNAL_WINDOW         (16u)
+
+/* Noise scans and touches needed before the statistics are used */
+#define CAPSENSE_AUTOTUNE_NOISE_WARMUP          (64u)
+#define CAPSENSE_AUTOTUNE_SIGNAL_WARMUP         (3u)
+
+/* A touch is counted once it stays this many scans above the touch level */
+#define CAPSENSE_AUTOTUNE_TOUCH_SCANS           (3u)
+
+/* Thresholds in percent of the mean touch signal, as recommended by the
+ * CapSense design guide, and their lower limits in standard deviations of
+ * the noise.
+ */
+#define CAPSENSE_AUTOTUNE_FINGER_PCT            (80u)
+#define CAPSENSE_AUTOTUNE_NOISE_PCT             (40u)
+#define CAPSENSE_AUTOTUNE_HYSTERESIS_PCT        (10u)
+#define CAPSENSE_AUTOTUNE_FINGER_SIGMA          (5u)
+#define CAPSENSE_AUTOTUNE_NOISE_SIGMA           (3u)
+
+/* Defaults of capsense_autotune_config(): bounds of every threshold in
+ * percent of its designed value.
+ */
+#define CAPSENSE_AUTOTUNE_MIN_PCT               (50u)
+#define CAPSENSE_AUTOTUNE_MAX_PCT               (400u)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    uint16_t fingerTh;
+    uint16_t noiseTh;           /* Also used as the negative noise threshold */
+    uint16_t hysteresis;
+} capsense_autotune_thresholds_t;
+
+typedef struct
+{
+    capsense_autotune_thresholds_t design;  /* Used until enough touches are seen */
+    capsense_autotune_thresholds_t min;
+    capsense_autotune_thresholds_t max;
+} capsense_autotune_config_t;
+
+/* Statistics of one sensor. A zero-initialized state equals the one after
+ * capsense_autotune_init().
+ */
+typedef struct
+{
+    uint16_t noiseCount;        /* Noise scans, up to CAPSENSE_AUTOTUNE_NOISE_WINDOW */
+    uint16_t signalCount;       /* Touches, up to CAPSENSE_AUTOTUNE_SIGNAL_WINDOW */
+    uint16_t touchScans;        /* Scans of the current touch */
+    uint32_t touchSum;          /* Sum of the differences of the current touch */
+    int32_t noiseMean;          /* Raw count minus baseline, in 1 / 2^CAPSENSE_AUTOTUNE_FRAC_SHIFT */
+    uint32_t noiseVar;          /* Variance of the same, in 1 / 2^CAPSENSE_AUTOTUNE_FRAC_SHIFT */
+    uint32_t signalMean;        /* Mean difference of a touch, in 1 / 2^CAPSENSE_AUTOTUNE_FRAC_SHIFT */
+} capsense_autotune_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void capsense_autotune_init(capsense_autotune_t *sns);
+void capsense_autotune_update(capsense_autotune_t *sns, int32_t delta, const capsense_autotune_thresholds_t *th,
+                              bool active);
+bool capsense_autotune_target(const capsense_autotune_config_t *cfg, const capsense_autotune_t *sns,
+                              uint32_t numSns, capsense_autotune_thresholds_t *target);
+uint16_t capsense_autotune_step(uint16_t value, uint16_t target);
+
+
+/*******************************************************************************
+* Function Name: capsense_autotune_config
+********************************************************************************
+* Summary:
+*   Default configuration for a widget designed with the given thresholds.
+*
+* Parameters:
+*  fingerTh: finger threshold of the design.
+*  noiseTh: noise threshold of the design.
+*  hysteresis: hysteresis of the design.
+*
+*******************************************************************************/
+constexpr capsense_autotune_config_t capsense_autotune_config(uint32_t fingerTh, uint32_t noiseTh,
+                                                              uint32_t hysteresis)
+{
+    return
+    {
+        { (uint16_t)fingerTh, (uint16_t)noiseTh, (uint16_t)hysteresis },
+        {
+            (uint16_t)(fingerTh * CAPSENSE_AUTOTUNE_MIN_PCT / 100u),
+            (uint16_t)(noiseTh * CAPSENSE_AUTOTUNE_MIN_PCT / 100u),
+            (uint16_t)(hysteresis * CAPSENSE_AUTOTUNE_MIN_PCT / 100u)
+        },
+        {
+            (uint16_t)(fingerTh * CAPSENSE_AUTOTUNE_MAX_PCT / 100u),
+            (uint16_t)(noiseTh * CAPSENSE_AUTOTUNE_MAX_PCT / 100u),
+            (uint16_t)(hysteresis * CAPSENSE_AUTOTUNE_MAX_PCT / 100u)
+        }
+    };
+}
+
+#endif /* CAPSENSE_AUTOTUNE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,149 @@
+/*******************************************************************************
+* File Name: capsense_ballistic.cpp
+*
+* Description:
+*   Ballistic multiplier of a slider, see capsense_ballistic.h.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "capsense_ballistic.h"
+
+
+/*******************************************************************************
+* Function Name: capsense_ballistic_gain
+********************************************************************************
+* Summary:
+*   Gain at a speed: slowGain up to slowSpeed, fastGain from fastSpeed, and
+*   a straight line between them.
+*
+*******************************************************************************/
+static uint32_t capsense_ballistic_gain(const capsense_ballistic_config_t *cfg, uint32_t speed)
+{
+    if (speed <= cfg->slowSpeed)
+    {
+        return cfg->slowGain;
+    }
+    if (speed >= cfg->fastSpeed)
+    {
+        return cfg->fastGain;
+    }
+    return cfg->slowGain + (uint32_t)(((uint64_t)(cfg->fastGain - cfg->slowGain) * (speed - cfg->slowSpeed)) /
+                                      (cfg->fastSpeed - cfg->slowSpeed));
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_ballistic_init
+********************************************************************************
+* Summary:
+*   Starts with the slider released.
+*
+*******************************************************************************/
+void capsense_ballistic_init(capsense_ballistic_t *ctx)
+{
+    ctx->touched = false;
+    ctx->lastPos = 0u;
+    ctx->lastMs = 0u;
+    ctx->speed = 0;
+    ctx->residue = 0;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_ballistic_update
+********************************************************************************
+* Summary:
+*   Turns the movement of the finger since the last call into a change of
+*   the driven value. Each move is multiplied by a gain that grows with the
+*   filtered speed of the finger, so slow moves adjust the value finely and
+*   fast ones cover its range in a few strokes. The fraction of an output
+*   unit that is left over is kept for the next move, so that slow moves
+*   are not lost to rounding. Integer only, constant work per call.
+*
+*   The first call of a touch only takes the position: putting the finger
+*   down does not change the value.
+*
+* Parameters:
+*  ctx: ballistic state of the slider.
+*  cfg: ballistic configuration.
+*  timeMs: time of the position.
+*  touched: true if a finger is on the slider.
+*  position: slider position, only valid if touched.
+*
+* Return:
+*  Change of the driven value, in output units.
+*
+*******************************************************************************/
+int32_t capsense_ballistic_update(capsense_ballistic_t *ctx, const capsense_ballistic_config_t *cfg,
+                                  uint32_t timeMs, bool touched, uint32_t position)
+{
+    if (!touched || !ctx->touched)
+    {
+        ctx->touched = touched;
+        ctx->lastPos = (uint16_t)position;
+        ctx->lastMs = timeMs;
+        ctx->speed = 0;
+        ctx->residue = 0;
+        return 0;
+    }
+
+    const int32_t delta = (int32_t)position - (int32_t)ctx->lastPos;
+    const uint32_t elapsedMs = timeMs - ctx->lastMs;
+
+    if (0u != elapsedMs)
+    {
+        const int32_t speed = delta * 1000 / (int32_t)elapsedMs;
+
+        ctx->speed += (speed - ctx->speed) / (int32_t)(1uL << cfg->speedShift);
+        ctx->lastMs = timeMs;
+    }
+    ctx->lastPos = (uint16_t)position;
+
+    const uint32_t gain = capsense_ballistic_gain(cfg, (uint32_t)((ctx->speed < 0) ? -ctx->speed : ctx->speed));
+    const int64_t scaled = ((int64_t)delta * gain) + ctx->residue;
+    const int32_t change = (int32_t)(scaled / (int32_t)(1uL << CAPSENSE_BALLISTIC_GAIN_SHIFT));
+
+    ctx->residue = (int32_t)(scaled - ((int64_t)change << CAPSENSE_BALLISTIC_GAIN_SHIFT));
+    return change;
+}
+
+
+/* [] END OF FILE */
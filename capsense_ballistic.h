@@ -0,0 +1,136 @@
+/*******************************************************************************
+* File Name: capsense_ballistic.h
+*
+* Description:
+*   Ballistic multiplier of a slider: turns finger moves into changes of a
+*   value with a much larger range, with a gain that grows with the speed of
+*   the finger, so that a short slider adjusts a large value both finely and
+*   quickly. Used by main.cpp with the capsense-slider-ballistic application
+*   option. Kept free of Mbed OS so that host tools can use it as well.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_BALLISTIC_H
+#define CAPSENSE_BALLISTIC_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Gains are output units per slider position, in 1 / 2^shift */
+#define CAPSENSE_BALLISTIC_GAIN_SHIFT           (8u)
+
+/* Defaults of capsense_ballistic_config(): speeds in percent of the slider
+ * range per second, and the number of full-length moves of the slider that
+ * cover the output range at the slow and at the fast gain.
+ */
+#define CAPSENSE_BALLISTIC_SLOW_SPEED_PCT       (20u)
+#define CAPSENSE_BALLISTIC_FAST_SPEED_PCT       (300u)
+#define CAPSENSE_BALLISTIC_SLOW_SWEEPS          (256u)
+#define CAPSENSE_BALLISTIC_FAST_SWEEPS          (2u)
+#define CAPSENSE_BALLISTIC_SPEED_SHIFT          (2u)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    uint32_t slowSpeed;         /* Positions per second up to which the gain is slowGain */
+    uint32_t fastSpeed;         /* Positions per second from which the gain is fastGain, above slowSpeed */
+    uint32_t slowGain;          /* Output units per position, in 1 / 2^CAPSENSE_BALLISTIC_GAIN_SHIFT */
+    uint32_t fastGain;          /* Same, at least slowGain */
+    uint8_t speedShift;         /* Speed filter coefficient is 1 / 2^shift */
+} capsense_ballistic_config_t;
+
+/* State of one slider. A zero-initialized state equals the one after
+ * capsense_ballistic_init().
+ */
+typedef struct
+{
+    bool touched;
+    uint16_t lastPos;
+    uint32_t lastMs;
+    int32_t speed;              /* Filtered speed, positions per second */
+    int32_t residue;            /* Output not reported yet, in 1 / 2^CAPSENSE_BALLISTIC_GAIN_SHIFT */
+} capsense_ballistic_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void capsense_ballistic_init(capsense_ballistic_t *ctx);
+int32_t capsense_ballistic_update(capsense_ballistic_t *ctx, const capsense_ballistic_config_t *cfg,
+                                  uint32_t timeMs, bool touched, uint32_t position);
+
+
+/*******************************************************************************
+* Function Name: capsense_ballistic_config
+********************************************************************************
+* Summary:
+*   Default configuration for a slider with the given resolution that drives
+*   a value of outputRange.
+*
+* Parameters:
+*  range: slider resolution, the highest position.
+*  outputRange: range of the driven value, up to 2^24.
+*
+*******************************************************************************/
+constexpr capsense_ballistic_config_t capsense_ballistic_config(uint32_t range, uint32_t outputRange)
+{
+    return
+    {
+        range * CAPSENSE_BALLISTIC_SLOW_SPEED_PCT / 100u,
+        (range * CAPSENSE_BALLISTIC_FAST_SPEED_PCT / 100u) + 1u,
+        (outputRange << CAPSENSE_BALLISTIC_GAIN_SHIFT) / (range * CAPSENSE_BALLISTIC_SLOW_SWEEPS) + 1u,
+        (outputRange << CAPSENSE_BALLISTIC_GAIN_SHIFT) / (range * CAPSENSE_BALLISTIC_FAST_SWEEPS) + 1u,
+        CAPSENSE_BALLISTIC_SPEED_SHIFT
+    };
+}
+
+#endif /* CAPSENSE_BALLISTIC_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,187 @@
+/*******************************************************************************
+* File Name: capsense_bench.cpp
+*
+* Description:
+*   On-target benchmark of CapSense scanning and processing. Built with the
+*   capsense-benchmark application option, typically together with a synthetic
+*   configuration from tools/capsense_gen.py. main() calls
+*   capsense_bench_run() instead of starting the periodic scan, and the result
+*   is printed over the serial port for tools/capsense_sweep.py to collect.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "mbed.h"
+#include "cycfg_capsense.h"
+#include "capsense_bench.h"
+#include "capsense_cycles.h"
+#include "capsense_frame.h"
+
+
+#if MBED_CONF_APP_CAPSENSE_BENCHMARK
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Frame times given to the encoder. Frames are scanned back to back, but
+ * the log sees the 20 ms scan period of the demo.
+ */
+#define CAPSENSE_BENCH_PERIOD_MS                (20u)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} capsense_bench_stat_t;
+
+
+/*******************************************************************************
+* Function Name: capsense_bench_add
+********************************************************************************
+* Summary:
+*   Adds one measurement to a statistic.
+*
+*******************************************************************************/
+static void capsense_bench_add(capsense_bench_stat_t *stat, uint32_t cycles)
+{
+    stat->min = (cycles < stat->min) ? cycles : stat->min;
+    stat->max = (cycles > stat->max) ? cycles : stat->max;
+    stat->sum += cycles;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_bench_capture
+********************************************************************************
+* Summary:
+*   Copies the raw count, baseline and difference count of the first
+*   CAPSENSE_FRAME_MAX_SENSORS sensors into a frame, as the raw-count log
+*   does, at the time of the given scan.
+*
+*******************************************************************************/
+static void capsense_bench_capture(capsense_frame_t *frame, uint32_t scan)
+{
+    uint32_t sensor = 0u;
+
+    for (uint32_t wdgtId = 0u; wdgtId < cy_capsense_context.ptrCommonConfig->numWd; wdgtId++)
+    {
+        const cy_stc_capsense_widget_config_t *widget = &cy_capsense_context.ptrWdConfig[wdgtId];
+        for (uint32_t snsId = 0u; (snsId < widget->numSns) && (sensor < CAPSENSE_FRAME_MAX_SENSORS); snsId++)
+        {
+            frame->raw[sensor] = widget->ptrSnsContext[snsId].raw;
+            frame->baseline[sensor] = widget->ptrSnsContext[snsId].bsln;
+            frame->diff[sensor] = widget->ptrSnsContext[snsId].diff;
+            sensor++;
+        }
+    }
+    frame->count = sensor;
+    frame->timeMs = scan * CAPSENSE_BENCH_PERIOD_MS;
+    frame->scan = scan;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_bench_run
+********************************************************************************
+* Summary:
+*   Scans and processes all widgets MBED_CONF_APP_CAPSENSE_BENCHMARK_FRAMES
+*   times and prints the cost in CPU cycles as one CSV record. The scan time
+*   runs from Cy_CapSense_ScanAllWidgets() until the end-of-scan callback has
+*   released scanDone; the processing time covers
+*   Cy_CapSense_ProcessAllWidgets() only. The encode time covers copying the
+*   processed frame and encoding it with capsense_frame_encode(), as the
+*   raw-count log does on every scan. tools/capsense_sweep.py parses the
+*   "bench," record.
+*
+* Parameters:
+*  scanDone: semaphore released by the end-of-scan callback.
+*
+*******************************************************************************/
+void capsense_bench_run(Semaphore &scanDone)
+{
+    capsense_bench_stat_t scan = {UINT32_MAX, 0u, 0u};
+    capsense_bench_stat_t process = {UINT32_MAX, 0u, 0u};
+    capsense_bench_stat_t encode = {UINT32_MAX, 0u, 0u};
+    static capsense_frame_t encodeFrame;
+    static capsense_frame_state_t encodeState;
+    static uint8_t encoded[CAPSENSE_FRAME_MAX_SIZE(CAPSENSE_FRAME_MAX_SENSORS)];
+    uint64_t encodedBytes = 0u;
+    const uint32_t frames = MBED_CONF_APP_CAPSENSE_BENCHMARK_FRAMES;
+
+    capsense_cycles_init();
+    capsense_frame_reset(&encodeState);
+
+    for (uint32_t frame = 0u; frame < frames; frame++)
+    {
+        uint32_t start = capsense_cycles_now();
+        Cy_CapSense_ScanAllWidgets(&cy_capsense_context);
+        scanDone.acquire();
+        uint32_t scanned = capsense_cycles_now();
+        Cy_CapSense_ProcessAllWidgets(&cy_capsense_context);
+        uint32_t processed = capsense_cycles_now();
+        capsense_bench_capture(&encodeFrame, frame);
+        encodedBytes += capsense_frame_encode(&encodeState, false, CAPSENSE_FRAME_ALL, &encodeFrame, encoded);
+        uint32_t encodedEnd = capsense_cycles_now();
+
+        capsense_bench_add(&scan, scanned - start);
+        capsense_bench_add(&process, processed - scanned);
+        capsense_bench_add(&encode, encodedEnd - processed);
+    }
+
+    printf("bench,widgets,sensors,frames,cpu_hz,process_min,process_avg,process_max,scan_avg,"
+           "encode_avg,encode_bytes_avg\r\n");
+    printf("bench,%u,%u,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\r\n",
+           (unsigned)cy_capsense_context.ptrCommonConfig->numWd,
+           (unsigned)cy_capsense_context.ptrCommonConfig->numSns,
+           (unsigned long)frames, (unsigned long)SystemCoreClock,
+           (unsigned long)process.min, (unsigned long)(process.sum / frames),
+           (unsigned long)process.max, (unsigned long)(scan.sum / frames),
+           (unsigned long)(encode.sum / frames), (unsigned long)(encodedBytes / frames));
+}
+
+#endif /* MBED_CONF_APP_CAPSENSE_BENCHMARK */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,146 @@
+/*******************************************************************************
+* File Name: capsense_boot.cpp
+*
+* Description:
+*   Boot-time profiler: timestamps the startup phases on the low-power timer
+*   and prints the boot timeline.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "mbed.h"
+#include "capsense_boot.h"
+
+
+#if MBED_CONF_APP_CAPSENSE_BOOT_PROFILE
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* The low-power timer runs from the ILO/WCO, so it keeps its rate while
+ * cybsp_init() reconfigures the FLL, PLL and peripheral clocks.
+ * Resolution is one 32 kHz tick, about 31 us.
+ */
+static LowPowerTimer capsense_boot_timer;
+static uint32_t capsense_boot_endUs[CAPSENSE_BOOT_PHASE_COUNT];
+static bool capsense_boot_marked[CAPSENSE_BOOT_PHASE_COUNT];
+
+static const char *const capsense_boot_names[CAPSENSE_BOOT_PHASE_COUNT] =
+{
+    "cybsp_init",
+    "initialize_capsense_tuner",
+    "Cy_CapSense_Init",
+    "Cy_CapSense_Enable",
+    "first_scan",
+};
+
+
+/*******************************************************************************
+* Function Name: capsense_boot_start
+********************************************************************************
+* Summary:
+*   Starts the timeline. Called first thing in main(); the time before main()
+*   (startup code, mbed_sdk_init() and RTOS start) is not covered.
+*
+*******************************************************************************/
+void capsense_boot_start(void)
+{
+    capsense_boot_timer.start();
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_boot_mark
+********************************************************************************
+* Summary:
+*   Records the end of a phase. Only the first mark of each phase counts, so
+*   marks on a periodic path record the first occurrence.
+*
+* Parameters:
+*  phase: phase that has just ended.
+*
+*******************************************************************************/
+void capsense_boot_mark(capsense_boot_phase_t phase)
+{
+    if (!capsense_boot_marked[phase])
+    {
+        capsense_boot_endUs[phase] = (uint32_t)capsense_boot_timer.elapsed_time().count();
+        capsense_boot_marked[phase] = true;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_boot_report
+********************************************************************************
+* Summary:
+*   Prints the timeline once, as "boot," records with the end and duration of
+*   every phase in microseconds since main() was entered. Phases that were not
+*   marked are skipped, so the duration of the next phase includes them.
+*
+*******************************************************************************/
+void capsense_boot_report(void)
+{
+    static bool reported = false;
+    uint32_t startUs = 0u;
+
+    if (reported)
+    {
+        return;
+    }
+    reported = true;
+
+    printf("boot,phase,end_us,duration_us\r\n");
+    for (uint32_t phase = 0u; phase < CAPSENSE_BOOT_PHASE_COUNT; phase++)
+    {
+        if (capsense_boot_marked[phase])
+        {
+            printf("boot,%s,%lu,%lu\r\n", capsense_boot_names[phase],
+                   (unsigned long)capsense_boot_endUs[phase],
+                   (unsigned long)(capsense_boot_endUs[phase] - startUs));
+            startUs = capsense_boot_endUs[phase];
+        }
+    }
+}
+
+#endif /* MBED_CONF_APP_CAPSENSE_BOOT_PROFILE */
+
+
+/* [] END OF FILE */
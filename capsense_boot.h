@@ -0,0 +1,88 @@
+/*******************************************************************************
+* File Name: capsense_boot.h
+*
+* Description:
+*   Boot-time profiler. main() marks the end of each startup phase, from
+*   cybsp_init() to the first processed scan, and the profiler prints the
+*   timeline once the first scan is done. Without the capsense-boot-profile
+*   option the marks compile to nothing.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_BOOT_H
+#define CAPSENSE_BOOT_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "mbed.h"
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+/* Startup phases in the order main() runs them. Each mark ends a phase. */
+typedef enum
+{
+    CAPSENSE_BOOT_CYBSP_INIT,
+    CAPSENSE_BOOT_TUNER_INIT,
+    CAPSENSE_BOOT_CAPSENSE_INIT,
+    CAPSENSE_BOOT_CAPSENSE_ENABLE,
+    CAPSENSE_BOOT_FIRST_SCAN,
+    CAPSENSE_BOOT_PHASE_COUNT
+} capsense_boot_phase_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#if MBED_CONF_APP_CAPSENSE_BOOT_PROFILE
+void capsense_boot_start(void);
+void capsense_boot_mark(capsense_boot_phase_t phase);
+void capsense_boot_report(void);
+#else
+static inline void capsense_boot_start(void) {}
+static inline void capsense_boot_mark(capsense_boot_phase_t phase) { (void)phase; }
+static inline void capsense_boot_report(void) {}
+#endif
+
+#endif /* CAPSENSE_BOOT_H */
+
+
+/* [] END OF FILE */
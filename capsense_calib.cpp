@@ -0,0 +1,323 @@
+/*******************************************************************************
+* File Name: capsense_calib.cpp
+*
+* Description:
+*   Cache of the CapSense calibration in non-volatile memory. Restores the
+*   IDAC, sense clock and SmartSense results of an earlier boot, guarded by
+*   the configuration ID and a CRC, and falls back to full calibration when
+*   the guard fails.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <string.h>
+#include "mbed.h"
+#include "kvstore_global_api.h"
+#include "cycfg_capsense.h"
+#include "capsense_layout.h"
+#include "capsense_crc.h"
+#include "capsense_calib.h"
+
+
+#if MBED_CONF_APP_CAPSENSE_CALIBRATION_CACHE
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define CAPSENSE_CALIB_KEY                      "/kv/capsense_cal"
+
+/* Marks the record layout. Change it whenever capsense_calib_record_t
+ * changes, so that records of older firmware are rejected.
+ */
+#define CAPSENSE_CALIB_MAGIC                    (0x43534331u) /* "CSC1" */
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+/* Per-widget results of IDAC calibration and SmartSense */
+typedef struct
+{
+    uint16_t resolution;
+    uint16_t maxRawCount;
+    uint16_t snsClk;
+    uint16_t sigPFC;
+    uint16_t fingerTh;
+    uint16_t noiseTh;
+    uint16_t nNoiseTh;
+    uint16_t hysteresis;
+    uint8_t idacMod[CY_CAPSENSE_FREQ_CHANNELS_NUM];
+    uint8_t rowIdacMod[CY_CAPSENSE_FREQ_CHANNELS_NUM];
+    uint8_t idacGainIndex;
+} capsense_calib_widget_t;
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t configId;
+    uint8_t numWd;
+    uint8_t numSns;
+    capsense_calib_widget_t widget[CAPSENSE_LAYOUT_WIDGET_COUNT];
+    uint8_t idacComp[capsense_layout_sensor_count()];
+    uint32_t crc;           /* CRC-32 of all preceding bytes */
+} capsense_calib_record_t;
+
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* Common configuration with calibration disabled, used by Cy_CapSense_Enable()
+ * while the cached values are applied. The generated one is const.
+ */
+static cy_stc_capsense_common_config_t capsense_calib_commonConfig;
+static const cy_stc_capsense_common_config_t *capsense_calib_generatedConfig;
+
+
+/*******************************************************************************
+* Function Name: capsense_calib_crc
+********************************************************************************
+* Summary:
+*   CRC-32 of a record, excluding the crc field.
+*
+*******************************************************************************/
+static uint32_t capsense_calib_crc(const capsense_calib_record_t *record)
+{
+    return ~capsense_crc32(CAPSENSE_CRC32_INIT, record, offsetof(capsense_calib_record_t, crc));
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_calib_matches
+********************************************************************************
+* Summary:
+*   Checks that the configuration being run has the size of the record.
+*   Synthetic configurations of tools/capsense_gen.py do not, and are
+*   always calibrated.
+*
+*******************************************************************************/
+static bool capsense_calib_matches(const cy_stc_capsense_context_t *context)
+{
+    return (CAPSENSE_LAYOUT_WIDGET_COUNT == context->ptrCommonConfig->numWd) &&
+           (capsense_layout_sensor_count() == context->ptrCommonConfig->numSns);
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_calib_restore
+********************************************************************************
+* Summary:
+*   Loads the cached calibration and applies it to the widget and sensor
+*   contexts. Must be called between Cy_CapSense_Init() and
+*   Cy_CapSense_Enable(). The record is used only if its CRC is intact and it
+*   was written for the same configuration ID, i.e. the same CapSense
+*   Configurator output; in that case the context is switched to a copy of
+*   the common configuration with IDAC autocalibration and SmartSense
+*   disabled, so that Cy_CapSense_Enable() keeps the restored values, until
+*   capsense_calib_enabled() switches it back.
+*
+* Parameters:
+*  context: CapSense context, initialized by Cy_CapSense_Init().
+*
+* Return:
+*  true if the cached calibration is in effect, false if
+*  Cy_CapSense_Enable() will calibrate.
+*
+*******************************************************************************/
+bool capsense_calib_restore(cy_stc_capsense_context_t *context)
+{
+    capsense_calib_record_t record;
+    size_t size = 0u;
+
+    if (!capsense_calib_matches(context) ||
+        (MBED_SUCCESS != kv_get(CAPSENSE_CALIB_KEY, &record, sizeof(record), &size)) ||
+        (sizeof(record) != size) ||
+        (CAPSENSE_CALIB_MAGIC != record.magic) ||
+        (context->ptrCommonContext->configId != record.configId) ||
+        (record.numWd != context->ptrCommonConfig->numWd) ||
+        (record.numSns != context->ptrCommonConfig->numSns) ||
+        (capsense_calib_crc(&record) != record.crc))
+    {
+        return false;
+    }
+
+    for (uint32_t wdgtId = 0u; wdgtId < CAPSENSE_LAYOUT_WIDGET_COUNT; wdgtId++)
+    {
+        const capsense_calib_widget_t *cached = &record.widget[wdgtId];
+        const cy_stc_capsense_widget_config_t *wdConfig = &context->ptrWdConfig[wdgtId];
+        cy_stc_capsense_widget_context_t *wdContext = wdConfig->ptrWdContext;
+
+        wdContext->resolution = cached->resolution;
+        wdContext->maxRawCount = cached->maxRawCount;
+        wdContext->snsClk = cached->snsClk;
+        wdContext->sigPFC = cached->sigPFC;
+        wdContext->fingerTh = cached->fingerTh;
+        wdContext->noiseTh = cached->noiseTh;
+        wdContext->nNoiseTh = cached->nNoiseTh;
+        wdContext->hysteresis = cached->hysteresis;
+        memcpy(wdContext->idacMod, cached->idacMod, sizeof(wdContext->idacMod));
+        memcpy(wdContext->rowIdacMod, cached->rowIdacMod, sizeof(wdContext->rowIdacMod));
+        wdContext->idacGainIndex = cached->idacGainIndex;
+
+        for (uint32_t snsId = 0u; snsId < wdConfig->numSns; snsId++)
+        {
+            wdConfig->ptrSnsContext[snsId].idacComp =
+                record.idacComp[capsense_layout_first_sensor(wdgtId) + snsId];
+        }
+    }
+
+    capsense_calib_generatedConfig = context->ptrCommonConfig;
+    capsense_calib_commonConfig = *context->ptrCommonConfig;
+    capsense_calib_commonConfig.csdAutotuneEn = CY_CAPSENSE_CSD_SS_DIS;
+    capsense_calib_commonConfig.csdIdacAutocalEn = CY_CAPSENSE_DISABLE;
+    capsense_calib_commonConfig.csdIdacAutoGainEn = CY_CAPSENSE_DISABLE;
+    capsense_calib_commonConfig.csxIdacAutocalEn = CY_CAPSENSE_DISABLE;
+    context->ptrCommonConfig = &capsense_calib_commonConfig;
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_calib_enabled
+********************************************************************************
+* Summary:
+*   Switches the context back to the generated common configuration once
+*   Cy_CapSense_Enable() has run with the restored values, so that the cache
+*   only skips the IDAC and sense clock calibration of the boot. SmartSense
+*   threshold tracking of the generated configuration runs on every scan as
+*   without the cache; the widget statuses are initialized again because
+*   Cy_CapSense_Enable() skipped the SmartSense noise envelopes. Does nothing
+*   if the calibration was not restored.
+*
+* Parameters:
+*  context: CapSense context after Cy_CapSense_Enable().
+*
+*******************************************************************************/
+void capsense_calib_enabled(cy_stc_capsense_context_t *context)
+{
+    if (&capsense_calib_commonConfig == context->ptrCommonConfig)
+    {
+        context->ptrCommonConfig = capsense_calib_generatedConfig;
+        Cy_CapSense_InitializeAllStatuses(context);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_calib_save
+********************************************************************************
+* Summary:
+*   Stores the calibration found by Cy_CapSense_Enable(). Called once after a
+*   boot that had to calibrate. A failed write only costs the next boot
+*   another calibration.
+*
+* Parameters:
+*  context: CapSense context after Cy_CapSense_Enable().
+*
+*******************************************************************************/
+void capsense_calib_save(const cy_stc_capsense_context_t *context)
+{
+    capsense_calib_record_t record;
+
+    if (!capsense_calib_matches(context))
+    {
+        return;
+    }
+
+    memset(&record, 0, sizeof(record));
+    record.magic = CAPSENSE_CALIB_MAGIC;
+    record.configId = context->ptrCommonContext->configId;
+    record.numWd = (uint8_t)context->ptrCommonConfig->numWd;
+    record.numSns = (uint8_t)context->ptrCommonConfig->numSns;
+
+    for (uint32_t wdgtId = 0u; wdgtId < CAPSENSE_LAYOUT_WIDGET_COUNT; wdgtId++)
+    {
+        capsense_calib_widget_t *cached = &record.widget[wdgtId];
+        const cy_stc_capsense_widget_config_t *wdConfig = &context->ptrWdConfig[wdgtId];
+        const cy_stc_capsense_widget_context_t *wdContext = wdConfig->ptrWdContext;
+
+        cached->resolution = wdContext->resolution;
+        cached->maxRawCount = wdContext->maxRawCount;
+        cached->snsClk = wdContext->snsClk;
+        cached->sigPFC = wdContext->sigPFC;
+        cached->fingerTh = wdContext->fingerTh;
+        cached->noiseTh = wdContext->noiseTh;
+        cached->nNoiseTh = wdContext->nNoiseTh;
+        cached->hysteresis = wdContext->hysteresis;
+        memcpy(cached->idacMod, wdContext->idacMod, sizeof(cached->idacMod));
+        memcpy(cached->rowIdacMod, wdContext->rowIdacMod, sizeof(cached->rowIdacMod));
+        cached->idacGainIndex = wdContext->idacGainIndex;
+
+        for (uint32_t snsId = 0u; snsId < wdConfig->numSns; snsId++)
+        {
+            record.idacComp[capsense_layout_first_sensor(wdgtId) + snsId] =
+                wdConfig->ptrSnsContext[snsId].idacComp;
+        }
+    }
+
+    record.crc = capsense_calib_crc(&record);
+    (void)kv_set(CAPSENSE_CALIB_KEY, &record, sizeof(record), 0u);
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_calib_discard
+********************************************************************************
+* Summary:
+*   Removes the cached calibration and switches the context back to the
+*   generated common configuration, so that the next Cy_CapSense_Enable()
+*   calibrates. Used when Cy_CapSense_Enable() fails with restored values.
+*
+* Parameters:
+*  context: CapSense context.
+*
+*******************************************************************************/
+void capsense_calib_discard(cy_stc_capsense_context_t *context)
+{
+    if (NULL != capsense_calib_generatedConfig)
+    {
+        context->ptrCommonConfig = capsense_calib_generatedConfig;
+    }
+    (void)kv_remove(CAPSENSE_CALIB_KEY);
+}
+
+#endif /* MBED_CONF_APP_CAPSENSE_CALIBRATION_CACHE */
+
+
+/* [] END OF FILE */
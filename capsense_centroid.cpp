@@ -0,0 +1,141 @@
+/*******************************************************************************
+* File Name: capsense_centroid.cpp
+*
+* Description:
+*   Local-maximum centroid of a linear slider, see capsense_centroid.h.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "capsense_centroid.h"
+
+
+/*******************************************************************************
+* Function Name: capsense_centroid_linear
+********************************************************************************
+* Summary:
+*   Finds up to maxTouches fingers on a linear slider from the difference
+*   counts of its segments, in one pass. Every local maximum at or above the
+*   threshold is a finger, and the strongest ones are kept. The position of
+*   each is the centroid of its segment and the two neighbors; a segment
+*   between two fingers contributes half of its count to each. Segment i
+*   lies at i * resolution / (numSns - 1).
+*
+*   Two fingers need at least one segment between them to be told apart.
+*   With maxTouches 1 this is the usual single centroid around the
+*   strongest segment.
+*
+* Parameters:
+*  diff: difference count of every segment, in slider order.
+*  numSns: number of segments, at least 2.
+*  threshold: lowest difference count of a finger, usually the finger
+*  threshold of the widget.
+*  resolution: highest position.
+*  maxTouches: 1 to CAPSENSE_CENTROID_MAX_TOUCHES.
+*  positions: receives the positions in ascending order.
+*
+* Return:
+*  Number of fingers found.
+*
+*******************************************************************************/
+uint32_t capsense_centroid_linear(const uint16_t *diff, uint32_t numSns, uint32_t threshold, uint32_t resolution,
+                                  uint32_t maxTouches, uint16_t positions[CAPSENSE_CENTROID_MAX_TOUCHES])
+{
+    uint32_t peaks[CAPSENSE_CENTROID_MAX_TOUCHES];
+    uint32_t count = 0u;
+
+    for (uint32_t i = 0u; i < numSns; i++)
+    {
+        const uint32_t left = (i > 0u) ? diff[i - 1u] : 0u;
+        const uint32_t right = ((i + 1u) < numSns) ? diff[i + 1u] : 0u;
+
+        /* A plateau counts once, at its first segment */
+        if ((diff[i] >= threshold) && (diff[i] > left) && (diff[i] >= right))
+        {
+            if (count < maxTouches)
+            {
+                peaks[count++] = i;
+            }
+            else if (diff[i] > diff[peaks[count - 1u]])
+            {
+                peaks[count - 1u] = i;
+            }
+
+            /* Strongest first, of at most two */
+            if ((count > 1u) && (diff[peaks[1u]] > diff[peaks[0u]]))
+            {
+                const uint32_t swap = peaks[0u];
+                peaks[0u] = peaks[1u];
+                peaks[1u] = swap;
+            }
+        }
+    }
+
+    /* Ascending positions */
+    if ((count > 1u) && (peaks[1u] < peaks[0u]))
+    {
+        const uint32_t swap = peaks[0u];
+        peaks[0u] = peaks[1u];
+        peaks[1u] = swap;
+    }
+
+    for (uint32_t touch = 0u; touch < count; touch++)
+    {
+        const uint32_t i = peaks[touch];
+        uint32_t left = (i > 0u) ? diff[i - 1u] : 0u;
+        uint32_t right = ((i + 1u) < numSns) ? diff[i + 1u] : 0u;
+
+        if ((count > 1u) && (1u == touch) && ((peaks[0u] + 2u) == i))
+        {
+            left /= 2u;
+        }
+        if ((count > 1u) && (0u == touch) && ((i + 2u) == peaks[1u]))
+        {
+            right /= 2u;
+        }
+
+        const uint32_t sum = left + diff[i] + right;
+        positions[touch] = (uint16_t)((((i * sum) + right - left) * resolution) / ((numSns - 1u) * sum));
+    }
+    return count;
+}
+
+
+/* [] END OF FILE */
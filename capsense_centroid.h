@@ -0,0 +1,73 @@
+/*******************************************************************************
+* File Name: capsense_centroid.h
+*
+* Description:
+*   Local-maximum centroid of a linear slider that finds up to two fingers,
+*   for the two-finger mode of capsense_touch.cpp (capsense-slider-touches
+*   option). Kept free of Mbed OS and the CapSense middleware so that host
+*   tools can use it as well.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_CENTROID_H
+#define CAPSENSE_CENTROID_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Most touches reported on one slider */
+#define CAPSENSE_CENTROID_MAX_TOUCHES           (2u)
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+uint32_t capsense_centroid_linear(const uint16_t *diff, uint32_t numSns, uint32_t threshold, uint32_t resolution,
+                                  uint32_t maxTouches, uint16_t positions[CAPSENSE_CENTROID_MAX_TOUCHES]);
+
+#endif /* CAPSENSE_CENTROID_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,126 @@
+/*******************************************************************************
+* File Name: capsense_crc.h
+*
+* Description:
+*   Small bitwise CRC routines shared by the calibration cache and the raw-
+*   count log. They run on records of a few hundred bytes, so no tables are
+*   kept. The header has no dependency on Mbed OS so that host tools can use
+*   it as well.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_CRC_H
+#define CAPSENSE_CRC_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define CAPSENSE_CRC32_INIT                     (0xFFFFFFFFu)
+#define CAPSENSE_CRC16_INIT                     (0xFFFFu)
+
+
+/*******************************************************************************
+* Function Name: capsense_crc32
+********************************************************************************
+* Summary:
+*   CRC-32 (IEEE 802.3), computed bitwise. Start with CAPSENSE_CRC32_INIT and
+*   invert the final value; intermediate values can be passed back in to
+*   cover data in several pieces.
+*
+* Parameters:
+*  crc: CAPSENSE_CRC32_INIT or the value of the previous piece.
+*  data: data to add.
+*  length: number of bytes.
+*
+*******************************************************************************/
+static inline uint32_t capsense_crc32(uint32_t crc, const void *data, size_t length)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    for (size_t i = 0u; i < length; i++)
+    {
+        crc ^= bytes[i];
+        for (uint32_t bit = 0u; bit < 8u; bit++)
+        {
+            crc = (crc >> 1u) ^ (0xEDB88320u & (0u - (crc & 1u)));
+        }
+    }
+    return crc;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_crc16
+********************************************************************************
+* Summary:
+*   CRC-16/CCITT-FALSE, computed bitwise. Start with CAPSENSE_CRC16_INIT;
+*   intermediate values can be passed back in.
+*
+* Parameters:
+*  crc: CAPSENSE_CRC16_INIT or the value of the previous piece.
+*  data: data to add.
+*  length: number of bytes.
+*
+*******************************************************************************/
+static inline uint16_t capsense_crc16(uint16_t crc, const void *data, size_t length)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+
+    for (size_t i = 0u; i < length; i++)
+    {
+        crc ^= (uint16_t)((uint16_t)bytes[i] << 8u);
+        for (uint32_t bit = 0u; bit < 8u; bit++)
+        {
+            crc = (uint16_t)((crc << 1u) ^ ((0u != (crc & 0x8000u)) ? 0x1021u : 0u));
+        }
+    }
+    return crc;
+}
+
+#endif /* CAPSENSE_CRC_H */
+
+
+/* [] END OF FILE */
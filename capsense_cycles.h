@@ -0,0 +1,118 @@
+/*******************************************************************************
+* File Name: capsense_cycles.h
+*
+* Description:
+*   Cycle counter used to time CapSense scanning and processing. On the
+*   Cortex-M4 it reads the DWT cycle counter; host builds fall back to
+*   std::chrono so that simulators and benchmarks can share the same code
+*   without Mbed OS headers.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_CYCLES_H
+#define CAPSENSE_CYCLES_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+
+#if defined(__ARM_ARCH_7EM__)
+#include "cmsis.h"
+#else
+#include <chrono>
+#endif
+
+
+/*******************************************************************************
+* Function Name: capsense_cycles_init
+********************************************************************************
+* Summary:
+*   Starts the DWT cycle counter of the Cortex-M4. No-op on the host.
+*
+*******************************************************************************/
+static inline void capsense_cycles_init(void)
+{
+#if defined(__ARM_ARCH_7EM__)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0u;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_cycles_now
+********************************************************************************
+* Summary:
+*   Returns a free-running 32-bit count: CPU cycles on the device, nanoseconds
+*   on the host. Intervals are the unsigned difference of two readings.
+*
+*******************************************************************************/
+static inline uint32_t capsense_cycles_now(void)
+{
+#if defined(__ARM_ARCH_7EM__)
+    return DWT->CYCCNT;
+#else
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_cycles_per_us
+********************************************************************************
+* Summary:
+*   Returns the number of counts of capsense_cycles_now() per microsecond.
+*
+*******************************************************************************/
+static inline uint32_t capsense_cycles_per_us(void)
+{
+#if defined(__ARM_ARCH_7EM__)
+    return SystemCoreClock / 1000000u;
+#else
+    return 1000u;
+#endif
+}
+
+#endif /* CAPSENSE_CYCLES_H */
+
+
+/* [] END OF FILE */
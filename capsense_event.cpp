@@ -0,0 +1,327 @@
+/*******************************************************************************
+* File Name: capsense_event.cpp
+*
+* Description:
+*   Event dispatch of the widget event API, see capsense_event.h.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <string.h>
+#include "mbed.h"
+#include "capsense_event.h"
+#include "capsense_predict.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define CAPSENSE_EVENT_SUBSCRIBERS              (MBED_CONF_APP_CAPSENSE_EVENT_SUBSCRIBERS)
+#define CAPSENSE_EVENT_LONG_PRESS_MS            (MBED_CONF_APP_CAPSENSE_LONG_PRESS_MS)
+
+/* Press or release, position, long press and gesture of every widget in one
+ * scan
+ */
+#define CAPSENSE_EVENT_MAX_PER_SCAN             (4u * CAPSENSE_LAYOUT_WIDGET_COUNT)
+
+static_assert(CAPSENSE_EVENT_SUBSCRIBERS <= 255u, "capsense-event-subscribers must fit the order table");
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    uint32_t wdgtId;
+    uint32_t kinds;
+    uint8_t priority;
+    capsense_event_handler_t handler;   /* NULL for a free entry */
+    void *arg;
+    bool fresh;                         /* Subscribed while handlers run */
+} capsense_event_sub_t;
+
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* Subscriptions live in a fixed pool; the handle is the pool index. order[]
+ * lists the used entries by descending priority, so dispatch never sorts.
+ */
+static capsense_event_sub_t capsense_event_pool[CAPSENSE_EVENT_SUBSCRIBERS];
+static uint8_t capsense_event_order[CAPSENSE_EVENT_SUBSCRIBERS];
+static uint32_t capsense_event_count;
+
+/* Held while the pool changes and while handlers run. It is recursive, so
+ * handlers may subscribe and unsubscribe. Dispatch walks a copy of order[],
+ * so such a change cannot skip or repeat a handler: an entry removed by a
+ * handler is not called again, and one added by a handler is fresh and
+ * only called from the next scan on.
+ */
+static Mutex capsense_event_mutex;
+static uint32_t capsense_event_dispatching;
+
+/* Touch state of the last dispatched scan, owned by the dispatching thread */
+static uint32_t capsense_event_touched;
+static uint32_t capsense_event_long;
+static uint32_t capsense_event_press_ms[CAPSENSE_LAYOUT_WIDGET_COUNT];
+static uint16_t capsense_event_position[CAPSENSE_LAYOUT_WIDGET_COUNT];
+
+#if MBED_CONF_APP_CAPSENSE_SLIDER_PREDICT
+/* Prediction state of every slider, indexed by widget ID */
+static capsense_predict_t capsense_event_predict[CAPSENSE_LAYOUT_WIDGET_COUNT];
+static constexpr capsense_predict_config_t capsense_event_predict_config =
+    capsense_predict_config(CAPSENSE_LAYOUT_TARGETS[CAPSENSE_LAYOUT_TARGET_INDEX].sliderResolution);
+#endif
+
+#if MBED_CONF_APP_CAPSENSE_GESTURES
+/* Gesture state of every slider, indexed by widget ID. The long press of a
+ * gesture uses the same time as CAPSENSE_EVENT_LONG_PRESS.
+ */
+static capsense_gesture_t capsense_event_gesture[CAPSENSE_LAYOUT_WIDGET_COUNT];
+static constexpr capsense_gesture_config_t capsense_event_gesture_config =
+    capsense_gesture_config(CAPSENSE_LAYOUT_TARGETS[CAPSENSE_LAYOUT_TARGET_INDEX].sliderResolution,
+                            CAPSENSE_EVENT_LONG_PRESS_MS);
+#endif
+
+
+/*******************************************************************************
+* Function Name: capsense_event_subscribe
+********************************************************************************
+* Summary:
+*   Registers a handler for some event kinds of one widget or of all of them.
+*   Handlers of an event run one after the other, in descending priority and
+*   in subscription order among equal priorities, on the thread that runs the
+*   capsense_report.h sink.
+*
+* Parameters:
+*  wdgtId: widget ID (CY_CAPSENSE_<NAME>_WDGT_ID) or CAPSENSE_EVENT_ALL_WIDGETS.
+*  kinds: mask of CAPSENSE_EVENT_<KIND>.
+*  priority: higher runs first.
+*  handler: called for every matching event.
+*  arg: passed to the handler.
+*
+* Return:
+*  Handle for capsense_event_unsubscribe(), or CAPSENSE_EVENT_NO_HANDLE if all
+*  capsense-event-subscribers entries are taken.
+*
+*******************************************************************************/
+int32_t capsense_event_subscribe(uint32_t wdgtId, uint32_t kinds, uint8_t priority,
+                                 capsense_event_handler_t handler, void *arg)
+{
+    ScopedLock<Mutex> lock(capsense_event_mutex);
+    uint32_t handle = 0u;
+
+    while ((handle < CAPSENSE_EVENT_SUBSCRIBERS) && (NULL != capsense_event_pool[handle].handler))
+    {
+        handle++;
+    }
+    if ((handle == CAPSENSE_EVENT_SUBSCRIBERS) || (NULL == handler))
+    {
+        return CAPSENSE_EVENT_NO_HANDLE;
+    }
+    capsense_event_pool[handle] = { wdgtId, kinds, priority, handler, arg, (0u != capsense_event_dispatching) };
+
+    uint32_t pos = capsense_event_count;
+    while ((pos > 0u) && (capsense_event_pool[capsense_event_order[pos - 1u]].priority < priority))
+    {
+        capsense_event_order[pos] = capsense_event_order[pos - 1u];
+        pos--;
+    }
+    capsense_event_order[pos] = (uint8_t)handle;
+    capsense_event_count++;
+    return (int32_t)handle;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_event_unsubscribe
+********************************************************************************
+* Summary:
+*   Removes a subscription and returns its entry to the pool.
+*
+* Parameters:
+*  handle: returned by capsense_event_subscribe().
+*
+*******************************************************************************/
+void capsense_event_unsubscribe(int32_t handle)
+{
+    ScopedLock<Mutex> lock(capsense_event_mutex);
+    uint32_t pos = 0u;
+
+    if ((handle < 0) || (handle >= (int32_t)CAPSENSE_EVENT_SUBSCRIBERS) ||
+        (NULL == capsense_event_pool[handle].handler))
+    {
+        return;
+    }
+    capsense_event_pool[handle].handler = NULL;
+
+    while (capsense_event_order[pos] != (uint8_t)handle)
+    {
+        pos++;
+    }
+    capsense_event_count--;
+    for (; pos < capsense_event_count; pos++)
+    {
+        capsense_event_order[pos] = capsense_event_order[pos + 1u];
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_event_dispatch
+********************************************************************************
+* Summary:
+*   capsense_report_sink_t that turns the status of one scan into events and
+*   calls the subscribed handlers. A widget is pressed and released when its
+*   touched bit changes; sliders also report every new position found by
+*   capsense_touch_diff(), after the press. A long press is reported once
+*   per press, CAPSENSE_EVENT_LONG_PRESS_MS after it. With capsense-gestures,
+*   every scan of a slider also runs through capsense_gesture_update(), and
+*   a recognized gesture is reported last. With two fingers on a slider,
+*   every event carries the position of the second one. With
+*   capsense-slider-predict, position events carry the position predicted
+*   by capsense_predict_update() one scan period ahead; the other events and
+*   the gestures keep the measured one.
+*
+* Parameters:
+*  state: status of the widgets.
+*  changes: changes found by capsense_touch_diff(), in widget order.
+*  count: number of changes.
+*  anyTouch: not used, every widget has its own press and release.
+*
+*******************************************************************************/
+void capsense_event_dispatch(const capsense_touch_state_t *state,
+                             const capsense_touch_event_t *changes, uint32_t count, bool anyTouch)
+{
+    capsense_event_t events[CAPSENSE_EVENT_MAX_PER_SCAN];
+    uint32_t numEvents = 0u;
+    uint32_t change = 0u;
+    uint32_t buttonIndex = 0u;
+    uint32_t sliderIndex = 0u;
+
+    (void)anyTouch;
+    for (uint32_t wdgtId = 0u; wdgtId < CAPSENSE_LAYOUT_WIDGET_COUNT; wdgtId++)
+    {
+        const uint32_t bit = 1uL << wdgtId;
+        const bool slider = (CAPSENSE_LAYOUT_LINEAR_SLIDER == CAPSENSE_LAYOUT_WIDGETS[wdgtId].type);
+        const uint32_t index = slider ? sliderIndex++ : buttonIndex++;
+        const bool touched = (0u != (state->touched & bit));
+        const bool wasTouched = (0u != (capsense_event_touched & bit));
+        const uint32_t position = slider ? state->value[wdgtId] : 0u;
+        const uint32_t second = (0u != (state->twoTouch & bit)) ? state->second[wdgtId] : CAPSENSE_TOUCH_NO_POSITION;
+        #if MBED_CONF_APP_CAPSENSE_SLIDER_PREDICT
+        const uint32_t predicted = slider ? capsense_predict_update(&capsense_event_predict[wdgtId],
+                                                                    &capsense_event_predict_config, state->timeMs,
+                                                                    touched, position) : position;
+        #else
+        const uint32_t predicted = position;
+        #endif
+
+        if (touched && !wasTouched)
+        {
+            events[numEvents++] = { CAPSENSE_EVENT_PRESS, wdgtId, index, position, second, state->timeMs, {} };
+            capsense_event_press_ms[wdgtId] = state->timeMs;
+            capsense_event_long &= ~bit;
+        }
+        else if (!touched && wasTouched)
+        {
+            events[numEvents++] = { CAPSENSE_EVENT_RELEASE, wdgtId, index, capsense_event_position[wdgtId],
+                                    CAPSENSE_TOUCH_NO_POSITION, state->timeMs, {} };
+        }
+
+        if ((change < count) && (changes[change].wdgtId == wdgtId))
+        {
+            if (slider)
+            {
+                events[numEvents++] = { CAPSENSE_EVENT_POSITION, wdgtId, index, predicted, second,
+                                        state->timeMs, {} };
+            }
+            change++;
+        }
+
+        if (touched && (0u == (capsense_event_long & bit)) &&
+            ((state->timeMs - capsense_event_press_ms[wdgtId]) >= CAPSENSE_EVENT_LONG_PRESS_MS))
+        {
+            events[numEvents++] = { CAPSENSE_EVENT_LONG_PRESS, wdgtId, index, position, second,
+                                    state->timeMs, {} };
+            capsense_event_long |= bit;
+        }
+
+        #if MBED_CONF_APP_CAPSENSE_GESTURES
+        capsense_gesture_event_t gesture;
+        if (slider && capsense_gesture_update(&capsense_event_gesture[wdgtId], &capsense_event_gesture_config,
+                                              state->timeMs, touched, position, &gesture))
+        {
+            events[numEvents++] = { CAPSENSE_EVENT_GESTURE, wdgtId, index, gesture.position, second,
+                                    state->timeMs, gesture };
+        }
+        #endif
+        capsense_event_position[wdgtId] = touched ? (uint16_t)position : capsense_event_position[wdgtId];
+    }
+    capsense_event_touched = state->touched;
+
+    ScopedLock<Mutex> lock(capsense_event_mutex);
+    uint8_t order[CAPSENSE_EVENT_SUBSCRIBERS];
+    const uint32_t subscribers = capsense_event_count;
+
+    memcpy(order, capsense_event_order, subscribers);
+    capsense_event_dispatching++;
+    for (uint32_t i = 0u; i < numEvents; i++)
+    {
+        for (uint32_t pos = 0u; pos < subscribers; pos++)
+        {
+            const capsense_event_sub_t *sub = &capsense_event_pool[order[pos]];
+
+            if ((NULL != sub->handler) && !sub->fresh && (0u != (sub->kinds & events[i].kind)) &&
+                ((CAPSENSE_EVENT_ALL_WIDGETS == sub->wdgtId) || (events[i].wdgtId == sub->wdgtId)))
+            {
+                sub->handler(&events[i], sub->arg);
+            }
+        }
+    }
+    capsense_event_dispatching--;
+    for (uint32_t handle = 0u; (0u == capsense_event_dispatching) && (handle < CAPSENSE_EVENT_SUBSCRIBERS); handle++)
+    {
+        capsense_event_pool[handle].fresh = false;
+    }
+}
+
+
+/* [] END OF FILE */
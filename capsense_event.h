@@ -0,0 +1,107 @@
+/*******************************************************************************
+* File Name: capsense_event.h
+*
+* Description:
+*   Widget event API. Application modules subscribe to press, release,
+*   position and long-press events of a widget with a priority, instead of
+*   polling the CapSense middleware after every scan. Subscriptions come from
+*   a fixed pool; nothing is allocated on the heap.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_EVENT_H
+#define CAPSENSE_EVENT_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "capsense_touch.h"
+#include "capsense_gesture.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Event kinds, also used as a mask in capsense_event_subscribe() */
+#define CAPSENSE_EVENT_PRESS                    (0x1u)  /* Widget touched */
+#define CAPSENSE_EVENT_RELEASE                  (0x2u)  /* Widget no longer touched */
+#define CAPSENSE_EVENT_POSITION                 (0x4u)  /* New slider position */
+#define CAPSENSE_EVENT_LONG_PRESS               (0x8u)  /* Touched for capsense-long-press-ms */
+#define CAPSENSE_EVENT_GESTURE                  (0x10u) /* Slider gesture, see capsense_gesture.h */
+#define CAPSENSE_EVENT_ALL                      (0x1Fu)
+
+/* Subscribes to every widget */
+#define CAPSENSE_EVENT_ALL_WIDGETS              (0xFFFFFFFFu)
+
+/* Returned by capsense_event_subscribe() when the pool is full */
+#define CAPSENSE_EVENT_NO_HANDLE                (-1)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    uint32_t kind;          /* One of CAPSENSE_EVENT_<KIND> */
+    uint32_t wdgtId;
+    uint32_t index;         /* Button or slider number within its kind */
+    uint32_t value;         /* Slider position; 0 for buttons */
+    uint32_t second;        /* Position of a second finger on the slider, or CAPSENSE_TOUCH_NO_POSITION */
+    uint32_t timeMs;        /* Time of the scan */
+    capsense_gesture_event_t gesture;   /* Only for CAPSENSE_EVENT_GESTURE */
+} capsense_event_t;
+
+typedef void (*capsense_event_handler_t)(const capsense_event_t *event, void *arg);
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+int32_t capsense_event_subscribe(uint32_t wdgtId, uint32_t kinds, uint8_t priority,
+                                 capsense_event_handler_t handler, void *arg);
+void capsense_event_unsubscribe(int32_t handle);
+void capsense_event_dispatch(const capsense_touch_state_t *state,
+                             const capsense_touch_event_t *changes, uint32_t count, bool anyTouch);
+
+#endif /* CAPSENSE_EVENT_H */
+
+
+/* [] END OF FILE */
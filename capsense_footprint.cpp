@@ -0,0 +1,104 @@
+/*******************************************************************************
+* File Name: capsense_footprint.cpp
+*
+* Description:
+*   Compile-time RAM and flash budget of the CapSense configuration. The
+*   objects generated in cycfg_capsense.c are summed with sizeof() and checked
+*   against capsense-ram-budget and capsense-flash-budget of mbed_app.json, so
+*   the build fails when a design change or an enabled feature exceeds the
+*   budget of the kit. tools/capsense_footprint.py reports the same footprint
+*   per widget and per kit.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "cycfg_capsense.h"
+#include "capsense_tuner_regs.h"
+
+
+/* Synthetic benchmark configurations are sized by tools/capsense_sweep.py */
+#if !MBED_CONF_APP_CAPSENSE_BENCHMARK
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define CAPSENSE_FOOTPRINT_WIDGETS  (sizeof(cy_stc_capsense_tuner_t::widgetContext) / \
+                                     sizeof(cy_stc_capsense_widget_context_t))
+
+/* cy_capsense_context is initialized data: it takes RAM and keeps its
+ * initial values in flash. The Tuner buffer cy_capsense_tuner counts as RAM
+ * only, as in tools/capsense_footprint.py.
+ */
+#define CAPSENSE_FOOTPRINT_DATA     (sizeof(cy_stc_capsense_context_t))
+
+#define CAPSENSE_FOOTPRINT_RAM      (CAPSENSE_FOOTPRINT_DATA + sizeof(cy_stc_capsense_tuner_t) +               \
+                                     sizeof(cy_stc_capsense_internal_context_t) +                              \
+                                     sizeof(cy_stc_active_scan_sns_t) +                                        \
+                                     (CAPSENSE_TUNER_REGS_DEBOUNCE_SIZE * sizeof(uint8_t)) +                   \
+                                     (CAPSENSE_TUNER_REGS_NOISE_ENVELOPE_SIZE *                                \
+                                      sizeof(cy_stc_capsense_smartsense_csd_noise_envelope_t)) +               \
+                                     (CAPSENSE_TUNER_REGS_RAW_HISTORY_SIZE * sizeof(uint16_t)) +               \
+                                     (CAPSENSE_TUNER_REGS_IIR_HISTORY_LOW_SIZE * sizeof(uint8_t)) +            \
+                                     (CAPSENSE_TUNER_REGS_POSITION_FILTER_HISTORY_SIZE *                       \
+                                      sizeof(cy_stc_capsense_position_t)))
+
+#define CAPSENSE_FOOTPRINT_FLASH    (CAPSENSE_FOOTPRINT_DATA +                                                 \
+                                     sizeof(cy_stc_capsense_common_config_t) +                                 \
+                                     sizeof(cy_stc_capsense_fptr_config_t) +                                   \
+                                     (CAPSENSE_FOOTPRINT_WIDGETS * sizeof(cy_stc_capsense_widget_config_t)) +  \
+                                     (CAPSENSE_TUNER_REGS_ELTD_COUNT * sizeof(cy_stc_capsense_electrode_config_t)) + \
+                                     (CAPSENSE_TUNER_REGS_PIN_COUNT * sizeof(cy_stc_capsense_pin_config_t)))
+
+
+/*******************************************************************************
+* Budgets
+*******************************************************************************/
+/* The budgets are set per kit in mbed_app.json. Run
+ * tools/capsense_footprint.py for a breakdown per widget when one fails.
+ */
+static_assert(CAPSENSE_FOOTPRINT_RAM <= MBED_CONF_APP_CAPSENSE_RAM_BUDGET,
+              "CapSense configuration exceeds capsense-ram-budget");
+static_assert(CAPSENSE_FOOTPRINT_FLASH <= MBED_CONF_APP_CAPSENSE_FLASH_BUDGET,
+              "CapSense configuration exceeds capsense-flash-budget");
+
+#endif /* !MBED_CONF_APP_CAPSENSE_BENCHMARK */
+
+
+/* [] END OF FILE */
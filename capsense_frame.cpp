@@ -0,0 +1,426 @@
+/*******************************************************************************
+* File Name: capsense_frame.cpp
+*
+* Description:
+*   Encoding of the sensor time series for the raw-count log: key frames, and
+*   delta frames with a delta-of-delta time and per-stream change bitmaps with
+*   zigzag varints.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <string.h>
+#include "capsense_frame.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Streams in coding order: raw counts come last, so that they can be
+ * predicted from the baseline and difference count of the same frame.
+ */
+static const uint8_t capsense_frame_order[CAPSENSE_FRAME_STREAMS] = { 1u, 2u, 0u };
+
+#define CAPSENSE_FRAME_DERIVED                  (CAPSENSE_FRAME_RAW | CAPSENSE_FRAME_BASELINE | CAPSENSE_FRAME_DIFF)
+
+
+/*******************************************************************************
+* Function Name: capsense_frame_put
+********************************************************************************
+* Summary:
+*   Writes an unsigned LEB128 varint and returns its length.
+*
+*******************************************************************************/
+static uint32_t capsense_frame_put(uint8_t *out, uint32_t value)
+{
+    uint32_t length = 0u;
+
+    while (value >= 0x80u)
+    {
+        out[length++] = (uint8_t)(value | 0x80u);
+        value >>= 7u;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_frame_get
+********************************************************************************
+* Summary:
+*   Reads an unsigned LEB128 varint of at most five bytes.
+*
+* Return:
+*  false if the input ends inside the varint or the varint is too long.
+*
+*******************************************************************************/
+static bool capsense_frame_get(const uint8_t *in, uint32_t length, uint32_t *pos, uint32_t *value)
+{
+    uint32_t result = 0u;
+
+    for (uint32_t shift = 0u; shift < 35u; shift += 7u)
+    {
+        if (*pos >= length)
+        {
+            return false;
+        }
+        uint8_t byte = in[(*pos)++];
+        result |= (uint32_t)(byte & 0x7Fu) << shift;
+        if (0u == (byte & 0x80u))
+        {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_frame_zigzag
+********************************************************************************
+* Summary:
+*   Maps small changes of either sign to small unsigned values.
+*
+*******************************************************************************/
+static inline uint32_t capsense_frame_zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1u) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t capsense_frame_unzigzag(uint32_t value)
+{
+    return (int32_t)((value >> 1u) ^ (0u - (value & 1u)));
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_frame_stream
+********************************************************************************
+* Summary:
+*   Values of stream index 0 (raw), 1 (baseline) or 2 (diff) of a frame.
+*
+*******************************************************************************/
+static inline uint16_t *capsense_frame_stream(capsense_frame_t *frame, uint32_t stream)
+{
+    return (0u == stream) ? frame->raw : ((1u == stream) ? frame->baseline : frame->diff);
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_frame_predict
+********************************************************************************
+* Summary:
+*   Prediction of a value of a delta frame. The middleware sets the
+*   difference count to the raw count minus the baseline whenever the raw
+*   count is above the baseline, so with all three streams the raw count is
+*   predicted exactly in that case. Otherwise the prediction is the value of
+*   the previous frame.
+*
+*******************************************************************************/
+static inline uint16_t capsense_frame_predict(const capsense_frame_t *frame, const uint16_t *last,
+                                              uint32_t streams, uint32_t stream, uint32_t sensor)
+{
+    if ((0u == stream) && (CAPSENSE_FRAME_DERIVED == streams))
+    {
+        return (uint16_t)(frame->baseline[sensor] + frame->diff[sensor]);
+    }
+    return last[sensor];
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_frame_reset
+********************************************************************************
+* Summary:
+*   Forgets the previous frame, so that the next frame must be a key frame.
+*   Called at the start of every log sector, because older sectors are erased
+*   when the log wraps around.
+*
+*******************************************************************************/
+void capsense_frame_reset(capsense_frame_state_t *state)
+{
+    state->valid = false;
+    state->streams = 0u;
+    state->deltaMs = 0u;
+    state->last.count = 0u;
+    state->last.timeMs = 0u;
+    state->last.scan = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_frame_encode
+********************************************************************************
+* Summary:
+*   Encodes one frame. A key frame is written when requested, when there is
+*   no previous frame, or when the sensor count or the streams changed. A
+*   delta frame whose scan does not follow the previous one is flagged
+*   CAPSENSE_FRAME_GAP and holds the number of scans skipped. One
+*   pass over the sensors without divisions, cheap enough for every scan;
+*   capsense_bench.cpp measures it on the kit.
+*
+* Parameters:
+*  state: previous frame, updated to this one.
+*  key: true to force a key frame.
+*  streams: CAPSENSE_FRAME_RAW, CAPSENSE_FRAME_BASELINE and/or
+*           CAPSENSE_FRAME_DIFF.
+*  frame: frame to encode, with at most CAPSENSE_FRAME_MAX_SENSORS sensors.
+*  out: buffer of CAPSENSE_FRAME_MAX_SIZE(frame->count) bytes.
+*
+* Return:
+*  Length of the encoded frame.
+*
+*******************************************************************************/
+uint32_t capsense_frame_encode(capsense_frame_state_t *state, bool key, uint32_t streams,
+                               const capsense_frame_t *frame, uint8_t *out)
+{
+    const uint32_t count = frame->count;
+    const uint32_t maskSize = (count + 7u) / 8u;
+    uint32_t length = 2u;
+
+    streams &= CAPSENSE_FRAME_ALL;
+    key = key || !state->valid || (state->last.count != count) || (state->streams != streams);
+    const uint32_t skipped = frame->scan - state->last.scan - 1u;
+    out[0] = (uint8_t)((key ? CAPSENSE_FRAME_KEY : ((0u != skipped) ? CAPSENSE_FRAME_GAP : 0u)) | streams);
+    out[1] = (uint8_t)count;
+
+    if (key)
+    {
+        length += capsense_frame_put(&out[length], frame->timeMs);
+        length += capsense_frame_put(&out[length], frame->scan);
+        state->deltaMs = 0u;
+    }
+    else
+    {
+        uint32_t deltaMs = frame->timeMs - state->last.timeMs;
+        length += capsense_frame_put(&out[length], capsense_frame_zigzag((int32_t)(deltaMs - state->deltaMs)));
+        if (0u != skipped)
+        {
+            length += capsense_frame_put(&out[length], skipped);
+        }
+        state->deltaMs = deltaMs;
+    }
+
+    for (uint32_t n = 0u; n < CAPSENSE_FRAME_STREAMS; n++)
+    {
+        const uint32_t stream = capsense_frame_order[n];
+        if (0u == (streams & (CAPSENSE_FRAME_RAW << stream)))
+        {
+            continue;
+        }
+        const uint16_t *value = capsense_frame_stream((capsense_frame_t *)frame, stream);
+        uint16_t *last = capsense_frame_stream(&state->last, stream);
+
+        if (key)
+        {
+            for (uint32_t i = 0u; i < count; i++)
+            {
+                length += capsense_frame_put(&out[length], value[i]);
+            }
+        }
+        else
+        {
+            uint8_t *mask = &out[length];
+            memset(mask, 0, maskSize);
+            length += maskSize;
+            for (uint32_t i = 0u; i < count; i++)
+            {
+                uint16_t predicted = capsense_frame_predict(frame, last, streams, stream, i);
+                if (value[i] != predicted)
+                {
+                    mask[i >> 3u] |= (uint8_t)(1u << (i & 7u));
+                    length += capsense_frame_put(&out[length],
+                                                 capsense_frame_zigzag((int32_t)value[i] - (int32_t)predicted));
+                }
+            }
+        }
+        memcpy(last, value, count * sizeof(value[0]));
+    }
+
+    state->valid = true;
+    state->streams = (uint8_t)streams;
+    state->last.count = count;
+    state->last.timeMs = frame->timeMs;
+    state->last.scan = frame->scan;
+    return length;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_frame_decode
+********************************************************************************
+* Summary:
+*   Decodes one frame. Streams that the frame does not hold are set to zero.
+*   The state is only updated once the whole frame has decoded, so a
+*   malformed frame leaves it at the previous frame.
+*
+* Parameters:
+*  state: previous frame, updated to this one on success.
+*  in: encoded frame.
+*  length: length of the encoded frame.
+*  frame: decoded frame.
+*  streams: streams present in the frame.
+*
+* Return:
+*  false if the frame is malformed, or is a delta frame without a matching
+*  previous frame.
+*
+*******************************************************************************/
+bool capsense_frame_decode(capsense_frame_state_t *state, const uint8_t *in, uint32_t length,
+                           capsense_frame_t *frame, uint32_t *streams)
+{
+    uint32_t pos = 2u;
+    uint32_t value;
+    uint32_t deltaMs = 0u;
+
+    if ((length < 2u) || (in[1] > CAPSENSE_FRAME_MAX_SENSORS) ||
+        (0u != (in[0] & ~(CAPSENSE_FRAME_KEY | CAPSENSE_FRAME_GAP | CAPSENSE_FRAME_ALL))))
+    {
+        return false;
+    }
+
+    const bool key = (0u != (in[0] & CAPSENSE_FRAME_KEY));
+    const bool gap = (0u != (in[0] & CAPSENSE_FRAME_GAP));
+    const uint32_t present = in[0] & CAPSENSE_FRAME_ALL;
+    const uint32_t count = in[1];
+    const uint32_t maskSize = (count + 7u) / 8u;
+
+    if ((key && gap) ||
+        (!key && (!state->valid || (state->last.count != count) || (state->streams != present))))
+    {
+        return false;
+    }
+    if (!capsense_frame_get(in, length, &pos, &value))
+    {
+        return false;
+    }
+    if (key)
+    {
+        frame->timeMs = value;
+        if (!capsense_frame_get(in, length, &pos, &frame->scan))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        deltaMs = state->deltaMs + (uint32_t)capsense_frame_unzigzag(value);
+        frame->timeMs = state->last.timeMs + deltaMs;
+        value = 0u;
+        if (gap && !capsense_frame_get(in, length, &pos, &value))
+        {
+            return false;
+        }
+        frame->scan = state->last.scan + 1u + value;
+    }
+    frame->count = count;
+
+    for (uint32_t n = 0u; n < CAPSENSE_FRAME_STREAMS; n++)
+    {
+        const uint32_t stream = capsense_frame_order[n];
+        uint16_t *out = capsense_frame_stream(frame, stream);
+        const uint16_t *last = capsense_frame_stream(&state->last, stream);
+
+        if (0u == (present & (CAPSENSE_FRAME_RAW << stream)))
+        {
+            memset(out, 0, count * sizeof(out[0]));
+            continue;
+        }
+
+        if (key)
+        {
+            for (uint32_t i = 0u; i < count; i++)
+            {
+                if (!capsense_frame_get(in, length, &pos, &value) || (value > UINT16_MAX))
+                {
+                    return false;
+                }
+                out[i] = (uint16_t)value;
+            }
+        }
+        else
+        {
+            const uint8_t *mask = &in[pos];
+            if ((pos + maskSize) > length)
+            {
+                return false;
+            }
+            pos += maskSize;
+            for (uint32_t i = 0u; i < count; i++)
+            {
+                out[i] = capsense_frame_predict(frame, last, present, stream, i);
+                if (0u != (mask[i >> 3u] & (1u << (i & 7u))))
+                {
+                    if (!capsense_frame_get(in, length, &pos, &value))
+                    {
+                        return false;
+                    }
+                    out[i] = (uint16_t)((int32_t)out[i] + capsense_frame_unzigzag(value));
+                }
+            }
+        }
+    }
+    if (pos != length)
+    {
+        return false;
+    }
+
+    for (uint32_t stream = 0u; stream < CAPSENSE_FRAME_STREAMS; stream++)
+    {
+        if (0u != (present & (CAPSENSE_FRAME_RAW << stream)))
+        {
+            memcpy(capsense_frame_stream(&state->last, stream), capsense_frame_stream(frame, stream),
+                   count * sizeof(uint16_t));
+        }
+    }
+    state->valid = true;
+    state->streams = (uint8_t)present;
+    state->deltaMs = deltaMs;
+    state->last.count = count;
+    state->last.timeMs = frame->timeMs;
+    state->last.scan = frame->scan;
+    *streams = present;
+    return true;
+}
+
+
+/* [] END OF FILE */
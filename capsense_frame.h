@@ -0,0 +1,126 @@
+/*******************************************************************************
+* File Name: capsense_frame.h
+*
+* Description:
+*   Compact encoding of the sensor time series for the raw-count log. A frame
+*   holds the raw counts, baselines and difference counts of one scan, or any
+*   subset of these streams. A key frame holds absolute values. The other
+*   frames hold the change of the scan interval (delta-of-delta), which is
+*   zero at a steady scan rate, the number of scans skipped since the
+*   previous frame if any, and for every stream a bitmap of the sensors
+*   whose value differs from its prediction followed by the differences as
+*   zigzag varints. The prediction is the previous value; with all three
+*   streams, a raw count is predicted as its baseline plus its difference
+*   count, which is exact whenever the raw count is above the baseline.
+*   Baselines drift slowly, so their stream mostly takes one bitmap byte per
+*   eight sensors. The header has no dependency on Mbed OS so that host tools
+*   can decode logs.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_FRAME_H
+#define CAPSENSE_FRAME_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define CAPSENSE_FRAME_MAX_SENSORS              (64u)
+
+/* Flags of the first byte of a frame: key frame, and the streams present */
+#define CAPSENSE_FRAME_KEY                      (0x01u)
+#define CAPSENSE_FRAME_RAW                      (0x02u)
+#define CAPSENSE_FRAME_BASELINE                 (0x04u)
+#define CAPSENSE_FRAME_DIFF                     (0x08u)
+#define CAPSENSE_FRAME_GAP                      (0x10u) /* Delta frame after skipped scans */
+#define CAPSENSE_FRAME_ALL                      (CAPSENSE_FRAME_RAW | CAPSENSE_FRAME_BASELINE | CAPSENSE_FRAME_DIFF)
+#define CAPSENSE_FRAME_STREAMS                  (3u)
+
+/* Largest encoded frame of count sensors: flags and count, a 32-bit
+ * varint time and scan counter, and for each stream a bitmap of the changed sensors and a
+ * varint of up to three bytes per sensor.
+ */
+#define CAPSENSE_FRAME_MAX_SIZE(count)          (2u + 10u + (CAPSENSE_FRAME_STREAMS * ((((count) + 7u) / 8u) + (3u * (count)))))
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+/* One scan: raw count, baseline and difference count of every sensor. The
+ * scan counter counts every scan, including those that were not encoded.
+ */
+typedef struct
+{
+    uint32_t timeMs;
+    uint32_t scan;
+    uint32_t count;
+    uint16_t raw[CAPSENSE_FRAME_MAX_SENSORS];
+    uint16_t baseline[CAPSENSE_FRAME_MAX_SENSORS];
+    uint16_t diff[CAPSENSE_FRAME_MAX_SENSORS];
+} capsense_frame_t;
+
+/* Previous frame of an encoder or decoder */
+typedef struct
+{
+    bool valid;
+    uint8_t streams;
+    uint32_t deltaMs;       /* Time between the last two frames */
+    capsense_frame_t last;
+} capsense_frame_state_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void capsense_frame_reset(capsense_frame_state_t *state);
+uint32_t capsense_frame_encode(capsense_frame_state_t *state, bool key, uint32_t streams,
+                               const capsense_frame_t *frame, uint8_t *out);
+bool capsense_frame_decode(capsense_frame_state_t *state, const uint8_t *in, uint32_t length,
+                           capsense_frame_t *frame, uint32_t *streams);
+
+#endif /* CAPSENSE_FRAME_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,220 @@
+/*******************************************************************************
+* File Name: capsense_gesture.cpp
+*
+* Description:
+*   Tap, double tap, long press, swipe and flick recognition for a linear
+*   slider, driven by the time stamp of every scan.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "capsense_gesture.h"
+
+
+/*******************************************************************************
+* Function Name: capsense_gesture_report
+********************************************************************************
+* Summary:
+*   Fills in a recognized gesture.
+*
+* Return:
+*  true.
+*
+*******************************************************************************/
+static bool capsense_gesture_report(capsense_gesture_event_t *event, uint32_t gesture, uint32_t direction,
+                                    uint32_t position, uint32_t speed)
+{
+    event->gesture = gesture;
+    event->direction = direction;
+    event->position = position;
+    event->speed = speed;
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_gesture_init
+********************************************************************************
+* Summary:
+*   Starts with the slider released and no tap pending.
+*
+*******************************************************************************/
+void capsense_gesture_init(capsense_gesture_t *ctx)
+{
+    ctx->touched = false;
+    ctx->moved = false;
+    ctx->longDone = false;
+    ctx->tapPending = false;
+    ctx->downMs = 0u;
+    ctx->lastMs = 0u;
+    ctx->tapMs = 0u;
+    ctx->downPos = 0u;
+    ctx->lastPos = 0u;
+    ctx->tapPos = 0u;
+    ctx->speed = 0;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_gesture_update
+********************************************************************************
+* Summary:
+*   Evaluates one scan of the slider and reports at most one gesture:
+*
+*   - A touch that ends within cfg->tapMaxMs without leaving the tap travel
+*     is a tap. It is held for cfg->doubleTapMs: a second tap that starts
+*     within that time makes a double tap, anything else reports the tap.
+*   - A touch that stays within the tap travel for cfg->longPressMs is a
+*     long press, reported while the finger is still down.
+*   - A touch that ends at least the swipe travel away from where it started
+*     is a swipe, or a flick if the filtered speed at release is at least
+*     cfg->flickMinSpeed.
+*
+*   Times are compared by difference, so the millisecond clock may wrap.
+*
+* Parameters:
+*  ctx: gesture state of the slider.
+*  cfg: gesture configuration.
+*  timeMs: time of the scan.
+*  touched: true if one finger is on the slider.
+*  position: slider position, only valid if touched.
+*  event: receives the gesture.
+*
+* Return:
+*  true if a gesture was recognized.
+*
+*******************************************************************************/
+bool capsense_gesture_update(capsense_gesture_t *ctx, const capsense_gesture_config_t *cfg, uint32_t timeMs,
+                             bool touched, uint32_t position, capsense_gesture_event_t *event)
+{
+    bool found = false;
+
+    if (touched && !ctx->touched)
+    {
+        /* A tap whose double tap time has run out is reported now */
+        if (ctx->tapPending && ((timeMs - ctx->tapMs) > cfg->doubleTapMs))
+        {
+            found = capsense_gesture_report(event, CAPSENSE_GESTURE_TAP, CAPSENSE_GESTURE_DIR_NONE, ctx->tapPos, 0u);
+            ctx->tapPending = false;
+        }
+        ctx->touched = true;
+        ctx->moved = false;
+        ctx->longDone = false;
+        ctx->downMs = timeMs;
+        ctx->downPos = (uint16_t)position;
+        ctx->speed = 0;
+    }
+    else if (touched)
+    {
+        const int32_t delta = (int32_t)position - (int32_t)ctx->lastPos;
+        const uint32_t elapsedMs = timeMs - ctx->lastMs;
+        const uint32_t travel = (position > ctx->downPos) ? (position - ctx->downPos) : (ctx->downPos - position);
+
+        if (0u != elapsedMs)
+        {
+            const int32_t speed = delta * 1000 / (int32_t)elapsedMs;
+            ctx->speed += (speed - ctx->speed) / (int32_t)(1uL << cfg->speedShift);
+        }
+        ctx->moved = ctx->moved || (travel > cfg->tapMaxTravel);
+
+        if (ctx->tapPending && (ctx->moved || ((timeMs - ctx->downMs) > cfg->tapMaxMs)))
+        {
+            /* This touch is no second tap */
+            found = capsense_gesture_report(event, CAPSENSE_GESTURE_TAP, CAPSENSE_GESTURE_DIR_NONE, ctx->tapPos, 0u);
+            ctx->tapPending = false;
+        }
+        else if (!ctx->moved && !ctx->longDone && ((timeMs - ctx->downMs) >= cfg->longPressMs))
+        {
+            found = capsense_gesture_report(event, CAPSENSE_GESTURE_LONG_PRESS, CAPSENSE_GESTURE_DIR_NONE,
+                                            ctx->downPos, 0u);
+            ctx->longDone = true;
+        }
+    }
+    else if (ctx->touched)
+    {
+        const uint32_t travel = (ctx->lastPos > ctx->downPos) ? (uint32_t)(ctx->lastPos - ctx->downPos) :
+                                                                (uint32_t)(ctx->downPos - ctx->lastPos);
+        const uint32_t speed = (uint32_t)((ctx->speed < 0) ? -ctx->speed : ctx->speed);
+
+        ctx->touched = false;
+        if (ctx->longDone)
+        {
+            /* The long press was the gesture of this touch */
+        }
+        else if (travel >= cfg->swipeMinTravel)
+        {
+            const uint32_t gesture = (speed >= cfg->flickMinSpeed) ? CAPSENSE_GESTURE_FLICK : CAPSENSE_GESTURE_SWIPE;
+            const uint32_t direction = (ctx->lastPos > ctx->downPos) ? CAPSENSE_GESTURE_DIR_RIGHT :
+                                                                       CAPSENSE_GESTURE_DIR_LEFT;
+
+            found = capsense_gesture_report(event, gesture, direction, ctx->lastPos, speed);
+        }
+        else if (!ctx->moved && ((ctx->lastMs - ctx->downMs) <= cfg->tapMaxMs))
+        {
+            if (ctx->tapPending)
+            {
+                found = capsense_gesture_report(event, CAPSENSE_GESTURE_DOUBLE_TAP, CAPSENSE_GESTURE_DIR_NONE,
+                                                ctx->downPos, 0u);
+                ctx->tapPending = false;
+            }
+            else
+            {
+                ctx->tapPending = true;
+                ctx->tapMs = timeMs;
+                ctx->tapPos = ctx->downPos;
+            }
+        }
+    }
+    else if (ctx->tapPending && ((timeMs - ctx->tapMs) > cfg->doubleTapMs))
+    {
+        found = capsense_gesture_report(event, CAPSENSE_GESTURE_TAP, CAPSENSE_GESTURE_DIR_NONE, ctx->tapPos, 0u);
+        ctx->tapPending = false;
+    }
+
+    if (touched)
+    {
+        ctx->lastMs = timeMs;
+        ctx->lastPos = (uint16_t)position;
+    }
+    return found;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,164 @@
+/*******************************************************************************
+* File Name: capsense_gesture.h
+*
+* Description:
+*   Gesture recognition for a linear slider: tap, double tap, long press,
+*   swipe and flick, from the touch position and the time of every scan. The
+*   state has a fixed size and every scan takes constant work, in integer
+*   arithmetic only. Kept free of Mbed OS so that host tools can use it as
+*   well.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_GESTURE_H
+#define CAPSENSE_GESTURE_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Gestures, also written to the gestureDetected Tuner field of the slider */
+#define CAPSENSE_GESTURE_NONE                   (0u)
+#define CAPSENSE_GESTURE_TAP                    (1u)
+#define CAPSENSE_GESTURE_DOUBLE_TAP             (2u)
+#define CAPSENSE_GESTURE_LONG_PRESS             (3u)
+#define CAPSENSE_GESTURE_SWIPE                  (4u)
+#define CAPSENSE_GESTURE_FLICK                  (5u)
+
+/* Directions of a swipe or flick, also written to gestureDirection */
+#define CAPSENSE_GESTURE_DIR_NONE               (0u)
+#define CAPSENSE_GESTURE_DIR_RIGHT              (1u)    /* Towards higher positions */
+#define CAPSENSE_GESTURE_DIR_LEFT               (2u)
+
+/* Defaults of capsense_gesture_config(), distances in percent of the slider
+ * range, so they suit every slider resolution.
+ */
+#define CAPSENSE_GESTURE_TAP_MAX_MS             (200u)
+#define CAPSENSE_GESTURE_DOUBLE_TAP_MS          (300u)
+#define CAPSENSE_GESTURE_TAP_TRAVEL_PCT         (5u)
+#define CAPSENSE_GESTURE_SWIPE_TRAVEL_PCT       (30u)
+#define CAPSENSE_GESTURE_FLICK_SPEED_PCT        (300u)  /* Per second */
+#define CAPSENSE_GESTURE_SPEED_SHIFT            (1u)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+/* Distances in slider positions */
+typedef struct
+{
+    uint16_t tapMaxMs;          /* Longest touch that is a tap */
+    uint16_t doubleTapMs;       /* Longest time from a tap to the next touch */
+    uint16_t longPressMs;       /* Shortest touch that is a long press */
+    uint16_t tapMaxTravel;      /* Farthest a tap or long press moves */
+    uint16_t swipeMinTravel;    /* Shortest swipe or flick, at least 1 */
+    uint32_t flickMinSpeed;     /* Slowest flick at release, positions per second */
+    uint8_t speedShift;         /* Speed filter coefficient is 1 / 2^shift */
+} capsense_gesture_config_t;
+
+typedef struct
+{
+    uint32_t gesture;           /* CAPSENSE_GESTURE_<KIND> */
+    uint32_t direction;         /* CAPSENSE_GESTURE_DIR_<DIR> */
+    uint32_t position;          /* Touch position of a tap or long press, end of a swipe */
+    uint32_t speed;             /* Positions per second at release */
+} capsense_gesture_event_t;
+
+/* State of one slider: constant size, whatever the length of the touch. A
+ * zero-initialized state equals the one after capsense_gesture_init().
+ */
+typedef struct
+{
+    bool touched;
+    bool moved;                 /* Left the tap travel since the touch */
+    bool longDone;              /* Long press reported for this touch */
+    bool tapPending;            /* Tap waiting for a second one */
+    uint32_t downMs;
+    uint32_t lastMs;
+    uint32_t tapMs;             /* Release of the pending tap */
+    uint16_t downPos;
+    uint16_t lastPos;
+    uint16_t tapPos;
+    int32_t speed;              /* Filtered speed, positions per second */
+} capsense_gesture_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void capsense_gesture_init(capsense_gesture_t *ctx);
+bool capsense_gesture_update(capsense_gesture_t *ctx, const capsense_gesture_config_t *cfg, uint32_t timeMs,
+                             bool touched, uint32_t position, capsense_gesture_event_t *event);
+
+
+/*******************************************************************************
+* Function Name: capsense_gesture_config
+********************************************************************************
+* Summary:
+*   Default configuration for a slider with the given resolution.
+*
+* Parameters:
+*  range: slider resolution, the highest position.
+*  longPressMs: shortest touch that is a long press.
+*
+*******************************************************************************/
+constexpr capsense_gesture_config_t capsense_gesture_config(uint32_t range, uint16_t longPressMs)
+{
+    return
+    {
+        CAPSENSE_GESTURE_TAP_MAX_MS,
+        CAPSENSE_GESTURE_DOUBLE_TAP_MS,
+        longPressMs,
+        (uint16_t)(range * CAPSENSE_GESTURE_TAP_TRAVEL_PCT / 100u),
+        (uint16_t)((range * CAPSENSE_GESTURE_SWIPE_TRAVEL_PCT / 100u) + 1u),
+        range * CAPSENSE_GESTURE_FLICK_SPEED_PCT / 100u,
+        CAPSENSE_GESTURE_SPEED_SHIFT
+    };
+}
+
+#endif /* CAPSENSE_GESTURE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,201 @@
+/*******************************************************************************
+* File Name: capsense_ipc.h
+*
+* Description:
+*   Shared memory protocol of the dual-core mode: the CM0+ scans and processes
+*   the sensors and publishes a touch frame per scan into a ring in memory
+*   shared with the CM4, which only consumes them. Kept free of Mbed OS and
+*   the PDL, so the CM0+ image and the host simulation use it as well.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_IPC_H
+#define CAPSENSE_IPC_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <atomic>
+#include "capsense_layout.h"
+#include "capsense_ring.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define CAPSENSE_IPC_MAGIC                      (0x43534950u)   /* "CSIP" */
+#define CAPSENSE_IPC_VERSION                    (1u)
+
+/* Frames the region holds, 320 ms of scans at the 20 ms period */
+#define CAPSENSE_IPC_RING_SIZE                  (16u)
+
+/* IPC channel that carries the region address from the CM4 to the CM0+, and
+ * IPC interrupt structure that tells the CM4 about new frames: the first of
+ * each that the PDL leaves to the application (CY_IPC_CHAN_USER,
+ * CY_IPC_INTR_USER).
+ */
+#define CAPSENSE_IPC_CHANNEL                    (8u)
+#define CAPSENSE_IPC_INTR                       (3u)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+/* Touch status of one scan on the CM0+, see capsense_touch_state_t. The two
+ * cores are built separately, so the shared layout is spelled out here and
+ * versioned instead of sharing the type of either image.
+ */
+typedef struct
+{
+    uint32_t seq;           /* Scans since the CM0+ started */
+    uint32_t timeMs;
+    uint32_t touched;       /* Bit per widget ID */
+    uint16_t value[CAPSENSE_LAYOUT_WIDGET_COUNT];
+} capsense_ipc_frame_t;
+
+/* Shared memory region. The CM4 owns it and sets it up; the CM0+ is the only
+ * producer and the CM4 the only consumer. The CM4 has no data cache, so
+ * the barriers of the ring indices are all the cores need.
+ */
+typedef struct
+{
+    std::atomic<uint32_t> magic;    /* Written last by capsense_ipc_init() */
+    uint32_t version;
+    uint32_t frameSize;
+    uint32_t widgets;
+    capsense_ring_t ring;
+    capsense_ipc_frame_t frames[CAPSENSE_IPC_RING_SIZE];
+} capsense_ipc_region_t;
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "capsense_ipc_region_t layout");
+
+
+/*******************************************************************************
+* Function Name: capsense_ipc_init
+********************************************************************************
+* Summary:
+*   Consumer side. Sets up an empty region. Call before passing its address
+*   to the producer.
+*
+*******************************************************************************/
+static inline void capsense_ipc_init(capsense_ipc_region_t *region)
+{
+    region->version = CAPSENSE_IPC_VERSION;
+    region->frameSize = sizeof(capsense_ipc_frame_t);
+    region->widgets = CAPSENSE_LAYOUT_WIDGET_COUNT;
+    capsense_ring_init(&region->ring, CAPSENSE_IPC_RING_SIZE);
+    region->magic.store(CAPSENSE_IPC_MAGIC, std::memory_order_release);
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_ipc_valid
+********************************************************************************
+* Summary:
+*   Producer side. Checks that the region was set up by an image built with
+*   the same protocol version and widgets.
+*
+* Return:
+*  true if the producer may publish frames.
+*
+*******************************************************************************/
+static inline bool capsense_ipc_valid(const capsense_ipc_region_t *region)
+{
+    return (CAPSENSE_IPC_MAGIC == region->magic.load(std::memory_order_acquire)) &&
+           (CAPSENSE_IPC_VERSION == region->version) &&
+           (sizeof(capsense_ipc_frame_t) == region->frameSize) &&
+           (CAPSENSE_LAYOUT_WIDGET_COUNT == region->widgets);
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_ipc_publish
+********************************************************************************
+* Summary:
+*   Producer side. Copies a frame into the region. Never waits: a full ring
+*   drops the frame and counts an overflow, which the consumer sees as a gap
+*   in seq.
+*
+* Return:
+*  false if the frame was dropped.
+*
+*******************************************************************************/
+static inline bool capsense_ipc_publish(capsense_ipc_region_t *region, const capsense_ipc_frame_t *frame)
+{
+    uint32_t slot;
+
+    if (!capsense_ring_reserve(&region->ring, &slot))
+    {
+        return false;
+    }
+    region->frames[slot] = *frame;
+    capsense_ring_publish(&region->ring);
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_ipc_consume
+********************************************************************************
+* Summary:
+*   Consumer side. Copies the oldest frame out of the region.
+*
+* Return:
+*  false if the region holds no frame.
+*
+*******************************************************************************/
+static inline bool capsense_ipc_consume(capsense_ipc_region_t *region, capsense_ipc_frame_t *frame)
+{
+    uint32_t slot;
+
+    if (!capsense_ring_peek(&region->ring, &slot))
+    {
+        return false;
+    }
+    *frame = region->frames[slot];
+    capsense_ring_release(&region->ring);
+    return true;
+}
+
+#endif /* CAPSENSE_IPC_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,112 @@
+/*******************************************************************************
+* File Name: capsense_latency.h
+*
+* Description:
+*   Wake latency statistics of the scan loop: the time from the interrupt that
+*   signals a thread to the moment that thread runs, in counts of
+*   capsense_cycles.h. Kept free of Mbed OS so that host tools can use it as
+*   well.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_LATENCY_H
+#define CAPSENSE_LATENCY_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+/* Latencies in counts of capsense_cycles_now() */
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+} capsense_latency_t;
+
+
+/*******************************************************************************
+* Function Name: capsense_latency_reset
+********************************************************************************
+* Summary:
+*   Starts a new measurement window.
+*
+*******************************************************************************/
+static inline void capsense_latency_reset(capsense_latency_t *latency)
+{
+    latency->count = 0u;
+    latency->min = UINT32_MAX;
+    latency->max = 0u;
+    latency->sum = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_latency_add
+********************************************************************************
+* Summary:
+*   Adds the time from an interrupt, stamped with capsense_cycles_now(), to
+*   the thread it woke.
+*
+* Parameters:
+*  latency: measurement window.
+*  stamp: reading taken in the interrupt.
+*  now: reading taken in the thread.
+*
+*******************************************************************************/
+static inline void capsense_latency_add(capsense_latency_t *latency, uint32_t stamp, uint32_t now)
+{
+    const uint32_t cycles = now - stamp;
+
+    latency->count++;
+    latency->min = (cycles < latency->min) ? cycles : latency->min;
+    latency->max = (cycles > latency->max) ? cycles : latency->max;
+    latency->sum += cycles;
+}
+
+#endif /* CAPSENSE_LATENCY_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,122 @@
+/*******************************************************************************
+* File Name: capsense_layout.cpp
+*
+* Description:
+*   Checks the shared CapSense description in capsense_layout.h against the
+*   configuration generated for the kit being built. Any mismatch in widget
+*   order, sensor counts, sensing method, analog settings or pin assignment
+*   fails the build.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "cycfg_capsense.h"
+#include "capsense_layout.h"
+
+
+/* The synthetic configurations of tools/capsense_gen.py have a different
+ * widget set and no Tuner register map.
+ */
+#if !MBED_CONF_APP_CAPSENSE_BENCHMARK
+
+#if (CAPSENSE_LAYOUT_TARGET_INDEX < 0)
+#error capsense_layout.h has no pin overlay for this target
+#endif
+
+
+/*******************************************************************************
+* Compile-time validation against the generated configuration
+*******************************************************************************/
+/* Counts */
+static_assert(CAPSENSE_LAYOUT_WIDGET_COUNT ==
+              (sizeof(cy_stc_capsense_tuner_t::widgetContext) / sizeof(cy_stc_capsense_widget_context_t)),
+              "Widget count differs from the generated configuration");
+static_assert(capsense_layout_sensor_count() ==
+              (sizeof(cy_stc_capsense_tuner_t::sensorContext) / sizeof(cy_stc_capsense_sensor_context_t)),
+              "Sensor count differs from the generated configuration");
+
+/* Widget order and sensor counts */
+static_assert((0u == CY_CAPSENSE_BUTTON0_WDGT_ID) && (1u == CY_CAPSENSE_BUTTON1_WDGT_ID) &&
+              (2u == CY_CAPSENSE_LINEARSLIDER0_WDGT_ID),
+              "Widget IDs differ from the order of CAPSENSE_LAYOUT_WIDGETS");
+static_assert(CAPSENSE_LAYOUT_LINEAR_SLIDER == CAPSENSE_LAYOUT_WIDGETS[CY_CAPSENSE_LINEARSLIDER0_WDGT_ID].type,
+              "LinearSlider0 is not described as a linear slider");
+static_assert((CY_CAPSENSE_LINEARSLIDER0_SNS4_ID + 1u) == CAPSENSE_LAYOUT_WIDGETS[CY_CAPSENSE_LINEARSLIDER0_WDGT_ID].numSns,
+              "LinearSlider0 segment count differs from the generated configuration");
+
+/* Sensing method of the buttons */
+static_assert((0u != CY_CAPSENSE_CSX_BUTTON_EN) == (CAPSENSE_LAYOUT_CSX == CAPSENSE_LAYOUT_ACTIVE.buttonSense),
+              "Button sensing method differs from the generated configuration");
+static_assert((0u != CY_CAPSENSE_CSD_BUTTON_EN) == (CAPSENSE_LAYOUT_CSD == CAPSENSE_LAYOUT_ACTIVE.buttonSense),
+              "Button sensing method differs from the generated configuration");
+
+/* Analog settings */
+static_assert(CY_CAPSENSE_VDDA_MV == CAPSENSE_LAYOUT_ACTIVE.vddaMv, "VDDA differs from cycfg_peripherals.h");
+static_assert(CY_CAPSENSE_PERI_CLK == CAPSENSE_LAYOUT_ACTIVE.periClkHz, "Peripheral clock differs from cycfg_peripherals.h");
+
+/* Pin overlay. The port macros expand to register pointers that cannot be
+ * compared at compile time, so only the pin numbers are checked here.
+ */
+#define CAPSENSE_LAYOUT_PIN_OF(wdgtId, eltd) \
+    (CAPSENSE_LAYOUT_ACTIVE.pins[capsense_layout_first_electrode(CAPSENSE_LAYOUT_ACTIVE, (wdgtId)) + (eltd)].pin)
+
+#if (0u != CY_CAPSENSE_CSX_BUTTON_EN)
+static_assert((Button0_Rx0_PIN == CAPSENSE_LAYOUT_PIN_OF(CY_CAPSENSE_BUTTON0_WDGT_ID, 0u)) &&
+              (Button0_Tx_PIN  == CAPSENSE_LAYOUT_PIN_OF(CY_CAPSENSE_BUTTON0_WDGT_ID, 1u)) &&
+              (Button1_Rx0_PIN == CAPSENSE_LAYOUT_PIN_OF(CY_CAPSENSE_BUTTON1_WDGT_ID, 0u)) &&
+              (Button1_Tx_PIN  == CAPSENSE_LAYOUT_PIN_OF(CY_CAPSENSE_BUTTON1_WDGT_ID, 1u)),
+              "Button pins differ from cycfg_peripherals.h");
+#else
+static_assert((Button0_Sns0_PIN == CAPSENSE_LAYOUT_PIN_OF(CY_CAPSENSE_BUTTON0_WDGT_ID, 0u)) &&
+              (Button1_Sns0_PIN == CAPSENSE_LAYOUT_PIN_OF(CY_CAPSENSE_BUTTON1_WDGT_ID, 0u)),
+              "Button pins differ from cycfg_peripherals.h");
+#endif
+
+static_assert((LinearSlider0_Sns0_PIN == CAPSENSE_LAYOUT_PIN_OF(CY_CAPSENSE_LINEARSLIDER0_WDGT_ID, 0u)) &&
+              (LinearSlider0_Sns1_PIN == CAPSENSE_LAYOUT_PIN_OF(CY_CAPSENSE_LINEARSLIDER0_WDGT_ID, 1u)) &&
+              (LinearSlider0_Sns2_PIN == CAPSENSE_LAYOUT_PIN_OF(CY_CAPSENSE_LINEARSLIDER0_WDGT_ID, 2u)) &&
+              (LinearSlider0_Sns3_PIN == CAPSENSE_LAYOUT_PIN_OF(CY_CAPSENSE_LINEARSLIDER0_WDGT_ID, 3u)) &&
+              (LinearSlider0_Sns4_PIN == CAPSENSE_LAYOUT_PIN_OF(CY_CAPSENSE_LINEARSLIDER0_WDGT_ID, 4u)),
+              "Slider pins differ from cycfg_peripherals.h");
+
+#endif /* !MBED_CONF_APP_CAPSENSE_BENCHMARK */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,423 @@
+/*******************************************************************************
+* File Name: capsense_layout.h
+*
+* Description:
+*   Single description of the CapSense widgets and sensors shared by every
+*   supported kit, plus a small per-kit pin overlay taken from each kit's
+*   cycfg_peripherals.h. Sensor, electrode, debounce and noise envelope counts
+*   are derived at compile time, and every overlay is checked against the
+*   design by static_assert. The header has no dependency on Mbed OS or the
+*   PDL so that host tools can use it as well.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_LAYOUT_H
+#define CAPSENSE_LAYOUT_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Largest electrode count of any kit. The CSX kits use one Rx and one Tx
+ * electrode per button, the CSD kits use a single self-cap electrode.
+ */
+#define CAPSENSE_LAYOUT_MAX_PINS                (9u)
+#define CAPSENSE_LAYOUT_TARGET_COUNT            (7u)
+
+/* Marks an unused entry of a pin overlay */
+#define CAPSENSE_LAYOUT_NO_PIN                  (0xFFu)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef enum
+{
+    CAPSENSE_LAYOUT_CSD,    /* Self-capacitance */
+    CAPSENSE_LAYOUT_CSX     /* Mutual-capacitance, one Rx and one Tx per sensor */
+} capsense_layout_sense_t;
+
+typedef enum
+{
+    CAPSENSE_LAYOUT_BUTTON,
+    CAPSENSE_LAYOUT_LINEAR_SLIDER
+} capsense_layout_widget_type_t;
+
+/* One widget of the design. Sensing method and pins come from the target. */
+typedef struct
+{
+    const char *name;
+    capsense_layout_widget_type_t type;
+    uint8_t numSns;
+} capsense_layout_widget_t;
+
+typedef struct
+{
+    uint8_t port;
+    uint8_t pin;
+} capsense_layout_pin_t;
+
+/* Per-kit overlay taken from the kit's cycfg_peripherals.h. Pins are listed
+ * in the electrode order used by cy_capsense_pinConfig[].
+ */
+typedef struct
+{
+    const char *name;
+    capsense_layout_sense_t buttonSense;
+    uint16_t sliderResolution;
+    uint16_t vddaMv;
+    uint32_t periClkHz;
+    capsense_layout_pin_t pins[CAPSENSE_LAYOUT_MAX_PINS];
+} capsense_layout_target_t;
+
+
+/*******************************************************************************
+* Design description
+*******************************************************************************/
+/* Widgets shared by every kit. The array index is the widget ID generated by
+ * the CapSense Configurator (CY_CAPSENSE_<NAME>_WDGT_ID).
+ */
+constexpr capsense_layout_widget_t CAPSENSE_LAYOUT_WIDGETS[] =
+{
+    { "Button0",       CAPSENSE_LAYOUT_BUTTON,        1u },
+    { "Button1",       CAPSENSE_LAYOUT_BUTTON,        1u },
+    { "LinearSlider0", CAPSENSE_LAYOUT_LINEAR_SLIDER, 5u },
+};
+
+constexpr uint32_t CAPSENSE_LAYOUT_WIDGET_COUNT =
+    sizeof(CAPSENSE_LAYOUT_WIDGETS) / sizeof(CAPSENSE_LAYOUT_WIDGETS[0]);
+
+#define CAPSENSE_LAYOUT_PIN(port, pin)          { (port), (pin) }
+#define CAPSENSE_LAYOUT_UNUSED_PIN              { CAPSENSE_LAYOUT_NO_PIN, CAPSENSE_LAYOUT_NO_PIN }
+
+constexpr capsense_layout_target_t CAPSENSE_LAYOUT_TARGETS[CAPSENSE_LAYOUT_TARGET_COUNT] =
+{
+    {
+        "CY8CKIT_062S2_43012", CAPSENSE_LAYOUT_CSX, 300u, 3300u, 72000000u,
+        {
+            CAPSENSE_LAYOUT_PIN(1u, 0u), CAPSENSE_LAYOUT_PIN(8u, 1u),   /* Button0 Rx, Tx */
+            CAPSENSE_LAYOUT_PIN(1u, 0u), CAPSENSE_LAYOUT_PIN(8u, 2u),   /* Button1 Rx, Tx */
+            CAPSENSE_LAYOUT_PIN(8u, 3u), CAPSENSE_LAYOUT_PIN(8u, 4u), CAPSENSE_LAYOUT_PIN(8u, 5u),
+            CAPSENSE_LAYOUT_PIN(8u, 6u), CAPSENSE_LAYOUT_PIN(8u, 7u),
+        },
+    },
+    {
+        "CY8CKIT_062_BLE", CAPSENSE_LAYOUT_CSX, 300u, 3300u, 100000000u,
+        {
+            CAPSENSE_LAYOUT_PIN(8u, 1u), CAPSENSE_LAYOUT_PIN(1u, 0u),
+            CAPSENSE_LAYOUT_PIN(8u, 2u), CAPSENSE_LAYOUT_PIN(1u, 0u),
+            CAPSENSE_LAYOUT_PIN(8u, 3u), CAPSENSE_LAYOUT_PIN(8u, 4u), CAPSENSE_LAYOUT_PIN(8u, 5u),
+            CAPSENSE_LAYOUT_PIN(8u, 6u), CAPSENSE_LAYOUT_PIN(8u, 7u),
+        },
+    },
+    {
+        "CY8CKIT_062_WIFI_BT", CAPSENSE_LAYOUT_CSX, 300u, 3300u, 100000000u,
+        {
+            CAPSENSE_LAYOUT_PIN(8u, 1u), CAPSENSE_LAYOUT_PIN(1u, 0u),
+            CAPSENSE_LAYOUT_PIN(8u, 2u), CAPSENSE_LAYOUT_PIN(1u, 0u),
+            CAPSENSE_LAYOUT_PIN(8u, 3u), CAPSENSE_LAYOUT_PIN(8u, 4u), CAPSENSE_LAYOUT_PIN(8u, 5u),
+            CAPSENSE_LAYOUT_PIN(8u, 6u), CAPSENSE_LAYOUT_PIN(8u, 7u),
+        },
+    },
+    {
+        "CY8CPROTO_062S3_4343W", CAPSENSE_LAYOUT_CSD, 100u, 3300u, 100000000u,
+        {
+            CAPSENSE_LAYOUT_PIN(8u, 0u), CAPSENSE_LAYOUT_PIN(8u, 1u),   /* Button0, Button1 */
+            CAPSENSE_LAYOUT_PIN(7u, 0u), CAPSENSE_LAYOUT_PIN(7u, 1u), CAPSENSE_LAYOUT_PIN(7u, 2u),
+            CAPSENSE_LAYOUT_PIN(7u, 3u), CAPSENSE_LAYOUT_PIN(9u, 0u),
+            CAPSENSE_LAYOUT_UNUSED_PIN, CAPSENSE_LAYOUT_UNUSED_PIN,
+        },
+    },
+    {
+        "CY8CPROTO_062_4343W", CAPSENSE_LAYOUT_CSX, 300u, 3300u, 50000000u,
+        {
+            CAPSENSE_LAYOUT_PIN(8u, 1u), CAPSENSE_LAYOUT_PIN(1u, 0u),
+            CAPSENSE_LAYOUT_PIN(8u, 2u), CAPSENSE_LAYOUT_PIN(1u, 0u),
+            CAPSENSE_LAYOUT_PIN(8u, 3u), CAPSENSE_LAYOUT_PIN(8u, 4u), CAPSENSE_LAYOUT_PIN(8u, 5u),
+            CAPSENSE_LAYOUT_PIN(8u, 6u), CAPSENSE_LAYOUT_PIN(8u, 7u),
+        },
+    },
+    {
+        "CYW9P62S1_43012EVB_01", CAPSENSE_LAYOUT_CSD, 300u, 1800u, 100000000u,
+        {
+            CAPSENSE_LAYOUT_PIN(9u, 7u), CAPSENSE_LAYOUT_PIN(7u, 0u),
+            CAPSENSE_LAYOUT_PIN(9u, 0u), CAPSENSE_LAYOUT_PIN(9u, 1u), CAPSENSE_LAYOUT_PIN(9u, 2u),
+            CAPSENSE_LAYOUT_PIN(9u, 3u), CAPSENSE_LAYOUT_PIN(9u, 4u),
+            CAPSENSE_LAYOUT_UNUSED_PIN, CAPSENSE_LAYOUT_UNUSED_PIN,
+        },
+    },
+    {
+        "CYW9P62S1_43438EVB_01", CAPSENSE_LAYOUT_CSX, 300u, 3300u, 100000000u,
+        {
+            CAPSENSE_LAYOUT_PIN(1u, 0u), CAPSENSE_LAYOUT_PIN(8u, 1u),
+            CAPSENSE_LAYOUT_PIN(1u, 0u), CAPSENSE_LAYOUT_PIN(8u, 2u),
+            CAPSENSE_LAYOUT_PIN(8u, 3u), CAPSENSE_LAYOUT_PIN(8u, 4u), CAPSENSE_LAYOUT_PIN(8u, 5u),
+            CAPSENSE_LAYOUT_PIN(8u, 6u), CAPSENSE_LAYOUT_PIN(8u, 7u),
+        },
+    },
+};
+
+/* Index of the kit being built, or -1 for host builds */
+#if defined(TARGET_CY8CKIT_062S2_43012)
+#define CAPSENSE_LAYOUT_TARGET_INDEX            (0)
+#elif defined(TARGET_CY8CKIT_062_BLE)
+#define CAPSENSE_LAYOUT_TARGET_INDEX            (1)
+#elif defined(TARGET_CY8CKIT_062_WIFI_BT)
+#define CAPSENSE_LAYOUT_TARGET_INDEX            (2)
+#elif defined(TARGET_CY8CPROTO_062S3_4343W)
+#define CAPSENSE_LAYOUT_TARGET_INDEX            (3)
+#elif defined(TARGET_CY8CPROTO_062_4343W)
+#define CAPSENSE_LAYOUT_TARGET_INDEX            (4)
+#elif defined(TARGET_CYW9P62S1_43012EVB_01)
+#define CAPSENSE_LAYOUT_TARGET_INDEX            (5)
+#elif defined(TARGET_CYW9P62S1_43438EVB_01)
+#define CAPSENSE_LAYOUT_TARGET_INDEX            (6)
+#else
+#define CAPSENSE_LAYOUT_TARGET_INDEX            (-1)
+#endif
+
+
+/*******************************************************************************
+* Derived quantities
+*******************************************************************************/
+constexpr capsense_layout_sense_t capsense_layout_widget_sense(const capsense_layout_target_t &target,
+                                                               uint32_t wdgtId)
+{
+    return (CAPSENSE_LAYOUT_BUTTON == CAPSENSE_LAYOUT_WIDGETS[wdgtId].type) ?
+           target.buttonSense : CAPSENSE_LAYOUT_CSD;
+}
+
+/* Index of the first sensor of a widget in cy_capsense_tuner.sensorContext[] */
+constexpr uint32_t capsense_layout_first_sensor(uint32_t wdgtId)
+{
+    uint32_t index = 0u;
+
+    for (uint32_t i = 0u; i < wdgtId; i++)
+    {
+        index += CAPSENSE_LAYOUT_WIDGETS[i].numSns;
+    }
+    return index;
+}
+
+constexpr uint32_t capsense_layout_sensor_count(void)
+{
+    return capsense_layout_first_sensor(CAPSENSE_LAYOUT_WIDGET_COUNT);
+}
+
+/* A CSX sensor owns one Rx electrode; the widget adds a single Tx electrode */
+constexpr uint32_t capsense_layout_widget_electrodes(const capsense_layout_target_t &target,
+                                                     uint32_t wdgtId)
+{
+    return CAPSENSE_LAYOUT_WIDGETS[wdgtId].numSns +
+           ((CAPSENSE_LAYOUT_CSX == capsense_layout_widget_sense(target, wdgtId)) ? 1u : 0u);
+}
+
+constexpr uint32_t capsense_layout_first_electrode(const capsense_layout_target_t &target,
+                                                   uint32_t wdgtId)
+{
+    uint32_t index = 0u;
+
+    for (uint32_t i = 0u; i < wdgtId; i++)
+    {
+        index += capsense_layout_widget_electrodes(target, i);
+    }
+    return index;
+}
+
+constexpr uint32_t capsense_layout_electrode_count(const capsense_layout_target_t &target)
+{
+    return capsense_layout_first_electrode(target, CAPSENSE_LAYOUT_WIDGET_COUNT);
+}
+
+/* Buttons debounce every sensor, sliders keep a single debounce counter */
+constexpr uint32_t capsense_layout_widget_debounce(uint32_t wdgtId)
+{
+    return (CAPSENSE_LAYOUT_BUTTON == CAPSENSE_LAYOUT_WIDGETS[wdgtId].type) ?
+           CAPSENSE_LAYOUT_WIDGETS[wdgtId].numSns : 1u;
+}
+
+/* Index of the first debounce counter of a widget in cy_capsense_debounce[] */
+constexpr uint32_t capsense_layout_first_debounce(uint32_t wdgtId)
+{
+    uint32_t index = 0u;
+
+    for (uint32_t i = 0u; i < wdgtId; i++)
+    {
+        index += capsense_layout_widget_debounce(i);
+    }
+    return index;
+}
+
+constexpr uint32_t capsense_layout_debounce_size(void)
+{
+    return capsense_layout_first_debounce(CAPSENSE_LAYOUT_WIDGET_COUNT);
+}
+
+/* SmartSense keeps one noise envelope per CSD sensor. Returns the index of
+ * the first envelope of a widget in cy_capsense_noiseEnvelope[].
+ */
+constexpr uint32_t capsense_layout_first_noise_envelope(const capsense_layout_target_t &target,
+                                                        uint32_t wdgtId)
+{
+    uint32_t index = 0u;
+
+    for (uint32_t i = 0u; i < wdgtId; i++)
+    {
+        if (CAPSENSE_LAYOUT_CSD == capsense_layout_widget_sense(target, i))
+        {
+            index += CAPSENSE_LAYOUT_WIDGETS[i].numSns;
+        }
+    }
+    return index;
+}
+
+constexpr uint32_t capsense_layout_noise_envelope_size(const capsense_layout_target_t &target)
+{
+    return capsense_layout_first_noise_envelope(target, CAPSENSE_LAYOUT_WIDGET_COUNT);
+}
+
+
+/*******************************************************************************
+* Compile-time validation
+*******************************************************************************/
+constexpr bool capsense_layout_same_pin(const capsense_layout_pin_t &a, const capsense_layout_pin_t &b)
+{
+    return (a.port == b.port) && (a.pin == b.pin);
+}
+
+/* Pin of the Tx electrode of a CSX widget */
+constexpr const capsense_layout_pin_t &capsense_layout_tx_pin(const capsense_layout_target_t &target,
+                                                              uint32_t wdgtId)
+{
+    return target.pins[capsense_layout_first_electrode(target, wdgtId) + CAPSENSE_LAYOUT_WIDGETS[wdgtId].numSns];
+}
+
+/* Every electrode is assigned and the unused tail of the overlay is empty.
+ * A self-cap electrode must not share its pin with any other electrode. CSX
+ * widgets may share Rx or Tx pins, but every (Rx, Tx) node must be unique.
+ */
+constexpr bool capsense_layout_target_valid(const capsense_layout_target_t &target)
+{
+    const uint32_t count = capsense_layout_electrode_count(target);
+
+    if (count > CAPSENSE_LAYOUT_MAX_PINS)
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0u; i < CAPSENSE_LAYOUT_MAX_PINS; i++)
+    {
+        const bool assigned = (CAPSENSE_LAYOUT_NO_PIN != target.pins[i].port) &&
+                              (CAPSENSE_LAYOUT_NO_PIN != target.pins[i].pin);
+        if (assigned != (i < count))
+        {
+            return false;
+        }
+    }
+
+    for (uint32_t w = 0u; w < CAPSENSE_LAYOUT_WIDGET_COUNT; w++)
+    {
+        const uint32_t first = capsense_layout_first_electrode(target, w);
+        const bool csx = (CAPSENSE_LAYOUT_CSX == capsense_layout_widget_sense(target, w));
+
+        for (uint32_t e = first; e < (first + capsense_layout_widget_electrodes(target, w)); e++)
+        {
+            for (uint32_t o = 0u; o < count; o++)
+            {
+                if ((o != e) && !csx && capsense_layout_same_pin(target.pins[e], target.pins[o]))
+                {
+                    return false;
+                }
+            }
+        }
+
+        for (uint32_t v = w + 1u; csx && (v < CAPSENSE_LAYOUT_WIDGET_COUNT); v++)
+        {
+            const uint32_t vFirst = capsense_layout_first_electrode(target, v);
+
+            if ((CAPSENSE_LAYOUT_CSX != capsense_layout_widget_sense(target, v)) ||
+                !capsense_layout_same_pin(capsense_layout_tx_pin(target, w), capsense_layout_tx_pin(target, v)))
+            {
+                continue;
+            }
+            for (uint32_t e = first; e < (first + CAPSENSE_LAYOUT_WIDGETS[w].numSns); e++)
+            {
+                for (uint32_t o = vFirst; o < (vFirst + CAPSENSE_LAYOUT_WIDGETS[v].numSns); o++)
+                {
+                    if (capsense_layout_same_pin(target.pins[e], target.pins[o]))
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+constexpr bool capsense_layout_all_targets_valid(void)
+{
+    for (uint32_t i = 0u; i < CAPSENSE_LAYOUT_TARGET_COUNT; i++)
+    {
+        if (!capsense_layout_target_valid(CAPSENSE_LAYOUT_TARGETS[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(CAPSENSE_LAYOUT_WIDGET_COUNT > 0u, "The design has no widgets");
+static_assert(capsense_layout_all_targets_valid(), "A kit pin overlay does not match the design");
+
+#if (CAPSENSE_LAYOUT_TARGET_INDEX >= 0)
+/* Overlay of the kit being built */
+constexpr const capsense_layout_target_t &CAPSENSE_LAYOUT_ACTIVE = CAPSENSE_LAYOUT_TARGETS[CAPSENSE_LAYOUT_TARGET_INDEX];
+#endif
+
+#endif /* CAPSENSE_LAYOUT_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,600 @@
+/*******************************************************************************
+* File Name: capsense_log.cpp
+*
+* Description:
+*   Append-only raw-count log on a ring of NOR flash sectors, with sector
+*   sequence numbers, erase counts and per-record CRCs.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <string.h>
+#include "capsense_crc.h"
+#include "capsense_log.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define CAPSENSE_LOG_MAGIC                      (0x474C5343u) /* "CSLG" */
+
+/* Length of an erased record header */
+#define CAPSENSE_LOG_ERASED                     (0xFFFFu)
+
+/* Record header made of CAPSENSE_LOG_PAD bytes */
+#define CAPSENSE_LOG_PADDED                     (0x0000u)
+
+/* capsense_log_walk() stopped because the reader asked to */
+#define CAPSENSE_LOG_STOPPED                    (1)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t eraseCount;
+    uint32_t crc;
+} capsense_log_header_t;
+
+typedef struct
+{
+    uint16_t length;
+    uint16_t crc;
+} capsense_log_record_t;
+
+static_assert(sizeof(capsense_log_header_t) == CAPSENSE_LOG_HEADER_SIZE, "Sector header size");
+static_assert(sizeof(capsense_log_record_t) == CAPSENSE_LOG_RECORD_HEADER_SIZE, "Record header size");
+
+
+/*******************************************************************************
+* Function Name: capsense_log_header
+********************************************************************************
+* Summary:
+*   Reads the header of a sector.
+*
+* Return:
+*  true if the sector holds a valid header.
+*
+*******************************************************************************/
+static bool capsense_log_header(const capsense_log_flash_t *flash, uint32_t sector, capsense_log_header_t *header)
+{
+    return (0 == flash->read(flash->arg, sector * flash->sectorSize, header, sizeof(*header))) &&
+           (CAPSENSE_LOG_MAGIC == header->magic) &&
+           (header->crc == ~capsense_crc32(CAPSENSE_CRC32_INIT, header, offsetof(capsense_log_header_t, crc)));
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_log_newest
+********************************************************************************
+* Summary:
+*   Finds the sector with the highest sequence number.
+*
+* Return:
+*  false if no sector holds a valid header.
+*
+*******************************************************************************/
+static bool capsense_log_newest(const capsense_log_flash_t *flash, uint32_t *sector, uint32_t *seq)
+{
+    capsense_log_header_t header;
+    bool found = false;
+
+    for (uint32_t s = 0u; s < flash->sectorCount; s++)
+    {
+        if (capsense_log_header(flash, s, &header) && (!found || ((int32_t)(header.seq - *seq) > 0)))
+        {
+            *sector = s;
+            *seq = header.seq;
+            found = true;
+        }
+    }
+    return found;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_log_walk
+********************************************************************************
+* Summary:
+*   Checks the records of a sector in order, and passes them to the reader if
+*   one is given. Padding skips to the next page. Stops at the first erased
+*   record header, at a record that fails its CRC, or at the end of the
+*   sector.
+*
+* Parameters:
+*  flash: flash region.
+*  sector: sector to walk.
+*  seq: sequence number passed to the reader.
+*  reader: record callback, or NULL.
+*  arg: argument of the reader.
+*  buf: scratch buffer; CAPSENSE_LOG_RECORD_MAX bytes if reader is set.
+*  bufSize: size of buf.
+*  end: offset after the last intact record.
+*  clean: true if the sector is erased from end onwards, as far as the record
+*         header at end tells.
+*
+* Return:
+*  CAPSENSE_LOG_OK, CAPSENSE_LOG_STOPPED or CAPSENSE_LOG_ERR_FLASH.
+*
+*******************************************************************************/
+static int32_t capsense_log_walk(const capsense_log_flash_t *flash, uint32_t sector, uint32_t seq,
+                                 capsense_log_reader_t reader, void *arg, uint8_t *buf, uint32_t bufSize,
+                                 uint32_t *end, bool *clean)
+{
+    const uint32_t base = sector * flash->sectorSize;
+    uint32_t offset = CAPSENSE_LOG_HEADER_SIZE;
+    capsense_log_record_t record;
+
+    *clean = false;
+    while ((offset + CAPSENSE_LOG_RECORD_HEADER_SIZE) <= flash->sectorSize)
+    {
+        const uint32_t pageLeft = flash->pageSize - (offset % flash->pageSize);
+
+        /* No record header starts in the last bytes of a page */
+        if (pageLeft < CAPSENSE_LOG_RECORD_HEADER_SIZE)
+        {
+            offset += pageLeft;
+            continue;
+        }
+        if (0 != flash->read(flash->arg, base + offset, &record, sizeof(record)))
+        {
+            *end = offset;
+            return CAPSENSE_LOG_ERR_FLASH;
+        }
+        if (CAPSENSE_LOG_ERASED == record.length)
+        {
+            *clean = (CAPSENSE_LOG_ERASED == record.crc);
+            break;
+        }
+        if ((CAPSENSE_LOG_PADDED == record.length) && (CAPSENSE_LOG_PADDED == record.crc))
+        {
+            offset += pageLeft;
+            continue;
+        }
+        if ((record.length > CAPSENSE_LOG_RECORD_MAX) ||
+            ((offset + CAPSENSE_LOG_RECORD_HEADER_SIZE + record.length) > flash->sectorSize))
+        {
+            break;
+        }
+
+        /* The payload is read in pieces of bufSize to check its CRC */
+        uint16_t crc = CAPSENSE_CRC16_INIT;
+        uint32_t payload = base + offset + CAPSENSE_LOG_RECORD_HEADER_SIZE;
+        for (uint32_t done = 0u; done < record.length; )
+        {
+            uint32_t piece = ((record.length - done) < bufSize) ? (record.length - done) : bufSize;
+            if (0 != flash->read(flash->arg, payload + done, buf, piece))
+            {
+                *end = offset;
+                return CAPSENSE_LOG_ERR_FLASH;
+            }
+            crc = capsense_crc16(crc, buf, piece);
+            done += piece;
+        }
+        if (crc != record.crc)
+        {
+            break;
+        }
+
+        offset += CAPSENSE_LOG_RECORD_HEADER_SIZE + record.length;
+        if ((NULL != reader) && !reader(arg, seq, buf, record.length))
+        {
+            *end = offset;
+            return CAPSENSE_LOG_STOPPED;
+        }
+    }
+
+    *end = offset;
+    return CAPSENSE_LOG_OK;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_log_program
+********************************************************************************
+* Summary:
+*   Programs the full page buffer. Every page is programmed once and as a
+*   whole: the S25FL512S computes its ECC when a page is programmed and does
+*   not allow a partly programmed page to be programmed again.
+*
+*******************************************************************************/
+static int32_t capsense_log_program(capsense_log_t *log)
+{
+    const capsense_log_flash_t *flash = log->flash;
+    const uint32_t addr = (log->sector * flash->sectorSize) + log->offset - flash->pageSize;
+
+    log->pageFill = 0u;
+    return (0 == flash->program(flash->arg, addr, log->page, flash->pageSize)) ?
+           CAPSENSE_LOG_OK : CAPSENSE_LOG_ERR_FLASH;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_log_pad
+********************************************************************************
+* Summary:
+*   Fills the rest of the current page with CAPSENSE_LOG_PAD and programs
+*   it, so that the records it holds reach the flash. The write position
+*   moves to the next page.
+*
+*******************************************************************************/
+static int32_t capsense_log_pad(capsense_log_t *log)
+{
+    const uint32_t pageSize = log->flash->pageSize;
+
+    if (0u == log->pageFill)
+    {
+        return CAPSENSE_LOG_OK;
+    }
+    memset(&log->page[log->pageFill], CAPSENSE_LOG_PAD, pageSize - log->pageFill);
+    log->offset += pageSize - log->pageFill;
+    return capsense_log_program(log);
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_log_start
+********************************************************************************
+* Summary:
+*   Offset at which the next record header goes. A header does not start in
+*   the last bytes of a page, which are padded instead, so that padding can
+*   always be told from a record.
+*
+*******************************************************************************/
+static uint32_t capsense_log_start(const capsense_log_t *log)
+{
+    const uint32_t pageLeft = log->flash->pageSize - log->pageFill;
+
+    return (pageLeft < CAPSENSE_LOG_RECORD_HEADER_SIZE) ? (log->offset + pageLeft) : log->offset;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_log_write
+********************************************************************************
+* Summary:
+*   Adds bytes at the write position. Full pages are programmed at once.
+*
+*******************************************************************************/
+static int32_t capsense_log_write(capsense_log_t *log, const void *data, uint32_t length)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    const uint32_t pageSize = log->flash->pageSize;
+
+    while (length > 0u)
+    {
+        uint32_t piece = ((pageSize - log->pageFill) < length) ? (pageSize - log->pageFill) : length;
+
+        memcpy(&log->page[log->pageFill], bytes, piece);
+        log->pageFill += piece;
+        log->offset += piece;
+        bytes += piece;
+        length -= piece;
+
+        if (log->pageFill == pageSize)
+        {
+            int32_t status = capsense_log_program(log);
+            if (CAPSENSE_LOG_OK != status)
+            {
+                return status;
+            }
+        }
+    }
+    return CAPSENSE_LOG_OK;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_log_open
+********************************************************************************
+* Summary:
+*   Pads the last page of the current sector, erases the sector after it,
+*   the oldest of the ring, and starts it with a new header. The header is
+*   programmed with the first page. A sector that fails to erase is skipped
+*   on the next attempt.
+*
+*******************************************************************************/
+static int32_t capsense_log_open(capsense_log_t *log)
+{
+    const capsense_log_flash_t *flash = log->flash;
+    const uint32_t next = (log->sector + 1u) % flash->sectorCount;
+    capsense_log_header_t header;
+    uint32_t eraseCount = 0u;
+
+    if (log->open)
+    {
+        (void)capsense_log_pad(log);
+    }
+    log->open = false;
+
+    if (capsense_log_header(flash, next, &header))
+    {
+        eraseCount = header.eraseCount;
+    }
+
+    log->sector = next;
+    if (0 != flash->erase(flash->arg, next * flash->sectorSize))
+    {
+        return CAPSENSE_LOG_ERR_FLASH;
+    }
+    log->erases++;
+
+    header.magic = CAPSENSE_LOG_MAGIC;
+    header.seq = log->seq + 1u;
+    header.eraseCount = eraseCount + 1u;
+    header.crc = ~capsense_crc32(CAPSENSE_CRC32_INIT, &header, offsetof(capsense_log_header_t, crc));
+    memcpy(log->page, &header, sizeof(header));
+
+    log->seq = header.seq;
+    log->offset = CAPSENSE_LOG_HEADER_SIZE;
+    log->pageFill = CAPSENSE_LOG_HEADER_SIZE;
+    log->open = true;
+    return CAPSENSE_LOG_OK;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_log_mount
+********************************************************************************
+* Summary:
+*   Finds the end of an existing log. Writing continues at the first erased
+*   page of the newest sector if the rest of that sector is still erased;
+*   otherwise, and on a blank region, the next record opens a new sector.
+*   Reads at most one sector besides the headers.
+*
+* Parameters:
+*  log: log state.
+*  flash: flash region. Pages must be a power of two of at least
+*         CAPSENSE_LOG_HEADER_SIZE and at most CAPSENSE_LOG_PAGE_MAX bytes.
+*
+* Return:
+*  CAPSENSE_LOG_OK, CAPSENSE_LOG_ERR_SIZE for an unsupported geometry, or
+*  CAPSENSE_LOG_ERR_FLASH.
+*
+*******************************************************************************/
+int32_t capsense_log_mount(capsense_log_t *log, const capsense_log_flash_t *flash)
+{
+    uint32_t end;
+    bool clean;
+
+    memset(log, 0, sizeof(*log));
+    log->flash = flash;
+    log->sector = flash->sectorCount - 1u;
+
+    if ((flash->pageSize < CAPSENSE_LOG_HEADER_SIZE) || (flash->pageSize > CAPSENSE_LOG_PAGE_MAX) ||
+        (0u != (flash->pageSize & (flash->pageSize - 1u))) || (0u != (flash->sectorSize % flash->pageSize)) ||
+        (0u == flash->sectorCount))
+    {
+        return CAPSENSE_LOG_ERR_SIZE;
+    }
+
+    if (!capsense_log_newest(flash, &log->sector, &log->seq))
+    {
+        return CAPSENSE_LOG_OK;
+    }
+
+    if ((CAPSENSE_LOG_OK != capsense_log_walk(flash, log->sector, log->seq, NULL, NULL, log->page,
+                                              flash->pageSize, &end, &clean)) || !clean ||
+        (0u != (end % flash->pageSize)))
+    {
+        return CAPSENSE_LOG_OK;
+    }
+
+    /* A program cut short by a power loss may have left bits anywhere
+     * after the last record, so check that the tail is really erased.
+     */
+    for (uint32_t offset = end; offset < flash->sectorSize; offset += flash->pageSize)
+    {
+        uint32_t piece = ((flash->sectorSize - offset) < flash->pageSize) ? (flash->sectorSize - offset) : flash->pageSize;
+
+        if (0 != flash->read(flash->arg, (log->sector * flash->sectorSize) + offset, log->page, piece))
+        {
+            return CAPSENSE_LOG_ERR_FLASH;
+        }
+        for (uint32_t i = 0u; i < piece; i++)
+        {
+            if (0xFFu != log->page[i])
+            {
+                return CAPSENSE_LOG_OK;
+            }
+        }
+    }
+
+    log->offset = end;
+    log->open = true;
+    return CAPSENSE_LOG_OK;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_log_fits
+********************************************************************************
+* Summary:
+*   Tells whether a record of the given length still fits into the current
+*   sector. If not, capsense_log_append() starts a new sector, so a caller
+*   that encodes records relative to earlier ones must start over.
+*
+*******************************************************************************/
+bool capsense_log_fits(const capsense_log_t *log, uint32_t length)
+{
+    return log->open &&
+           ((capsense_log_start(log) + CAPSENSE_LOG_RECORD_HEADER_SIZE + length) <= log->flash->sectorSize);
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_log_append
+********************************************************************************
+* Summary:
+*   Appends one record, opening a new sector first if it does not fit. The
+*   record reaches the flash when its page is full or on capsense_log_flush().
+*   Opening a sector erases it, which takes up to a few seconds on the
+*   S25FL512S, so this must not run in a time-critical thread.
+*
+* Parameters:
+*  log: log state.
+*  data: record payload.
+*  length: payload length, at most CAPSENSE_LOG_RECORD_MAX.
+*
+* Return:
+*  CAPSENSE_LOG_OK, CAPSENSE_LOG_ERR_SIZE or CAPSENSE_LOG_ERR_FLASH.
+*
+*******************************************************************************/
+int32_t capsense_log_append(capsense_log_t *log, const void *data, uint32_t length)
+{
+    capsense_log_record_t record;
+    int32_t status;
+
+    if ((length > CAPSENSE_LOG_RECORD_MAX) ||
+        ((CAPSENSE_LOG_HEADER_SIZE + CAPSENSE_LOG_RECORD_HEADER_SIZE + length) > log->flash->sectorSize))
+    {
+        return CAPSENSE_LOG_ERR_SIZE;
+    }
+
+    if (!capsense_log_fits(log, length))
+    {
+        status = capsense_log_open(log);
+        if (CAPSENSE_LOG_OK != status)
+        {
+            return status;
+        }
+    }
+
+    record.length = (uint16_t)length;
+    record.crc = capsense_crc16(CAPSENSE_CRC16_INIT, data, length);
+    status = (capsense_log_start(log) != log->offset) ? capsense_log_pad(log) : CAPSENSE_LOG_OK;
+    if (CAPSENSE_LOG_OK == status)
+    {
+        status = capsense_log_write(log, &record, sizeof(record));
+    }
+    if (CAPSENSE_LOG_OK == status)
+    {
+        status = capsense_log_write(log, data, length);
+    }
+    if (CAPSENSE_LOG_OK != status)
+    {
+        /* Do not append after a record that may be torn */
+        log->open = false;
+        return status;
+    }
+
+    log->records++;
+    return CAPSENSE_LOG_OK;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_log_flush
+********************************************************************************
+* Summary:
+*   Programs the records still held in the page buffer. The rest of the page
+*   is padded, so every flush of a partly filled page costs the remaining
+*   bytes of that page; the next record starts on the following page.
+*
+* Return:
+*  CAPSENSE_LOG_OK or CAPSENSE_LOG_ERR_FLASH.
+*
+*******************************************************************************/
+int32_t capsense_log_flush(capsense_log_t *log)
+{
+    int32_t status = log->open ? capsense_log_pad(log) : CAPSENSE_LOG_OK;
+
+    if (CAPSENSE_LOG_OK != status)
+    {
+        /* Do not append after a page that may be torn */
+        log->open = false;
+    }
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_log_read
+********************************************************************************
+* Summary:
+*   Passes every intact record of the log to the reader, oldest sector first.
+*   Sectors without a valid header, such as one whose erase was cut short,
+*   are skipped; a torn record ends its sector.
+*
+* Parameters:
+*  flash: flash region.
+*  reader: record callback.
+*  arg: argument of the reader.
+*
+* Return:
+*  CAPSENSE_LOG_OK or CAPSENSE_LOG_ERR_FLASH.
+*
+*******************************************************************************/
+int32_t capsense_log_read(const capsense_log_flash_t *flash, capsense_log_reader_t reader, void *arg)
+{
+    capsense_log_header_t header;
+    uint8_t buf[CAPSENSE_LOG_RECORD_MAX];
+    uint32_t newest = 0u;
+    uint32_t seq = 0u;
+    uint32_t end;
+    bool clean;
+
+    if (!capsense_log_newest(flash, &newest, &seq))
+    {
+        return CAPSENSE_LOG_OK;
+    }
+
+    for (uint32_t i = 1u; i <= flash->sectorCount; i++)
+    {
+        uint32_t sector = (newest + i) % flash->sectorCount;
+
+        if (capsense_log_header(flash, sector, &header))
+        {
+            int32_t status = capsense_log_walk(flash, sector, header.seq, reader, arg,
+                                               buf, sizeof(buf), &end, &clean);
+            if (CAPSENSE_LOG_OK != status)
+            {
+                return (CAPSENSE_LOG_STOPPED == status) ? CAPSENSE_LOG_OK : status;
+            }
+        }
+    }
+    return CAPSENSE_LOG_OK;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,138 @@
+/*******************************************************************************
+* File Name: capsense_log.h
+*
+* Description:
+*   Append-only log of records on a NOR flash region, used to keep the most
+*   recent raw counts. The region is a ring of erase sectors, each starting
+*   with a header that carries a sequence number and an erase count. When the
+*   newest sector is full, the oldest one is erased and reused, so every
+*   sector is erased equally often. Records are collected in a page buffer and
+*   programmed a page at a time. Mounting finds the newest sector and
+*   continues after its last intact record; a record torn by a power loss is
+*   detected by its CRC and writing continues in the next sector.
+*
+*   The flash is accessed through capsense_log_flash_t, so the same code runs
+*   on the QSPI memory of the kit and on the file-backed emulator of the host
+*   tools.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_LOG_H
+#define CAPSENSE_LOG_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Largest program page. The S25FL512S has 512-byte pages. */
+#define CAPSENSE_LOG_PAGE_MAX                   (512u)
+
+/* Every sector starts with a header: magic, sequence number, erase count
+ * and CRC-32, 16 bytes, one S25FL512S ECC unit.
+ */
+#define CAPSENSE_LOG_HEADER_SIZE                (16u)
+
+/* Every record starts with its length and the CRC-16 of its payload */
+#define CAPSENSE_LOG_RECORD_HEADER_SIZE         (4u)
+
+/* Fills the rest of a page that is flushed before it is full. Read as a
+ * record header, it has length 0 and a CRC that no empty record has.
+ */
+#define CAPSENSE_LOG_PAD                        (0x00u)
+#define CAPSENSE_LOG_RECORD_MAX                 (1024u)
+
+#define CAPSENSE_LOG_OK                         (0)
+#define CAPSENSE_LOG_ERR_FLASH                  (-1)
+#define CAPSENSE_LOG_ERR_SIZE                   (-2)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+/* NOR flash region holding the log. Addresses are relative to the region.
+ * program() never crosses a page; erase() erases the sector at addr. All
+ * return 0 on success.
+ */
+typedef struct
+{
+    uint32_t sectorSize;
+    uint32_t sectorCount;
+    uint32_t pageSize;
+    int32_t (*read)(void *arg, uint32_t addr, void *buf, uint32_t length);
+    int32_t (*program)(void *arg, uint32_t addr, const void *buf, uint32_t length);
+    int32_t (*erase)(void *arg, uint32_t addr);
+    void *arg;
+} capsense_log_flash_t;
+
+typedef struct
+{
+    const capsense_log_flash_t *flash;
+    bool open;              /* sector accepts records at offset */
+    uint32_t sector;        /* Sector written last */
+    uint32_t seq;           /* Sequence number of that sector */
+    uint32_t offset;        /* Next write position within the sector */
+    uint32_t pageFill;      /* Bytes of the current page up to offset, not programmed yet */
+    uint32_t records;
+    uint32_t erases;
+    uint8_t page[CAPSENSE_LOG_PAGE_MAX];
+} capsense_log_t;
+
+/* Called for every record, oldest first. Returns false to stop reading. */
+typedef bool (*capsense_log_reader_t)(void *arg, uint32_t seq, const uint8_t *data, uint32_t length);
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+int32_t capsense_log_mount(capsense_log_t *log, const capsense_log_flash_t *flash);
+bool capsense_log_fits(const capsense_log_t *log, uint32_t length);
+int32_t capsense_log_append(capsense_log_t *log, const void *data, uint32_t length);
+int32_t capsense_log_flush(capsense_log_t *log);
+int32_t capsense_log_read(const capsense_log_flash_t *flash, capsense_log_reader_t reader, void *arg);
+
+#endif /* CAPSENSE_LOG_H */
+
+
+/* [] END OF FILE */
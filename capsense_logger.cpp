@@ -0,0 +1,450 @@
+/*******************************************************************************
+* File Name: capsense_logger.cpp
+*
+* Description:
+*   Raw-count logger on the QSPI flash. The scan thread queues the raw
+*   counts, baselines and difference counts of every scan; a low-priority
+*   thread encodes and appends them to a capsense_log.h ring in the
+*   S25FL512S, which absorbs the sector erases.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <string.h>
+#include "mbed.h"
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cycfg_capsense.h"
+#include "capsense_layout.h"
+#include "capsense_frame.h"
+#include "capsense_log.h"
+#include "capsense_logger.h"
+
+
+#if MBED_CONF_APP_CAPSENSE_RAW_LOG
+
+#if !__has_include("cycfg_qspi_memslot.h")
+#error "capsense-raw-log needs a kit with a QSPI memory configuration (cycfg_qspi_memslot.h)"
+#endif
+#include "cycfg_qspi_memslot.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define CAPSENSE_LOGGER_SENSORS                 (capsense_layout_sensor_count())
+
+/* Scans queued while the logger thread waits for the flash. A sector erase
+ * of the S25FL512S takes 520 ms typically, 26 scans at the 20 ms period;
+ * scans that find the queue full are dropped and counted.
+ */
+#define CAPSENSE_LOGGER_QUEUE_SIZE              (32u)
+
+#define CAPSENSE_LOGGER_STACK_SIZE              (2048u)
+#define CAPSENSE_LOGGER_QSPI_HZ                 (50000000u)
+
+/* Status polling interval while the flash erases or writes its status
+ * register. The logger thread sleeps in between.
+ */
+#define CAPSENSE_LOGGER_BUSY_POLL               (5ms)
+
+/* The page buffer is flushed when no scan arrives for the idle time, as in
+ * the wake-on-touch mode, and at least once per flush period, which bounds
+ * the scans a reset loses. A flush pads the rest of the page, so the period
+ * is long against the few hundred ms a page takes to fill at 20 ms scans.
+ */
+#define CAPSENSE_LOGGER_IDLE_FLUSH              (100ms)
+#define CAPSENSE_LOGGER_FLUSH_PERIOD            (2s)
+
+static_assert(capsense_layout_sensor_count() <= CAPSENSE_FRAME_MAX_SENSORS,
+              "Too many sensors for capsense_frame.h");
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    uint32_t timeMs;
+    uint32_t scan;
+    uint16_t raw[CAPSENSE_LOGGER_SENSORS];
+    uint16_t baseline[CAPSENSE_LOGGER_SENSORS];
+    uint16_t diff[CAPSENSE_LOGGER_SENSORS];
+} capsense_logger_sample_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static int32_t capsense_logger_read(void *arg, uint32_t addr, void *buf, uint32_t length);
+static int32_t capsense_logger_program(void *arg, uint32_t addr, const void *buf, uint32_t length);
+static int32_t capsense_logger_erase(void *arg, uint32_t addr);
+
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static Thread capsense_logger_thread(osPriorityBelowNormal, CAPSENSE_LOGGER_STACK_SIZE, NULL, "CapSense Log Thread");
+static Mail<capsense_logger_sample_t, CAPSENSE_LOGGER_QUEUE_SIZE> capsense_logger_mail;
+static volatile bool capsense_logger_ready;
+
+static cyhal_qspi_t capsense_logger_qspi;
+static cy_stc_smif_mem_config_t *capsense_logger_mem;
+static uint32_t capsense_logger_base;
+
+static capsense_log_flash_t capsense_logger_flash =
+{
+    .sectorSize  = 0u,
+    .sectorCount = MBED_CONF_APP_CAPSENSE_RAW_LOG_SECTORS,
+    .pageSize    = 0u,
+    .read        = capsense_logger_read,
+    .program     = capsense_logger_program,
+    .erase       = capsense_logger_erase,
+    .arg         = NULL
+};
+
+static capsense_log_t capsense_logger_log;
+static capsense_frame_state_t capsense_logger_state;
+static capsense_frame_t capsense_logger_frame;
+
+/* Scans pushed since the start, the scan counter of the frames */
+static uint32_t capsense_logger_scans;
+
+/* Scans dropped because the queue was full, and records the flash refused */
+static uint32_t capsense_logger_drops;
+static uint32_t capsense_logger_failures;
+
+
+/*******************************************************************************
+* Function Name: capsense_logger_wait
+********************************************************************************
+* Summary:
+*   Waits until the flash has finished an erase or a status register write.
+*
+*******************************************************************************/
+static void capsense_logger_wait(void)
+{
+    while (Cy_SMIF_Memslot_IsBusy(capsense_logger_qspi.base, capsense_logger_mem, &capsense_logger_qspi.context))
+    {
+        ThisThread::sleep_for(CAPSENSE_LOGGER_BUSY_POLL);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_logger_read
+********************************************************************************
+* Summary:
+*   capsense_log_flash_t read function of the log region.
+*
+*******************************************************************************/
+static int32_t capsense_logger_read(void *arg, uint32_t addr, void *buf, uint32_t length)
+{
+    (void)arg;
+    return (CY_SMIF_SUCCESS == Cy_SMIF_MemRead(capsense_logger_qspi.base, capsense_logger_mem,
+                                               capsense_logger_base + addr, (uint8_t *)buf, length,
+                                               &capsense_logger_qspi.context)) ? 0 : -1;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_logger_program
+********************************************************************************
+* Summary:
+*   capsense_log_flash_t program function of the log region. A page program
+*   takes a few hundred microseconds, which Cy_SMIF_MemWrite() waits for.
+*
+*******************************************************************************/
+static int32_t capsense_logger_program(void *arg, uint32_t addr, const void *buf, uint32_t length)
+{
+    (void)arg;
+    return (CY_SMIF_SUCCESS == Cy_SMIF_MemWrite(capsense_logger_qspi.base, capsense_logger_mem,
+                                                capsense_logger_base + addr, (const uint8_t *)buf, length,
+                                                &capsense_logger_qspi.context)) ? 0 : -1;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_logger_erase
+********************************************************************************
+* Summary:
+*   capsense_log_flash_t erase function of the log region. Issues the sector
+*   erase command and sleeps while the flash is busy, instead of spinning in
+*   Cy_SMIF_MemEraseSector().
+*
+*******************************************************************************/
+static int32_t capsense_logger_erase(void *arg, uint32_t addr)
+{
+    const uint32_t address = capsense_logger_base + addr;
+    const uint32_t addrBytes = capsense_logger_mem->deviceCfg->numOfAddrBytes;
+    uint8_t sectorAddr[4u];
+
+    (void)arg;
+    for (uint32_t i = 0u; i < addrBytes; i++)
+    {
+        sectorAddr[i] = (uint8_t)(address >> (8u * (addrBytes - 1u - i)));
+    }
+
+    if ((CY_SMIF_SUCCESS != Cy_SMIF_Memslot_CmdWriteEnable(capsense_logger_qspi.base, capsense_logger_mem,
+                                                           &capsense_logger_qspi.context)) ||
+        (CY_SMIF_SUCCESS != Cy_SMIF_Memslot_CmdSectorErase(capsense_logger_qspi.base, capsense_logger_mem,
+                                                           sectorAddr, &capsense_logger_qspi.context)))
+    {
+        return -1;
+    }
+    capsense_logger_wait();
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_logger_init
+********************************************************************************
+* Summary:
+*   Sets up the QSPI block for the memory slot of cycfg_qspi_memslot.c and
+*   checks that the configured region fits into the device.
+*
+* Return:
+*  true on success.
+*
+*******************************************************************************/
+static bool capsense_logger_init(void)
+{
+    capsense_logger_mem = smifBlockConfig.memConfig[0u];
+    const cy_stc_smif_mem_device_cfg_t *device = capsense_logger_mem->deviceCfg;
+
+    capsense_logger_base = MBED_CONF_APP_CAPSENSE_RAW_LOG_FIRST_SECTOR * device->eraseSize;
+    capsense_logger_flash.sectorSize = device->eraseSize;
+    capsense_logger_flash.pageSize = device->programSize;
+    if ((capsense_logger_base + (capsense_logger_flash.sectorCount * device->eraseSize)) > device->memSize)
+    {
+        return false;
+    }
+
+    /* The HAL reserves and connects the pins and clocks the SMIF block; the
+     * memory slot driver then sends the commands of the generated device
+     * configuration.
+     */
+    if ((CY_RSLT_SUCCESS != cyhal_qspi_init(&capsense_logger_qspi, CYBSP_QSPI_D0, CYBSP_QSPI_D1, CYBSP_QSPI_D2,
+                                            CYBSP_QSPI_D3, NC, NC, NC, NC, CYBSP_QSPI_SCK, CYBSP_QSPI_SS,
+                                            CAPSENSE_LOGGER_QSPI_HZ, 0u)) ||
+        (CY_SMIF_SUCCESS != Cy_SMIF_Memslot_Init(capsense_logger_qspi.base,
+                                                 (cy_stc_smif_block_config_t *)&smifBlockConfig,
+                                                 &capsense_logger_qspi.context)))
+    {
+        return false;
+    }
+    Cy_SMIF_SetMode(capsense_logger_qspi.base, CY_SMIF_NORMAL);
+
+    if (CY_SMIF_SUCCESS != Cy_SMIF_Memslot_QuadEnable(capsense_logger_qspi.base, capsense_logger_mem,
+                                                      &capsense_logger_qspi.context))
+    {
+        return false;
+    }
+    capsense_logger_wait();
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_logger_flush
+********************************************************************************
+* Summary:
+*   Programs the frames held in the page buffer of the log.
+*
+*******************************************************************************/
+static void capsense_logger_flush(void)
+{
+    if (CAPSENSE_LOG_OK != capsense_log_flush(&capsense_logger_log))
+    {
+        /* The next frame must not refer to the lost ones */
+        capsense_frame_reset(&capsense_logger_state);
+        capsense_logger_failures++;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_logger_run
+********************************************************************************
+* Summary:
+*   Logger thread. Mounts the log, then encodes and appends every queued
+*   scan. The first frame of every sector is a key frame, so each sector
+*   decodes on its own once older ones have been erased. Appended frames
+*   are flushed when the queue stays empty for CAPSENSE_LOGGER_IDLE_FLUSH,
+*   and CAPSENSE_LOGGER_FLUSH_PERIOD after the first frame of a flush at the
+*   latest.
+*
+*******************************************************************************/
+static void capsense_logger_run(void)
+{
+    uint8_t frame[CAPSENSE_FRAME_MAX_SIZE(CAPSENSE_LOGGER_SENSORS)];
+    Kernel::Clock::time_point flushDue = Kernel::Clock::now();
+    bool pending = false;
+
+    if (!capsense_logger_init() ||
+        (CAPSENSE_LOG_OK != capsense_log_mount(&capsense_logger_log, &capsense_logger_flash)))
+    {
+        printf("Raw-count log: QSPI flash not available\r\n");
+        return;
+    }
+    capsense_frame_reset(&capsense_logger_state);
+    capsense_logger_ready = true;
+
+    while (true)
+    {
+        capsense_logger_sample_t *sample = capsense_logger_mail.try_get_for(
+            pending ? Kernel::Clock::duration_u32(CAPSENSE_LOGGER_IDLE_FLUSH) : Kernel::wait_for_u32_forever);
+        if (NULL == sample)
+        {
+            if (pending)
+            {
+                capsense_logger_flush();
+                pending = false;
+            }
+            continue;
+        }
+
+        bool key = !capsense_log_fits(&capsense_logger_log, sizeof(frame));
+        capsense_logger_frame.timeMs = sample->timeMs;
+        capsense_logger_frame.scan = sample->scan;
+        capsense_logger_frame.count = CAPSENSE_LOGGER_SENSORS;
+        memcpy(capsense_logger_frame.raw, sample->raw, sizeof(sample->raw));
+        memcpy(capsense_logger_frame.baseline, sample->baseline, sizeof(sample->baseline));
+        memcpy(capsense_logger_frame.diff, sample->diff, sizeof(sample->diff));
+        capsense_logger_mail.free(sample);
+
+        uint32_t length = capsense_frame_encode(&capsense_logger_state, key, CAPSENSE_FRAME_ALL,
+                                                &capsense_logger_frame, frame);
+
+        if (CAPSENSE_LOG_OK != capsense_log_append(&capsense_logger_log, frame, length))
+        {
+            /* The next frame must not refer to this one */
+            capsense_frame_reset(&capsense_logger_state);
+            capsense_logger_failures++;
+        }
+
+        if (!pending)
+        {
+            pending = true;
+            flushDue = Kernel::Clock::now() + CAPSENSE_LOGGER_FLUSH_PERIOD;
+        }
+        else if (Kernel::Clock::now() >= flushDue)
+        {
+            capsense_logger_flush();
+            pending = false;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_logger_start
+********************************************************************************
+* Summary:
+*   Starts the logger thread. The flash is set up and the log mounted in that
+*   thread, so the scan loop starts without waiting for it; scans pushed
+*   before the log is mounted are not logged.
+*
+*******************************************************************************/
+void capsense_logger_start(void)
+{
+    capsense_logger_thread.start(callback(capsense_logger_run));
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_logger_push
+********************************************************************************
+* Summary:
+*   Queues the raw counts, baselines and difference counts of the last
+*   scan. Called by the scan thread after
+*   Cy_CapSense_ProcessAllWidgets(); never waits for the logger thread or the
+*   flash.
+*
+* Parameters:
+*  context: CapSense context.
+*  timeMs: time of the scan.
+*
+*******************************************************************************/
+void capsense_logger_push(const cy_stc_capsense_context_t *context, uint32_t timeMs)
+{
+    const uint32_t scan = capsense_logger_scans++;
+
+    if (!capsense_logger_ready)
+    {
+        return;
+    }
+
+    capsense_logger_sample_t *sample = capsense_logger_mail.try_alloc();
+    if (NULL == sample)
+    {
+        capsense_logger_drops++;
+        return;
+    }
+
+    uint32_t sensor = 0u;
+    sample->timeMs = timeMs;
+    sample->scan = scan;
+    for (uint32_t wdgtId = 0u; wdgtId < context->ptrCommonConfig->numWd; wdgtId++)
+    {
+        const cy_stc_capsense_widget_config_t *widget = &context->ptrWdConfig[wdgtId];
+        for (uint32_t snsId = 0u; (snsId < widget->numSns) && (sensor < CAPSENSE_LOGGER_SENSORS); snsId++)
+        {
+            sample->raw[sensor] = widget->ptrSnsContext[snsId].raw;
+            sample->baseline[sensor] = widget->ptrSnsContext[snsId].bsln;
+            sample->diff[sensor] = widget->ptrSnsContext[snsId].diff;
+            sensor++;
+        }
+    }
+    while (sensor < CAPSENSE_LOGGER_SENSORS)
+    {
+        sample->raw[sensor] = 0u;
+        sample->baseline[sensor] = 0u;
+        sample->diff[sensor] = 0u;
+        sensor++;
+    }
+    capsense_logger_mail.put(sample);
+}
+
+#endif /* MBED_CONF_APP_CAPSENSE_RAW_LOG */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,76 @@
+/*******************************************************************************
+* File Name: capsense_logger.h
+*
+* Description:
+*   Logs the raw counts, baselines and difference counts of every scan to
+*   the QSPI flash of the kit with capsense_log.h. The scan thread only
+*   queues a copy of them; a low-priority thread compresses them with
+*   capsense_frame.h and writes the flash.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_LOGGER_H
+#define CAPSENSE_LOGGER_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "mbed.h"
+#include "cycfg_capsense.h"
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+#if MBED_CONF_APP_CAPSENSE_RAW_LOG
+void capsense_logger_start(void);
+void capsense_logger_push(const cy_stc_capsense_context_t *context, uint32_t timeMs);
+#else
+static inline void capsense_logger_start(void) {}
+static inline void capsense_logger_push(const cy_stc_capsense_context_t *context, uint32_t timeMs)
+{
+    (void)context;
+    (void)timeMs;
+}
+#endif
+
+#endif /* CAPSENSE_LOGGER_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,163 @@
+/*******************************************************************************
+* File Name: capsense_power.cpp
+*
+* Description:
+*   Power mode state machine of the scan loop: switches between scanning all
+*   widgets and scanning one ganged wake-on-touch sensor.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "capsense_power.h"
+
+
+/*******************************************************************************
+* Function Name: capsense_power_init
+********************************************************************************
+* Summary:
+*   Starts in active mode so that the first frames after reset are scanned at
+*   the normal rate.
+*
+*******************************************************************************/
+void capsense_power_init(capsense_power_t *ctx)
+{
+    ctx->mode = CAPSENSE_POWER_ACTIVE;
+    ctx->idleMs = 0u;
+    ctx->baseline = 0u;
+    ctx->baselineValid = false;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_power_ganged
+********************************************************************************
+* Summary:
+*   Evaluates one raw count of the ganged sensor in wake-on-touch mode. The
+*   first sample after reset sets the baseline. A raw count that exceeds the
+*   baseline by cfg->threshold switches to active mode; otherwise the baseline
+*   follows the raw count through a first-order filter so that slow drift
+*   with temperature or humidity does not wake the device.
+*
+* Parameters:
+*  ctx: power mode state.
+*  cfg: power mode configuration.
+*  raw: raw count of the ganged sensor.
+*
+* Return:
+*  true when the scan loop has to switch to active mode.
+*
+*******************************************************************************/
+bool capsense_power_ganged(capsense_power_t *ctx, const capsense_power_config_t *cfg, uint16_t raw)
+{
+    uint32_t sample = (uint32_t)raw << 8u;
+
+    if (!ctx->baselineValid)
+    {
+        ctx->baseline = sample;
+        ctx->baselineValid = true;
+        return false;
+    }
+
+    if ((uint32_t)raw >= ((ctx->baseline >> 8u) + cfg->threshold))
+    {
+        ctx->mode = CAPSENSE_POWER_ACTIVE;
+        ctx->idleMs = 0u;
+        return true;
+    }
+
+    if (sample >= ctx->baseline)
+    {
+        ctx->baseline += (sample - ctx->baseline) >> cfg->baselineShift;
+    }
+    else
+    {
+        ctx->baseline -= (ctx->baseline - sample) >> cfg->baselineShift;
+    }
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_power_active
+********************************************************************************
+* Summary:
+*   Accounts one full scan. A touch on any widget restarts the timeout and
+*   keeps the scan loop in active mode, also when the full scan was not
+*   requested by the ganged sensor; when no widget has been touched for
+*   cfg->timeoutMs the scan loop switches to wake-on-touch mode.
+*
+* Parameters:
+*  ctx: power mode state.
+*  cfg: power mode configuration.
+*  touched: true if any widget is active, or if the scan loop must stay in
+*           active mode for another reason.
+*
+*******************************************************************************/
+void capsense_power_active(capsense_power_t *ctx, const capsense_power_config_t *cfg, bool touched)
+{
+    if (touched)
+    {
+        ctx->mode = CAPSENSE_POWER_ACTIVE;
+        ctx->idleMs = 0u;
+        return;
+    }
+
+    ctx->idleMs += cfg->activePeriodMs;
+    if (ctx->idleMs >= cfg->timeoutMs)
+    {
+        ctx->mode = CAPSENSE_POWER_WAKE_ON_TOUCH;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_power_period_ms
+********************************************************************************
+* Summary:
+*   Returns the delay until the next scan in the current mode.
+*
+*******************************************************************************/
+uint32_t capsense_power_period_ms(const capsense_power_t *ctx, const capsense_power_config_t *cfg)
+{
+    return (CAPSENSE_POWER_WAKE_ON_TOUCH == ctx->mode) ? cfg->wotPeriodMs : cfg->activePeriodMs;
+}
+
+
+/* [] END OF FILE */
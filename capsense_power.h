@@ -0,0 +1,101 @@
+/*******************************************************************************
+* File Name: capsense_power.h
+*
+* Description:
+*   Power mode state machine of the scan loop. In active mode every widget is
+*   scanned at the normal rate; after a period without touch the loop drops
+*   into wake-on-touch mode, where all button and slider electrodes, the Rx
+*   and Tx electrodes of CSX buttons included, are scanned together as one
+*   ganged CSD sensor at a low rate. A ganged raw count above its tracked
+*   baseline returns to active mode.
+*
+*   The logic has no dependency on Mbed OS or the PDL so that
+*   tools/capsense_power_sim.cpp can model it on the host.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_POWER_H
+#define CAPSENSE_POWER_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef enum
+{
+    CAPSENSE_POWER_ACTIVE,          /* Every widget scanned each activePeriodMs */
+    CAPSENSE_POWER_WAKE_ON_TOUCH    /* Ganged sensor scanned each wotPeriodMs */
+} capsense_power_mode_t;
+
+typedef struct
+{
+    uint32_t activePeriodMs;
+    uint32_t wotPeriodMs;
+    uint32_t timeoutMs;     /* Time without touch before wake-on-touch */
+    uint16_t threshold;     /* Ganged raw count above the baseline that wakes */
+    uint8_t baselineShift;  /* Baseline filter coefficient is 1 / 2^shift */
+} capsense_power_config_t;
+
+typedef struct
+{
+    capsense_power_mode_t mode;
+    uint32_t idleMs;
+    uint32_t baseline;      /* Ganged raw count baseline, Q24.8 */
+    bool baselineValid;
+} capsense_power_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void capsense_power_init(capsense_power_t *ctx);
+bool capsense_power_ganged(capsense_power_t *ctx, const capsense_power_config_t *cfg, uint16_t raw);
+void capsense_power_active(capsense_power_t *ctx, const capsense_power_config_t *cfg, bool touched);
+uint32_t capsense_power_period_ms(const capsense_power_t *ctx, const capsense_power_config_t *cfg);
+
+#endif /* CAPSENSE_POWER_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,163 @@
+/*******************************************************************************
+* File Name: capsense_predict.cpp
+*
+* Description:
+*   Predicted slider position, see capsense_predict.h.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "capsense_predict.h"
+
+
+/*******************************************************************************
+* Function Name: capsense_predict_init
+********************************************************************************
+* Summary:
+*   Starts with the slider released.
+*
+*******************************************************************************/
+void capsense_predict_init(capsense_predict_t *ctx)
+{
+    ctx->touched = false;
+    ctx->run = 0u;
+    ctx->lastPos = 0u;
+    ctx->lastMs = 0u;
+    ctx->speed = 0;
+    ctx->accel = 0;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_predict_update
+********************************************************************************
+* Summary:
+*   Estimates speed and acceleration from the positions of successive scans
+*   and extrapolates the position one scan period ahead:
+*   position + speed * t + accel * t^2 / 2, with t the time since the
+*   previous scan. Both estimates are first-order filters over the
+*   differences of successive scans, in integers.
+*
+*   The prediction is gated: the measured position is returned on the first
+*   scans of a touch, after a gap of more than cfg->maxGapMs, and until the
+*   finger has moved cfg->minRun scans the same way. A step against the
+*   filtered speed is a reversal; it restarts the estimate and drops the
+*   prediction, so a finger that turns around is not carried past the turn.
+*   A decelerating finger is never predicted behind its measured position.
+*
+* Parameters:
+*  ctx: prediction state of the slider.
+*  cfg: prediction configuration.
+*  timeMs: time of the scan.
+*  touched: true if a finger is on the slider.
+*  position: slider position, only valid if touched.
+*
+* Return:
+*  Predicted position, between 0 and cfg->range.
+*
+*******************************************************************************/
+uint32_t capsense_predict_update(capsense_predict_t *ctx, const capsense_predict_config_t *cfg, uint32_t timeMs,
+                                 bool touched, uint32_t position)
+{
+    const uint32_t elapsedMs = timeMs - ctx->lastMs;
+    const int32_t delta = (int32_t)position - (int32_t)ctx->lastPos;
+    const int32_t divider = (int32_t)(1uL << cfg->filterShift);
+
+    if (!touched)
+    {
+        ctx->touched = false;
+        return position;
+    }
+
+    ctx->lastPos = (uint16_t)position;
+    ctx->lastMs = timeMs;
+    if (!ctx->touched || (0u == elapsedMs) || (elapsedMs > cfg->maxGapMs))
+    {
+        ctx->touched = true;
+        ctx->run = 0u;
+        ctx->speed = 0;
+        ctx->accel = 0;
+        return position;
+    }
+
+    const int32_t speed = delta * 1000 / (int32_t)elapsedMs;
+
+    if (((delta > 0) && (ctx->speed < 0)) || ((delta < 0) && (ctx->speed > 0)))
+    {
+        /* Reversal: the new direction starts from its own step */
+        ctx->run = 1u;
+        ctx->speed = speed;
+        ctx->accel = 0;
+        return position;
+    }
+
+    const int32_t accel = (speed - ctx->speed) * 1000 / (int32_t)elapsedMs;
+
+    ctx->speed += (speed - ctx->speed) / divider;
+    ctx->accel += (accel - ctx->accel) / divider;
+    if ((delta >= -(int32_t)cfg->minStep) && (delta <= (int32_t)cfg->minStep))
+    {
+        /* Too slow to tell from noise */
+        ctx->run = 0u;
+    }
+    else if (ctx->run < UINT8_MAX)
+    {
+        ctx->run++;
+    }
+    if (ctx->run < cfg->minRun)
+    {
+        return position;
+    }
+
+    /* Positions ahead, rounded to nearest; in 64 bits as t^2 reaches 10^4 ms^2 */
+    const int64_t t = (int64_t)elapsedMs;
+    const int64_t scaled = ((int64_t)ctx->speed * t * 2000) + ((int64_t)ctx->accel * t * t);
+    int64_t ahead = (scaled + ((scaled < 0) ? -1000000 : 1000000)) / 2000000;
+    if (((ctx->speed >= 0) && (ahead < 0)) || ((ctx->speed <= 0) && (ahead > 0)))
+    {
+        ahead = 0;
+    }
+
+    const int64_t predicted = (int64_t)position + ahead;
+    return (predicted < 0) ? 0u : ((predicted > cfg->range) ? cfg->range : (uint32_t)predicted);
+}
+
+
+/* [] END OF FILE */
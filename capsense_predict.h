@@ -0,0 +1,130 @@
+/*******************************************************************************
+* File Name: capsense_predict.h
+*
+* Description:
+*   Predicted slider position: estimates speed and acceleration of the finger
+*   over the last scans and extrapolates its position one scan period ahead,
+*   to hide part of the scan and filter latency. Used by capsense_event.cpp
+*   with the capsense-slider-predict application option. Kept free of Mbed OS
+*   so that host tools can use it as well.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_PREDICT_H
+#define CAPSENSE_PREDICT_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Defaults of capsense_predict_config(), the step in percent of the slider
+ * range, so it suits every slider resolution.
+ */
+#define CAPSENSE_PREDICT_MIN_STEP_PCT           (1u)
+#define CAPSENSE_PREDICT_FILTER_SHIFT           (1u)
+#define CAPSENSE_PREDICT_MIN_RUN                (3u)
+#define CAPSENSE_PREDICT_MAX_GAP_MS             (100u)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    uint16_t range;             /* Highest position */
+    uint16_t minStep;           /* Smallest move between scans that counts as moving, at least 1 */
+    uint16_t maxGapMs;          /* A longer time between scans restarts the estimate */
+    uint8_t filterShift;        /* Speed and acceleration filter coefficient is 1 / 2^shift */
+    uint8_t minRun;             /* Scans moving the same way before the prediction starts */
+} capsense_predict_config_t;
+
+/* State of one slider. A zero-initialized state equals the one after
+ * capsense_predict_init().
+ */
+typedef struct
+{
+    bool touched;
+    uint8_t run;                /* Scans moving the same way since the touch or the last reversal */
+    uint16_t lastPos;
+    uint32_t lastMs;
+    int32_t speed;              /* Filtered speed, positions per second */
+    int32_t accel;              /* Filtered acceleration, positions per second squared */
+} capsense_predict_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void capsense_predict_init(capsense_predict_t *ctx);
+uint32_t capsense_predict_update(capsense_predict_t *ctx, const capsense_predict_config_t *cfg, uint32_t timeMs,
+                                 bool touched, uint32_t position);
+
+
+/*******************************************************************************
+* Function Name: capsense_predict_config
+********************************************************************************
+* Summary:
+*   Default configuration for a slider with the given resolution.
+*
+* Parameters:
+*  range: slider resolution, the highest position.
+*
+*******************************************************************************/
+constexpr capsense_predict_config_t capsense_predict_config(uint32_t range)
+{
+    return
+    {
+        (uint16_t)range,
+        (uint16_t)((range * CAPSENSE_PREDICT_MIN_STEP_PCT / 100u) + 1u),
+        CAPSENSE_PREDICT_MAX_GAP_MS,
+        CAPSENSE_PREDICT_FILTER_SHIFT,
+        CAPSENSE_PREDICT_MIN_RUN
+    };
+}
+
+#endif /* CAPSENSE_PREDICT_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,205 @@
+/*******************************************************************************
+* File Name: capsense_remote.cpp
+*
+* Description:
+*   CM4 consumer of the dual-core mode, see capsense_remote.h.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "mbed.h"
+#include "cy_pdl.h"
+#include "capsense_ipc.h"
+#include "capsense_remote.h"
+
+
+#if MBED_CONF_APP_CAPSENSE_DUAL_CORE
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* The thread only converts frames; reporting runs in the capsense_report.h
+ * sink, on this thread or on the report thread.
+ */
+#define CAPSENSE_REMOTE_STACK_SIZE              (2048u)
+#define CAPSENSE_REMOTE_INTR_PRIORITY           (5u)
+
+/* Thread flag set by the IPC interrupt */
+#define CAPSENSE_REMOTE_FLAG                    (0x1u)
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void capsense_remote_isr(void);
+
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* The region lives in the section the PSoC 6 linker scripts keep for memory
+ * shared between the cores.
+ */
+CY_SECTION(".cy_sharedmem") static capsense_ipc_region_t capsense_remote_region;
+
+static Thread capsense_remote_thread(osPriorityNormal, CAPSENSE_REMOTE_STACK_SIZE, NULL, "CapSense IPC Thread");
+
+static const cy_stc_sysint_t capsense_remote_isr_cfg =
+{
+    .intrSrc = (IRQn_Type)(cpuss_interrupts_ipc_0_IRQn + CAPSENSE_IPC_INTR),
+    .intrPriority = CAPSENSE_REMOTE_INTR_PRIORITY
+};
+
+/* Frames consumed, and frames the CM0+ dropped as seen from gaps in seq */
+static uint32_t capsense_remote_frames;
+static uint32_t capsense_remote_gaps;
+
+
+/*******************************************************************************
+* Function Name: capsense_remote_isr
+********************************************************************************
+* Summary:
+*   IPC interrupt of the CM0+ notification. Wakes the consumer thread.
+*
+*******************************************************************************/
+static void capsense_remote_isr(void)
+{
+    Cy_IPC_Drv_ClearInterrupt(Cy_IPC_Drv_GetIntrBaseAddr(CAPSENSE_IPC_INTR), 0u, 1uL << CAPSENSE_IPC_CHANNEL);
+    capsense_remote_thread.flags_set(CAPSENSE_REMOTE_FLAG);
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_remote_run
+********************************************************************************
+* Summary:
+*   Consumer thread. Drains the region after every notification and hands
+*   each frame to capsense_report_push() as if it came from a local scan.
+*   Gaps are counted from the first frame received: the CM0+ may have
+*   published frames before this thread started, or kept running across a
+*   reset of the CM4 alone.
+*
+*******************************************************************************/
+static void capsense_remote_run(void)
+{
+    uint32_t expected = 0u;
+    bool synced = false;
+
+    while (true)
+    {
+        capsense_ipc_frame_t frame;
+
+        ThisThread::flags_wait_any(CAPSENSE_REMOTE_FLAG);
+        while (capsense_ipc_consume(&capsense_remote_region, &frame))
+        {
+            capsense_touch_state_t state;
+
+            capsense_remote_gaps += synced ? (frame.seq - expected) : 0u;
+            synced = true;
+            expected = frame.seq + 1u;
+            capsense_remote_frames++;
+
+            state.timeMs = frame.timeMs;
+            state.touched = frame.touched;
+            state.twoTouch = 0u;        /* The CM0+ reports one finger per slider */
+            for (uint32_t wdgtId = 0u; wdgtId < CAPSENSE_LAYOUT_WIDGET_COUNT; wdgtId++)
+            {
+                state.value[wdgtId] = frame.value[wdgtId];
+                state.second[wdgtId] = 0u;
+            }
+            capsense_report_push(&state);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_remote_start
+********************************************************************************
+* Summary:
+*   Sets up the shared region, enables the notification interrupt, and hands
+*   the region address to the CM0+. The address stays in the data register of
+*   CAPSENSE_IPC_CHANNEL, whose lock tells the CM0+ that it is valid. Call
+*   after capsense_report_start().
+*
+*******************************************************************************/
+void capsense_remote_start(void)
+{
+    IPC_STRUCT_Type *channel = Cy_IPC_Drv_GetIpcBaseAddress(CAPSENSE_IPC_CHANNEL);
+
+    capsense_ipc_init(&capsense_remote_region);
+    capsense_remote_thread.start(callback(capsense_remote_run));
+
+    Cy_SysInt_Init(&capsense_remote_isr_cfg, capsense_remote_isr);
+    Cy_IPC_Drv_SetInterruptMask(Cy_IPC_Drv_GetIntrBaseAddr(CAPSENSE_IPC_INTR), 0u, 1uL << CAPSENSE_IPC_CHANNEL);
+    NVIC_EnableIRQ(capsense_remote_isr_cfg.intrSrc);
+
+    while (CY_IPC_DRV_SUCCESS != Cy_IPC_Drv_LockAcquire(channel))
+    {
+        ThisThread::sleep_for(1ms);
+    }
+    Cy_IPC_Drv_WriteDataValue(channel, (uint32_t)(uintptr_t)&capsense_remote_region);
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_remote_stats
+********************************************************************************
+* Summary:
+*   Returns the counters of the shared ring. records counts the frames
+*   consumed, overflows the frames the CM0+ dropped.
+*
+* Parameters:
+*  stats: receives the counters.
+*
+*******************************************************************************/
+void capsense_remote_stats(capsense_report_stats_t *stats)
+{
+    stats->records = capsense_remote_frames;
+    stats->overflows = capsense_remote_gaps;
+    stats->occupancy = capsense_ring_count(&capsense_remote_region.ring);
+    stats->peak = capsense_remote_region.ring.peak;
+    stats->size = CAPSENSE_IPC_RING_SIZE;
+}
+
+#endif /* MBED_CONF_APP_CAPSENSE_DUAL_CORE */
+
+
+/* [] END OF FILE */
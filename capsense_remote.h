@@ -0,0 +1,65 @@
+/*******************************************************************************
+* File Name: capsense_remote.h
+*
+* Description:
+*   CM4 side of the dual-core mode (capsense-dual-core option), see
+*   capsense_ipc.h: consumes the touch frames of the CM0+ and hands them to
+*   capsense_report.h, so the CM4 runs no CapSense scanning or processing.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_REMOTE_H
+#define CAPSENSE_REMOTE_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "capsense_report.h"
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void capsense_remote_start(void);
+void capsense_remote_stats(capsense_report_stats_t *stats);
+
+#endif /* CAPSENSE_REMOTE_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,164 @@
+/*******************************************************************************
+* File Name: capsense_replay.cpp
+*
+* Description:
+*   Golden-trace replay, see capsense_replay.h.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "mbed.h"
+#include "cycfg_capsense.h"
+#include "capsense_cycles.h"
+#include "capsense_replay.h"
+#include "capsense_touch.h"
+
+
+#if MBED_CONF_APP_CAPSENSE_REPLAY
+
+/*******************************************************************************
+* Function Name: capsense_replay_load
+********************************************************************************
+* Summary:
+*   Writes the raw counts of one scan of a trace into the sensor contexts,
+*   where a real scan leaves them.
+*
+*******************************************************************************/
+static void capsense_replay_load(const capsense_replay_trace_t *trace, uint32_t frame)
+{
+    const uint16_t *raw = &trace->raw[frame * trace->sensors];
+    uint32_t sensor = 0u;
+
+    for (uint32_t wdgtId = 0u; wdgtId < cy_capsense_context.ptrCommonConfig->numWd; wdgtId++)
+    {
+        const cy_stc_capsense_widget_config_t *widget = &cy_capsense_context.ptrWdConfig[wdgtId];
+        for (uint32_t snsId = 0u; snsId < widget->numSns; snsId++)
+        {
+            widget->ptrSnsContext[snsId].raw = raw[sensor++];
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_replay_trace
+********************************************************************************
+* Summary:
+*   Replays one trace. The baselines start from the first scan, and the
+*   filters and widget status are cleared, so every trace starts from the
+*   state after Cy_CapSense_Enable(). Each scan runs through
+*   Cy_CapSense_ProcessAllWidgets() and capsense_touch_update(), and every
+*   event is printed as a "replay,event," record with its scan number. A
+*   "replay,trace," record with the processing cost in CPU cycles follows.
+*
+*******************************************************************************/
+static void capsense_replay_trace(const capsense_replay_trace_t *trace)
+{
+    capsense_touch_t touch;
+    capsense_touch_event_t events[CAPSENSE_LAYOUT_WIDGET_COUNT];
+    bool anyTouch;
+    uint32_t min = UINT32_MAX;
+    uint32_t max = 0u;
+    uint64_t sum = 0u;
+
+    capsense_replay_load(trace, 0u);
+    Cy_CapSense_InitializeAllBaselines(&cy_capsense_context);
+    Cy_CapSense_InitializeAllFilters(&cy_capsense_context);
+    Cy_CapSense_InitializeAllStatuses(&cy_capsense_context);
+    capsense_touch_init(&touch);
+
+    for (uint32_t frame = 0u; frame < trace->frames; frame++)
+    {
+        capsense_replay_load(trace, frame);
+        uint32_t start = capsense_cycles_now();
+        Cy_CapSense_ProcessAllWidgets(&cy_capsense_context);
+        uint32_t cycles = capsense_cycles_now() - start;
+
+        min = (cycles < min) ? cycles : min;
+        max = (cycles > max) ? cycles : max;
+        sum += cycles;
+
+        uint32_t count = capsense_touch_update(&touch, &cy_capsense_context, events, &anyTouch);
+        for (uint32_t i = 0u; i < count; i++)
+        {
+            printf("replay,event,%s,%lu,%lu,%lu\r\n", trace->name, (unsigned long)frame,
+                   (unsigned long)events[i].wdgtId, (unsigned long)events[i].value);
+        }
+    }
+
+    printf("replay,trace,%s,%lu,%lu,%lu,%lu,%lu\r\n", trace->name, (unsigned long)trace->frames,
+           (unsigned long)SystemCoreClock, (unsigned long)min, (unsigned long)(sum / trace->frames),
+           (unsigned long)max);
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_replay_run
+********************************************************************************
+* Summary:
+*   Replays every trace of the corpus instead of scanning the sensors, then
+*   prints "replay,done". tools/capsense_replay.py compares the events with
+*   the golden ones and the cost with its baseline. A trace recorded with a
+*   different number of sensors is reported with "replay,error," and
+*   skipped.
+*
+*******************************************************************************/
+void capsense_replay_run(void)
+{
+    capsense_cycles_init();
+
+    for (uint32_t i = 0u; i < capsense_replay_trace_count; i++)
+    {
+        const capsense_replay_trace_t *trace = &capsense_replay_traces[i];
+
+        if ((trace->sensors != cy_capsense_context.ptrCommonConfig->numSns) || (0u == trace->frames))
+        {
+            printf("replay,error,%s,%lu sensors\r\n", trace->name, (unsigned long)trace->sensors);
+            continue;
+        }
+        capsense_replay_trace(trace);
+    }
+    printf("replay,done\r\n");
+}
+
+#endif /* MBED_CONF_APP_CAPSENSE_REPLAY */
+
+
+/* [] END OF FILE */
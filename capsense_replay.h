@@ -0,0 +1,90 @@
+/*******************************************************************************
+* File Name: capsense_replay.h
+*
+* Description:
+*   Golden-trace replay. Feeds the raw counts of recorded or synthesized
+*   traces through the CapSense processing and the touch reporting of the
+*   demo, and prints every event and the processing cost.
+*   tools/capsense_replay.py generates the corpus, builds and flashes the
+*   firmware with the capsense-replay option, and checks the output against
+*   the golden events.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_REPLAY_H
+#define CAPSENSE_REPLAY_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+/* Recorded or synthesized trace: the raw counts of every sensor, in the
+ * order of the sensor contexts, one row per scan.
+ */
+typedef struct
+{
+    const char *name;
+    uint32_t sensors;
+    uint32_t frames;
+    const uint16_t *raw;
+} capsense_replay_trace_t;
+
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* Corpus generated by tools/capsense_replay.py */
+extern const capsense_replay_trace_t capsense_replay_traces[];
+extern const uint32_t capsense_replay_trace_count;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void capsense_replay_run(void);
+
+#endif /* CAPSENSE_REPLAY_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,253 @@
+/*******************************************************************************
+* File Name: capsense_report.cpp
+*
+* Description:
+*   Touch status handoff to the report thread, see capsense_report.h.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "mbed.h"
+#include "capsense_ring.h"
+#include "capsense_seqlock.h"
+#include "capsense_report.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define CAPSENSE_REPORT_RING_SIZE               (MBED_CONF_APP_CAPSENSE_REPORT_RING)
+
+/* printf() and the LED of the demo need less than 1 KB; sinks that talk to
+ * the network or a display need more.
+ */
+#define CAPSENSE_REPORT_STACK_SIZE              (2048u)
+
+/* Thread flag set by capsense_report_push() */
+#define CAPSENSE_REPORT_FLAG                    (0x1u)
+
+static_assert((CAPSENSE_REPORT_RING_SIZE > 0u) &&
+              (0u == (CAPSENSE_REPORT_RING_SIZE & (CAPSENSE_REPORT_RING_SIZE - 1u))),
+              "capsense-report-ring must be a power of two");
+static_assert((0u == (sizeof(capsense_touch_state_t) % 4u)) &&
+              (CAPSENSE_SEQLOCK_WORDS(capsense_touch_state_t) <= CAPSENSE_SEQLOCK_MAX_WORDS),
+              "capsense_touch_state_t does not fit capsense_seqlock.h");
+
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static capsense_report_sink_t capsense_report_sink;
+
+/* Last reported state, owned by the thread that runs the sink */
+static capsense_touch_t capsense_report_touch;
+
+/* Records pushed, written by the scan thread only */
+static uint32_t capsense_report_records;
+
+/* Last pushed record, for capsense_report_latest() */
+static std::atomic<uint32_t> capsense_report_latest_words[CAPSENSE_SEQLOCK_WORDS(capsense_touch_state_t)];
+static capsense_seqlock_t capsense_report_latest_lock =
+{
+    { 0u }, capsense_report_latest_words, CAPSENSE_SEQLOCK_WORDS(capsense_touch_state_t)
+};
+
+#if MBED_CONF_APP_CAPSENSE_REPORT_THREAD
+static Thread capsense_report_thread(osPriorityBelowNormal, CAPSENSE_REPORT_STACK_SIZE, NULL, "CapSense Report Thread");
+static capsense_ring_t capsense_report_ring;
+static capsense_touch_state_t capsense_report_slots[CAPSENSE_REPORT_RING_SIZE];
+#endif
+
+
+/*******************************************************************************
+* Function Name: capsense_report_deliver
+********************************************************************************
+* Summary:
+*   Finds the changes of one record and passes them to the sink.
+*
+*******************************************************************************/
+static void capsense_report_deliver(const capsense_touch_state_t *state)
+{
+    capsense_touch_event_t events[CAPSENSE_LAYOUT_WIDGET_COUNT];
+    bool anyTouch;
+    uint32_t count = capsense_touch_diff(&capsense_report_touch, state, events, &anyTouch);
+
+    capsense_report_sink(state, events, count, anyTouch);
+}
+
+
+#if MBED_CONF_APP_CAPSENSE_REPORT_THREAD
+/*******************************************************************************
+* Function Name: capsense_report_run
+********************************************************************************
+* Summary:
+*   Report thread. Drains the ring every time the scan thread pushes a
+*   record. Each record is copied out of its slot before the sink runs, so a
+*   slow sink holds no slot.
+*
+*******************************************************************************/
+static void capsense_report_run(void)
+{
+    while (true)
+    {
+        uint32_t slot;
+
+        ThisThread::flags_wait_any(CAPSENSE_REPORT_FLAG);
+        while (capsense_ring_peek(&capsense_report_ring, &slot))
+        {
+            capsense_touch_state_t state = capsense_report_slots[slot];
+
+            capsense_ring_release(&capsense_report_ring);
+            capsense_report_deliver(&state);
+        }
+    }
+}
+#endif
+
+
+/*******************************************************************************
+* Function Name: capsense_report_start
+********************************************************************************
+* Summary:
+*   Sets the sink and starts the report thread. Call before the first scan.
+*
+* Parameters:
+*  sink: receives the changes of every scan.
+*
+*******************************************************************************/
+void capsense_report_start(capsense_report_sink_t sink)
+{
+    capsense_report_sink = sink;
+    capsense_touch_init(&capsense_report_touch);
+
+    #if MBED_CONF_APP_CAPSENSE_REPORT_THREAD
+    capsense_ring_init(&capsense_report_ring, CAPSENSE_REPORT_RING_SIZE);
+    capsense_report_thread.start(callback(capsense_report_run));
+    #endif
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_report_push
+********************************************************************************
+* Summary:
+*   Publishes the status of the last scan for capsense_report_latest() and
+*   hands it to the sink. Called by the scan thread.
+*
+*   With capsense-report-thread the record goes to the ring and the report
+*   thread, which runs at a lower priority, is woken; this never waits for
+*   it. A full ring drops the record. Since every record holds the complete
+*   status, the next one still reports every button change; only slider
+*   positions in between are lost.
+*
+* Parameters:
+*  state: status of the widgets.
+*
+*******************************************************************************/
+void capsense_report_push(const capsense_touch_state_t *state)
+{
+    capsense_report_records++;
+    capsense_seqlock_write(&capsense_report_latest_lock, state);
+
+    #if MBED_CONF_APP_CAPSENSE_REPORT_THREAD
+    uint32_t slot;
+
+    if (capsense_ring_reserve(&capsense_report_ring, &slot))
+    {
+        capsense_report_slots[slot] = *state;
+        capsense_ring_publish(&capsense_report_ring);
+    }
+    capsense_report_thread.flags_set(CAPSENSE_REPORT_FLAG);
+    #else
+    capsense_report_deliver(state);
+    #endif
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_report_stats
+********************************************************************************
+* Summary:
+*   Returns the ring counters. May be called from any thread; the values are
+*   a snapshot.
+*
+* Parameters:
+*  stats: receives the counters.
+*
+*******************************************************************************/
+void capsense_report_stats(capsense_report_stats_t *stats)
+{
+    stats->records = capsense_report_records;
+
+    #if MBED_CONF_APP_CAPSENSE_REPORT_THREAD
+    stats->overflows = capsense_report_ring.overflows;
+    stats->occupancy = capsense_ring_count(&capsense_report_ring);
+    stats->peak = capsense_report_ring.peak;
+    stats->size = CAPSENSE_REPORT_RING_SIZE;
+    #else
+    stats->overflows = 0u;
+    stats->occupancy = 0u;
+    stats->peak = 0u;
+    stats->size = 0u;
+    #endif
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_report_latest
+********************************************************************************
+* Summary:
+*   Returns the status of the last scan. May be called from any number of
+*   threads at any time: the copy is consistent even while the scan thread
+*   processes the next scan, and neither side waits for a lock. Use it instead
+*   of reading the widget status in cy_capsense_context from other threads.
+*   All zero before the first scan.
+*
+* Parameters:
+*  state: receives the status.
+*
+*******************************************************************************/
+void capsense_report_latest(capsense_touch_state_t *state)
+{
+    (void)capsense_seqlock_read(&capsense_report_latest_lock, state);
+}
+
+
+/* [] END OF FILE */
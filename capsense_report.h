@@ -0,0 +1,89 @@
+/*******************************************************************************
+* File Name: capsense_report.h
+*
+* Description:
+*   Hands the touch status of every scan from the scan thread to the code that
+*   reports it: the LED, the serial output and application callbacks. With the
+*   capsense-report-thread option they run on their own lower priority thread,
+*   fed through a wait-free ring, so they cannot delay the next scan.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_REPORT_H
+#define CAPSENSE_REPORT_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "capsense_touch.h"
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+/* Receives the changes of one scan, see capsense_touch_diff(). Runs on the
+ * report thread with capsense-report-thread, on the scan thread otherwise.
+ */
+typedef void (*capsense_report_sink_t)(const capsense_touch_state_t *state,
+                                       const capsense_touch_event_t *events, uint32_t count, bool anyTouch);
+
+typedef struct
+{
+    uint32_t records;       /* Records pushed by the scan thread */
+    uint32_t overflows;     /* Records dropped because the ring was full */
+    uint32_t occupancy;     /* Records waiting for the report thread */
+    uint32_t peak;          /* Highest occupancy */
+    uint32_t size;          /* Ring size, 0 without the report thread */
+} capsense_report_stats_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void capsense_report_start(capsense_report_sink_t sink);
+void capsense_report_push(const capsense_touch_state_t *state);
+void capsense_report_stats(capsense_report_stats_t *stats);
+void capsense_report_latest(capsense_touch_state_t *state);
+
+#endif /* CAPSENSE_REPORT_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,202 @@
+/*******************************************************************************
+* File Name: capsense_ring.h
+*
+* Description:
+*   Wait-free single-producer, single-consumer ring indices, used to hand
+*   records from the scan thread to lower priority threads. Kept free of Mbed
+*   OS so that host tools can use it as well.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_RING_H
+#define CAPSENSE_RING_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <atomic>
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+/* Indices of a single-producer, single-consumer ring. The slots live with the
+ * user, in an array of a power-of-two size. Neither side ever waits: the
+ * producer drops a record when the ring is full, and only the producer
+ * writes head and the counters, only the consumer writes tail.
+ */
+typedef struct
+{
+    std::atomic<uint32_t> head;     /* Records published, wraps */
+    std::atomic<uint32_t> tail;     /* Records consumed, wraps */
+    uint32_t mask;                  /* Slot count - 1 */
+    uint32_t overflows;             /* Records dropped because the ring was full */
+    uint32_t peak;                  /* Highest occupancy seen by the producer */
+} capsense_ring_t;
+
+
+/*******************************************************************************
+* Function Name: capsense_ring_init
+********************************************************************************
+* Summary:
+*   Empties the ring and clears its counters. Call before either side runs.
+*
+* Parameters:
+*  ring: ring indices.
+*  size: slot count, a power of two.
+*
+*******************************************************************************/
+static inline void capsense_ring_init(capsense_ring_t *ring, uint32_t size)
+{
+    ring->head.store(0u, std::memory_order_relaxed);
+    ring->tail.store(0u, std::memory_order_relaxed);
+    ring->mask = size - 1u;
+    ring->overflows = 0u;
+    ring->peak = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_ring_count
+********************************************************************************
+* Summary:
+*   Returns the number of records waiting. Exact on either side; from any
+*   other thread it is a snapshot.
+*
+*******************************************************************************/
+static inline uint32_t capsense_ring_count(const capsense_ring_t *ring)
+{
+    return ring->head.load(std::memory_order_acquire) - ring->tail.load(std::memory_order_acquire);
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_ring_reserve
+********************************************************************************
+* Summary:
+*   Producer side. Returns the slot for the next record, to be filled and
+*   then published with capsense_ring_publish(). Counts an overflow if the
+*   ring is full.
+*
+* Parameters:
+*  ring: ring indices.
+*  slot: receives the slot index.
+*
+* Return:
+*  false if the ring is full.
+*
+*******************************************************************************/
+static inline bool capsense_ring_reserve(capsense_ring_t *ring, uint32_t *slot)
+{
+    const uint32_t head = ring->head.load(std::memory_order_relaxed);
+
+    if ((head - ring->tail.load(std::memory_order_acquire)) > ring->mask)
+    {
+        ring->overflows++;
+        return false;
+    }
+    *slot = head & ring->mask;
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_ring_publish
+********************************************************************************
+* Summary:
+*   Producer side. Makes the record of the reserved slot visible to the
+*   consumer.
+*
+*******************************************************************************/
+static inline void capsense_ring_publish(capsense_ring_t *ring)
+{
+    const uint32_t head = ring->head.load(std::memory_order_relaxed) + 1u;
+    const uint32_t count = head - ring->tail.load(std::memory_order_relaxed);
+
+    ring->head.store(head, std::memory_order_release);
+    ring->peak = (count > ring->peak) ? count : ring->peak;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_ring_peek
+********************************************************************************
+* Summary:
+*   Consumer side. Returns the slot of the oldest record, which stays valid
+*   until capsense_ring_release().
+*
+* Parameters:
+*  ring: ring indices.
+*  slot: receives the slot index.
+*
+* Return:
+*  false if the ring is empty.
+*
+*******************************************************************************/
+static inline bool capsense_ring_peek(capsense_ring_t *ring, uint32_t *slot)
+{
+    const uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+
+    if (tail == ring->head.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+    *slot = tail & ring->mask;
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_ring_release
+********************************************************************************
+* Summary:
+*   Consumer side. Hands the slot of the oldest record back to the producer.
+*
+*******************************************************************************/
+static inline void capsense_ring_release(capsense_ring_t *ring)
+{
+    ring->tail.store(ring->tail.load(std::memory_order_relaxed) + 1u, std::memory_order_release);
+}
+
+#endif /* CAPSENSE_RING_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,109 @@
+/*******************************************************************************
+* File Name: capsense_sched.cpp
+*
+* Description:
+*   Tickless scan scheduler: arms a low-power one-shot timer for the next scan
+*   deadline.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "capsense_sched.h"
+
+
+/*******************************************************************************
+* Function Name: capsense_sched_init
+********************************************************************************
+* Summary:
+*   Arms the timer for the first scan, one period from now.
+*
+* Parameters:
+*  ctx: scheduler state.
+*  timer: one-shot timer that expires in deep sleep.
+*  periodUs: scan period.
+*
+*******************************************************************************/
+void capsense_sched_init(capsense_sched_t *ctx, const capsense_sched_timer_t *timer, uint32_t periodUs)
+{
+    ctx->timer = timer;
+    ctx->deadlineUs = timer->now(timer->arg) + periodUs;
+    ctx->wakeups = 0u;
+    ctx->overruns = 0u;
+    ctx->activeUs = 0u;
+    timer->start(timer->arg, periodUs);
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_sched_done
+********************************************************************************
+* Summary:
+*   Called when the scan started by the last expiration has been processed.
+*   Accounts the time spent awake and arms the timer for the next deadline,
+*   one period after the previous one. If processing ran past that deadline,
+*   the missed scan is dropped and the next one starts a period from now, so
+*   that an overrun does not cause a burst of back-to-back scans.
+*
+* Parameters:
+*  ctx: scheduler state.
+*  periodUs: period until the next scan; it may change from scan to scan.
+*
+*******************************************************************************/
+void capsense_sched_done(capsense_sched_t *ctx, uint32_t periodUs)
+{
+    const capsense_sched_timer_t *timer = ctx->timer;
+    const uint32_t nowUs = timer->now(timer->arg);
+    uint32_t nextUs = ctx->deadlineUs + periodUs;
+
+    ctx->wakeups++;
+    ctx->activeUs += (uint32_t)(nowUs - ctx->deadlineUs);
+
+    if ((int32_t)(nextUs - nowUs) <= 0)
+    {
+        ctx->overruns++;
+        nextUs = nowUs + periodUs;
+    }
+
+    ctx->deadlineUs = nextUs;
+    timer->start(timer->arg, nextUs - nowUs);
+}
+
+
+/* [] END OF FILE */
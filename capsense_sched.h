@@ -0,0 +1,91 @@
+/*******************************************************************************
+* File Name: capsense_sched.h
+*
+* Description:
+*   Tickless scan scheduler. The next scan is a deadline on a low-power one-
+*   shot timer, armed when processing of the previous scan is done, so the
+*   device wakes once per scan and sleeps in between. Deadlines advance by
+*   whole periods and do not drift with the processing time. The timer is
+*   abstract so that tools/capsense_power_sim.cpp can run the same scheduler
+*   on virtual time and count wakeups and sleep residency.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_SCHED_H
+#define CAPSENSE_SCHED_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+/* One-shot timer that keeps running in deep sleep. On the device it is the
+ * low-power timer; host simulators provide a virtual one.
+ */
+typedef struct
+{
+    uint32_t (*now)(void *arg);                     /* Free-running microseconds */
+    void (*start)(void *arg, uint32_t delayUs);     /* Expires once after delayUs */
+    void *arg;
+} capsense_sched_timer_t;
+
+typedef struct
+{
+    const capsense_sched_timer_t *timer;
+    uint32_t deadlineUs;    /* Scheduled start of the current or next scan */
+    uint32_t wakeups;       /* Timer expirations, one per scan */
+    uint32_t overruns;      /* Scans that ended after the next deadline */
+    uint64_t activeUs;      /* Time from the deadlines to the end of processing */
+} capsense_sched_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void capsense_sched_init(capsense_sched_t *ctx, const capsense_sched_timer_t *timer, uint32_t periodUs);
+void capsense_sched_done(capsense_sched_t *ctx, uint32_t periodUs);
+
+#endif /* CAPSENSE_SCHED_H */
+
+
+/* [] END OF FILE */
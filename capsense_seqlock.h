@@ -0,0 +1,203 @@
+/*******************************************************************************
+* File Name: capsense_seqlock.h
+*
+* Description:
+*   Sequence lock that publishes a small record from one writer to any number
+*   of reader threads without blocking either side. Kept free of Mbed OS so
+*   that host tools can use it as well.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_SEQLOCK_H
+#define CAPSENSE_SEQLOCK_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <atomic>
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Words of seqlock storage for a record type */
+#define CAPSENSE_SEQLOCK_WORDS(type)            ((sizeof(type) + 3u) / 4u)
+
+/* Largest record capsense_seqlock_write() and capsense_seqlock_read() copy */
+#define CAPSENSE_SEQLOCK_MAX_WORDS              (32u)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+/* Sequence lock for one writer and any number of readers. The sequence is
+ * odd while the writer copies a record. Readers copy without taking any lock
+ * and retry if the sequence was odd or changed meanwhile. The writer never
+ * waits for a reader. The record is kept in atomic words, read and written
+ * with relaxed order, so that a reader racing with the writer is not a data
+ * race; on a Cortex-M these are plain loads and stores.
+ */
+typedef struct
+{
+    std::atomic<uint32_t> seq;
+    std::atomic<uint32_t> *words;   /* CAPSENSE_SEQLOCK_WORDS() of the record */
+    uint32_t count;
+} capsense_seqlock_t;
+
+
+/*******************************************************************************
+* Function Name: capsense_seqlock_init
+********************************************************************************
+* Summary:
+*   Attaches the storage of a record. Call before the writer and the readers
+*   run. The record size must be a multiple of 4 bytes, as it is for any
+*   struct with a 32-bit member.
+*
+* Parameters:
+*  lock: sequence lock.
+*  words: storage of CAPSENSE_SEQLOCK_WORDS(type) words.
+*  count: CAPSENSE_SEQLOCK_WORDS(type), up to CAPSENSE_SEQLOCK_MAX_WORDS.
+*
+*******************************************************************************/
+static inline void capsense_seqlock_init(capsense_seqlock_t *lock, std::atomic<uint32_t> *words, uint32_t count)
+{
+    lock->seq.store(0u, std::memory_order_relaxed);
+    lock->words = words;
+    lock->count = count;
+    for (uint32_t i = 0u; i < count; i++)
+    {
+        words[i].store(0u, std::memory_order_relaxed);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_seqlock_write
+********************************************************************************
+* Summary:
+*   Writer side. Publishes a record.
+*
+* Parameters:
+*  lock: sequence lock.
+*  record: record of the size given to capsense_seqlock_init().
+*
+*******************************************************************************/
+static inline void capsense_seqlock_write(capsense_seqlock_t *lock, const void *record)
+{
+    uint32_t buffer[CAPSENSE_SEQLOCK_MAX_WORDS] = {0u};
+    const uint32_t seq = lock->seq.load(std::memory_order_relaxed);
+
+    memcpy(buffer, record, lock->count * sizeof(uint32_t));
+    lock->seq.store(seq + 1u, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (uint32_t i = 0u; i < lock->count; i++)
+    {
+        lock->words[i].store(buffer[i], std::memory_order_relaxed);
+    }
+    lock->seq.store(seq + 2u, std::memory_order_release);
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_seqlock_try_read
+********************************************************************************
+* Summary:
+*   Reader side. Copies the record once.
+*
+* Parameters:
+*  lock: sequence lock.
+*  record: receives the record.
+*
+* Return:
+*  false if the writer interfered; the copy must then be discarded.
+*
+*******************************************************************************/
+static inline bool capsense_seqlock_try_read(const capsense_seqlock_t *lock, void *record)
+{
+    uint32_t buffer[CAPSENSE_SEQLOCK_MAX_WORDS];
+    const uint32_t before = lock->seq.load(std::memory_order_acquire);
+
+    for (uint32_t i = 0u; i < lock->count; i++)
+    {
+        buffer[i] = lock->words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if ((0u != (before & 1u)) || (before != lock->seq.load(std::memory_order_relaxed)))
+    {
+        return false;
+    }
+    memcpy(record, buffer, lock->count * sizeof(uint32_t));
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_seqlock_read
+********************************************************************************
+* Summary:
+*   Reader side. Copies a consistent record, retrying while the writer
+*   interferes. The writer holds the sequence odd only for the copy of a few
+*   words, so retries are rare and short.
+*
+* Parameters:
+*  lock: sequence lock.
+*  record: receives the record.
+*
+* Return:
+*  Number of retries.
+*
+*******************************************************************************/
+static inline uint32_t capsense_seqlock_read(const capsense_seqlock_t *lock, void *record)
+{
+    uint32_t retries = 0u;
+
+    while (!capsense_seqlock_try_read(lock, record))
+    {
+        retries++;
+    }
+    return retries;
+}
+
+#endif /* CAPSENSE_SEQLOCK_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,109 @@
+/*******************************************************************************
+* File Name: capsense_sleep.cpp
+*
+* Description:
+*   Deep sleep policy for builds with the CapSense Tuner: holds the deep sleep
+*   lock only while a tuner host is active.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "capsense_sleep.h"
+
+
+/*******************************************************************************
+* Function Name: capsense_sleep_init
+********************************************************************************
+* Summary:
+*   Starts unlocked. The EZI2C slave wakes the device from deep sleep on an
+*   address match, so the first tuner access is served and then detected by
+*   capsense_sleep_update().
+*
+*******************************************************************************/
+void capsense_sleep_init(capsense_sleep_t *ctx)
+{
+    ctx->locked = false;
+    ctx->lastActivityMs = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_sleep_update
+********************************************************************************
+* Summary:
+*   Decides whether the deep sleep lock must be taken or released. Any tuner
+*   access restarts the window; the lock is released once no access has been
+*   seen for windowMs. Timestamps may wrap around.
+*
+* Parameters:
+*  ctx: policy state.
+*  windowMs: time after the last tuner access during which deep sleep stays
+*            locked.
+*  nowMs: current time in milliseconds.
+*  tunerActivity: true if the tuner host accessed the EZI2C buffer since the
+*                 previous call.
+*
+* Return:
+*  Change of the deep sleep lock the caller has to apply.
+*
+*******************************************************************************/
+capsense_sleep_action_t capsense_sleep_update(capsense_sleep_t *ctx, uint32_t windowMs,
+                                              uint32_t nowMs, bool tunerActivity)
+{
+    if (tunerActivity)
+    {
+        ctx->lastActivityMs = nowMs;
+        if (!ctx->locked)
+        {
+            ctx->locked = true;
+            return CAPSENSE_SLEEP_LOCK;
+        }
+    }
+    else if (ctx->locked && ((uint32_t)(nowMs - ctx->lastActivityMs) >= windowMs))
+    {
+        ctx->locked = false;
+        return CAPSENSE_SLEEP_UNLOCK;
+    }
+
+    return CAPSENSE_SLEEP_KEEP;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,86 @@
+/*******************************************************************************
+* File Name: capsense_sleep.h
+*
+* Description:
+*   Deep sleep policy for builds with the CapSense Tuner. The deep sleep lock
+*   is held only while a tuner host has accessed the EZI2C buffer within a
+*   window, so a unit built with tuning support sleeps between scans when
+*   nobody is connected. The logic has no dependency on Mbed OS so that host
+*   tools can use it as well.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_SLEEP_H
+#define CAPSENSE_SLEEP_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef enum
+{
+    CAPSENSE_SLEEP_KEEP,        /* Leave the deep sleep lock as it is */
+    CAPSENSE_SLEEP_LOCK,        /* Call sleep_manager_lock_deep_sleep() */
+    CAPSENSE_SLEEP_UNLOCK       /* Call sleep_manager_unlock_deep_sleep() */
+} capsense_sleep_action_t;
+
+typedef struct
+{
+    bool locked;
+    uint32_t lastActivityMs;
+} capsense_sleep_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void capsense_sleep_init(capsense_sleep_t *ctx);
+capsense_sleep_action_t capsense_sleep_update(capsense_sleep_t *ctx, uint32_t windowMs,
+                                              uint32_t nowMs, bool tunerActivity);
+
+#endif /* CAPSENSE_SLEEP_H */
+
+
+/* [] END OF FILE */
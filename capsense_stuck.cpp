@@ -0,0 +1,142 @@
+/*******************************************************************************
+* File Name: capsense_stuck.cpp
+*
+* Description:
+*   Stuck-sensor supervisor, see capsense_stuck.h.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "capsense_stuck.h"
+
+
+/*******************************************************************************
+* Function Name: capsense_stuck_init
+********************************************************************************
+* Summary:
+*   Starts with the sensor untouched and at its baseline.
+*
+*******************************************************************************/
+void capsense_stuck_init(capsense_stuck_t *sns)
+{
+    sns->on = false;
+    sns->negScans = 0u;
+    sns->clearScans = 0u;
+    sns->onSinceMs = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_stuck_update
+********************************************************************************
+* Summary:
+*   Watches one sensor after every processed scan for a baseline that is
+*   latched wrong:
+*
+*   - A sensor above the finger threshold for more than maxOnMs is taken
+*     for an object resting on it, not a finger. The baseline does not
+*     follow a touch, so it would stay touched until the object is gone.
+*   - A sensor below its baseline by more than the negative noise
+*     threshold for CAPSENSE_STUCK_NEGATIVE_FACTOR times lowBslnRst scans
+*     has a baseline the low baseline reset of the middleware did not bring
+*     down, for example after such an object was removed. The middleware
+*     zeroes negBslnRstCnt when it resets a low baseline, so once
+*     lowBslnRst scans are counted they are only counted from zero again
+*     after the sensor has stayed at its baseline for lowBslnRst scans; a
+*     sensor that drops below the new baseline right after the reset keeps
+*     counting. Shorter runs below the baseline are noise and are dropped.
+*
+*   The caller resets the baseline of the sensor on either result; the
+*   state is cleared, so the sensor is reported again only once it is
+*   stuck for the whole time again. Times are compared by difference, so
+*   the millisecond clock may wrap.
+*
+* Parameters:
+*  sns: supervisor state of the sensor.
+*  maxOnMs: longest touch, 0 to never end a touch.
+*  timeMs: time of the scan.
+*  on: difference count at or above the finger threshold.
+*  negative: raw count below the baseline by more than the negative noise
+*  threshold, as counted in negBslnRstCnt.
+*  lowBslnRst: scans after which the middleware resets a low baseline, 0 to
+*  never report a negative sensor.
+*
+* Return:
+*  CAPSENSE_STUCK_NONE, CAPSENSE_STUCK_ON or CAPSENSE_STUCK_NEGATIVE.
+*
+*******************************************************************************/
+uint32_t capsense_stuck_update(capsense_stuck_t *sns, uint32_t maxOnMs, uint32_t timeMs, bool on, bool negative,
+                               uint32_t lowBslnRst)
+{
+    if (on && !sns->on)
+    {
+        sns->onSinceMs = timeMs;
+    }
+    sns->on = on;
+    if (negative)
+    {
+        sns->clearScans = 0u;
+        sns->negScans = (sns->negScans < UINT16_MAX) ? (uint16_t)(sns->negScans + 1u) : sns->negScans;
+    }
+    else if (0u != sns->negScans)
+    {
+        sns->clearScans++;
+        if ((sns->negScans < lowBslnRst) || (sns->clearScans >= lowBslnRst))
+        {
+            sns->negScans = 0u;
+            sns->clearScans = 0u;
+        }
+    }
+
+    if (on && (0u != maxOnMs) && ((timeMs - sns->onSinceMs) > maxOnMs))
+    {
+        capsense_stuck_init(sns);
+        return CAPSENSE_STUCK_ON;
+    }
+    if ((0u != lowBslnRst) && (sns->negScans >= (CAPSENSE_STUCK_NEGATIVE_FACTOR * lowBslnRst)))
+    {
+        capsense_stuck_init(sns);
+        return CAPSENSE_STUCK_NEGATIVE;
+    }
+    return CAPSENSE_STUCK_NONE;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,99 @@
+/*******************************************************************************
+* File Name: capsense_stuck.h
+*
+* Description:
+*   Stuck-sensor supervisor: finds single sensors whose baseline is latched
+*   wrong, touched for much longer than a finger would be or held below the
+*   baseline, so that only their baseline is reset instead of restarting
+*   CapSense. Used by main.cpp with the capsense-stuck-reset application
+*   option. Kept free of Mbed OS and the CapSense middleware so that host
+*   tools can use it as well.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_STUCK_H
+#define CAPSENSE_STUCK_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Results of capsense_stuck_update() */
+#define CAPSENSE_STUCK_NONE                     (0u)
+#define CAPSENSE_STUCK_ON                       (1u)    /* Above the finger threshold for too long */
+#define CAPSENSE_STUCK_NEGATIVE                 (2u)    /* Below the baseline for too long */
+
+/* The middleware resets a low baseline after lowBslnRst scans; a sensor
+ * that stays low this many times longer is stuck.
+ */
+#define CAPSENSE_STUCK_NEGATIVE_FACTOR          (2u)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+/* State of one sensor. A zero-initialized state equals the one after
+ * capsense_stuck_init().
+ */
+typedef struct
+{
+    bool on;                    /* Above the finger threshold at the last scan */
+    uint16_t negScans;          /* Scans below the baseline since it was last left */
+    uint16_t clearScans;        /* Consecutive scans at the baseline since the last negative one */
+    uint32_t onSinceMs;         /* First scan of the current touch */
+} capsense_stuck_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void capsense_stuck_init(capsense_stuck_t *sns);
+uint32_t capsense_stuck_update(capsense_stuck_t *sns, uint32_t maxOnMs, uint32_t timeMs, bool on, bool negative,
+                               uint32_t lowBslnRst);
+
+#endif /* CAPSENSE_STUCK_H */
+
+
+/* [] END OF FILE */
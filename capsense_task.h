@@ -0,0 +1,213 @@
+/*******************************************************************************
+* File Name: capsense_task.h
+*
+* Description:
+*   Stackless tasks for the scan loop. A task is a function that returns to
+*   the dispatcher at every await and is resumed at the next line when an
+*   awaited event is posted, so a loop that waits for interrupts reads as
+*   straight-line code without a thread stack of its own. Several tasks share
+*   one dispatching thread. C++14 has no coroutines, so the resume point is
+*   kept in the task with a switch on __LINE__. Kept free of Mbed OS so that
+*   host tools can use it as well.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_TASK_H
+#define CAPSENSE_TASK_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Resume point of a task that has run to CAPSENSE_TASK_END() */
+#define CAPSENSE_TASK_FINISHED                  (UINT32_MAX)
+
+/* Start of the body of a task function */
+#define CAPSENSE_TASK_BEGIN(task)               switch ((task)->line) { case 0u:
+
+/* Returns to the dispatcher until one of the events is posted, and resumes
+ * on the next line. Use at most one await per source line. Locals of the
+ * task function are lost across the await; keep state that must survive it
+ * in static or global variables.
+ */
+#define CAPSENSE_TASK_AWAIT(task, events)                               \
+    do                                                                  \
+    {                                                                   \
+        (task)->waiting = (events);                                     \
+        (task)->line = (uint32_t)__LINE__;                              \
+        return;                                                         \
+        case __LINE__:;                                                 \
+    } while (0)
+
+/* End of the body of a task function. The task is never resumed again. */
+#define CAPSENSE_TASK_END(task)                                         \
+    }                                                                   \
+    (task)->line = CAPSENSE_TASK_FINISHED;                              \
+    (task)->waiting = 0u
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct capsense_task capsense_task_t;
+
+/* Body of a task, written between CAPSENSE_TASK_BEGIN() and
+ * CAPSENSE_TASK_END()
+ */
+typedef void (*capsense_task_fn_t)(capsense_task_t *task);
+
+struct capsense_task
+{
+    capsense_task_fn_t run;
+    uint32_t line;          /* Resume point, 0 before the first run */
+    uint32_t waiting;       /* Events awaited, 0 while ready to run */
+    capsense_task_t *next;
+};
+
+/* Tasks that share one dispatching thread */
+typedef struct
+{
+    std::atomic<uint32_t> pending;  /* Events posted since the last dispatch */
+    capsense_task_t *tasks;
+} capsense_task_sched_t;
+
+
+/*******************************************************************************
+* Function Name: capsense_task_init
+********************************************************************************
+* Summary:
+*   Starts an empty dispatcher.
+*
+*******************************************************************************/
+static inline void capsense_task_init(capsense_task_sched_t *sched)
+{
+    sched->pending.store(0u, std::memory_order_relaxed);
+    sched->tasks = NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_task_add
+********************************************************************************
+* Summary:
+*   Adds a task. It runs up to its first await on the next dispatch. Tasks
+*   are added before the first event is posted.
+*
+* Parameters:
+*  sched: dispatcher.
+*  task: task state, owned by the caller for the life of the dispatcher.
+*  run: body of the task.
+*
+*******************************************************************************/
+static inline void capsense_task_add(capsense_task_sched_t *sched, capsense_task_t *task, capsense_task_fn_t run)
+{
+    task->run = run;
+    task->line = 0u;
+    task->waiting = 0u;
+    task->next = sched->tasks;
+    sched->tasks = task;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_task_post
+********************************************************************************
+* Summary:
+*   Posts events. Safe to call from interrupt context.
+*
+* Return:
+*  true if nothing was pending before: the caller schedules one
+*  capsense_task_dispatch() on the dispatching thread. Events posted while
+*  a dispatch is already scheduled are picked up by it.
+*
+*******************************************************************************/
+static inline bool capsense_task_post(capsense_task_sched_t *sched, uint32_t events)
+{
+    return 0u == sched->pending.fetch_or(events, std::memory_order_release);
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_task_clear
+********************************************************************************
+* Summary:
+*   Drops pending events that nobody waited for.
+*
+*******************************************************************************/
+static inline void capsense_task_clear(capsense_task_sched_t *sched, uint32_t events)
+{
+    (void)sched->pending.fetch_and(~events, std::memory_order_relaxed);
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_task_dispatch
+********************************************************************************
+* Summary:
+*   Takes the pending events and resumes every task that is ready or awaits
+*   one of them. Events that no task awaits are dropped; an event posted
+*   while a task runs stays pending for the next dispatch.
+*
+*******************************************************************************/
+static inline void capsense_task_dispatch(capsense_task_sched_t *sched)
+{
+    const uint32_t events = sched->pending.exchange(0u, std::memory_order_acquire);
+
+    for (capsense_task_t *task = sched->tasks; NULL != task; task = task->next)
+    {
+        if ((CAPSENSE_TASK_FINISHED != task->line) &&
+            ((0u == task->waiting) || (0u != (task->waiting & events))))
+        {
+            task->waiting = 0u;
+            task->run(task);
+        }
+    }
+}
+
+#endif /* CAPSENSE_TASK_H */
+
+
+/* [] END OF FILE */
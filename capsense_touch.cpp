@@ -0,0 +1,263 @@
+/*******************************************************************************
+* File Name: capsense_touch.cpp
+*
+* Description:
+*   Touch reporting of the demo, see capsense_touch.h.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "capsense_touch.h"
+#include "capsense_centroid.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Number of touches on the slider. The CM0+ image is built without the
+ * application options and keeps the single touch of the middleware.
+ */
+#ifdef MBED_CONF_APP_CAPSENSE_SLIDER_TOUCHES
+#define CAPSENSE_TOUCH_SLIDER_TOUCHES           (MBED_CONF_APP_CAPSENSE_SLIDER_TOUCHES)
+#else
+#define CAPSENSE_TOUCH_SLIDER_TOUCHES           (1u)
+#endif
+
+static_assert((CAPSENSE_TOUCH_SLIDER_TOUCHES >= 1u) && (CAPSENSE_TOUCH_SLIDER_TOUCHES <= CAPSENSE_CENTROID_MAX_TOUCHES),
+              "capsense-slider-touches must be 1 or 2");
+
+/* Most segments of a slider in the two-finger mode */
+#define CAPSENSE_TOUCH_MAX_SEGMENTS             (16u)
+
+
+/*******************************************************************************
+* Function Name: capsense_touch_init
+********************************************************************************
+* Summary:
+*   Starts with all buttons released and all slider positions at 0.
+*
+*******************************************************************************/
+void capsense_touch_init(capsense_touch_t *touch)
+{
+    for (uint32_t wdgtId = 0u; wdgtId < CAPSENSE_LAYOUT_WIDGET_COUNT; wdgtId++)
+    {
+        touch->last[wdgtId] = 0u;
+        touch->lastSecond[wdgtId] = CAPSENSE_TOUCH_NO_POSITION;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_touch_slider
+********************************************************************************
+* Summary:
+*   Finds one or two fingers on an active slider with
+*   capsense_centroid_linear() on the difference counts of its segments, in
+*   place of the single centroid of the middleware. The lower position goes
+*   to value and the higher one to second.
+*
+* Parameters:
+*  context: CapSense context.
+*  wdgtId: slider widget.
+*  state: receives the status of the slider.
+*
+* Return:
+*  false with capsense-slider-touches 1, if the slider is not active, or if
+*  no segment peaks above the finger threshold; the single centroid of the
+*  middleware applies then.
+*
+*******************************************************************************/
+static bool capsense_touch_slider(const cy_stc_capsense_context_t *context, uint32_t wdgtId,
+                                  capsense_touch_state_t *state)
+{
+    const cy_stc_capsense_widget_config_t *wdgt = &context->ptrWdConfig[wdgtId];
+    uint16_t diff[CAPSENSE_TOUCH_MAX_SEGMENTS];
+    uint16_t positions[CAPSENSE_CENTROID_MAX_TOUCHES];
+
+    if ((CAPSENSE_TOUCH_SLIDER_TOUCHES < 2u) || (0u == Cy_CapSense_IsWidgetActive(wdgtId, context)) ||
+        (wdgt->numSns < 2u) || (wdgt->numSns > CAPSENSE_TOUCH_MAX_SEGMENTS))
+    {
+        return false;
+    }
+
+    for (uint32_t i = 0u; i < wdgt->numSns; i++)
+    {
+        diff[i] = wdgt->ptrSnsContext[i].diff;
+    }
+
+    uint32_t count = capsense_centroid_linear(diff, wdgt->numSns, wdgt->ptrWdContext->fingerTh,
+                                              wdgt->xResolution, CAPSENSE_TOUCH_SLIDER_TOUCHES, positions);
+    if (0u == count)
+    {
+        return false;
+    }
+
+    state->value[wdgtId] = positions[0u];
+    state->touched |= 1uL << wdgtId;
+    if (count > 1u)
+    {
+        state->second[wdgtId] = positions[1u];
+        state->twoTouch |= 1uL << wdgtId;
+    }
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_touch_snapshot
+********************************************************************************
+* Summary:
+*   Takes the status of every widget after Cy_CapSense_ProcessAllWidgets().
+*   A slider counts as touched only with one finger on it, or with one or
+*   two if capsense-slider-touches is 2.
+*
+* Parameters:
+*  context: CapSense context.
+*  timeMs: time of the scan.
+*  state: receives the status.
+*
+*******************************************************************************/
+void capsense_touch_snapshot(const cy_stc_capsense_context_t *context, uint32_t timeMs,
+                             capsense_touch_state_t *state)
+{
+    state->timeMs = timeMs;
+    state->touched = 0u;
+    state->twoTouch = 0u;
+    for (uint32_t wdgtId = 0u; wdgtId < CAPSENSE_LAYOUT_WIDGET_COUNT; wdgtId++)
+    {
+        state->value[wdgtId] = 0u;
+        state->second[wdgtId] = 0u;
+        if (CAPSENSE_LAYOUT_BUTTON == CAPSENSE_LAYOUT_WIDGETS[wdgtId].type)
+        {
+            uint32_t status = Cy_CapSense_IsWidgetActive(wdgtId, context);
+
+            state->value[wdgtId] = (uint16_t)status;
+            state->touched |= (0u != status) ? (1uL << wdgtId) : 0u;
+        }
+        else if (!capsense_touch_slider(context, wdgtId, state))
+        {
+            cy_stc_capsense_touch_t *sldrTouch = Cy_CapSense_GetTouchInfo(wdgtId, context);
+
+            if (sldrTouch->numPosition == 1u)
+            {
+                state->value[wdgtId] = sldrTouch->ptrPosition->x;
+                state->touched |= 1uL << wdgtId;
+            }
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_touch_diff
+********************************************************************************
+* Summary:
+*   Compares a status from capsense_touch_snapshot() with the last reported
+*   one. A button reports every change of its status; a slider reports a new
+*   position while it is touched, and nothing when it is released. A second
+*   finger that comes, moves or goes is a new position as well.
+*
+* Parameters:
+*  touch: last reported state, updated.
+*  state: status of the widgets.
+*  events: receives the changes in widget order.
+*  anyTouch: set to true if any widget is touched.
+*
+* Return:
+*  Number of events.
+*
+*******************************************************************************/
+uint32_t capsense_touch_diff(capsense_touch_t *touch, const capsense_touch_state_t *state,
+                             capsense_touch_event_t events[CAPSENSE_LAYOUT_WIDGET_COUNT], bool *anyTouch)
+{
+    uint32_t buttonIndex = 0u;
+    uint32_t sliderIndex = 0u;
+    uint32_t count = 0u;
+
+    for (uint32_t wdgtId = 0u; wdgtId < CAPSENSE_LAYOUT_WIDGET_COUNT; wdgtId++)
+    {
+        const bool button = (CAPSENSE_LAYOUT_BUTTON == CAPSENSE_LAYOUT_WIDGETS[wdgtId].type);
+        const uint32_t value = state->value[wdgtId];
+        const uint32_t second = (0u != (state->twoTouch & (1uL << wdgtId))) ?
+                                state->second[wdgtId] : CAPSENSE_TOUCH_NO_POSITION;
+
+        if ((button || (0u != (state->touched & (1uL << wdgtId)))) &&
+            ((value != touch->last[wdgtId]) || (second != touch->lastSecond[wdgtId])))
+        {
+            events[count++] = { wdgtId, button ? buttonIndex : sliderIndex, value };
+            touch->last[wdgtId] = value;
+            touch->lastSecond[wdgtId] = second;
+        }
+        buttonIndex += button ? 1u : 0u;
+        sliderIndex += button ? 0u : 1u;
+    }
+    *anyTouch = (0u != state->touched);
+    return count;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_touch_update
+********************************************************************************
+* Summary:
+*   capsense_touch_snapshot() and capsense_touch_diff() in one step, for a
+*   caller that reports on the scan thread.
+*
+* Parameters:
+*  touch: last reported state, updated.
+*  context: CapSense context.
+*  events: receives the changes in widget order.
+*  anyTouch: set to true if any widget is touched.
+*
+* Return:
+*  Number of events.
+*
+*******************************************************************************/
+uint32_t capsense_touch_update(capsense_touch_t *touch, const cy_stc_capsense_context_t *context,
+                               capsense_touch_event_t events[CAPSENSE_LAYOUT_WIDGET_COUNT], bool *anyTouch)
+{
+    capsense_touch_state_t state;
+
+    capsense_touch_snapshot(context, 0u, &state);
+    return capsense_touch_diff(touch, &state, events, anyTouch);
+}
+
+
+/* [] END OF FILE */
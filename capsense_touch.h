@@ -0,0 +1,116 @@
+/*******************************************************************************
+* File Name: capsense_touch.h
+*
+* Description:
+*   Touch reporting of the demo: finds the button status changes and slider
+*   positions after every processed scan. Shared by the scan loop in main.cpp
+*   and the golden-trace replay in capsense_replay.cpp, so that the replay
+*   checks the same decisions.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CAPSENSE_TOUCH_H
+#define CAPSENSE_TOUCH_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stdbool.h>
+#include "cycfg_capsense.h"
+#include "capsense_layout.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Slider position of a finger that is not there */
+#define CAPSENSE_TOUCH_NO_POSITION              (0xFFFFFFFFu)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+/* Change of a widget: new button status, or new slider position */
+typedef struct
+{
+    uint32_t wdgtId;
+    uint32_t index;         /* Button or slider number within its kind */
+    uint32_t value;
+} capsense_touch_event_t;
+
+typedef struct
+{
+    /* Last reported button status or slider position, indexed by widget ID */
+    uint32_t last[CAPSENSE_LAYOUT_WIDGET_COUNT];
+
+    /* Last reported position of a second finger, or CAPSENSE_TOUCH_NO_POSITION */
+    uint32_t lastSecond[CAPSENSE_LAYOUT_WIDGET_COUNT];
+} capsense_touch_t;
+
+/* Status of every widget after one scan, small enough to hand to another
+ * thread by value.
+ */
+typedef struct
+{
+    uint32_t timeMs;
+    uint32_t touched;       /* Bit per widget ID: button active, or slider touched */
+    uint32_t twoTouch;      /* Bit per widget ID: second finger on the slider */
+    uint16_t value[CAPSENSE_LAYOUT_WIDGET_COUNT];   /* Button status or slider position */
+    uint16_t second[CAPSENSE_LAYOUT_WIDGET_COUNT];  /* Position of the second finger, above value */
+} capsense_touch_state_t;
+
+static_assert(CAPSENSE_LAYOUT_WIDGET_COUNT <= 32u, "capsense_touch_state_t has a touched bit per widget");
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void capsense_touch_init(capsense_touch_t *touch);
+void capsense_touch_snapshot(const cy_stc_capsense_context_t *context, uint32_t timeMs,
+                             capsense_touch_state_t *state);
+uint32_t capsense_touch_diff(capsense_touch_t *touch, const capsense_touch_state_t *state,
+                             capsense_touch_event_t events[CAPSENSE_LAYOUT_WIDGET_COUNT], bool *anyTouch);
+uint32_t capsense_touch_update(capsense_touch_t *touch, const cy_stc_capsense_context_t *context,
+                               capsense_touch_event_t events[CAPSENSE_LAYOUT_WIDGET_COUNT], bool *anyTouch);
+
+#endif /* CAPSENSE_TOUCH_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,123 @@
+/*******************************************************************************
+* File Name: capsense_tuner_map.cpp
+*
+* Description:
+*   Compile-time validation of the CapSense Tuner register map. Every register
+*   listed in the generated capsense_tuner_regs.h is checked with offsetof and
+*   sizeof against cy_stc_capsense_tuner_t, and the buffer indices written by
+*   hand in cy_capsense_widgetConfig[] are checked against capsense_layout.h.
+*   Run tools/tuner_map.py to regenerate capsense_tuner_regs.h after changing
+*   design.cycapsense.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stddef.h>
+#include "cycfg_capsense.h"
+#include "capsense_layout.h"
+#include "capsense_tuner_regs.h"
+
+
+/* The synthetic configurations of tools/capsense_gen.py have a different
+ * widget set and no Tuner register map.
+ */
+#if !MBED_CONF_APP_CAPSENSE_BENCHMARK
+
+/*******************************************************************************
+* Tuner register map
+*******************************************************************************/
+/* Every register the Tuner reads or writes over EZI2C must stay at the offset
+ * and size published in cycfg_capsense.h. Inserting fields ahead of them in
+ * cy_stc_capsense_tuner_t fails here; regions appended after the last
+ * register do not move any offset and are allowed.
+ */
+#define CAPSENSE_TUNER_CHECK_REG(reg, member)                                           \
+    static_assert(offsetof(cy_stc_capsense_tuner_t, member) == CY_CAPSENSE_##reg##_OFFSET, \
+                  "Tuner register " #reg " moved");                                     \
+    static_assert(sizeof(cy_capsense_tuner.member) == CY_CAPSENSE_##reg##_SIZE,         \
+                  "Tuner register " #reg " changed size");
+
+CAPSENSE_TUNER_REGS(CAPSENSE_TUNER_CHECK_REG)
+
+static_assert(CAPSENSE_TUNER_REGS_END <= sizeof(cy_stc_capsense_tuner_t),
+              "Tuner register map extends past cy_stc_capsense_tuner_t");
+
+/* initialize_capsense_tuner() exposes the whole structure with 16-bit
+ * EZI2C sub-addresses.
+ */
+static_assert(sizeof(cy_stc_capsense_tuner_t) <= 0x10000u,
+              "cy_stc_capsense_tuner_t exceeds the EZI2C sub-address range");
+
+
+/*******************************************************************************
+* Widget buffers
+*******************************************************************************/
+/* Indices written by hand in cy_capsense_widgetConfig[] must match the
+ * positions derived from capsense_layout.h, and stay inside their buffers.
+ */
+#define CAPSENSE_TUNER_CHECK_WIDGET(wdgtId, snsContext, eltdConfig, debounce, noiseEnvelope)               \
+    static_assert((snsContext) == capsense_layout_first_sensor(wdgtId),                                  \
+                  "Sensor context index of widget " #wdgtId " differs from capsense_layout.h");          \
+    static_assert((eltdConfig) == capsense_layout_first_electrode(CAPSENSE_LAYOUT_ACTIVE, (wdgtId)),       \
+                  "Electrode index of widget " #wdgtId " differs from capsense_layout.h");               \
+    static_assert((debounce) == capsense_layout_first_debounce(wdgtId),                                  \
+                  "cy_capsense_debounce[] index of widget " #wdgtId " differs from capsense_layout.h");  \
+    static_assert(((debounce) + capsense_layout_widget_debounce(wdgtId)) <= CAPSENSE_TUNER_REGS_DEBOUNCE_SIZE, \
+                  "cy_capsense_debounce[] index of widget " #wdgtId " is out of bounds");                \
+    static_assert((CAPSENSE_LAYOUT_CSD != capsense_layout_widget_sense(CAPSENSE_LAYOUT_ACTIVE, (wdgtId))) ||  \
+                  ((noiseEnvelope) == capsense_layout_first_noise_envelope(CAPSENSE_LAYOUT_ACTIVE, (wdgtId))), \
+                  "cy_capsense_noiseEnvelope[] index of widget " #wdgtId " differs from capsense_layout.h"); \
+    static_assert(((noiseEnvelope) == CAPSENSE_TUNER_REGS_NO_INDEX) ||                                   \
+                  (((noiseEnvelope) + CAPSENSE_LAYOUT_WIDGETS[(wdgtId)].numSns) <= CAPSENSE_TUNER_REGS_NOISE_ENVELOPE_SIZE), \
+                  "cy_capsense_noiseEnvelope[] index of widget " #wdgtId " is out of bounds");
+
+CAPSENSE_TUNER_REGS_WIDGETS(CAPSENSE_TUNER_CHECK_WIDGET)
+
+static_assert(CAPSENSE_TUNER_REGS_DEBOUNCE_SIZE == capsense_layout_debounce_size(),
+              "CY_CAPSENSE_DEBOUNCE_SIZE differs from capsense_layout.h");
+static_assert(CAPSENSE_TUNER_REGS_NOISE_ENVELOPE_SIZE == capsense_layout_noise_envelope_size(CAPSENSE_LAYOUT_ACTIVE),
+              "CY_CAPSENSE_NOISE_ENVELOPE_SIZE differs from capsense_layout.h");
+static_assert(CAPSENSE_TUNER_REGS_ELTD_COUNT == capsense_layout_electrode_count(CAPSENSE_LAYOUT_ACTIVE),
+              "CY_CAPSENSE_ELTD_COUNT differs from capsense_layout.h");
+
+#endif /* !MBED_CONF_APP_CAPSENSE_BENCHMARK */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,334 @@
+/*******************************************************************************
+* File Name: capsense_cm0p.cpp
+*
+* Description:
+*   CM0+ image of the dual-core mode (capsense-dual-core option). Owns the CSD
+*   block: scans and processes all widgets and publishes a touch frame per
+*   scan into the region shared with the CM4, see capsense_ipc.h. Mbed OS
+*   builds the CM4 image only; build this file with the PDL, the kit's
+*   GeneratedSource set to the CM0+ core and capsense_touch.cpp, and merge it
+*   in place of the prebuilt CM0P_SLEEP image. See README.md.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include "cy_pdl.h"
+#include "cycfg.h"
+#include "cycfg_capsense.h"
+#include "capsense_touch.h"
+#include "capsense_ipc.h"
+
+
+#if (CY_CAPSENSE_CORE != __CORTEX_M)
+#error "Set the CapSense core to CM0+ in the CapSense Configurator (CY_CAPSENSE_CORE 0u) for this image"
+#endif
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define CAPSENSE_CM0P_SCAN_PERIOD_MS            (20u)
+
+/* The scan period runs on counter 0 of this MCWDT, which keeps counting on
+ * the LFCLK in DeepSleep; free-running counter 2 times the frames. Mbed OS
+ * on the CM4 takes the first MCWDT for its low-power ticker.
+ */
+#define CAPSENSE_CM0P_MCWDT                     (MCWDT_STRUCT1)
+#define CAPSENSE_CM0P_MCWDT_WAIT_US             (93u)   /* Three LFCLK cycles for a counter update */
+
+/* Poll interval while waiting for the CM4 to share the region */
+#define CAPSENSE_CM0P_HANDSHAKE_POLL_MS         (1u)
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void capsense_cm0p_isr(void);
+static void capsense_cm0p_period_isr(void);
+static void capsense_cm0p_end_of_scan(cy_stc_active_scan_sns_t *ptrActiveScan);
+
+
+/*******************************************************************************
+* Interrupt configuration
+*******************************************************************************/
+/* The CM0+ reaches the CSD interrupt through an NVIC multiplexer */
+static const cy_stc_sysint_t capsense_cm0p_isr_cfg =
+{
+    .intrSrc = NvicMux3_IRQn,
+    .cm0pSrc = csd_interrupt_IRQn,
+    .intrPriority = 1u
+};
+
+static const cy_stc_sysint_t capsense_cm0p_period_isr_cfg =
+{
+    .intrSrc = NvicMux2_IRQn,
+    .cm0pSrc = srss_interrupt_mcwdt_1_IRQn,
+    .intrPriority = 2u
+};
+
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static volatile bool capsense_cm0p_done;
+static volatile uint32_t capsense_cm0p_periods;
+
+
+/*******************************************************************************
+* Function Name: capsense_cm0p_isr
+********************************************************************************
+* Summary:
+*   Wrapper function for handling interrupts from CSD block.
+*
+*******************************************************************************/
+static void capsense_cm0p_isr(void)
+{
+    Cy_CapSense_InterruptHandler(CYBSP_CSD_HW, &cy_capsense_context);
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_cm0p_period_isr
+********************************************************************************
+* Summary:
+*   Scan period interrupt of the MCWDT. Wakes the scan loop.
+*
+*******************************************************************************/
+static void capsense_cm0p_period_isr(void)
+{
+    Cy_MCWDT_ClearInterrupt(CAPSENSE_CM0P_MCWDT, CY_MCWDT_CTR0);
+    capsense_cm0p_periods++;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_cm0p_end_of_scan
+********************************************************************************
+* Summary:
+*   End of scan callback. Wakes the scan loop.
+*
+*******************************************************************************/
+static void capsense_cm0p_end_of_scan(cy_stc_active_scan_sns_t *ptrActiveScan)
+{
+    (void)ptrActiveScan;
+    capsense_cm0p_done = true;
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_cm0p_handshake
+********************************************************************************
+* Summary:
+*   Waits until the CM4 has set up the shared region and returns it. The CM4
+*   does so after cybsp_init(), so clocks and pins of the CSD block are set
+*   up as well.
+*
+*******************************************************************************/
+static capsense_ipc_region_t *capsense_cm0p_handshake(void)
+{
+    IPC_STRUCT_Type *channel = Cy_IPC_Drv_GetIpcBaseAddress(CAPSENSE_IPC_CHANNEL);
+
+    while (true)
+    {
+        if (Cy_IPC_Drv_IsLockAcquired(channel))
+        {
+            capsense_ipc_region_t *region = (capsense_ipc_region_t *)(uintptr_t)Cy_IPC_Drv_ReadDataValue(channel);
+
+            if ((NULL != region) && capsense_ipc_valid(region))
+            {
+                return region;
+            }
+        }
+        Cy_SysLib_Delay(CAPSENSE_CM0P_HANDSHAKE_POLL_MS);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_cm0p_lf_hz
+********************************************************************************
+* Summary:
+*   Frequency of the LFCLK, which clocks the MCWDT.
+*
+*******************************************************************************/
+static uint32_t capsense_cm0p_lf_hz(void)
+{
+    switch (Cy_SysClk_ClkLfGetSource())
+    {
+        case CY_SYSCLK_CLKLF_IN_WCO:
+            return CY_SYSCLK_WCO_FREQ;
+        case CY_SYSCLK_CLKLF_IN_PILO:
+            return CY_SYSCLK_PILO_FREQ;
+        default:
+            return CY_SYSCLK_ILO_FREQ;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: capsense_cm0p_timer_init
+********************************************************************************
+* Summary:
+*   Starts the MCWDT: counter 0 interrupts every CAPSENSE_CM0P_SCAN_PERIOD_MS
+*   and counter 2 runs free as the time base of the frames.
+*
+*******************************************************************************/
+static void capsense_cm0p_timer_init(uint32_t lfHz)
+{
+    cy_stc_mcwdt_config_t config =
+    {
+        /* Cleared on match, so the counter runs from 0 to c0Match */
+        .c0Match = (uint16_t)(((lfHz * CAPSENSE_CM0P_SCAN_PERIOD_MS) / 1000u) - 1u),
+        .c1Match = 0u,
+        .c0Mode = CY_MCWDT_MODE_INT,
+        .c1Mode = CY_MCWDT_MODE_NONE,
+        .c2ToggleBit = 31u,
+        .c2Mode = CY_MCWDT_MODE_NONE,
+        .c0ClearOnMatch = true,
+        .c1ClearOnMatch = false,
+        .c0c1Cascade = false,
+        .c1c2Cascade = false
+    };
+
+    if (CY_MCWDT_SUCCESS != Cy_MCWDT_Init(CAPSENSE_CM0P_MCWDT, &config))
+    {
+        CY_ASSERT(0);
+    }
+    Cy_SysInt_Init(&capsense_cm0p_period_isr_cfg, capsense_cm0p_period_isr);
+    NVIC_ClearPendingIRQ(capsense_cm0p_period_isr_cfg.intrSrc);
+    NVIC_EnableIRQ(capsense_cm0p_period_isr_cfg.intrSrc);
+    Cy_MCWDT_SetInterruptMask(CAPSENSE_CM0P_MCWDT, CY_MCWDT_CTR0);
+    Cy_MCWDT_Enable(CAPSENSE_CM0P_MCWDT, CY_MCWDT_CTR0 | CY_MCWDT_CTR2, CAPSENSE_CM0P_MCWDT_WAIT_US);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   Starts the CM4 application, then scans and processes all widgets every
+*   CAPSENSE_CM0P_SCAN_PERIOD_MS and publishes a touch frame per scan. The
+*   CM0+ sleeps while the CSD block scans and enters DeepSleep until the
+*   next period, so the system reaches DeepSleep whenever the CM4 does too.
+*   Frames are stamped with the MCWDT time of their scan.
+*
+*******************************************************************************/
+int main(void)
+{
+    capsense_touch_state_t state;
+    capsense_ipc_frame_t frame;
+    uint32_t seq = 0u;
+    uint32_t periods = 0u;
+    uint64_t ticks = 0u;
+
+    __enable_irq();
+    Cy_SysEnableCM4(CY_CORTEX_M4_APPL_ADDR);
+
+    capsense_ipc_region_t *region = capsense_cm0p_handshake();
+    IPC_STRUCT_Type *channel = Cy_IPC_Drv_GetIpcBaseAddress(CAPSENSE_IPC_CHANNEL);
+
+    if (CY_RET_SUCCESS != Cy_CapSense_Init(&cy_capsense_context))
+    {
+        CY_ASSERT(0);
+    }
+    Cy_SysInt_Init(&capsense_cm0p_isr_cfg, capsense_cm0p_isr);
+    NVIC_ClearPendingIRQ(capsense_cm0p_isr_cfg.intrSrc);
+    NVIC_EnableIRQ(capsense_cm0p_isr_cfg.intrSrc);
+    Cy_CapSense_Enable(&cy_capsense_context);
+    Cy_CapSense_RegisterCallback(CY_CAPSENSE_END_OF_SCAN_E, capsense_cm0p_end_of_scan, &cy_capsense_context);
+
+    const uint32_t lfHz = capsense_cm0p_lf_hz();
+    capsense_cm0p_timer_init(lfHz);
+    uint32_t lastCount = Cy_MCWDT_GetCount(CAPSENSE_CM0P_MCWDT, CY_MCWDT_COUNTER2);
+
+    while (true)
+    {
+        /* Counter 2 wraps after 2^32 LFCLK cycles; the 64-bit sum does not */
+        const uint32_t count = Cy_MCWDT_GetCount(CAPSENSE_CM0P_MCWDT, CY_MCWDT_COUNTER2);
+        ticks += (uint32_t)(count - lastCount);
+        lastCount = count;
+
+        capsense_cm0p_done = false;
+        Cy_CapSense_ScanAllWidgets(&cy_capsense_context);
+
+        /* WFI returns on a pending interrupt even while they are masked, so
+         * the end of scan cannot slip in between the check and the sleep.
+         */
+        __disable_irq();
+        while (!capsense_cm0p_done)
+        {
+            __WFI();
+            __enable_irq();
+            __disable_irq();
+        }
+        __enable_irq();
+
+        Cy_CapSense_ProcessAllWidgets(&cy_capsense_context);
+        capsense_touch_snapshot(&cy_capsense_context, (uint32_t)((ticks * 1000u) / lfHz), &state);
+
+        frame.seq = seq++;
+        frame.timeMs = state.timeMs;
+        frame.touched = state.touched;
+        for (uint32_t wdgtId = 0u; wdgtId < CAPSENSE_LAYOUT_WIDGET_COUNT; wdgtId++)
+        {
+            frame.value[wdgtId] = state.value[wdgtId];
+        }
+        if (capsense_ipc_publish(region, &frame))
+        {
+            Cy_IPC_Drv_AcquireNotify(channel, 1uL << CAPSENSE_IPC_INTR);
+        }
+
+        /* A scan that ran past the period finds it elapsed and starts the
+         * next one at once, without catching up on the missed ones.
+         */
+        __disable_irq();
+        while (periods == capsense_cm0p_periods)
+        {
+            (void)Cy_SysPm_CpuEnterDeepSleep(CY_SYSPM_WAIT_FOR_INTERRUPT);
+            __enable_irq();
+            __disable_irq();
+        }
+        periods = capsense_cm0p_periods;
+        __enable_irq();
+    }
+}
+
+
+/* [] END OF FILE */
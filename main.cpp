@@ -17,6 +17,10 @@
 *   EventQueue: The dispatcher of the EventQueue is run inside a thread to
 *               periodically scan the sensors. 
 *
+*   With the capsense-scan-thread option, a dedicated osPriorityRealtime
+*   thread replaces both: the low-power timeout and the end of scan callback
+*   wake it directly with thread flags.
+*
 * Related Document: README.md
 *
 *
@@ -62,35 +66,135 @@
 #include "cycfg.h"
 #include "cybsp.h"
 #include "cyhal.h"
+#include "capsense_layout.h"
+#include "capsense_bench.h"
+#include "capsense_power.h"
+#include "capsense_sleep.h"
+#include "capsense_sched.h"
+#include "capsense_calib.h"
+#include "capsense_boot.h"
+#include "capsense_logger.h"
+#include "capsense_touch.h"
+#include "capsense_report.h"
+#include "capsense_event.h"
+#include "capsense_remote.h"
+#include "capsense_replay.h"
+#include "capsense_cycles.h"
+#include "capsense_latency.h"
+#include "capsense_task.h"
+#include "capsense_ballistic.h"
+#include "capsense_stuck.h"
+#include "capsense_autotune.h"
 
 
 /*******************************************************************************
 * Global constants
 *******************************************************************************/
-/* Number of touches on the slider */
-#define SLIDER_NUM_TOUCH                        (1u)
 #define LED_OFF                                 (1u)
 #define LED_ON                                  (0u)
 
+/* The LED follows touches before anything is printed */
+#define TOUCH_LED_PRIORITY                      (200u)
+#define TOUCH_PRINT_PRIORITY                    (100u)
+
+/* Range of the value driven by the slider with capsense-slider-ballistic */
+#define SLIDER_VALUE_MAX                        (65535u)
+
 /* Defines periodicity of the CapSense scan and touch processing in
  * milliseconds.
  */
 #define CAPSENSE_SCAN_PERIOD_MS                 (20ms)
+#define CAPSENSE_SCAN_PERIOD_US                 ((uint32_t)std::chrono::microseconds(CAPSENSE_SCAN_PERIOD_MS).count())
 #define EZI2C_INTERRUPT_PRIORITY                (3u) /* EZI2C interrupt priority must be
                                                       * higher than CapSense interrupt */
                                                     
 /* Enable tuner functionality */
 #define TUNER_ENABLE                            (1u)
 
+/* Widget whose first sensor hosts the ganged wake-on-touch sensor. It must be
+ * a CSD widget; the electrodes of every other widget, CSD or CSX, are
+ * connected to it. The ganged sensor has its own IDAC and sense clock
+ * settings, see CalibrateGangedSensor().
+ */
+#define CAPSENSE_WOT_WDGT_ID                    (CY_CAPSENSE_LINEARSLIDER0_WDGT_ID)
+
+/* Raw count target of the ganged sensor calibration, in percent of the
+ * maximum raw count, as for the IDAC autocalibration of the widgets.
+ */
+#define CAPSENSE_WOT_CALIBRATION_PCT            (85u)
+
+/* Largest modulator IDAC code and sense clock divider of the CSD block */
+#define CAPSENSE_WOT_IDAC_MAX                   (127u)
+#define CAPSENSE_WOT_SNS_CLK_MAX                (4095u)
+
+/* Baseline filter coefficient of the ganged sensor, 1/16 per scan */
+#define CAPSENSE_WOT_BASELINE_SHIFT             (4u)
+
+/* The benchmark runs its scans from main() and waits on capsense_sem. */
+#define SCAN_THREAD_ENABLED                     (MBED_CONF_APP_CAPSENSE_SCAN_THREAD && \
+                                                 !MBED_CONF_APP_CAPSENSE_BENCHMARK)
+
+/* The scan thread takes precedence over the scan task. */
+#define SCAN_TASK_ENABLED                       (MBED_CONF_APP_CAPSENSE_SCAN_TASK && !SCAN_THREAD_ENABLED && \
+                                                 !MBED_CONF_APP_CAPSENSE_BENCHMARK)
+
+/* Thread flags of the dedicated scan thread, and events of the scan task */
+#define SCAN_FLAG_START                         (0x1u)
+#define SCAN_FLAG_DONE                          (0x2u)
+
 
 /***************************************
 * Function Prototypes
 **************************************/
 void RunCapSenseScan(void);
+static bool UseGangedScan(void);
+static void ProcessCapSenseScan(void);
 static void initialize_capsense_tuner(void);
-void ProcessTouchStatus(void);
+void ProcessTouchStatus(uint32_t timeMs);
+static void SubscribeTouchEvents(void);
+static void PrintTouchEvent(const capsense_event_t *event, void *arg);
+static void UpdateTouchLed(const capsense_event_t *event, void *arg);
+#if MBED_CONF_APP_CAPSENSE_GESTURES
+static void ShowGesture(const capsense_event_t *event, void *arg);
+#endif
+#if MBED_CONF_APP_CAPSENSE_SLIDER_BALLISTIC
+static void UpdateSliderValue(const capsense_event_t *event, void *arg);
+#endif
+#if MBED_CONF_APP_CAPSENSE_STUCK_RESET
+static void SuperviseSensors(uint32_t timeMs);
+#endif
+#if MBED_CONF_APP_CAPSENSE_THRESHOLD_AUTOTUNE
+static void TuneThresholds(void);
+#endif
 void CapSense_InterruptHandler(void);
 void CapSenseEndOfScanCallback(cy_stc_active_scan_sns_t * ptrActiveScan);
+static void UpdateTunerSleepLock(void);
+static uint32_t ScanTimerNow(void *arg);
+static void ScanTimerStart(void *arg, uint32_t delayUs);
+static void ScanTimerExpired(void);
+static uint32_t ScanPeriodUs(void);
+static bool IsTunerConnected(void);
+static void WaitScanDone(void);
+#if SCAN_THREAD_ENABLED
+static void ScanThreadRun(void);
+#endif
+#if SCAN_TASK_ENABLED
+static void ScanTaskRun(capsense_task_t *task);
+static void PostScanEvent(uint32_t events);
+#endif
+#if MBED_CONF_APP_CAPSENSE_SCAN_LATENCY_REPORT
+static void ReportScanLatency(void);
+#endif
+#if MBED_CONF_APP_CAPSENSE_WAKE_ON_TOUCH
+static void CalibrateGangedSensor(void);
+static uint16_t CalibrateGangedIdac(void);
+static uint16_t ScanGangedBlocking(void);
+static uint16_t ScanGangedSensor(void);
+static void ScanGangedStart(void);
+static uint16_t ScanGangedFinish(void);
+static void ConnectGangedPins(bool connect);
+static void ClearScanDone(void);
+#endif
 
 
 /*******************************************************************************
@@ -109,10 +213,20 @@ const cy_stc_sysint_t CapSense_ISR_cfg =
 DigitalOut ledStatus(CYBSP_USER_LED);
 Semaphore capsense_sem;
 EventQueue queue;
+#if SCAN_THREAD_ENABLED
+/* Scans run on this thread instead of the event queue dispatcher, so they
+ * preempt every other application thread.
+ */
+Thread scanThread(osPriorityRealtime, MBED_CONF_APP_CAPSENSE_SCAN_THREAD_STACK, NULL, "CapSense Scan Thread");
+#endif
+#if SCAN_TASK_ENABLED
+/* The scan loop as a stackless task on the event queue thread, resumed by
+ * SCAN_FLAG_START and SCAN_FLAG_DONE, see capsense_task.h.
+ */
+capsense_task_sched_t scanTasks;
+capsense_task_t scanTask;
+#endif
 cy_stc_scb_ezi2c_context_t EZI2C_context;
-uint32_t prevBtn0Status = 0u; 
-uint32_t prevBtn1Status = 0u;
-uint32_t prevSliderPos = 0u;
 
 /* SysPm callback params */
 cy_stc_syspm_callback_params_t callbackParams = 
@@ -131,6 +245,58 @@ cy_stc_syspm_callback_t capsenseDeepSleepCb =
     NULL
 };
 
+#if MBED_CONF_APP_CAPSENSE_WAKE_ON_TOUCH
+/* Scan loop power mode, see capsense_power.h */
+capsense_power_t powerMode;
+
+const capsense_power_config_t powerConfig =
+{
+    .activePeriodMs = (uint32_t)CAPSENSE_SCAN_PERIOD_MS.count(),
+    .wotPeriodMs    = MBED_CONF_APP_CAPSENSE_WOT_PERIOD_MS,
+    .timeoutMs      = MBED_CONF_APP_CAPSENSE_WOT_TIMEOUT_MS,
+    .threshold      = MBED_CONF_APP_CAPSENSE_WOT_THRESHOLD,
+    .baselineShift  = CAPSENSE_WOT_BASELINE_SHIFT
+};
+
+/* Settings of the ganged sensor. Its capacitance is several times that of
+ * the host sensor, so CalibrateGangedSensor() finds them once at boot.
+ */
+uint16_t gangedSnsClk;
+uint8_t gangedIdacMod;
+
+/* Raw count of the host sensor, kept across a ganged scan */
+uint16_t gangedHostRaw;
+#endif
+
+/* Scan deadlines run on the low-power timer, so the device sleeps in deep
+ * sleep between scans without waking for the RTOS tick.
+ */
+LowPowerTimer scanClock;
+LowPowerTimeout scanTimeout;
+capsense_sched_t scanSched;
+const capsense_sched_timer_t scanTimer = { ScanTimerNow, ScanTimerStart, NULL };
+
+#if TUNER_ENABLE
+/* Deep sleep lock held while the Tuner is connected, see capsense_sleep.h */
+capsense_sleep_t tunerSleep;
+#endif
+
+#if MBED_CONF_APP_CAPSENSE_THRESHOLD_AUTOTUNE
+/* SmartSense of the generated configuration, taken before the calibration
+ * cache can switch the context to its copy with SmartSense disabled.
+ */
+bool smartSenseEn;
+#endif
+
+#if MBED_CONF_APP_CAPSENSE_SCAN_LATENCY_REPORT
+/* capsense_cycles_now() in the low-power timeout and end of scan interrupts */
+volatile uint32_t scanWakeStamp;
+volatile uint32_t scanDoneStamp;
+/* From the interrupt to the scan loop, see capsense_latency.h */
+capsense_latency_t wakeLatency;
+capsense_latency_t doneLatency;
+#endif
+
 cy_stc_scb_ezi2c_context_t ezi2c_context;
 cyhal_ezi2c_t sEzI2C;
 cyhal_ezi2c_slave_cfg_t sEzI2C_sub_cfg;
@@ -169,15 +335,33 @@ void handle_error(void)
 *******************************************************************************/
 int main(void)
 {
+    capsense_boot_start();
     cybsp_init();
+    capsense_boot_mark(CAPSENSE_BOOT_CYBSP_INIT);
+
+    #if MBED_CONF_APP_CAPSENSE_DUAL_CORE
+    /* The CM0+ image of cm0p/ owns the CSD block and publishes a touch frame
+     * per scan; this core only reports them. The Tuner is not available.
+     */
+    SubscribeTouchEvents();
+    capsense_report_start(capsense_event_dispatch);
+    capsense_remote_start();
+    printf("Application has started. Touch any CapSense button or slider.\r\n");
+    while (true) {
+        ThisThread::sleep_for(1000s);
+    }
+    #endif
     
     #if TUNER_ENABLE
+    /* Deep sleep is locked only while the Tuner is connected. */
     initialize_capsense_tuner();
-    sleep_manager_lock_deep_sleep();
+    capsense_sleep_init(&tunerSleep);
+    capsense_boot_mark(CAPSENSE_BOOT_TUNER_INIT);
     #endif
 
     /* Initialize the CSD HW block to the default state. */
     cy_status status = Cy_CapSense_Init(&cy_capsense_context);
+    capsense_boot_mark(CAPSENSE_BOOT_CAPSENSE_INIT);
 
     if(CY_RET_SUCCESS != status)
     {
@@ -188,23 +372,88 @@ int main(void)
         
     }
     
+    #if MBED_CONF_APP_CAPSENSE_THRESHOLD_AUTOTUNE
+    smartSenseEn = (CY_CAPSENSE_CSD_SS_DIS != cy_capsense_context.ptrCommonConfig->csdAutotuneEn);
+    #endif
+
     /* Initialize CapSense interrupt */
     Cy_SysInt_Init(&CapSense_ISR_cfg, &CapSense_InterruptHandler);
     NVIC_ClearPendingIRQ(CapSense_ISR_cfg.intrSrc);
     NVIC_EnableIRQ(CapSense_ISR_cfg.intrSrc);
 
-    /* Initialize the CapSense firmware modules. */
+    /* Initialize the CapSense firmware modules. With a valid calibration
+     * cache, Cy_CapSense_Enable() skips IDAC autocalibration and SmartSense;
+     * SmartSense threshold tracking is back on after capsense_calib_enabled().
+     */
+    #if MBED_CONF_APP_CAPSENSE_CALIBRATION_CACHE
+    bool calibRestored = capsense_calib_restore(&cy_capsense_context);
+    status = Cy_CapSense_Enable(&cy_capsense_context);
+    if (calibRestored && (CY_RET_SUCCESS != status))
+    {
+        /* Fall back to full calibration. */
+        capsense_calib_discard(&cy_capsense_context);
+        calibRestored = false;
+        status = Cy_CapSense_Enable(&cy_capsense_context);
+    }
+    if (!calibRestored && (CY_RET_SUCCESS == status))
+    {
+        capsense_calib_save(&cy_capsense_context);
+    }
+    capsense_calib_enabled(&cy_capsense_context);
+    #else
     Cy_CapSense_Enable(&cy_capsense_context);
+    #endif
+    #if MBED_CONF_APP_CAPSENSE_WAKE_ON_TOUCH
+    /* Polls the scans, so it runs before the end of scan callback is set. */
+    CalibrateGangedSensor();
+    #endif
+    capsense_boot_mark(CAPSENSE_BOOT_CAPSENSE_ENABLE);
     Cy_SysPm_RegisterCallback(&capsenseDeepSleepCb);
     Cy_CapSense_RegisterCallback(CY_CAPSENSE_END_OF_SCAN_E, 
                                  CapSenseEndOfScanCallback, &cy_capsense_context);
     
+    #if MBED_CONF_APP_CAPSENSE_BENCHMARK
+    /* Measure the cost of the configuration instead of running the demo. */
+    capsense_bench_run(capsense_sem);
+    #elif MBED_CONF_APP_CAPSENSE_REPLAY
+    /* Replay the golden traces of tools/capsense_replay.py instead. */
+    capsense_replay_run();
+    #else
+    #if MBED_CONF_APP_CAPSENSE_SCAN_LATENCY_REPORT
+    capsense_cycles_init();
+    capsense_latency_reset(&wakeLatency);
+    capsense_latency_reset(&doneLatency);
+    #endif
+
+    #if SCAN_THREAD_ENABLED
+    /* The low-power timer and the end of scan interrupt wake the scan
+     * thread directly with thread flags.
+     */
+    scanThread.start(ScanThreadRun);
+    #else
     /* Create a thread to run CapSense scan periodically using an event queue
-     * dispatcher.
+     * dispatcher. The low-power timer posts every scan to the queue, and
+     * every run arms the timer for the next one.
      */
     Thread thread(osPriorityNormal, OS_STACK_SIZE, NULL, "CapSense Scan Thread");
     thread.start(callback(&queue, &EventQueue::dispatch_forever));
-    queue.call_every(CAPSENSE_SCAN_PERIOD_MS, RunCapSenseScan);
+    #endif
+    #if SCAN_TASK_ENABLED
+    /* The interrupts post events instead, and the queue resumes the scan
+     * task, which runs up to its first await right away.
+     */
+    capsense_task_init(&scanTasks);
+    capsense_task_add(&scanTasks, &scanTask, ScanTaskRun);
+    queue.call(capsense_task_dispatch, &scanTasks);
+    #endif
+    capsense_logger_start();
+    SubscribeTouchEvents();
+    capsense_report_start(capsense_event_dispatch);
+    #if MBED_CONF_APP_CAPSENSE_WAKE_ON_TOUCH
+    capsense_power_init(&powerMode);
+    #endif
+    scanClock.start();
+    capsense_sched_init(&scanSched, &scanTimer, CAPSENSE_SCAN_PERIOD_US);
 
     /* Initiate scan immediately since the first call of RunCapSenseScan()
      * happens CAPSENSE_SCAN_PERIOD_MS after the event queue dispatcher has
@@ -212,6 +461,7 @@ int main(void)
      */
     Cy_CapSense_ScanAllWidgets(&cy_capsense_context); 
     printf("Application has started. Touch any CapSense button or slider.\r\n");
+    #endif
 
     /* The EZI2C pins for the target CYW9P62S1_43012EVB_01 are P1[0] and P1[1].
      * The SCB associated with these pins is not deep sleep wake-up capable.
@@ -237,12 +487,29 @@ int main(void)
 ********************************************************************************
 * Summary:
 *   This function starts the scan, and processes the touch status. It is
-* periodically called by an event dispatcher. 
+* called by an event dispatcher when the low-power scan timer expires, and
+* arms the timer for the next run when it is done.
+*
+*   With the capsense-wake-on-touch option it only scans the ganged sensor
+* while in wake-on-touch mode, and the period follows the power mode.
 *
 *******************************************************************************/
 void RunCapSenseScan(void)
 {
+    #if MBED_CONF_APP_CAPSENSE_SCAN_LATENCY_REPORT
+    capsense_latency_add(&wakeLatency, scanWakeStamp, capsense_cycles_now());
+    #endif
+
     Cy_CapSense_Wakeup(&cy_capsense_context);
+    UpdateTunerSleepLock();
+
+    #if MBED_CONF_APP_CAPSENSE_WAKE_ON_TOUCH
+    if (UseGangedScan() && !capsense_power_ganged(&powerMode, &powerConfig, ScanGangedSensor()))
+    {
+        capsense_sched_done(&scanSched, ScanPeriodUs());
+        return;
+    }
+    #endif
 
     if (CY_CAPSENSE_NOT_BUSY == Cy_CapSense_IsBusy(&cy_capsense_context))
     {
@@ -251,17 +518,709 @@ void RunCapSenseScan(void)
          
     }
 
-    capsense_sem.acquire();
+    WaitScanDone();
+    ProcessCapSenseScan();
+}
+
+
+/*******************************************************************************
+* Function Name: UseGangedScan
+********************************************************************************
+* Summary:
+*   Returns true if this frame only scans the ganged sensor. The Tuner needs
+*   the data of every widget, so the ganged scan is only used while it is
+*   disconnected.
+*
+*******************************************************************************/
+static bool UseGangedScan(void)
+{
+    #if MBED_CONF_APP_CAPSENSE_WAKE_ON_TOUCH
+    return (CAPSENSE_POWER_WAKE_ON_TOUCH == powerMode.mode) && !IsTunerConnected();
+    #else
+    return false;
+    #endif
+}
+
+
+/*******************************************************************************
+* Function Name: ProcessCapSenseScan
+********************************************************************************
+* Summary:
+*   Processes a completed scan of all widgets, reports the touch status and
+*   arms the timer for the next scan.
+*
+*******************************************************************************/
+static void ProcessCapSenseScan(void)
+{
+    #if MBED_CONF_APP_CAPSENSE_SCAN_LATENCY_REPORT
+    capsense_latency_add(&doneLatency, scanDoneStamp, capsense_cycles_now());
+    #endif
     Cy_CapSense_ProcessAllWidgets(&cy_capsense_context);
+    const uint32_t timeMs =
+        (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(scanClock.elapsed_time()).count();
+    #if MBED_CONF_APP_CAPSENSE_STUCK_RESET
+    SuperviseSensors(timeMs);
+    #endif
+    #if MBED_CONF_APP_CAPSENSE_THRESHOLD_AUTOTUNE
+    TuneThresholds();
+    #endif
+    capsense_logger_push(&cy_capsense_context, timeMs);
     
     #if TUNER_ENABLE
     Cy_CapSense_RunTuner(&cy_capsense_context);
     #endif
 
-    ProcessTouchStatus();
+    ProcessTouchStatus(timeMs);
+    capsense_boot_mark(CAPSENSE_BOOT_FIRST_SCAN);
+    capsense_boot_report();
+
+    #if MBED_CONF_APP_CAPSENSE_WAKE_ON_TOUCH
+    capsense_power_active(&powerMode, &powerConfig,
+                          (0u != Cy_CapSense_IsAnyWidgetActive(&cy_capsense_context)) || IsTunerConnected());
+    #endif
+
+    #if MBED_CONF_APP_CAPSENSE_SCAN_LATENCY_REPORT
+    if (wakeLatency.count >= MBED_CONF_APP_CAPSENSE_SCAN_LATENCY_REPORT)
+    {
+        ReportScanLatency();
+    }
+    #endif
+
+    capsense_sched_done(&scanSched, ScanPeriodUs());
 }
 
 
+#if MBED_CONF_APP_CAPSENSE_STUCK_RESET
+/*******************************************************************************
+* Function Name: SuperviseSensors
+********************************************************************************
+* Summary:
+*   Runs every sensor through the stuck-sensor supervisor of capsense_stuck.h
+*   after processing, and resets the baseline of each stuck one alone with
+*   Cy_CapSense_InitializeSensorBaseline(). The other sensors keep their
+*   baselines and nothing is recalibrated.
+*
+* Parameters:
+*  timeMs: time of the scan.
+*
+*******************************************************************************/
+static void SuperviseSensors(uint32_t timeMs)
+{
+    static capsense_stuck_t sensors[capsense_layout_sensor_count()];
+    static const char *const reasons[] = { "", "touched too long", "below its baseline" };
+    uint32_t index = 0u;
+
+    for (uint32_t wdgtId = 0u; wdgtId < CAPSENSE_LAYOUT_WIDGET_COUNT; wdgtId++)
+    {
+        const cy_stc_capsense_widget_config_t *wdgt = &cy_capsense_context.ptrWdConfig[wdgtId];
+        const cy_stc_capsense_widget_context_t *wdContext = wdgt->ptrWdContext;
+
+        for (uint32_t snsId = 0u; (snsId < wdgt->numSns) && (index < capsense_layout_sensor_count()); snsId++)
+        {
+            const cy_stc_capsense_sensor_context_t *sns = &wdgt->ptrSnsContext[snsId];
+            const uint32_t stuck = capsense_stuck_update(&sensors[index++], MBED_CONF_APP_CAPSENSE_STUCK_ON_MS, timeMs,
+                                                         sns->diff >= wdContext->fingerTh, 0u != sns->negBslnRstCnt,
+                                                         wdContext->lowBslnRst);
+
+            if (CAPSENSE_STUCK_NONE != stuck)
+            {
+                Cy_CapSense_InitializeSensorBaseline(wdgtId, snsId, &cy_capsense_context);
+                printf("%s sensor %lu %s, baseline reset\r\n", CAPSENSE_LAYOUT_WIDGETS[wdgtId].name,
+                       (unsigned long)snsId, reasons[stuck]);
+            }
+        }
+    }
+}
+#endif
+
+
+#if MBED_CONF_APP_CAPSENSE_THRESHOLD_AUTOTUNE
+/*******************************************************************************
+* Function Name: TuneThresholds
+********************************************************************************
+* Summary:
+*   Feeds every sensor to the threshold auto-tuning of capsense_autotune.h
+*   after processing and moves the finger threshold, noise thresholds and
+*   hysteresis of each widget by one count per scan towards the tuned ones,
+*   while the widget reports no touch. The bounds are taken around the
+*   thresholds the widgets have at the first scan.
+*
+*   CSD widgets are left alone if the generated configuration enables
+*   SmartSense, as it sets their thresholds itself. Nothing is changed while
+*   the Tuner is connected, so that the values it shows and writes stay as
+*   they are.
+*
+*******************************************************************************/
+static void TuneThresholds(void)
+{
+    static capsense_autotune_t sensors[capsense_layout_sensor_count()];
+    static capsense_autotune_config_t configs[CAPSENSE_LAYOUT_WIDGET_COUNT];
+    static bool configured = false;
+    uint32_t index = 0u;
+
+    if (IsTunerConnected())
+    {
+        return;
+    }
+
+    for (uint32_t wdgtId = 0u; wdgtId < CAPSENSE_LAYOUT_WIDGET_COUNT; wdgtId++)
+    {
+        const cy_stc_capsense_widget_config_t *wdgt = &cy_capsense_context.ptrWdConfig[wdgtId];
+        cy_stc_capsense_widget_context_t *wdContext = wdgt->ptrWdContext;
+        const uint32_t first = index;
+        const bool active = (0u != Cy_CapSense_IsWidgetActive(wdgtId, &cy_capsense_context));
+        capsense_autotune_thresholds_t current = { wdContext->fingerTh, wdContext->noiseTh, wdContext->hysteresis };
+        capsense_autotune_thresholds_t target;
+
+        if (!configured)
+        {
+            configs[wdgtId] = capsense_autotune_config(current.fingerTh, current.noiseTh, current.hysteresis);
+        }
+        if (smartSenseEn && (CY_CAPSENSE_SENSE_METHOD_CSD_E == wdgt->senseMethod))
+        {
+            index += wdgt->numSns;
+            continue;
+        }
+
+        for (uint32_t snsId = 0u; (snsId < wdgt->numSns) && (index < capsense_layout_sensor_count()); snsId++)
+        {
+            const cy_stc_capsense_sensor_context_t *sns = &wdgt->ptrSnsContext[snsId];
+
+            capsense_autotune_update(&sensors[index++], (int32_t)sns->raw - (int32_t)sns->bsln, &current, active);
+        }
+
+        if (!active && capsense_autotune_target(&configs[wdgtId], &sensors[first], index - first, &target))
+        {
+            wdContext->fingerTh = capsense_autotune_step(current.fingerTh, target.fingerTh);
+            wdContext->noiseTh = capsense_autotune_step(current.noiseTh, target.noiseTh);
+            wdContext->nNoiseTh = wdContext->noiseTh;
+            wdContext->hysteresis = capsense_autotune_step(current.hysteresis, target.hysteresis);
+        }
+    }
+    configured = true;
+}
+#endif
+
+
+/*******************************************************************************
+* Function Name: WaitScanDone
+********************************************************************************
+* Summary:
+*   Blocks the scan loop until CapSenseEndOfScanCallback() signals the end of
+*   the scan.
+*
+*******************************************************************************/
+static void WaitScanDone(void)
+{
+    #if SCAN_THREAD_ENABLED
+    ThisThread::flags_wait_any(SCAN_FLAG_DONE);
+    #else
+    capsense_sem.acquire();
+    #endif
+}
+
+
+#if MBED_CONF_APP_CAPSENSE_WAKE_ON_TOUCH
+/*******************************************************************************
+* Function Name: ClearScanDone
+********************************************************************************
+* Summary:
+*   Drops an end of scan signal that nobody waited for.
+*
+*******************************************************************************/
+static void ClearScanDone(void)
+{
+    #if SCAN_THREAD_ENABLED
+    ThisThread::flags_clear(SCAN_FLAG_DONE);
+    #else
+    (void)capsense_sem.try_acquire();
+    #endif
+}
+#endif
+
+
+#if SCAN_THREAD_ENABLED
+/*******************************************************************************
+* Function Name: ScanThreadRun
+********************************************************************************
+* Summary:
+*   Body of the dedicated scan thread. Runs a scan every time the low-power
+*   timeout sets SCAN_FLAG_START.
+*
+*******************************************************************************/
+static void ScanThreadRun(void)
+{
+    while (true)
+    {
+        ThisThread::flags_wait_any(SCAN_FLAG_START);
+        RunCapSenseScan();
+    }
+}
+#endif
+
+
+#if SCAN_TASK_ENABLED
+/*******************************************************************************
+* Function Name: ScanTaskRun
+********************************************************************************
+* Summary:
+*   RunCapSenseScan() as a stackless task: instead of blocking the event
+*   queue thread, every wait for an interrupt returns to the dispatcher until
+*   the low-power timeout or the end of scan interrupt posts its event.
+*
+*******************************************************************************/
+static void ScanTaskRun(capsense_task_t *task)
+{
+    CAPSENSE_TASK_BEGIN(task);
+    while (true)
+    {
+        CAPSENSE_TASK_AWAIT(task, SCAN_FLAG_START);
+        #if MBED_CONF_APP_CAPSENSE_SCAN_LATENCY_REPORT
+        capsense_latency_add(&wakeLatency, scanWakeStamp, capsense_cycles_now());
+        #endif
+
+        Cy_CapSense_Wakeup(&cy_capsense_context);
+        UpdateTunerSleepLock();
+
+        #if MBED_CONF_APP_CAPSENSE_WAKE_ON_TOUCH
+        if (UseGangedScan())
+        {
+            /* A full scan is still in flight after the last active frame. */
+            if (CY_CAPSENSE_NOT_BUSY != Cy_CapSense_IsBusy(&cy_capsense_context))
+            {
+                CAPSENSE_TASK_AWAIT(task, SCAN_FLAG_DONE);
+            }
+            capsense_task_clear(&scanTasks, SCAN_FLAG_DONE);
+            ScanGangedStart();
+            CAPSENSE_TASK_AWAIT(task, SCAN_FLAG_DONE);
+            if (!capsense_power_ganged(&powerMode, &powerConfig, ScanGangedFinish()))
+            {
+                capsense_sched_done(&scanSched, ScanPeriodUs());
+                continue;
+            }
+        }
+        #endif
+
+        if (CY_CAPSENSE_NOT_BUSY == Cy_CapSense_IsBusy(&cy_capsense_context))
+        {
+            Cy_CapSense_ScanAllWidgets(&cy_capsense_context);
+        }
+        CAPSENSE_TASK_AWAIT(task, SCAN_FLAG_DONE);
+        ProcessCapSenseScan();
+    }
+    CAPSENSE_TASK_END(task);
+}
+
+
+/*******************************************************************************
+* Function Name: PostScanEvent
+********************************************************************************
+* Summary:
+*   Posts events to the scan task from interrupt context, and queues one
+*   dispatch on the event queue thread if none is queued yet.
+*
+*******************************************************************************/
+static void PostScanEvent(uint32_t events)
+{
+    if (capsense_task_post(&scanTasks, events))
+    {
+        queue.call(capsense_task_dispatch, &scanTasks);
+    }
+}
+#endif
+
+
+#if MBED_CONF_APP_CAPSENSE_SCAN_LATENCY_REPORT
+/*******************************************************************************
+* Function Name: ReportScanLatency
+********************************************************************************
+* Summary:
+*   Prints and restarts the latency statistics as one record:
+*
+*   latency,<thread>,<scans>,<wake min>,<wake avg>,<wake max>,
+*   <done min>,<done avg>,<done max>,<stack used>,<stack size>
+*
+*   <thread> is "realtime" with capsense-scan-thread, "task" with
+*   capsense-scan-task and "queue" otherwise.
+*   Wake is the time from the low-power timeout to the start of
+*   RunCapSenseScan(), done the time from the end of scan interrupt to the
+*   return of WaitScanDone(), both in ns. The stack use of the dedicated
+*   thread needs the platform.stack-stats-enabled option, and is 0 without.
+*
+*   With capsense-report-thread, a second record shows the counters of the
+*   report ring, see capsense_report_stats():
+*
+*   ring,<records>,<overflows>,<occupancy>,<peak>,<size>
+*
+*******************************************************************************/
+static void ReportScanLatency(void)
+{
+    const uint32_t perUs = capsense_cycles_per_us();
+    const capsense_latency_t wake = wakeLatency;
+    const capsense_latency_t done = doneLatency;
+    uint32_t stackUsed = 0u;
+    uint32_t stackSize = 0u;
+
+    #if SCAN_THREAD_ENABLED
+    stackSize = scanThread.stack_size();
+    #if defined(MBED_STACK_STATS_ENABLED)
+    stackUsed = scanThread.max_stack();
+    #endif
+    #endif
+
+    printf("latency,%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu\r\n",
+           SCAN_THREAD_ENABLED ? "realtime" : (SCAN_TASK_ENABLED ? "task" : "queue"), (unsigned long)wake.count,
+           (unsigned long)((uint64_t)wake.min * 1000u / perUs),
+           (unsigned long)(wake.sum * 1000u / perUs / wake.count),
+           (unsigned long)((uint64_t)wake.max * 1000u / perUs),
+           (unsigned long)((uint64_t)done.min * 1000u / perUs),
+           (unsigned long)((0u != done.count) ? (done.sum * 1000u / perUs / done.count) : 0u),
+           (unsigned long)((uint64_t)done.max * 1000u / perUs),
+           (unsigned long)stackUsed, (unsigned long)stackSize);
+
+    #if MBED_CONF_APP_CAPSENSE_REPORT_THREAD
+    capsense_report_stats_t report;
+    capsense_report_stats(&report);
+    printf("ring,%lu,%lu,%lu,%lu,%lu\r\n", (unsigned long)report.records, (unsigned long)report.overflows,
+           (unsigned long)report.occupancy, (unsigned long)report.peak, (unsigned long)report.size);
+    #endif
+
+    capsense_latency_reset(&wakeLatency);
+    capsense_latency_reset(&doneLatency);
+}
+#endif
+
+
+/*******************************************************************************
+* Function Name: ScanPeriodUs
+********************************************************************************
+* Summary:
+*   Returns the time from the start of this scan to the start of the next.
+*
+*******************************************************************************/
+static uint32_t ScanPeriodUs(void)
+{
+    #if MBED_CONF_APP_CAPSENSE_WAKE_ON_TOUCH
+    return capsense_power_period_ms(&powerMode, &powerConfig) * 1000u;
+    #else
+    return CAPSENSE_SCAN_PERIOD_US;
+    #endif
+}
+
+
+/*******************************************************************************
+* Function Name: ScanTimerNow
+********************************************************************************
+* Summary:
+*   Time base of the scan scheduler: microseconds of the low-power timer,
+*   which keeps counting in deep sleep.
+*
+*******************************************************************************/
+static uint32_t ScanTimerNow(void *arg)
+{
+    (void)arg;
+    return (uint32_t)scanClock.elapsed_time().count();
+}
+
+
+/*******************************************************************************
+* Function Name: ScanTimerStart
+********************************************************************************
+* Summary:
+*   Arms the low-power timeout for the next scan. LowPowerTimeout does not
+*   lock deep sleep, and with MBED_TICKLESS the RTOS suspends its tick while
+*   all threads wait, so this is the only wakeup between scans.
+*
+*******************************************************************************/
+static void ScanTimerStart(void *arg, uint32_t delayUs)
+{
+    (void)arg;
+    scanTimeout.attach(&ScanTimerExpired, std::chrono::microseconds(delayUs));
+}
+
+
+/*******************************************************************************
+* Function Name: ScanTimerExpired
+********************************************************************************
+* Summary:
+*   Low-power timeout handler. Runs in interrupt context and defers the scan
+*   to the event queue thread, wakes the dedicated scan thread, or resumes
+*   the scan task.
+*
+*******************************************************************************/
+static void ScanTimerExpired(void)
+{
+    #if MBED_CONF_APP_CAPSENSE_SCAN_LATENCY_REPORT
+    scanWakeStamp = capsense_cycles_now();
+    #endif
+
+    #if SCAN_THREAD_ENABLED
+    scanThread.flags_set(SCAN_FLAG_START);
+    #elif SCAN_TASK_ENABLED
+    PostScanEvent(SCAN_FLAG_START);
+    #else
+    queue.call(RunCapSenseScan);
+    #endif
+}
+
+
+#if MBED_CONF_APP_CAPSENSE_WAKE_ON_TOUCH
+/*******************************************************************************
+* Function Name: CalibrateGangedSensor
+********************************************************************************
+* Summary:
+*   Finds the modulator IDAC and sense clock divider of the ganged sensor.
+*   The scan starts from the settings of the host sensor and slows the sense
+*   clock while the IDAC cannot balance the ganged electrodes. The clock is
+*   then scaled by the capacitance ratio of the ganged and the host sensor,
+*   estimated from the IDAC codes, so the larger electrode still settles in
+*   every sense cycle, and the IDAC is calibrated again at the final clock.
+*   The compensation IDAC is not used. Must run while no other scan is in
+*   flight and before the end of scan callback is registered.
+*
+*******************************************************************************/
+static void CalibrateGangedSensor(void)
+{
+    const cy_stc_capsense_widget_config_t *host = &cy_capsense_context.ptrWdConfig[CAPSENSE_WOT_WDGT_ID];
+    const uint32_t hostIdac = (uint32_t)host->ptrWdContext->idacMod[0u] + host->ptrSnsContext[0u].idacComp;
+    const uint16_t target = (uint16_t)(((uint32_t)host->ptrWdContext->maxRawCount *
+                                        CAPSENSE_WOT_CALIBRATION_PCT) / 100u);
+
+    gangedSnsClk = host->ptrWdContext->snsClk;
+    while ((CalibrateGangedIdac() > target) && ((gangedSnsClk * 2u) <= CAPSENSE_WOT_SNS_CLK_MAX))
+    {
+        /* The IDAC is at its maximum and the raw count is still too high. */
+        gangedSnsClk *= 2u;
+    }
+
+    if (0u != hostIdac)
+    {
+        uint32_t snsClk = ((uint32_t)gangedSnsClk * gangedIdacMod + hostIdac - 1u) / hostIdac;
+
+        if (snsClk > CAPSENSE_WOT_SNS_CLK_MAX)
+        {
+            snsClk = CAPSENSE_WOT_SNS_CLK_MAX;
+        }
+        if (snsClk > gangedSnsClk)
+        {
+            gangedSnsClk = (uint16_t)snsClk;
+            (void)CalibrateGangedIdac();
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: CalibrateGangedIdac
+********************************************************************************
+* Summary:
+*   Finds the smallest modulator IDAC code that keeps the raw count of the
+*   ganged sensor at or below CAPSENSE_WOT_CALIBRATION_PCT of the maximum
+*   raw count, one bit at a time, at the sense clock in gangedSnsClk.
+*
+* Return:
+*  Raw count of the ganged sensor with the code found.
+*
+*******************************************************************************/
+static uint16_t CalibrateGangedIdac(void)
+{
+    const cy_stc_capsense_widget_context_t *hostContext =
+        cy_capsense_context.ptrWdConfig[CAPSENSE_WOT_WDGT_ID].ptrWdContext;
+    const uint16_t target = (uint16_t)(((uint32_t)hostContext->maxRawCount *
+                                        CAPSENSE_WOT_CALIBRATION_PCT) / 100u);
+    uint32_t code = 0u;
+
+    /* A larger IDAC current gives a lower raw count. The code stays below
+     * the smallest one that reaches the target.
+     */
+    for (uint32_t bit = (CAPSENSE_WOT_IDAC_MAX + 1u) >> 1u; 0u != bit; bit >>= 1u)
+    {
+        gangedIdacMod = (uint8_t)(code | bit);
+        if (ScanGangedBlocking() > target)
+        {
+            code |= bit;
+        }
+    }
+    gangedIdacMod = (uint8_t)((code < CAPSENSE_WOT_IDAC_MAX) ? (code + 1u) : CAPSENSE_WOT_IDAC_MAX);
+
+    return ScanGangedBlocking();
+}
+
+
+/*******************************************************************************
+* Function Name: ScanGangedBlocking
+********************************************************************************
+* Summary:
+*   Scans the ganged sensor and polls the CSD block until the scan completes.
+*
+* Return:
+*  Raw count of the ganged sensor.
+*
+*******************************************************************************/
+static uint16_t ScanGangedBlocking(void)
+{
+    ScanGangedStart();
+    while (CY_CAPSENSE_NOT_BUSY != Cy_CapSense_IsBusy(&cy_capsense_context))
+    {
+    }
+    return ScanGangedFinish();
+}
+
+
+/*******************************************************************************
+* Function Name: ScanGangedSensor
+********************************************************************************
+* Summary:
+*   Scans every button and slider electrode as one self-capacitance sensor.
+*   The first sensor of CAPSENSE_WOT_WDGT_ID is set up with the low-level
+*   CSD API and the electrode pins of every other widget, the Rx and Tx pins
+*   of CSX buttons included, are connected to it for the duration of the
+*   scan, so a finger anywhere on those widgets raises the raw count. One
+*   scan replaces a scan of every sensor,
+*   and the device stays in deep sleep between scans: capsenseDeepSleepCb
+*   only allows the transition while the CSD block is idle.
+*
+* Return:
+*  Raw count of the ganged sensor.
+*
+*******************************************************************************/
+static uint16_t ScanGangedSensor(void)
+{
+    /* A full scan is still in flight after the last active frame. */
+    if (CY_CAPSENSE_NOT_BUSY != Cy_CapSense_IsBusy(&cy_capsense_context))
+    {
+        WaitScanDone();
+    }
+    ClearScanDone();
+
+    ScanGangedStart();
+    WaitScanDone();
+    return ScanGangedFinish();
+}
+
+
+/*******************************************************************************
+* Function Name: ScanGangedStart
+********************************************************************************
+* Summary:
+*   Connects the electrodes to the ganged sensor and starts its scan with
+*   the ganged settings. The settings are swapped into the host widget only
+*   while the scan is set up, and the raw count of the host sensor, which the
+*   scan overwrites, is kept for ScanGangedFinish().
+*
+*******************************************************************************/
+static void ScanGangedStart(void)
+{
+    const cy_stc_capsense_widget_config_t *host = &cy_capsense_context.ptrWdConfig[CAPSENSE_WOT_WDGT_ID];
+    cy_stc_capsense_widget_context_t *hostContext = host->ptrWdContext;
+    cy_stc_capsense_sensor_context_t *hostSensor = &host->ptrSnsContext[0u];
+    const uint16_t snsClk = hostContext->snsClk;
+    const uint8_t idacMod = hostContext->idacMod[0u];
+    const uint8_t idacComp = hostSensor->idacComp;
+
+    gangedHostRaw = hostSensor->raw;
+
+    hostContext->snsClk = gangedSnsClk;
+    hostContext->idacMod[0u] = gangedIdacMod;
+    hostSensor->idacComp = 0u;
+    Cy_CapSense_CSDSetupWidgetExt(CAPSENSE_WOT_WDGT_ID, 0u, &cy_capsense_context);
+    hostContext->snsClk = snsClk;
+    hostContext->idacMod[0u] = idacMod;
+    hostSensor->idacComp = idacComp;
+
+    ConnectGangedPins(true);
+    Cy_CapSense_CSDScanExt(&cy_capsense_context);
+}
+
+
+/*******************************************************************************
+* Function Name: ScanGangedFinish
+********************************************************************************
+* Summary:
+*   Disconnects the electrodes after the scan of the ganged sensor and puts
+*   back the raw count of the host sensor.
+*
+* Return:
+*  Raw count of the ganged sensor.
+*
+*******************************************************************************/
+static uint16_t ScanGangedFinish(void)
+{
+    cy_stc_capsense_sensor_context_t *hostSensor =
+        &cy_capsense_context.ptrWdConfig[CAPSENSE_WOT_WDGT_ID].ptrSnsContext[0u];
+    const uint16_t raw = hostSensor->raw;
+
+    ConnectGangedPins(false);
+    hostSensor->raw = gangedHostRaw;
+
+    return raw;
+}
+
+
+/*******************************************************************************
+* Function Name: ConnectGangedPins
+********************************************************************************
+* Summary:
+*   Connects the electrodes of every widget to the ganged sensor, or
+*   disconnects them. The electrode of the host sensor is set up by
+*   Cy_CapSense_CSDSetupWidgetExt() and skipped here.
+*   Cy_CapSense_CSDConnectSns() routes any CapSense pin to the CSD block, so
+*   the Rx and Tx electrodes of CSX buttons take part as self-capacitance
+*   electrodes. When disconnected, they return to the state the CSX scans
+*   leave them in rather than the CSD inactive state.
+*
+* Parameters:
+*  connect: true to connect the electrodes, false to disconnect them.
+*
+*******************************************************************************/
+static void ConnectGangedPins(bool connect)
+{
+    const cy_stc_capsense_electrode_config_t *hostEltd =
+        &cy_capsense_context.ptrWdConfig[CAPSENSE_WOT_WDGT_ID].ptrEltdConfig[0u];
+
+    for (uint32_t wdgtId = 0u; wdgtId < cy_capsense_context.ptrCommonConfig->numWd; wdgtId++)
+    {
+        const cy_stc_capsense_widget_config_t *wdgt = &cy_capsense_context.ptrWdConfig[wdgtId];
+        const bool csx = (CY_CAPSENSE_SENSE_METHOD_CSX_E == wdgt->senseMethod);
+
+        /* A CSD widget has one electrode per sensor, a CSX widget one per
+         * Rx column and Tx row.
+         */
+        const uint32_t numEltd = csx ? ((uint32_t)wdgt->numCols + wdgt->numRows) : wdgt->numSns;
+
+        for (uint32_t eltdId = 0u; eltdId < numEltd; eltdId++)
+        {
+            const cy_stc_capsense_electrode_config_t *eltd = &wdgt->ptrEltdConfig[eltdId];
+
+            if (eltd == hostEltd)
+            {
+                continue;
+            }
+            for (uint32_t pinId = 0u; pinId < eltd->numPins; pinId++)
+            {
+                if (connect)
+                {
+                    Cy_CapSense_CSDConnectSns(&eltd->ptrPin[pinId], &cy_capsense_context);
+                }
+                else if (!csx)
+                {
+                    Cy_CapSense_CSDDisconnectSns(&eltd->ptrPin[pinId], &cy_capsense_context);
+                }
+                else if (CY_CAPSENSE_ELTD_TYPE_MUT_RX_E == eltd->type)
+                {
+                    Cy_CapSense_CSXDisconnectRx(&eltd->ptrPin[pinId], &cy_capsense_context);
+                }
+                else
+                {
+                    Cy_CapSense_CSXDisconnectTx(&eltd->ptrPin[pinId], &cy_capsense_context);
+                }
+            }
+        }
+    }
+}
+#endif
+
+
 /*******************************************************************************
 * Function Name: initialize_capsense_tuner
 ********************************************************************************
@@ -292,47 +1251,211 @@ static void initialize_capsense_tuner(void)
 }
 
 
+/*******************************************************************************
+* Function Name: UpdateTunerSleepLock
+********************************************************************************
+* Summary:
+*   Locks deep sleep while the CapSense Tuner accesses the EZI2C buffer and
+*   releases the lock MBED_CONF_APP_CAPSENSE_TUNER_WINDOW_MS after the last
+*   access. The activity status of the EZI2C slave is cleared on read, so
+*   every access since the previous scan is seen, including those that woke
+*   the device from deep sleep.
+*
+*******************************************************************************/
+static void UpdateTunerSleepLock(void)
+{
+    #if TUNER_ENABLE
+    const uint32_t activity = (uint32_t)cyhal_ezi2c_get_activity_status(&sEzI2C) &
+                              (CYHAL_EZI2C_STATUS_READ1 | CYHAL_EZI2C_STATUS_WRITE1 | CYHAL_EZI2C_STATUS_BUSY);
+    const uint32_t nowMs = (uint32_t)Kernel::Clock::now().time_since_epoch().count();
+
+    switch (capsense_sleep_update(&tunerSleep, MBED_CONF_APP_CAPSENSE_TUNER_WINDOW_MS, nowMs, (0u != activity)))
+    {
+        case CAPSENSE_SLEEP_LOCK:
+            sleep_manager_lock_deep_sleep();
+            break;
+
+        case CAPSENSE_SLEEP_UNLOCK:
+            sleep_manager_unlock_deep_sleep();
+            break;
+
+        default:
+            break;
+    }
+    #endif
+}
+
+
+/*******************************************************************************
+* Function Name: IsTunerConnected
+********************************************************************************
+* Summary:
+*   Returns true while the CapSense Tuner holds the deep sleep lock.
+*
+*******************************************************************************/
+static bool IsTunerConnected(void)
+{
+    #if TUNER_ENABLE
+    return tunerSleep.locked;
+    #else
+    return false;
+    #endif
+}
+
+
 /*******************************************************************************
 * Function Name: ProcessTouchStatus
 ********************************************************************************
 *
 * Summary:
-*   Controls the LED status according to the status of CapSense widgets and
-*   prints the status to serial terminal.
+*   Takes the status of the CapSense widgets after the scan and hands it to
+*   the widget event dispatch through capsense_report_push().
+*
+* Parameters:
+*  timeMs: time of the scan.
 *
 *******************************************************************************/
-void ProcessTouchStatus(void)
+void ProcessTouchStatus(uint32_t timeMs)
 {
-    uint32_t currSliderPos;    
-    uint32_t currBtn0Status = Cy_CapSense_IsSensorActive(CY_CAPSENSE_BUTTON0_WDGT_ID, CY_CAPSENSE_BUTTON0_SNS0_ID, &cy_capsense_context);        
-    uint32_t currBtn1Status = Cy_CapSense_IsSensorActive(CY_CAPSENSE_BUTTON1_WDGT_ID, CY_CAPSENSE_BUTTON1_SNS0_ID, &cy_capsense_context);       
-    cy_stc_capsense_touch_t *sldrTouch = Cy_CapSense_GetTouchInfo(CY_CAPSENSE_LINEARSLIDER0_WDGT_ID, &cy_capsense_context);
-    
-    if(currBtn0Status != prevBtn0Status)
+    capsense_touch_state_t state;
+
+    capsense_touch_snapshot(&cy_capsense_context, timeMs, &state);
+    capsense_report_push(&state);
+}
+
+
+/*******************************************************************************
+* Function Name: SubscribeTouchEvents
+********************************************************************************
+*
+* Summary:
+*   Subscribes the LED and the serial output of the demo to the widget events
+*   of capsense_event.h.
+*
+*******************************************************************************/
+static void SubscribeTouchEvents(void)
+{
+    capsense_event_subscribe(CAPSENSE_EVENT_ALL_WIDGETS, CAPSENSE_EVENT_PRESS | CAPSENSE_EVENT_RELEASE,
+                             TOUCH_LED_PRIORITY, UpdateTouchLed, NULL);
+    capsense_event_subscribe(CY_CAPSENSE_BUTTON0_WDGT_ID, CAPSENSE_EVENT_PRESS | CAPSENSE_EVENT_RELEASE,
+                             TOUCH_PRINT_PRIORITY, PrintTouchEvent, NULL);
+    capsense_event_subscribe(CY_CAPSENSE_BUTTON1_WDGT_ID, CAPSENSE_EVENT_PRESS | CAPSENSE_EVENT_RELEASE,
+                             TOUCH_PRINT_PRIORITY, PrintTouchEvent, NULL);
+    capsense_event_subscribe(CY_CAPSENSE_LINEARSLIDER0_WDGT_ID, CAPSENSE_EVENT_POSITION,
+                             TOUCH_PRINT_PRIORITY, PrintTouchEvent, NULL);
+    #if MBED_CONF_APP_CAPSENSE_GESTURES
+    capsense_event_subscribe(CY_CAPSENSE_LINEARSLIDER0_WDGT_ID, CAPSENSE_EVENT_GESTURE,
+                             TOUCH_PRINT_PRIORITY, ShowGesture, NULL);
+    #endif
+    #if MBED_CONF_APP_CAPSENSE_SLIDER_BALLISTIC
+    capsense_event_subscribe(CY_CAPSENSE_LINEARSLIDER0_WDGT_ID,
+                             CAPSENSE_EVENT_PRESS | CAPSENSE_EVENT_RELEASE | CAPSENSE_EVENT_POSITION,
+                             TOUCH_PRINT_PRIORITY, UpdateSliderValue, NULL);
+    #endif
+}
+
+
+/*******************************************************************************
+* Function Name: PrintTouchEvent
+********************************************************************************
+*
+* Summary:
+*   Prints the button status and slider position changes to serial terminal.
+*
+*******************************************************************************/
+static void PrintTouchEvent(const capsense_event_t *event, void *arg)
+{
+    (void)arg;
+
+    if ((CAPSENSE_EVENT_POSITION == event->kind) && (CAPSENSE_TOUCH_NO_POSITION != event->second))
     {
-        printf("Button_0 status: %lu\r\n", (unsigned long)currBtn0Status);
-        prevBtn0Status = currBtn0Status;
+        printf("Slider positions: %lu, %lu\r\n", (unsigned long)event->value, (unsigned long)event->second);
     }
-    
-    if(currBtn1Status != prevBtn1Status)
+    else if (CAPSENSE_EVENT_POSITION == event->kind)
+    {
+        printf("Slider position: %lu\r\n", (unsigned long)event->value);
+    }
+    else
     {
-        printf("Button_1 status: %lu\r\n", (unsigned long)currBtn1Status);
-        prevBtn1Status = currBtn1Status;
-    } 
+        printf("Button_%lu status: %lu\r\n", (unsigned long)event->index,
+               (CAPSENSE_EVENT_PRESS == event->kind) ? 1uL : 0uL);
+    }
+}
 
-    if (sldrTouch->numPosition == SLIDER_NUM_TOUCH)
-    {       
-        currSliderPos = sldrTouch->ptrPosition->x;
 
-        if(currSliderPos != prevSliderPos)
-        {
-            printf("Slider position: %lu\r\n", (unsigned long)currSliderPos);
-            prevSliderPos = currSliderPos;
-        }
-    }
+/*******************************************************************************
+* Function Name: UpdateTouchLed
+********************************************************************************
+*
+* Summary:
+*   Turns the LED ON while any CapSense widget is touched.
+*
+*******************************************************************************/
+static void UpdateTouchLed(const capsense_event_t *event, void *arg)
+{
+    static uint32_t touched;
+
+    (void)arg;
+    touched = (CAPSENSE_EVENT_PRESS == event->kind) ? (touched + 1u) : (touched - 1u);
+    ledStatus = (0u != touched) ? LED_ON : LED_OFF;
+}
+
+
+#if MBED_CONF_APP_CAPSENSE_GESTURES
+/*******************************************************************************
+* Function Name: ShowGesture
+********************************************************************************
+*
+* Summary:
+*   Prints a slider gesture to serial terminal, and shows the last one in the
+*   gestureDetected and gestureDirection fields of the widget in the Tuner.
+*
+*******************************************************************************/
+static void ShowGesture(const capsense_event_t *event, void *arg)
+{
+    static const char *const names[] = { "none", "tap", "double tap", "long press", "swipe", "flick" };
+    static const char *const directions[] = { "", " right", " left" };
+    cy_stc_capsense_widget_context_t *wdContext = cy_capsense_context.ptrWdConfig[event->wdgtId].ptrWdContext;
+
+    (void)arg;
+    printf("Slider gesture: %s%s at %lu\r\n", names[event->gesture.gesture], directions[event->gesture.direction],
+           (unsigned long)event->gesture.position);
+    wdContext->gestureDetected = (uint16_t)event->gesture.gesture;
+    wdContext->gestureDirection = (uint16_t)event->gesture.direction;
+}
+#endif
 
-    ledStatus = (currBtn0Status || currBtn1Status || (SLIDER_NUM_TOUCH == sldrTouch->numPosition)) ? LED_ON : LED_OFF;
+
+#if MBED_CONF_APP_CAPSENSE_SLIDER_BALLISTIC
+/*******************************************************************************
+* Function Name: UpdateSliderValue
+********************************************************************************
+*
+* Summary:
+*   Drives a value from 0 to SLIDER_VALUE_MAX with the slider through the
+*   ballistic multiplier of capsense_ballistic.h, and prints it when it
+*   changes. Runs on the reporting thread only, so the state needs no lock.
+*
+*******************************************************************************/
+static void UpdateSliderValue(const capsense_event_t *event, void *arg)
+{
+    static constexpr capsense_ballistic_config_t config =
+        capsense_ballistic_config(CAPSENSE_LAYOUT_TARGETS[CAPSENSE_LAYOUT_TARGET_INDEX].sliderResolution,
+                                  SLIDER_VALUE_MAX);
+    static capsense_ballistic_t ballistic;
+    static int32_t value;
+
+    (void)arg;
+    const int32_t change = capsense_ballistic_update(&ballistic, &config, event->timeMs,
+                                                     CAPSENSE_EVENT_RELEASE != event->kind, event->value);
+    if (0 != change)
+    {
+        value += change;
+        value = (value < 0) ? 0 : ((value > (int32_t)SLIDER_VALUE_MAX) ? (int32_t)SLIDER_VALUE_MAX : value);
+        printf("Slider value: %ld\r\n", (long)value);
+    }
 }
+#endif
 
 
 /*******************************************************************************
@@ -352,7 +1475,9 @@ void CapSense_InterruptHandler(void)
 * Function Name: CapSenseEndOfScanCallback()
 ********************************************************************************
 * Summary:
-*  This function releases a semaphore to indicate end of a CapSense scan.
+*  This function releases a semaphore, sets SCAN_FLAG_DONE of the dedicated
+*  scan thread, or posts it to the scan task, to indicate end of a CapSense
+*  scan.
 *
 * Parameters:
 *  cy_stc_active_scan_sns_t* : pointer to active sensor details.
@@ -360,7 +1485,17 @@ void CapSense_InterruptHandler(void)
 *******************************************************************************/
 void CapSenseEndOfScanCallback(cy_stc_active_scan_sns_t * ptrActiveScan)
 {  
+    #if MBED_CONF_APP_CAPSENSE_SCAN_LATENCY_REPORT
+    scanDoneStamp = capsense_cycles_now();
+    #endif
+
+    #if SCAN_THREAD_ENABLED
+    scanThread.flags_set(SCAN_FLAG_DONE);
+    #elif SCAN_TASK_ENABLED
+    PostScanEvent(SCAN_FLAG_DONE);
+    #else
     capsense_sem.release();
+    #endif
 }
 
 
@@ -0,0 +1,461 @@
+/*******************************************************************************
+* File Name: capsense_autotune_sim.cpp
+*
+* Description:
+*   Simulates the threshold auto-tuning of capsense_autotune.h on a button
+*   whose noise and touch signal differ from the design, as in another
+*   enclosure or environment, and checks that the thresholds converge to the
+*   ones expected from the true statistics without missed or false touches.
+*   Also times the tuner per sensor and scan.
+*
+*   Build with CMake from the tools directory, for example: cmake -S tools -B
+*   build-tools && cmake --build build-tools && build-
+*   tools/capsense_autotune_sim
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include "../capsense_autotune.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Sensor model and designed thresholds of the CSX buttons, in counts */
+#define SIM_LEVEL                               (1500)
+#define SIM_FINGER_TH                           (100u)
+#define SIM_NOISE_TH                            (40u)
+#define SIM_HYSTERESIS                          (10u)
+#define SIM_ON_DEBOUNCE                         (3u)
+#define SIM_LOW_BSLN_RST                        (30u)
+
+/* Touch pattern: a tap of SIM_TAP_MS every SIM_TAP_PERIOD_MS */
+#define SIM_TAP_PERIOD_MS                       (2000u)
+#define SIM_TAP_MS                              (300u)
+
+/* Allowed error of the final thresholds against the ones expected from the
+ * true noise and signal: percent plus counts.
+ */
+#define SIM_TOLERANCE_PCT                       (15u)
+#define SIM_TOLERANCE_COUNTS                    (2u)
+
+/* Taps missed beyond the reference run, as the thresholds wander by a count
+ * around the expected ones.
+ */
+#define SIM_MISSED_SLACK                        (1u)
+
+/* Calls timed per function */
+#define SIM_TIMING_CALLS                        (10000000u)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    uint32_t periodMs;
+    uint32_t durationMs;
+    uint32_t seed;
+} sim_args_t;
+
+typedef struct
+{
+    const char *name;
+    double noise;           /* Standard deviation of the raw count */
+    double noiseAfter;      /* Same after half the duration, as in a new environment */
+    int32_t signal;         /* Counts added by a finger */
+    bool touches;           /* Whether the sensor is tapped at all */
+} sim_scenario_t;
+
+/* Sensor with a simplified baseline and touch detection of the middleware */
+typedef struct
+{
+    int32_t bsln;
+    uint32_t negScans;
+    uint32_t onScans;
+    bool active;
+} sim_sensor_t;
+
+typedef struct
+{
+    capsense_autotune_thresholds_t th;
+    capsense_autotune_thresholds_t expected;
+    uint32_t convergeMs;    /* Since the last change of the environment */
+    uint32_t falseTouches;  /* Reported without a finger, after convergence */
+    uint32_t missedTaps;    /* Not reported, after convergence */
+} sim_result_t;
+
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static const sim_scenario_t sim_scenarios[] =
+{
+    { "nominal",         3.0,  3.0,  200, true },
+    { "thick_overlay",   3.0,  3.0,  80,  true },
+    { "noisy",           15.0, 15.0, 200, true },
+    { "very_noisy",      25.0, 25.0, 200, true },
+    { "weak_and_noisy",  8.0,  8.0,  100, true },
+    { "enclosure_change", 3.0, 30.0, 200, true },
+    { "no_touch",        3.0,  3.0,  0,   false },
+};
+
+
+/*******************************************************************************
+* Function Name: sim_expected
+********************************************************************************
+* Summary:
+*   Thresholds expected from the true noise and signal, following the rules
+*   of capsense_autotune_target().
+*
+*******************************************************************************/
+static capsense_autotune_thresholds_t sim_expected(const capsense_autotune_config_t *cfg, double noise,
+                                                   int32_t signal)
+{
+    const double finger = signal ? (signal * CAPSENSE_AUTOTUNE_FINGER_PCT / 100.0) : cfg->design.fingerTh;
+    const double noiseTh = signal ? (signal * CAPSENSE_AUTOTUNE_NOISE_PCT / 100.0) : cfg->design.noiseTh;
+    const double hysteresis = signal ? (signal * CAPSENSE_AUTOTUNE_HYSTERESIS_PCT / 100.0) : cfg->design.hysteresis;
+    capsense_autotune_thresholds_t th;
+
+    th.fingerTh = (uint16_t)fmin(fmax(fmax(finger, ceil(CAPSENSE_AUTOTUNE_FINGER_SIGMA * noise)), cfg->min.fingerTh),
+                                 cfg->max.fingerTh);
+    th.noiseTh = (uint16_t)fmin(fmax(fmax(noiseTh, ceil(CAPSENSE_AUTOTUNE_NOISE_SIGMA * noise)), cfg->min.noiseTh),
+                                cfg->max.noiseTh);
+    th.hysteresis = (uint16_t)fmin(fmax(hysteresis, cfg->min.hysteresis), cfg->max.hysteresis);
+    if ((th.fingerTh > th.hysteresis) && (th.noiseTh >= (th.fingerTh - th.hysteresis)))
+    {
+        th.noiseTh = (uint16_t)(th.fingerTh - th.hysteresis - 1u);
+    }
+    return th;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_close
+********************************************************************************
+* Summary:
+*   Returns true if every threshold is within the tolerance of the expected
+*   one.
+*
+*******************************************************************************/
+static bool sim_close(const capsense_autotune_thresholds_t *th, const capsense_autotune_thresholds_t *expected)
+{
+    const uint16_t values[][2] =
+    {
+        { th->fingerTh, expected->fingerTh },
+        { th->noiseTh, expected->noiseTh },
+        { th->hysteresis, expected->hysteresis },
+    };
+
+    for (const auto &value : values)
+    {
+        const uint32_t error = (uint32_t)abs((int32_t)value[0] - (int32_t)value[1]);
+
+        if (error > ((value[1] * SIM_TOLERANCE_PCT / 100u) + SIM_TOLERANCE_COUNTS))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_process
+********************************************************************************
+* Summary:
+*   Updates the baseline model and the touch status with one raw count. The
+*   baseline follows the raw count by one count per scan below the noise
+*   threshold and is reset after SIM_LOW_BSLN_RST scans below the negative
+*   noise threshold. A touch is reported after SIM_ON_DEBOUNCE scans at
+*   fingerTh + hysteresis and ends below fingerTh - hysteresis.
+*
+*******************************************************************************/
+static void sim_process(sim_sensor_t *sns, const capsense_autotune_thresholds_t *th, int32_t raw)
+{
+    const int32_t diff = raw - sns->bsln;
+
+    if (diff < -(int32_t)th->noiseTh)
+    {
+        if (++sns->negScans >= SIM_LOW_BSLN_RST)
+        {
+            sns->bsln = raw;
+            sns->negScans = 0u;
+        }
+    }
+    else
+    {
+        sns->negScans = 0u;
+        if (diff < (int32_t)th->noiseTh)
+        {
+            sns->bsln += (diff > 0) ? 1 : ((diff < 0) ? -1 : 0);
+        }
+    }
+
+    if (sns->active)
+    {
+        sns->active = (diff >= ((int32_t)th->fingerTh - (int32_t)th->hysteresis));
+    }
+    else
+    {
+        sns->onScans = (diff >= (int32_t)(th->fingerTh + th->hysteresis)) ? (sns->onScans + 1u) : 0u;
+        sns->active = (sns->onScans >= SIM_ON_DEBOUNCE);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_run
+********************************************************************************
+* Summary:
+*   Scans one scenario at the scan period. The tuner sees every scan and
+*   moves the thresholds of the model one step per scan while it reports no
+*   touch, as main.cpp does with the middleware. Touches are counted from
+*   the convergence on.
+*
+*   Without tune, the thresholds are the expected ones from the start
+*   instead, and touches are counted from fromMs. This is the reference for
+*   the touches a scenario misses with ideal thresholds.
+*
+*******************************************************************************/
+static sim_result_t sim_run(const sim_args_t *args, const sim_scenario_t *scenario, std::mt19937 rng, bool tune,
+                            uint32_t fromMs)
+{
+    const capsense_autotune_config_t cfg = capsense_autotune_config(SIM_FINGER_TH, SIM_NOISE_TH, SIM_HYSTERESIS);
+    const uint32_t changeMs = (scenario->noise != scenario->noiseAfter) ? (args->durationMs / 2u) : 0u;
+    capsense_autotune_t stats = {};
+    sim_sensor_t sns = { SIM_LEVEL, 0u, 0u, false };
+    sim_result_t result = {};
+    bool converged = false;
+    bool tapReported = false;
+    bool wasActive = false;
+
+    result.expected = sim_expected(&cfg, scenario->noiseAfter, scenario->touches ? scenario->signal : 0);
+    result.th = tune ? cfg.design : result.expected;
+
+    for (uint32_t ms = 0u; ms < args->durationMs; ms += args->periodMs)
+    {
+        std::normal_distribution<double> noise(0.0, (ms < changeMs) ? scenario->noise : scenario->noiseAfter);
+        const uint32_t tapMs = ms % SIM_TAP_PERIOD_MS;
+        const bool finger = scenario->touches && (tapMs >= (SIM_TAP_PERIOD_MS / 2u)) &&
+                            (tapMs < ((SIM_TAP_PERIOD_MS / 2u) + SIM_TAP_MS));
+        const int32_t raw = SIM_LEVEL + (finger ? scenario->signal : 0) + (int32_t)lround(noise(rng));
+        capsense_autotune_thresholds_t target;
+
+        sim_process(&sns, &result.th, raw);
+        capsense_autotune_update(&stats, raw - sns.bsln, &result.th, sns.active);
+        if (tune && !sns.active && capsense_autotune_target(&cfg, &stats, 1u, &target))
+        {
+            result.th.fingerTh = capsense_autotune_step(result.th.fingerTh, target.fingerTh);
+            result.th.noiseTh = capsense_autotune_step(result.th.noiseTh, target.noiseTh);
+            result.th.hysteresis = capsense_autotune_step(result.th.hysteresis, target.hysteresis);
+        }
+
+        /* Converged once within the tolerance for good, after the change */
+        if (tune ? (!sim_close(&result.th, &result.expected) || (ms < changeMs)) : (ms < fromMs))
+        {
+            converged = false;
+        }
+        else if (!converged)
+        {
+            converged = true;
+            result.convergeMs = ms - changeMs;
+            result.falseTouches = 0u;
+            result.missedTaps = 0u;
+        }
+
+        result.falseTouches += (sns.active && !wasActive && !finger) ? 1u : 0u;
+        tapReported = (tapMs == 0u) ? false : (tapReported || sns.active);
+        if (finger && ((tapMs + args->periodMs) >= ((SIM_TAP_PERIOD_MS / 2u) + SIM_TAP_MS)) && !tapReported)
+        {
+            result.missedTaps++;
+        }
+        wasActive = sns.active;
+    }
+    if (!converged)
+    {
+        result.convergeMs = UINT32_MAX;
+    }
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_time
+********************************************************************************
+* Summary:
+*   Average time of capsense_autotune_update(), the cost per sensor and
+*   scan, and of capsense_autotune_target() for one sensor, in ns.
+*
+*******************************************************************************/
+static void sim_time(double *updateNs, double *targetNs)
+{
+    const capsense_autotune_config_t cfg = capsense_autotune_config(SIM_FINGER_TH, SIM_NOISE_TH, SIM_HYSTERESIS);
+    capsense_autotune_t stats = {};
+    capsense_autotune_thresholds_t target = cfg.design;
+    volatile uint32_t sink = 0u;
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t call = 0u; call < SIM_TIMING_CALLS; call++)
+    {
+        const int32_t delta = (int32_t)(call % 11u) - 5 + ((0u != (call & 256u)) ? 150 : 0);
+
+        capsense_autotune_update(&stats, delta, &cfg.design, 0u != (call & 512u));
+    }
+    *updateNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count() / SIM_TIMING_CALLS;
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t call = 0u; call < SIM_TIMING_CALLS; call++)
+    {
+        stats.noiseVar = call;
+        sink = sink + (capsense_autotune_target(&cfg, &stats, 1u, &target) ? target.fingerTh : 0u);
+    }
+    *targetNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count() / SIM_TIMING_CALLS;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_option
+********************************************************************************
+* Summary:
+*   Stores the value of a "--name value" option in the matching field.
+*
+* Return:
+*  false if the option is unknown.
+*******************************************************************************/
+static bool sim_option(sim_args_t *args, const char *name, const char *value)
+{
+    uint32_t number = (uint32_t)strtoul(value, NULL, 0);
+    struct
+    {
+        const char *name;
+        uint32_t *field;
+    } const options[] =
+    {
+        { "--period-ms",   &args->periodMs },
+        { "--duration-ms", &args->durationMs },
+        { "--seed",        &args->seed },
+    };
+
+    for (const auto &option : options)
+    {
+        if (0 == strcmp(name, option.name))
+        {
+            *option.field = number;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   Runs every scenario and checks that the thresholds converge to the ones
+*   expected from the true noise and signal, and that after that no touch is
+*   reported without a finger and no more taps are missed than with the
+*   expected thresholds on the same noise. Then times the tuner.
+*
+* Return:
+*  0 if every scenario passes, 1 otherwise, 2 for a usage error.
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    sim_args_t args =
+    {
+        .periodMs   = 20u,
+        .durationMs = 240000u,
+        .seed       = 1u
+    };
+
+    for (int i = 1; i < argc; i += 2)
+    {
+        if ((i + 1 >= argc) || !sim_option(&args, argv[i], argv[i + 1]) || (0u == args.periodMs))
+        {
+            fprintf(stderr, "usage: %s [--period-ms ms] [--duration-ms ms] [--seed n]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::mt19937 rng(args.seed);
+    bool failed = false;
+
+    printf("scenario,finger_th,noise_th,hysteresis,expected_finger_th,expected_noise_th,expected_hysteresis,"
+           "converge_ms,false_touches,missed_taps,reference_missed_taps,result\n");
+    for (const sim_scenario_t &scenario : sim_scenarios)
+    {
+        const sim_result_t result = sim_run(&args, &scenario, rng, true, 0u);
+        const bool converged = (UINT32_MAX != result.convergeMs);
+        const uint32_t changeMs = (scenario.noise != scenario.noiseAfter) ? (args.durationMs / 2u) : 0u;
+        const sim_result_t reference = sim_run(&args, &scenario, rng, false,
+                                               converged ? (changeMs + result.convergeMs) : args.durationMs);
+        const bool pass = converged && (0u == result.falseTouches) &&
+                          (result.missedTaps <= (reference.missedTaps + SIM_MISSED_SLACK));
+
+        rng.discard(args.durationMs / args.periodMs);
+        printf("%s,%u,%u,%u,%u,%u,%u,%ld,%lu,%lu,%lu,%s\n", scenario.name, result.th.fingerTh, result.th.noiseTh,
+               result.th.hysteresis, result.expected.fingerTh, result.expected.noiseTh, result.expected.hysteresis,
+               (UINT32_MAX == result.convergeMs) ? -1L : (long)result.convergeMs,
+               (unsigned long)result.falseTouches, (unsigned long)result.missedTaps,
+               (unsigned long)reference.missedTaps, pass ? "ok" : "fail");
+        failed = failed || !pass;
+    }
+
+    double updateNs;
+    double targetNs;
+
+    sim_time(&updateNs, &targetNs);
+    printf("\ncalls,update_ns,target_ns\n");
+    printf("%u,%.1f,%.1f\n", SIM_TIMING_CALLS, updateNs, targetNs);
+    return failed ? 1 : 0;
+}
+
+
+/* [] END OF FILE */
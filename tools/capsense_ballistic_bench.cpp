@@ -0,0 +1,320 @@
+/*******************************************************************************
+* File Name: capsense_ballistic_bench.cpp
+*
+* Description:
+*   Host check and benchmark of the slider ballistic multiplier,
+*   capsense_ballistic.cpp. Strokes along a simulated slider at slow, medium
+*   and fast speeds are fed through the multiplier with the firmware defaults:
+*   each scenario must cover its share of the output range, and no change may
+*   go against the move of the finger. The cost of one call per scan is then
+*   timed.
+*
+*   Build with CMake from the tools directory, for example: cmake -S tools -B
+*   build-tools && cmake --build build-tools && build-
+*   tools/capsense_ballistic_bench
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "../capsense_ballistic.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Scans timed per call of capsense_ballistic_update() */
+#define BENCH_TIMING_SCANS                      (1000000u)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    uint32_t range;
+    uint32_t output;        /* Range of the driven value */
+    uint32_t periodMs;
+    uint32_t jitter;        /* Largest position noise */
+    uint32_t seed;
+} bench_args_t;
+
+typedef struct
+{
+    uint32_t timeMs;
+    bool touched;
+    uint32_t position;
+} bench_scan_t;
+
+typedef struct
+{
+    const char *name;
+    uint32_t strokes;       /* Full-length moves of the slider, each a separate touch */
+    int32_t direction;      /* 1 to move up, -1 down, 0 up then back down in one touch */
+    uint32_t speedPct;      /* Percent of the range per second */
+    double minOutput;       /* Least |sum of the changes| in output ranges */
+    double maxOutput;       /* Most |sum of the changes| in output ranges */
+} bench_scenario_t;
+
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static const bench_scenario_t bench_scenarios[] =
+{
+    /* Slow strokes need CAPSENSE_BALLISTIC_SLOW_SWEEPS per output range */
+    { "slow_stroke",     1u, 1,  10u,  0.0033, 0.0045 },
+    { "slow_round_trip", 1u, 0,  10u,  0.0,    0.0001 },
+    /* Fast strokes cover the range in CAPSENSE_BALLISTIC_FAST_SWEEPS, less
+     * the scans the speed filter takes to catch up
+     */
+    { "fast_strokes",    2u, 1,  600u, 0.8,    1.05 },
+    { "fast_down",       2u, -1, 600u, 0.8,    1.05 },
+    { "medium_strokes",  2u, 1,  150u, 0.2,    0.6 },
+};
+
+
+/*******************************************************************************
+* Function Name: bench_synthesize
+********************************************************************************
+* Summary:
+*   Scans of a scenario at the scan period: each stroke is a touch that
+*   moves the full length of the slider at a constant speed, with position
+*   noise, followed by a release of 200 ms.
+*
+*******************************************************************************/
+static std::vector<bench_scan_t> bench_synthesize(const bench_args_t *args, const bench_scenario_t *scenario,
+                                                  std::mt19937 *rng)
+{
+    std::uniform_int_distribution<int32_t> noise(-(int32_t)args->jitter, (int32_t)args->jitter);
+    const double strokeMs = 100000.0 / scenario->speedPct;
+    const double legs = (0 == scenario->direction) ? 2.0 : 1.0;
+    std::vector<bench_scan_t> scans;
+    uint32_t timeMs = 1000u;
+
+    for (uint32_t stroke = 0u; stroke < scenario->strokes; stroke++)
+    {
+        for (double ms = 0.0; ms <= (strokeMs * legs); ms += args->periodMs)
+        {
+            double along = fmin(ms, strokeMs) - fmax(0.0, ms - strokeMs);
+            double position = args->range * along / strokeMs;
+
+            if (scenario->direction < 0)
+            {
+                position = args->range - position;
+            }
+            const int32_t noisy = (int32_t)lround(position) + noise(*rng);
+            scans.push_back({ timeMs, true, (uint32_t)((noisy < 0) ? 0 :
+                                                       ((noisy > (int32_t)args->range) ? args->range : noisy)) });
+            timeMs += args->periodMs;
+        }
+        for (uint32_t ms = 0u; ms < 200u; ms += args->periodMs)
+        {
+            scans.push_back({ timeMs, false, 0u });
+            timeMs += args->periodMs;
+        }
+    }
+    return scans;
+}
+
+
+/*******************************************************************************
+* Function Name: bench_run
+********************************************************************************
+* Summary:
+*   Feeds the scans of a scenario through capsense_ballistic_update().
+*
+* Parameters:
+*  reversed: incremented for every change against the move of its scan.
+*
+* Return:
+*  Sum of the changes.
+*
+*******************************************************************************/
+static int64_t bench_run(const capsense_ballistic_config_t *cfg, const std::vector<bench_scan_t> &scans,
+                         uint32_t *reversed)
+{
+    capsense_ballistic_t ctx = {};
+    uint32_t lastPos = 0u;
+    int64_t sum = 0;
+
+    for (const bench_scan_t &scan : scans)
+    {
+        const int32_t change = capsense_ballistic_update(&ctx, cfg, scan.timeMs, scan.touched, scan.position);
+        const int32_t move = (int32_t)scan.position - (int32_t)lastPos;
+
+        *reversed += (((change > 0) && (move < 0)) || ((change < 0) && (move > 0))) ? 1u : 0u;
+        lastPos = scan.position;
+        sum += change;
+    }
+    return sum;
+}
+
+
+/*******************************************************************************
+* Function Name: bench_time
+********************************************************************************
+* Summary:
+*   Average time of one capsense_ballistic_update() call over a trace that
+*   repeats the scans of every scenario, in ns.
+*
+*******************************************************************************/
+static double bench_time(const capsense_ballistic_config_t *cfg, const std::vector<bench_scan_t> &scans)
+{
+    capsense_ballistic_t ctx = {};
+    volatile int32_t sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t i = 0u; i < BENCH_TIMING_SCANS; i++)
+    {
+        const bench_scan_t &scan = scans[i % scans.size()];
+
+        sink = sink + capsense_ballistic_update(&ctx, cfg, scan.timeMs + (i / (uint32_t)scans.size()),
+                                                scan.touched, scan.position);
+    }
+    const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now() - start).count();
+    return ns / BENCH_TIMING_SCANS;
+}
+
+
+/*******************************************************************************
+* Function Name: bench_option
+********************************************************************************
+* Summary:
+*   Stores the value of a "--name value" option in the matching field.
+*
+* Return:
+*  false if the option is unknown.
+*******************************************************************************/
+static bool bench_option(bench_args_t *args, const char *name, const char *value)
+{
+    uint32_t number = (uint32_t)strtoul(value, NULL, 0);
+    struct
+    {
+        const char *name;
+        uint32_t *field;
+    } const options[] =
+    {
+        { "--range",     &args->range },
+        { "--output",    &args->output },
+        { "--period-ms", &args->periodMs },
+        { "--jitter",    &args->jitter },
+        { "--seed",      &args->seed },
+    };
+
+    for (const auto &option : options)
+    {
+        if (0 == strcmp(name, option.name))
+        {
+            *option.field = number;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   Runs every scenario with the firmware defaults and checks how much of
+*   the output range its strokes cover, and that no change goes against the
+*   move of the finger, then times capsense_ballistic_update() per scan.
+*
+* Return:
+*  0 if every scenario passes, 1 otherwise, 2 for a usage error.
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    bench_args_t args =
+    {
+        .range    = 300u,
+        .output   = 65535u,
+        .periodMs = 20u,
+        .jitter   = 1u,
+        .seed     = 1u
+    };
+
+    for (int i = 1; i < argc; i += 2)
+    {
+        if ((i + 1 >= argc) || !bench_option(&args, argv[i], argv[i + 1]) || (0u == args.periodMs) ||
+            (0u == args.range) || (0u == args.output) || (args.output > (1uL << 24)))
+        {
+            fprintf(stderr, "usage: %s [--range positions] [--output units] [--period-ms ms] [--jitter positions]\n"
+                    "       [--seed n]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const capsense_ballistic_config_t cfg = capsense_ballistic_config(args.range, args.output);
+    std::mt19937 rng(args.seed);
+    std::vector<bench_scan_t> all;
+    bool failed = false;
+
+    printf("scenario,scans,output,output_pct,reversed,result\n");
+    for (const bench_scenario_t &scenario : bench_scenarios)
+    {
+        const std::vector<bench_scan_t> scans = bench_synthesize(&args, &scenario, &rng);
+        uint32_t reversed = 0u;
+        const int64_t sum = bench_run(&cfg, scans, &reversed);
+        const double covered = fabs((double)sum) / args.output;
+        const bool pass = (covered >= scenario.minOutput) && (covered <= scenario.maxOutput) && (0u == reversed);
+
+        printf("%s,%lu,%lld,%.2f,%lu,%s\n", scenario.name, (unsigned long)scans.size(), (long long)sum,
+               100.0 * covered, (unsigned long)reversed, pass ? "ok" : "fail");
+        failed = failed || !pass;
+        all.insert(all.end(), scans.begin(), scans.end());
+    }
+
+    printf("\nscans,update_ns\n");
+    printf("%u,%.1f\n", BENCH_TIMING_SCANS, bench_time(&cfg, all));
+    return failed ? 1 : 0;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,467 @@
+/*******************************************************************************
+* File Name: capsense_calib_check.cpp
+*
+* Description:
+*   Host check of the calibration cache. It builds capsense_calib.cpp against
+*   the stand-ins in tools/host and boots the common configuration of every
+*   generated design several times with an in-memory KVStore.
+*   Cy_CapSense_Enable() may skip the IDAC and sense clock calibration only
+*   when the cache is restored, and SmartSense threshold tracking must stay as
+*   generated after every boot.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "mbed.h"
+#include "kvstore_global_api.h"
+#include "cycfg_capsense.h"
+#include "../capsense_layout.h"
+#include "../capsense_calib.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Values the emulated Cy_CapSense_Enable() finds when it calibrates */
+#define SIM_CAL_IDAC_MOD                        (32u)
+#define SIM_CAL_SNS_CLK                         (16u)
+#define SIM_CAL_IDAC_COMP                       (20u)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+/* Common configuration of a generated design */
+typedef struct
+{
+    std::string name;
+    cy_stc_capsense_common_config_t config;
+    uint16_t configId;
+} sim_design_t;
+
+typedef struct
+{
+    const char *name;
+    bool corrupt;           /* Damage the stored record before the boot */
+    uint16_t configIdDelta; /* Boot a design with another configuration ID */
+    bool restored;          /* Expected result of capsense_calib_restore() */
+} sim_boot_t;
+
+typedef struct
+{
+    bool restored;
+    uint8_t enableAutotune;     /* csdAutotuneEn seen by Cy_CapSense_Enable() */
+    uint8_t enableAutocal;      /* csdIdacAutocalEn seen by Cy_CapSense_Enable() */
+    uint8_t runtimeAutotune;    /* csdAutotuneEn seen by the scans after the boot */
+    bool generated;             /* The context uses the generated configuration after the boot */
+    bool statuses;              /* Widget statuses initialized after Cy_CapSense_Enable() */
+    bool calibrated;            /* Contexts hold the values of the first calibration */
+} sim_result_t;
+
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* The boots of every design, in order, sharing one store */
+const sim_boot_t sim_boots[] =
+{
+    { "first",   false, 0u, false },
+    { "cached",  false, 0u, true  },
+    { "cached",  false, 0u, true  },
+    { "corrupt", true,  0u, false },
+    { "cached",  false, 0u, true  },
+    { "changed", false, 1u, false },
+};
+
+std::map<std::string, std::vector<uint8_t>> sim_store;
+
+cy_stc_capsense_widget_context_t sim_wdContext[CAPSENSE_LAYOUT_WIDGET_COUNT];
+cy_stc_capsense_sensor_context_t sim_snsContext[capsense_layout_sensor_count()];
+cy_stc_capsense_widget_config_t sim_wdConfig[CAPSENSE_LAYOUT_WIDGET_COUNT];
+cy_stc_capsense_common_context_t sim_commonContext;
+cy_stc_capsense_context_t sim_context;
+
+bool sim_enabled;
+bool sim_statuses;
+
+
+/*******************************************************************************
+* Function Name: kv_set, kv_get, kv_remove
+********************************************************************************
+* Summary:
+*   KVStore kept in memory.
+*
+*******************************************************************************/
+int kv_set(const char *full_name_key, const void *buffer, size_t size, uint32_t create_flags)
+{
+    (void)create_flags;
+    sim_store[full_name_key].assign((const uint8_t *)buffer, (const uint8_t *)buffer + size);
+    return MBED_SUCCESS;
+}
+
+int kv_get(const char *full_name_key, void *buffer, size_t buffer_size, size_t *actual_size)
+{
+    const auto entry = sim_store.find(full_name_key);
+
+    if (sim_store.end() == entry)
+    {
+        return -1;
+    }
+    *actual_size = (entry->second.size() < buffer_size) ? entry->second.size() : buffer_size;
+    memcpy(buffer, entry->second.data(), *actual_size);
+    return MBED_SUCCESS;
+}
+
+int kv_remove(const char *full_name_key)
+{
+    return (0u != sim_store.erase(full_name_key)) ? MBED_SUCCESS : -1;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_CapSense_InitializeAllStatuses
+********************************************************************************
+* Summary:
+*   Records that the widget statuses were initialized after the enable.
+*
+*******************************************************************************/
+void Cy_CapSense_InitializeAllStatuses(const cy_stc_capsense_context_t *context)
+{
+    (void)context;
+    sim_statuses = sim_enabled;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_enable
+********************************************************************************
+* Summary:
+*   Cy_CapSense_Enable() as far as the cache is concerned: it calibrates the
+*   IDACs and the sense clock only if the common configuration asks for it.
+*
+* Return:
+*  csdAutotuneEn and csdIdacAutocalEn it ran with, in the result.
+*
+*******************************************************************************/
+static cy_status sim_enable(cy_stc_capsense_context_t *context, sim_result_t *result)
+{
+    result->enableAutotune = context->ptrCommonConfig->csdAutotuneEn;
+    result->enableAutocal = context->ptrCommonConfig->csdIdacAutocalEn;
+
+    if (CY_CAPSENSE_ENABLE == context->ptrCommonConfig->csdIdacAutocalEn)
+    {
+        for (uint32_t wdgtId = 0u; wdgtId < CAPSENSE_LAYOUT_WIDGET_COUNT; wdgtId++)
+        {
+            const cy_stc_capsense_widget_config_t *wdConfig = &context->ptrWdConfig[wdgtId];
+
+            wdConfig->ptrWdContext->idacMod[0u] = (uint8_t)(SIM_CAL_IDAC_MOD + wdgtId);
+            wdConfig->ptrWdContext->snsClk = (uint16_t)(SIM_CAL_SNS_CLK + wdgtId);
+            for (uint32_t snsId = 0u; snsId < wdConfig->numSns; snsId++)
+            {
+                wdConfig->ptrSnsContext[snsId].idacComp = (uint8_t)(SIM_CAL_IDAC_COMP + snsId);
+            }
+        }
+    }
+    sim_enabled = true;
+    return CY_RET_SUCCESS;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_calibrated
+********************************************************************************
+* Summary:
+*   Checks that the contexts hold the values of the emulated calibration.
+*
+*******************************************************************************/
+static bool sim_calibrated(const cy_stc_capsense_context_t *context)
+{
+    for (uint32_t wdgtId = 0u; wdgtId < CAPSENSE_LAYOUT_WIDGET_COUNT; wdgtId++)
+    {
+        const cy_stc_capsense_widget_config_t *wdConfig = &context->ptrWdConfig[wdgtId];
+
+        if ((wdConfig->ptrWdContext->idacMod[0u] != SIM_CAL_IDAC_MOD + wdgtId) ||
+            (wdConfig->ptrWdContext->snsClk != SIM_CAL_SNS_CLK + wdgtId))
+        {
+            return false;
+        }
+        for (uint32_t snsId = 0u; snsId < wdConfig->numSns; snsId++)
+        {
+            if (wdConfig->ptrSnsContext[snsId].idacComp != SIM_CAL_IDAC_COMP + snsId)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_run
+********************************************************************************
+* Summary:
+*   Boots a design with the sequence of main(): the contexts start from the
+*   values of Cy_CapSense_Init(), i.e. zero here.
+*
+*******************************************************************************/
+static sim_result_t sim_run(const sim_design_t *design, const sim_boot_t *boot)
+{
+    sim_result_t result = {};
+
+    memset(sim_wdContext, 0, sizeof(sim_wdContext));
+    memset(sim_snsContext, 0, sizeof(sim_snsContext));
+    for (uint32_t wdgtId = 0u; wdgtId < CAPSENSE_LAYOUT_WIDGET_COUNT; wdgtId++)
+    {
+        sim_wdConfig[wdgtId].ptrWdContext = &sim_wdContext[wdgtId];
+        sim_wdConfig[wdgtId].ptrSnsContext = &sim_snsContext[capsense_layout_first_sensor(wdgtId)];
+        sim_wdConfig[wdgtId].numSns = CAPSENSE_LAYOUT_WIDGETS[wdgtId].numSns;
+    }
+    sim_commonContext.configId = (uint16_t)(design->configId + boot->configIdDelta);
+    sim_context.ptrCommonConfig = &design->config;
+    sim_context.ptrCommonContext = &sim_commonContext;
+    sim_context.ptrWdConfig = sim_wdConfig;
+    sim_enabled = false;
+    sim_statuses = false;
+
+    if (boot->corrupt)
+    {
+        for (auto &entry : sim_store)
+        {
+            entry.second[entry.second.size() / 2u] ^= 0x01u;
+        }
+    }
+
+    result.restored = capsense_calib_restore(&sim_context);
+    cy_status status = sim_enable(&sim_context, &result);
+    if (result.restored && (CY_RET_SUCCESS != status))
+    {
+        capsense_calib_discard(&sim_context);
+        result.restored = false;
+        status = sim_enable(&sim_context, &result);
+    }
+    if (!result.restored && (CY_RET_SUCCESS == status))
+    {
+        capsense_calib_save(&sim_context);
+    }
+    capsense_calib_enabled(&sim_context);
+
+    result.runtimeAutotune = sim_context.ptrCommonConfig->csdAutotuneEn;
+    result.generated = (&design->config == sim_context.ptrCommonConfig);
+    result.statuses = sim_statuses;
+    result.calibrated = sim_calibrated(&sim_context);
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_flag
+********************************************************************************
+* Summary:
+*   Value of a ".field = CY_CAPSENSE_..." initializer of a generated
+*   configuration.
+*
+* Return:
+*  false if the field or its value is not known.
+*******************************************************************************/
+static bool sim_flag(const std::string &text, const char *field, uint8_t *value)
+{
+    struct
+    {
+        const char *name;
+        uint8_t value;
+    } const names[] =
+    {
+        { "CY_CAPSENSE_CSD_SS_HWTH_EN", CY_CAPSENSE_CSD_SS_HWTH_EN },
+        { "CY_CAPSENSE_CSD_SS_HW_EN",   CY_CAPSENSE_CSD_SS_HW_EN },
+        { "CY_CAPSENSE_CSD_SS_TH_EN",   CY_CAPSENSE_CSD_SS_TH_EN },
+        { "CY_CAPSENSE_CSD_SS_DIS",     CY_CAPSENSE_CSD_SS_DIS },
+        { "CY_CAPSENSE_ENABLE",         CY_CAPSENSE_ENABLE },
+        { "CY_CAPSENSE_DISABLE",        CY_CAPSENSE_DISABLE },
+    };
+    const std::string key = std::string(".") + field + " = ";
+    const size_t pos = text.find(key);
+
+    if (std::string::npos == pos)
+    {
+        return false;
+    }
+    const std::string rest = text.substr(pos + key.size(), text.find(',', pos) - pos - key.size());
+    for (const auto &name : names)
+    {
+        if (rest == name.name)
+        {
+            *value = name.value;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_load
+********************************************************************************
+* Summary:
+*   Reads the common configuration of a generated cycfg_capsense.c.
+*
+* Return:
+*  false if the file cannot be read or lacks a field.
+*******************************************************************************/
+static bool sim_load(const char *path, sim_design_t *design)
+{
+    FILE *file = fopen(path, "rb");
+    std::string text;
+    char chunk[4096];
+    size_t size;
+
+    if (NULL == file)
+    {
+        return false;
+    }
+    while (0u != (size = fread(chunk, 1u, sizeof(chunk), file)))
+    {
+        text.append(chunk, size);
+    }
+    fclose(file);
+
+    const size_t configId = text.find(".configId = ");
+    const char *target = strstr(path, "TARGET_");
+
+    /* Kits are named by their target directory */
+    if (NULL != target)
+    {
+        target += strlen("TARGET_");
+        design->name.assign(target, strcspn(target, "/\\"));
+    }
+    else
+    {
+        design->name = path;
+    }
+    design->config.numWd = (uint8_t)CAPSENSE_LAYOUT_WIDGET_COUNT;
+    design->config.numSns = (uint16_t)capsense_layout_sensor_count();
+    design->configId = (std::string::npos != configId) ?
+                       (uint16_t)strtoul(text.c_str() + configId + strlen(".configId = "), NULL, 0) : 0u;
+    return (std::string::npos != configId) &&
+           sim_flag(text, "csdAutotuneEn", &design->config.csdAutotuneEn) &&
+           sim_flag(text, "csdIdacAutocalEn", &design->config.csdIdacAutocalEn) &&
+           sim_flag(text, "csdIdacAutoGainEn", &design->config.csdIdacAutoGainEn) &&
+           sim_flag(text, "csxIdacAutocalEn", &design->config.csxIdacAutocalEn);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   Boots every design given on the command line, or a default one with
+*   SmartSense and IDAC autocalibration, several times with one store. Only
+*   a boot from the cache may run Cy_CapSense_Enable() without calibration;
+*   after every boot the context must use the generated configuration, so
+*   that SmartSense threshold tracking is as generated, and the contexts must
+*   hold the calibrated values.
+*
+* Return:
+*  0 if every boot passes, 1 otherwise, 2 for a usage error.
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    std::vector<sim_design_t> designs;
+    bool failed = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        sim_design_t design = {};
+
+        if (!sim_load(argv[i], &design))
+        {
+            fprintf(stderr, "usage: %s [cycfg_capsense.c...]\n%s: cannot read the common configuration\n",
+                    argv[0], argv[i]);
+            return 2;
+        }
+        designs.push_back(design);
+    }
+    if (designs.empty())
+    {
+        sim_design_t design = {};
+
+        design.name = "default";
+        design.config.numWd = (uint8_t)CAPSENSE_LAYOUT_WIDGET_COUNT;
+        design.config.numSns = (uint16_t)capsense_layout_sensor_count();
+        design.config.csdAutotuneEn = CY_CAPSENSE_CSD_SS_HWTH_EN;
+        design.config.csdIdacAutocalEn = CY_CAPSENSE_ENABLE;
+        design.config.csdIdacAutoGainEn = CY_CAPSENSE_ENABLE;
+        design.config.csxIdacAutocalEn = CY_CAPSENSE_ENABLE;
+        design.configId = 0x1234u;
+        designs.push_back(design);
+    }
+
+    printf("design,boot,restored,enable_autotune,enable_autocal,runtime_autotune,statuses,result\n");
+    for (const sim_design_t &design : designs)
+    {
+        sim_store.clear();
+        for (const sim_boot_t &boot : sim_boots)
+        {
+            const sim_result_t result = sim_run(&design, &boot);
+            const bool enableOk = result.restored ?
+                ((CY_CAPSENSE_CSD_SS_DIS == result.enableAutotune) && (CY_CAPSENSE_DISABLE == result.enableAutocal)) :
+                ((design.config.csdAutotuneEn == result.enableAutotune) &&
+                 (design.config.csdIdacAutocalEn == result.enableAutocal));
+            const bool pass = (result.restored == boot.restored) && enableOk && result.generated &&
+                              (design.config.csdAutotuneEn == result.runtimeAutotune) &&
+                              (result.statuses == result.restored) && result.calibrated;
+
+            printf("%s,%s,%d,%u,%u,%u,%d,%s\n", design.name.c_str(), boot.name, result.restored ? 1 : 0,
+                   result.enableAutotune, result.enableAutocal, result.runtimeAutotune, result.statuses ? 1 : 0,
+                   pass ? "ok" : "fail");
+            failed = failed || !pass;
+        }
+    }
+    return failed ? 1 : 0;
+}
+
+
+/* [] END OF FILE */
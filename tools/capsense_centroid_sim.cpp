@@ -0,0 +1,317 @@
+/*******************************************************************************
+* File Name: capsense_centroid_sim.cpp
+*
+* Description:
+*   Host check of the two-finger slider centroid, capsense_centroid.cpp. One
+*   finger, then two fingers at least --min-gap-pct of a segment apart, are
+*   placed at every position of a fine grid on a simulated slider with noise,
+*   and the positions found must match within --max-error. The single and the
+*   two-finger centroid are then timed on the same profiles, to compare their
+*   cost per scan.
+*
+*   Build with CMake from the tools directory, for example: cmake -S tools -B
+*   build-tools && cmake --build build-tools && build-
+*   tools/capsense_centroid_sim
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <random>
+#include "../capsense_centroid.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define SIM_MAX_SEGMENTS                        (16u)
+
+/* Finger positions per scenario, in hundredths of a segment */
+#define SIM_STEP                                (5u)
+
+/* Calls per timing measurement */
+#define SIM_TIMING_CALLS                        (1000000u)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    uint32_t segments;
+    uint32_t resolution;
+    uint32_t signal;        /* Difference count of a finger centered on a segment */
+    uint32_t threshold;     /* Finger threshold */
+    uint32_t noise;         /* Standard deviation of the difference counts */
+    uint32_t widthPct;      /* Distance at which a finger stops touching a segment, in % of a segment */
+    uint32_t minGapPct;     /* Smallest finger distance that must be told apart, in % of a segment */
+    uint32_t maxError;      /* Largest allowed position error */
+    uint32_t seed;
+} sim_args_t;
+
+typedef struct
+{
+    uint32_t frames;
+    uint32_t found;         /* Frames with the right number of fingers */
+    uint32_t extra;         /* Frames with more fingers than placed */
+    double errorSum;
+    double errorMax;
+} sim_result_t;
+
+
+/*******************************************************************************
+* Function Name: sim_profile
+********************************************************************************
+* Summary:
+*   Difference counts of the segments with fingers at the given positions, in
+*   segments. A finger adds signal to a segment in proportion to its
+*   closeness, down to 0 at widthPct, and noise is added to every segment.
+*
+*******************************************************************************/
+static void sim_profile(const sim_args_t *args, const double *fingers, uint32_t count, std::mt19937 *rng,
+                        uint16_t diff[SIM_MAX_SEGMENTS])
+{
+    std::normal_distribution<double> noise(0.0, (double)args->noise);
+    const double width = args->widthPct / 100.0;
+
+    for (uint32_t i = 0u; i < args->segments; i++)
+    {
+        double level = noise(*rng);
+
+        for (uint32_t finger = 0u; finger < count; finger++)
+        {
+            level += args->signal * fmax(0.0, 1.0 - (fabs(fingers[finger] - i) / width));
+        }
+        diff[i] = (uint16_t)fmin(65535.0, fmax(0.0, round(level)));
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_run
+********************************************************************************
+* Summary:
+*   Places count fingers at every position of a SIM_STEP grid, with the
+*   second finger at least minGapPct above the first, and checks the
+*   positions found by capsense_centroid_linear().
+*
+*******************************************************************************/
+static sim_result_t sim_run(const sim_args_t *args, uint32_t count, std::mt19937 *rng)
+{
+    const uint32_t last = (args->segments - 1u) * 100u;
+    const double scale = (double)args->resolution / (args->segments - 1u);
+    sim_result_t result = {};
+
+    for (uint32_t first = 0u; first <= last; first += SIM_STEP)
+    {
+        /* One finger needs one pass of the inner loop */
+        const uint32_t lastSecond = (1u == count) ? (first + args->minGapPct) : last;
+
+        for (uint32_t second = first + args->minGapPct; second <= lastSecond; second += SIM_STEP)
+        {
+            const double fingers[CAPSENSE_CENTROID_MAX_TOUCHES] = { first / 100.0, second / 100.0 };
+            uint16_t diff[SIM_MAX_SEGMENTS];
+            uint16_t positions[CAPSENSE_CENTROID_MAX_TOUCHES];
+
+            sim_profile(args, fingers, count, rng, diff);
+            const uint32_t found = capsense_centroid_linear(diff, args->segments, args->threshold,
+                                                            args->resolution, CAPSENSE_CENTROID_MAX_TOUCHES,
+                                                            positions);
+            result.frames++;
+            result.extra += (found > count) ? 1u : 0u;
+            if (found == count)
+            {
+                result.found++;
+                for (uint32_t finger = 0u; finger < count; finger++)
+                {
+                    const double error = fabs(positions[finger] - (fingers[finger] * scale));
+
+                    result.errorSum += error;
+                    result.errorMax = fmax(result.errorMax, error);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_time
+********************************************************************************
+* Summary:
+*   Average time of one capsense_centroid_linear() call on a fixed profile,
+*   in ns.
+*
+*******************************************************************************/
+static double sim_time(const sim_args_t *args, const uint16_t diff[SIM_MAX_SEGMENTS], uint32_t maxTouches)
+{
+    uint16_t positions[CAPSENSE_CENTROID_MAX_TOUCHES];
+    volatile uint32_t sink = 0u;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t call = 0u; call < SIM_TIMING_CALLS; call++)
+    {
+        /* Through volatile, so that the calls are not merged */
+        const uint16_t *volatile profile = diff;
+
+        sink = sink + capsense_centroid_linear(profile, args->segments, args->threshold, args->resolution,
+                                               maxTouches, positions) + positions[0u];
+    }
+    const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now() - start).count();
+    return ns / SIM_TIMING_CALLS;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_option
+********************************************************************************
+* Summary:
+*   Stores the value of a "--name value" option in the matching field.
+*
+* Return:
+*  false if the option is unknown.
+*******************************************************************************/
+static bool sim_option(sim_args_t *args, const char *name, const char *value)
+{
+    uint32_t number = (uint32_t)strtoul(value, NULL, 0);
+    struct
+    {
+        const char *name;
+        uint32_t *field;
+    } const options[] =
+    {
+        { "--segments",    &args->segments },
+        { "--resolution",  &args->resolution },
+        { "--signal",      &args->signal },
+        { "--threshold",   &args->threshold },
+        { "--noise",       &args->noise },
+        { "--width-pct",   &args->widthPct },
+        { "--min-gap-pct", &args->minGapPct },
+        { "--max-error",   &args->maxError },
+        { "--seed",        &args->seed },
+    };
+
+    for (const auto &option : options)
+    {
+        if (0 == strcmp(name, option.name))
+        {
+            *option.field = number;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   Runs the one- and two-finger scenarios, then times the single and the
+*   two-finger centroid.
+*
+* Return:
+*  0 if both scenarios pass, 1 otherwise, 2 for a usage error.
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    sim_args_t args =
+    {
+        .segments   = 5u,
+        .resolution = 300u,
+        .signal     = 200u,
+        .threshold  = 100u,
+        .noise      = 5u,
+        .widthPct   = 120u,
+        .minGapPct  = 250u,
+        .maxError   = 15u,
+        .seed       = 1u
+    };
+
+    for (int i = 1; i < argc; i += 2)
+    {
+        if ((i + 1 >= argc) || !sim_option(&args, argv[i], argv[i + 1]) || (args.segments < 2u) ||
+            (args.segments > SIM_MAX_SEGMENTS) || (0u == args.widthPct))
+        {
+            fprintf(stderr, "usage: %s [--segments n] [--resolution positions] [--signal counts]\n"
+                    "       [--threshold counts] [--noise counts] [--width-pct %%] [--min-gap-pct %%]\n"
+                    "       [--max-error positions] [--seed n]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::mt19937 rng(args.seed);
+    bool failed = false;
+
+    printf("scenario,frames,found_pct,extra,error_avg,error_max,result\n");
+    for (uint32_t count = 1u; count <= CAPSENSE_CENTROID_MAX_TOUCHES; count++)
+    {
+        const sim_result_t result = sim_run(&args, count, &rng);
+        const double foundPct = (100.0 * result.found) / result.frames;
+        const bool pass = (result.found == result.frames) && (result.errorMax <= args.maxError);
+
+        printf("%s,%lu,%.1f,%lu,%.2f,%.1f,%s\n", (1u == count) ? "one_finger" : "two_fingers",
+               (unsigned long)result.frames, foundPct, (unsigned long)result.extra,
+               result.found ? (result.errorSum / (result.found * count)) : 0.0, result.errorMax,
+               pass ? "ok" : "fail");
+        failed = failed || !pass;
+    }
+
+    const double one[CAPSENSE_CENTROID_MAX_TOUCHES] = { 1.3, 0.0 };
+    const double two[CAPSENSE_CENTROID_MAX_TOUCHES] = { 0.7, 3.4 };
+    uint16_t oneDiff[SIM_MAX_SEGMENTS];
+    uint16_t twoDiff[SIM_MAX_SEGMENTS];
+
+    sim_profile(&args, one, 1u, &rng, oneDiff);
+    sim_profile(&args, two, 2u, &rng, twoDiff);
+    printf("\nprofile,single_ns,two_finger_ns\n");
+    printf("one_finger,%.1f,%.1f\n", sim_time(&args, oneDiff, 1u), sim_time(&args, oneDiff, 2u));
+    printf("two_fingers,%.1f,%.1f\n", sim_time(&args, twoDiff, 1u), sim_time(&args, twoDiff, 2u));
+    return failed ? 1 : 0;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,233 @@
+/*******************************************************************************
+* File Name: capsense_event_check.cpp
+*
+* Description:
+*   Host check of the widget event dispatch. It builds capsense_event.cpp
+*   against the stand-ins in tools/host and lets a handler subscribe and
+*   unsubscribe from inside the dispatch, which the recursive mutex allows.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include "mbed.h"
+#include "../capsense_event.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Subscribers of every scenario, by descending priority */
+#define SIM_SUBSCRIBERS                         "ABC"
+#define SIM_NO_SUBSCRIBER                       ('-')
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef enum
+{
+    SIM_NONE,
+    SIM_UNSUBSCRIBE,        /* actor unsubscribes target */
+    SIM_SUBSCRIBE,          /* actor subscribes target with priority */
+    SIM_REPLACE             /* actor unsubscribes itself, then subscribes target with priority */
+} sim_action_t;
+
+/* The actor acts once, in its first call. Every scenario dispatches a press
+ * and a release of Button0; the calls of both are separated by '|'.
+ */
+typedef struct
+{
+    const char *name;
+    char actor;
+    sim_action_t action;
+    char target;
+    uint8_t priority;
+    const char *expected;
+} sim_scenario_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void sim_handler(const capsense_event_t *event, void *arg);
+
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+const sim_scenario_t sim_scenarios[] =
+{
+    { "none",                SIM_NO_SUBSCRIBER, SIM_NONE,        SIM_NO_SUBSCRIBER, 0u, "ABC|ABC"  },
+    { "unsubscribe_self",    'A',               SIM_UNSUBSCRIBE, 'A',               0u, "ABC|BC"   },
+    { "unsubscribe_earlier", 'B',               SIM_UNSUBSCRIBE, 'A',               0u, "ABC|BC"   },
+    { "unsubscribe_later",   'B',               SIM_UNSUBSCRIBE, 'C',               0u, "AB|AB"    },
+    { "subscribe_higher",    'B',               SIM_SUBSCRIBE,   'D',               9u, "ABC|DABC" },
+    { "subscribe_lower",     'A',               SIM_SUBSCRIBE,   'D',               0u, "ABC|ABCD" },
+    { "replace_self",        'A',               SIM_REPLACE,     'D',               9u, "ABC|DBC"  },
+};
+
+const sim_scenario_t *sim_scenario;
+bool sim_acted;
+int32_t sim_handles[26];
+std::string sim_calls;
+
+
+/*******************************************************************************
+* Function Name: sim_subscribe
+********************************************************************************
+* Summary:
+*   Subscribes the handler named by a letter to every event of every widget.
+*
+*******************************************************************************/
+static void sim_subscribe(char name, uint8_t priority)
+{
+    sim_handles[name - 'A'] = capsense_event_subscribe(CAPSENSE_EVENT_ALL_WIDGETS, CAPSENSE_EVENT_ALL, priority,
+                                                       sim_handler, (void *)(intptr_t)name);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_handler
+********************************************************************************
+* Summary:
+*   Records the call and, in the first call of the actor, changes the
+*   subscriptions from inside the dispatch.
+*
+*******************************************************************************/
+static void sim_handler(const capsense_event_t *event, void *arg)
+{
+    const char name = (char)(intptr_t)arg;
+
+    (void)event;
+    sim_calls += name;
+    if ((name != sim_scenario->actor) || sim_acted)
+    {
+        return;
+    }
+    sim_acted = true;
+    switch (sim_scenario->action)
+    {
+        case SIM_UNSUBSCRIBE:
+            capsense_event_unsubscribe(sim_handles[sim_scenario->target - 'A']);
+            break;
+        case SIM_REPLACE:
+            capsense_event_unsubscribe(sim_handles[name - 'A']);
+            sim_subscribe(sim_scenario->target, sim_scenario->priority);
+            break;
+        case SIM_SUBSCRIBE:
+            sim_subscribe(sim_scenario->target, sim_scenario->priority);
+            break;
+        default:
+            break;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_dispatch
+********************************************************************************
+* Summary:
+*   Dispatches one scan with Button0 touched or not.
+*
+*******************************************************************************/
+static void sim_dispatch(bool touched)
+{
+    capsense_touch_state_t state = {};
+
+    state.touched = touched ? 1u : 0u;
+    state.value[0] = touched ? 1u : 0u;
+    capsense_event_dispatch(&state, NULL, 0u, touched);
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   Runs every scenario: subscribes the handlers, dispatches a press and a
+*   release while one handler changes the subscriptions, and checks which
+*   handlers ran. A handler removed during a dispatch must not run again,
+*   no handler may be skipped or run twice for one event, and a handler
+*   added during a dispatch runs from the next event on.
+*
+* Return:
+*  0 if every scenario passes, 1 otherwise.
+*******************************************************************************/
+int main(void)
+{
+    bool failed = false;
+
+    for (int32_t &handle : sim_handles)
+    {
+        handle = CAPSENSE_EVENT_NO_HANDLE;
+    }
+    printf("scenario,calls,expected,result\n");
+    for (const sim_scenario_t &scenario : sim_scenarios)
+    {
+        sim_scenario = &scenario;
+        sim_acted = false;
+        sim_calls.clear();
+        for (const char *name = SIM_SUBSCRIBERS; '\0' != *name; name++)
+        {
+            sim_subscribe(*name, (uint8_t)(strlen(name)));
+        }
+
+        sim_dispatch(true);
+        sim_calls += '|';
+        sim_dispatch(false);
+
+        const bool pass = (sim_calls == scenario.expected);
+        printf("%s,%s,%s,%s\n", scenario.name, sim_calls.c_str(), scenario.expected, pass ? "ok" : "fail");
+        failed = failed || !pass;
+
+        for (int32_t &handle : sim_handles)
+        {
+            capsense_event_unsubscribe(handle);
+            handle = CAPSENSE_EVENT_NO_HANDLE;
+        }
+    }
+    return failed ? 1 : 0;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,392 @@
+#!/usr/bin/env python3
+"""
+Reports the RAM and flash taken by the CapSense configuration of every kit.
+
+The tool reads GeneratedSource/cycfg_capsense.c and cycfg_capsense.h of each
+COMPONENT_CUSTOM_DESIGN_MODUS/TARGET_<kit> and attributes every object the
+Configurator emits to a widget or to the shared part:
+
+    RAM    cy_capsense_tuner (common, widget and sensor contexts, positions),
+           cy_capsense_internalContext, cy_capsense_activeScanSns,
+           cy_capsense_context, debounce, noise envelope and history buffers
+    flash  cy_capsense_commonConfig, cy_capsense_fptrConfig, pin, electrode
+           and widget configuration tables, and the initial values of
+           cy_capsense_context
+
+cy_capsense_tuner is the buffer the Tuner reads and writes; it is counted as
+RAM only, although its initial values are part of .data.
+
+The sizes are taken from the GCC_ARM map file of the kit's build: --map, or
+else BUILD/<kit>/GCC_ARM/*.map below --build. Every object of
+cycfg_capsense.o in the map is counted with its linked size, including any
+the generated sources do not show. Without a map, the layout of
+cy_capsense_tuner is taken from the Tuner register offsets and the other
+structure sizes are those of CapSense MW 2.0 on the Cortex-M4, some of them
+estimated; such a report is marked as estimated.
+
+The totals are checked against capsense-ram-budget and capsense-flash-budget
+of mbed_app.json, including per-kit target_overrides. --check only accepts
+linked sizes and fails for a kit that has no map. capsense_footprint.cpp
+enforces the same budgets at compile time with the exact sizeof() values.
+
+Usage:
+    python tools/capsense_footprint.py                   summary of every kit
+    python tools/capsense_footprint.py --detail KIT      every object of one kit
+    python tools/capsense_footprint.py --check           fail if a built kit exceeds its budget
+    python tools/capsense_footprint.py --csv             all objects as CSV
+    python tools/capsense_footprint.py --kit KIT --map BUILD/.../app.map
+"""
+
+import argparse
+import collections
+import glob
+import json
+import os
+import re
+import sys
+
+import mapfile
+import tuner_map
+
+ROOT = tuner_map.ROOT
+DESIGN_DIR = tuner_map.DESIGN_DIR
+SHARED = "shared"
+
+# Sizes of the CapSense MW 2.0 structures on the Cortex-M4 (GCC_ARM)
+POINTER_SIZE = 4
+ESTIMATED = {
+    "cy_stc_capsense_internal_context_t": 160,
+    "cy_stc_active_scan_sns_t": 36,
+    "cy_stc_capsense_common_config_t": 160,
+    "cy_stc_capsense_context_t": 40,
+    "cy_stc_capsense_csx_touch_buffer_t": 64,
+    "cy_stc_capsense_csx_touch_history_t": 32,
+    "cy_stc_capsense_ballistic_context_t": 12,
+    "cy_stc_capsense_gesture_context_t": 88,
+}
+KNOWN = {
+    "cy_stc_capsense_pin_config_t": 8,
+    "cy_stc_capsense_electrode_config_t": 8,
+    "cy_stc_capsense_widget_config_t": 112,
+    "cy_stc_capsense_smartsense_csd_noise_envelope_t": 12,
+    "cy_stc_capsense_position_t": 8,
+    "cy_stc_capsense_touch_t": 8,
+}
+
+# (symbol, size macro, element type or size, widget configuration pointer)
+BUFFERS = (
+    ("cy_capsense_debounce", "DEBOUNCE_SIZE", 1, "ptrDebounceArr"),
+    ("cy_capsense_noiseEnvelope", "NOISE_ENVELOPE_SIZE", "cy_stc_capsense_smartsense_csd_noise_envelope_t", "ptrNoiseEnvelope"),
+    ("cy_capsense_rawFilterHistory", "RAW_HISTORY_SIZE", 2, "ptrRawFilterHistory"),
+    ("cy_capsense_iirHistoryLow", "IIR_HISTORY_LOW_SIZE", 1, "ptrRawFilterHistoryLow"),
+    ("cy_capsense_positionFilterHistory", "POSITION_FILTER_HISTORY_SIZE", "cy_stc_capsense_position_t", "ptrPosFilterHistory"),
+    ("cy_capsense_touchFilterHistory", "TOUCH_FILTER_HISTORY_SIZE", "cy_stc_capsense_touch_t", None),
+    ("cy_capsense_csdTouchBuffer", "CSD_TOUCHPAD_MAX_SENSORS_SIZE", 2, "ptrCsdTouchBuffer"),
+    ("cy_capsense_csxTouchBuffer", "CSX_TOUCH_BUFFER_ENABLE", "cy_stc_capsense_csx_touch_buffer_t", "ptrCsxTouchBuffer"),
+    ("cy_capsense_csxTouchHistory", "CSX_TOUCH_HISTORY_SIZE", "cy_stc_capsense_csx_touch_history_t", "ptrCsxTouchHistory"),
+    ("cy_capsense_ballisticContext", "BALLISTIC_WIDGET_COUNT", "cy_stc_capsense_ballistic_context_t", "ptrBallisticContext"),
+    ("cy_capsense_gestureContext", "GESTURE_WIDGET_COUNT", "cy_stc_capsense_gesture_context_t", "ptrGestureContext"),
+)
+CONST_BUFFERS = (
+    ("cy_capsense_diplexTable", "DIPLEX_SIZE", 1, "ptrDiplexTable"),
+)
+
+COUNT_RE = re.compile(r"#define\s+CY_CAPSENSE_(\w+)\s+\((\d+)u\)")
+WIDGET_RE = re.compile(r"\n    \{ /\* (\w+) \*/(.*?)\n    \},", re.S)
+
+Item = collections.namedtuple("Item", "owner name ram flash estimated")
+
+
+class FootprintError(Exception):
+    pass
+
+
+def align(value, boundary=POINTER_SIZE):
+    return (value + boundary - 1) // boundary * boundary
+
+
+def section(text, start, end):
+    first = text.find(start)
+    last = text.find(end, first)
+    if first < 0 or last < 0:
+        raise FootprintError("'{}' not found".format(start))
+    return text[first:last]
+
+
+class Config:
+    """Objects of one kit's generated CapSense configuration."""
+
+    def __init__(self, kit):
+        generated = os.path.join(DESIGN_DIR, "TARGET_" + kit, "GeneratedSource")
+        self.kit = kit
+        self.source = tuner_map.read(os.path.join(generated, "cycfg_capsense.c"))
+        self.header = tuner_map.read(os.path.join(generated, "cycfg_capsense.h"))
+        self.counts = {name: int(value) for name, value in COUNT_RE.findall(self.source)}
+
+        widgets = section(self.source, "cy_capsense_widgetConfig[CY_CAPSENSE_WIDGET_COUNT] =", "\n};")
+        self.widgets = [(name, block) for name, block in WIDGET_RE.findall(widgets)]
+        if len(self.widgets) != self.counts["WIDGET_COUNT"]:
+            raise FootprintError("cy_capsense_widgetConfig[] has {} entries, CY_CAPSENSE_WIDGET_COUNT is {}"
+                                 .format(len(self.widgets), self.counts["WIDGET_COUNT"]))
+
+        electrodes = section(self.source, "cy_capsense_electrodeConfig[CY_CAPSENSE_ELTD_COUNT] =", "\n};")
+        self.electrode_pins = [int(n) for n in re.findall(r"\.numPins = (\d+)u,", electrodes)]
+
+        contexts = section(self.source, ".widgetContext = {", "\n    .sensorContext")
+        self.positions = [int(n) for n in re.findall(r"\.numPosition = (\d+),", contexts)]
+
+        fptr = section(self.source, "cy_capsense_fptrConfig =", "\n};")
+        self.sizes = dict(ESTIMATED)
+        self.sizes.update(KNOWN)
+        self.sizes["cy_stc_capsense_fptr_config_t"] = POINTER_SIZE * len(set(re.findall(r"\.(fptr\w+)", fptr)))
+        self.estimated = set(ESTIMATED)
+        self.linked = {}
+        self.tuner_layout()
+
+    def tuner_layout(self):
+        """Derives the cy_capsense_tuner layout from the Tuner register offsets."""
+        registers = tuner_map.parse_registers(self.header)
+        offset = {member: off for _, member, off, _, _ in registers}
+        end = max(off + size for _, _, off, size, _ in registers)
+        try:
+            widget = offset["widgetContext[0].fingerCap"]
+            sensor = offset["sensorContext[0].raw"]
+        except KeyError as e:
+            raise FootprintError("Tuner register {} is missing".format(e))
+        position = offset.get("position[0].x", end)
+        self.common_context = widget
+        self.widget_context = (sensor - widget) // self.counts["WIDGET_COUNT"]
+        self.sensor_context = (position - sensor) // self.counts["SENSOR_COUNT"]
+        self.position = self.sizes["cy_stc_capsense_position_t"]
+        self.tuner = align(end)
+
+    def size_of(self, element):
+        return self.sizes[element] if isinstance(element, str) else element
+
+    def use_map(self, path):
+        """Replaces the structure sizes with the sizes of the linked objects."""
+        for s in mapfile.parse(path):
+            if s.obj == "cycfg_capsense.o":
+                size, kind = self.linked.get(mapfile.symbol_of(s), (0, s.kind))
+                self.linked[mapfile.symbol_of(s)] = (size + s.size, kind)
+        if not self.linked:
+            raise FootprintError("{} does not contain cycfg_capsense.o".format(path))
+        symbols = {symbol: size for symbol, (size, _) in self.linked.items()}
+        for symbol, element, count in (
+                ("cy_capsense_internalContext", "cy_stc_capsense_internal_context_t", 1),
+                ("cy_capsense_activeScanSns", "cy_stc_active_scan_sns_t", 1),
+                ("cy_capsense_commonConfig", "cy_stc_capsense_common_config_t", 1),
+                ("cy_capsense_fptrConfig", "cy_stc_capsense_fptr_config_t", 1),
+                ("cy_capsense_context", "cy_stc_capsense_context_t", 1),
+                ("cy_capsense_widgetConfig", "cy_stc_capsense_widget_config_t", self.counts["WIDGET_COUNT"]),
+                ("cy_capsense_electrodeConfig", "cy_stc_capsense_electrode_config_t", self.counts["ELTD_COUNT"]),
+                ("cy_capsense_pinConfig", "cy_stc_capsense_pin_config_t", self.counts["PIN_COUNT"])):
+            if symbol in symbols:
+                self.sizes[element] = symbols[symbol] // count
+                self.estimated.discard(element)
+        if "cy_capsense_tuner" in symbols:
+            self.tuner = symbols["cy_capsense_tuner"]
+        self.estimated.clear()
+
+    def items(self):
+        items = []
+
+        def add(owner, name, ram=0, flash=0, element=None):
+            # With a map, objects the linker dropped take nothing
+            if self.linked and name.split(".")[0].split(" ")[0] not in self.linked:
+                return
+            items.append(Item(owner, name, ram, flash, element in self.estimated))
+
+        # The Tuner buffer counts as RAM only
+        add(SHARED, "cy_capsense_tuner.commonContext", ram=self.common_context)
+        tuner_used = self.common_context
+        for (name, _), positions in zip(self.widgets, self.positions):
+            size = self.widget_context
+            add(name, "cy_capsense_tuner.widgetContext", ram=size)
+            tuner_used += size
+            if positions:
+                size = positions * self.position
+                add(name, "cy_capsense_tuner.position", ram=size)
+                tuner_used += size
+        sensors = self.sensor_counts()
+        for name, _ in self.widgets:
+            size = sensors[name] * self.sensor_context
+            add(name, "cy_capsense_tuner.sensorContext", ram=size)
+            tuner_used += size
+        if self.tuner > tuner_used:
+            add(SHARED, "cy_capsense_tuner padding", ram=self.tuner - tuner_used)
+
+        for symbol, element in (("cy_capsense_internalContext", "cy_stc_capsense_internal_context_t"),
+                                ("cy_capsense_activeScanSns", "cy_stc_active_scan_sns_t")):
+            add(SHARED, symbol, ram=self.sizes[element], element=element)
+        size = self.sizes["cy_stc_capsense_context_t"]
+        add(SHARED, "cy_capsense_context", size, size, "cy_stc_capsense_context_t")
+        for symbol, element in (("cy_capsense_commonConfig", "cy_stc_capsense_common_config_t"),
+                                ("cy_capsense_fptrConfig", "cy_stc_capsense_fptr_config_t")):
+            add(SHARED, symbol, flash=self.sizes[element], element=element)
+
+        for buffers, ram in ((BUFFERS, True), (CONST_BUFFERS, False)):
+            for symbol, count, element, pointer in buffers:
+                slices = self.buffer_slices(symbol, self.counts.get(count, 0), pointer)
+                sizes = [elements * self.size_of(element) for _, elements in slices]
+                if symbol in self.linked and sum(sizes):
+                    sizes = self.scale(sizes, self.linked[symbol][0])
+                for (owner, _), size in zip(slices, sizes):
+                    if size:
+                        add(owner, symbol, ram=size if ram else 0, flash=0 if ram else size,
+                            element=element if isinstance(element, str) else None)
+
+        eltd = self.widget_indices("ptrEltdConfig", "cy_capsense_electrodeConfig")
+        starts = [eltd[name] for name, _ in self.widgets] + [len(self.electrode_pins)]
+        for (name, _), first, last in zip(self.widgets, starts, starts[1:]):
+            add(name, "cy_capsense_widgetConfig", flash=self.sizes["cy_stc_capsense_widget_config_t"],
+                element="cy_stc_capsense_widget_config_t")
+            add(name, "cy_capsense_electrodeConfig",
+                flash=(last - first) * self.sizes["cy_stc_capsense_electrode_config_t"])
+            add(name, "cy_capsense_pinConfig",
+                flash=sum(self.electrode_pins[first:last]) * self.sizes["cy_stc_capsense_pin_config_t"])
+        shield = self.counts.get("SHIELD_PIN_COUNT", 0)
+        if shield:
+            add(SHARED, "cy_capsense_shieldPinConfig", flash=shield * self.sizes["cy_stc_capsense_pin_config_t"])
+
+        # Linked objects the generated sources do not show, such as the BIST context
+        named = {item.name.split(".")[0].split(" ")[0] for item in items}
+        for symbol, (size, kind) in sorted(self.linked.items()):
+            if symbol not in named:
+                add(SHARED, symbol, ram=size if kind in (mapfile.RAM, mapfile.BOTH) else 0,
+                    flash=size if kind in (mapfile.FLASH, mapfile.BOTH) else 0)
+        return items
+
+    @staticmethod
+    def scale(sizes, total):
+        """Scales the slices of a buffer to its linked size."""
+        scaled = [size * total // sum(sizes) for size in sizes]
+        scaled[-1] += total - sum(scaled)
+        return scaled
+
+    def widget_indices(self, pointer, symbol):
+        indices = {}
+        for name, block in self.widgets:
+            match = re.search(r"\.{} = &{}\[(\d+)u\],".format(pointer, symbol), block)
+            if match:
+                indices[name] = int(match.group(1))
+        return indices
+
+    def sensor_counts(self):
+        return {name: int(re.search(r"\.numSns = (\d+)u,", block).group(1)) for name, block in self.widgets}
+
+    def buffer_slices(self, symbol, size, pointer):
+        """Splits a buffer between the widgets that point into it."""
+        if size == 0:
+            return []
+        if pointer is None:
+            return [(SHARED, size)]
+        indices = self.widget_indices(pointer, symbol)
+        whole = [name for name, block in self.widgets
+                 if re.search(r"\.{} = &{},".format(pointer, symbol), block)]
+        if whole:
+            return [(SHARED, size)]
+        starts = sorted(indices.items(), key=lambda i: i[1])
+        if not starts:
+            return [(SHARED, size)]
+        slices = [(SHARED, starts[0][1])] if starts[0][1] else []
+        for (name, first), (_, last) in zip(starts, starts[1:] + [(None, size)]):
+            slices.append((name, last - first))
+        return slices
+
+def find_map(build, kit):
+    """Map file of the GCC_ARM build of a kit below the build directory, or None."""
+    maps = glob.glob(os.path.join(build, kit, "GCC_ARM", "*.map"))
+    return max(maps, key=os.path.getmtime) if maps else None
+
+
+def budgets(kit):
+    """Returns (RAM, flash) budgets of a kit from mbed_app.json."""
+    with open(os.path.join(ROOT, "mbed_app.json")) as f:
+        app = json.load(f)
+    values = {name: app["config"][name]["value"]
+              for name in ("capsense-ram-budget", "capsense-flash-budget")}
+    for name in values:
+        override = app.get("target_overrides", {}).get(kit, {})
+        for key in (name, "app." + name):
+            if key in override:
+                values[name] = override[key]
+    return values["capsense-ram-budget"], values["capsense-flash-budget"]
+
+
+def totals(items):
+    ram = sum(i.ram for i in items)
+    flash = sum(i.flash for i in items)
+    return ram, flash
+
+
+def summary(kit, items, out):
+    owners = collections.OrderedDict()
+    for item in items:
+        if item.owner != SHARED:
+            owners.setdefault(item.owner, []).append(item)
+    owners[SHARED] = [i for i in items if i.owner == SHARED]
+    approx = any(i.estimated for i in items)
+    print("{:<28}{:>8}{:>8}".format(kit, "RAM", "flash"), file=out)
+    for owner, owned in owners.items():
+        print("  {:<26}{:>8}{:>8}".format(owner, *totals(owned)), file=out)
+    ram, flash = totals(items)
+    ram_budget, flash_budget = budgets(kit)
+    print("  {:<26}{:>8}{:>8}{}".format("total", ram, flash, "  (estimated)" if approx else ""), file=out)
+    print("  {:<26}{:>8}{:>8}".format("budget", ram_budget, flash_budget), file=out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--kit", help="report one kit only")
+    parser.add_argument("--map", help="GCC_ARM map file of --kit (default: the one below --build)")
+    parser.add_argument("--build", default=os.path.join(ROOT, "BUILD"),
+                        help="Mbed CLI build directory with BUILD/<kit>/GCC_ARM/*.map (default %(default)s)")
+    parser.add_argument("--detail", action="store_true", help="list every object")
+    parser.add_argument("--csv", action="store_true", help="print all objects as CSV")
+    parser.add_argument("--check", action="store_true", help="fail if a kit exceeds its budget")
+    args = parser.parse_args()
+    if args.map and not args.kit:
+        parser.error("--map needs --kit")
+
+    status = 0
+    if args.csv:
+        print("kit,owner,object,ram,flash,estimated")
+    for kit in [args.kit] if args.kit else tuner_map.kits():
+        path = args.map or find_map(args.build, kit)
+        if path is None and args.check:
+            print("{}: no GCC_ARM map file below {}; build the kit or pass --kit with --map"
+                  .format(kit, args.build), file=sys.stderr)
+            status = 1
+            continue
+        try:
+            config = Config(kit)
+            if path:
+                config.use_map(path)
+            items = config.items()
+        except (FootprintError, tuner_map.MapError) as e:
+            print("{}: {}".format(kit, e), file=sys.stderr)
+            status = 1
+            continue
+
+        if args.csv:
+            for i in items:
+                print("{},{},{},{},{},{}".format(kit, i.owner, i.name, i.ram, i.flash, int(i.estimated)))
+        elif args.detail:
+            for i in items:
+                print("{:<24}{:<36}{:>8}{:>8}{}".format(i.owner, i.name, i.ram, i.flash, " *" if i.estimated else ""))
+        if not args.csv:
+            summary(kit, items, sys.stdout)
+
+        ram, flash = totals(items)
+        ram_budget, flash_budget = budgets(kit)
+        if ram > ram_budget or flash > flash_budget:
+            print("{}: CapSense footprint {} B RAM / {} B flash exceeds the budget of {} B / {} B"
+                  .format(kit, ram, flash, ram_budget, flash_budget), file=sys.stderr)
+            if args.check:
+                status = 1
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,380 @@
+#!/usr/bin/env python3
+"""
+Generates a synthetic CapSense configuration with an arbitrary widget count.
+
+The output replaces GeneratedSource/cycfg_capsense.c and cycfg_capsense.h of
+one kit. It keeps the common, function-pointer and pin-check sections of the
+kit's Configurator output verbatim and regenerates the pin, electrode, widget
+and tuner tables for N buttons, M linear sliders and K CSX matrix buttons in
+the same layout. The synthetic electrodes reuse the kit's sensor pins round
+robin, so the configuration scans and calibrates on the unmodified board: it
+measures firmware cost, not sensor performance.
+
+The output has no Tuner register map. Build it only with the
+"capsense-benchmark" application option, which skips the layout and register
+map checks of capsense_layout.cpp and capsense_tuner_map.cpp.
+
+Usage:
+    python tools/capsense_gen.py --buttons 48 --out DIR
+    python tools/capsense_gen.py --buttons 16 --sliders 2 --matrix 2 --kit CY8CPROTO_062_4343W --install
+
+--install overwrites the kit's GeneratedSource; restore it with
+"git checkout COMPONENT_CUSTOM_DESIGN_MODUS".
+"""
+
+import argparse
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DESIGN_DIR = os.path.join(ROOT, "COMPONENT_CUSTOM_DESIGN_MODUS")
+DEFAULT_KIT = "CY8CPROTO_062_4343W"
+GENERATED = ("cycfg_capsense.c", "cycfg_capsense.h")
+
+DEFINE_WIDTH = 73
+TUNER_ADDRESS_LIMIT = 0x10000
+
+WD_BUTTON = "CY_CAPSENSE_WD_BUTTON_E"
+WD_MATRIX = "CY_CAPSENSE_WD_MATRIX_BUTTON_E"
+WD_SLIDER = "CY_CAPSENSE_WD_LINEAR_SLIDER_E"
+CSD = "CY_CAPSENSE_SENSE_METHOD_CSD_E"
+CSX = "CY_CAPSENSE_SENSE_METHOD_CSX_E"
+ELTD_RX = "CY_CAPSENSE_ELTD_TYPE_MUT_RX_E"
+ELTD_TX = "CY_CAPSENSE_ELTD_TYPE_MUT_TX_E"
+ELTD_SELF = "CY_CAPSENSE_ELTD_TYPE_SELF_E"
+
+# Approximate sizes of the MW 2.0 structures, for the sub-address check only.
+COMMON_CONTEXT_SIZE = 40
+WIDGET_CONTEXT_SIZE = 48
+SENSOR_CONTEXT_SIZE = 10
+POSITION_SIZE = 8
+
+
+class GenError(Exception):
+    pass
+
+
+def read(path):
+    with open(path) as f:
+        return f.read()
+
+
+def define(name, value):
+    return "#define {}({}u)".format(name.ljust(DEFINE_WIDTH), value)
+
+
+def between(text, start, end):
+    first = text.find(start)
+    last = text.find(end, first)
+    if first < 0 or last < 0:
+        raise GenError("section '{}' not found in the template".format(start.strip()))
+    return first, last
+
+
+def blocks(text, start, end):
+    """Splits the initializer between start and end into its top-level entries."""
+    first, last = between(text, start, end)
+    return re.findall(r"\n(    \{.*?\n    \},)", text[first:last], re.S)
+
+
+class Widget:
+    def __init__(self, name, wd_type, sense, electrodes, num_sns, cols, rows):
+        self.name = name
+        self.wd_type = wd_type
+        self.sense = sense
+        self.electrodes = electrodes  # [(electrode name, type, pool)]
+        self.num_sns = num_sns
+        self.cols = cols
+        self.rows = rows
+
+    @property
+    def debounce(self):
+        return self.num_sns if self.wd_type in (WD_BUTTON, WD_MATRIX) else 1
+
+    @property
+    def noise_envelope(self):
+        return self.num_sns if self.sense == CSD else 0
+
+    @property
+    def positions(self):
+        return 1 if self.wd_type == WD_SLIDER else 0
+
+
+class Template:
+    """The Configurator output of one kit."""
+
+    def __init__(self, kit):
+        base = os.path.join(DESIGN_DIR, "TARGET_" + kit, "GeneratedSource")
+        if not os.path.isdir(base):
+            raise GenError("unknown kit " + kit)
+        self.kit = kit
+        self.source = read(os.path.join(base, GENERATED[0]))
+        self.header = read(os.path.join(base, GENERATED[1]))
+
+        self.pins = {"rx": [], "tx": [], "self": []}
+        for name in re.findall(r"\{ /\* (\w+) \*/\n\s+\w+_PORT,",
+                               self.source[slice(*between(self.source, "cy_capsense_pinConfig[", "\n};"))]):
+            if re.search(r"_Rx\d+$", name):
+                self.pins["rx"].append(name)
+            elif name.endswith("_Tx"):
+                self.pins["tx"].append(name)
+            else:
+                self.pins["self"].append(name)
+
+        widgets = blocks(self.source, "cy_capsense_widgetConfig[CY_CAPSENSE_WIDGET_COUNT] =", "\n};")
+        contexts = re.findall(r"\n(        \{.*?\n        \},)", self.source[slice(*between(
+            self.source, ".widgetContext = {", "\n    .sensorContext"))], re.S)
+        self.sensor_context = re.findall(r"\n(        \{.*?\n        \},)", self.source[slice(*between(
+            self.source, ".sensorContext = {", "\n    .position"))], re.S)[0]
+
+        self.widget_config = {}
+        self.widget_context = {}
+        for config, context in zip(widgets, contexts):
+            wd_type = re.search(r"\.wdType = (\w+),", config).group(1)
+            self.widget_config.setdefault(wd_type, config)
+            self.widget_context.setdefault(wd_type, context)
+        if WD_BUTTON not in self.widget_config or WD_SLIDER not in self.widget_config:
+            raise GenError("{} has no button or linear slider to use as a template".format(kit))
+        self.button_sense = re.search(r"\.senseMethod = (\w+),", self.widget_config[WD_BUTTON]).group(1)
+
+
+def layout(template, buttons, sliders, segments, matrix, rx, tx):
+    """Returns the widget list in widget ID order: buttons, sliders, matrices."""
+    if template.button_sense == CSX:
+        if not template.pins["rx"] or not template.pins["tx"]:
+            raise GenError("{} has no CSX electrodes".format(template.kit))
+    elif matrix:
+        raise GenError("{} uses CSD buttons; CSX matrix buttons need a CSX kit".format(template.kit))
+
+    widgets = []
+    for i in range(buttons):
+        name = "Button{}".format(i)
+        if template.button_sense == CSX:
+            electrodes = [(name + "_Rx0", ELTD_RX, "rx"), (name + "_Tx", ELTD_TX, "tx")]
+        else:
+            electrodes = [(name + "_Sns0", ELTD_SELF, "self")]
+        widgets.append(Widget(name, WD_BUTTON, template.button_sense, electrodes, 1, 1, 1))
+    for i in range(sliders):
+        name = "LinearSlider{}".format(i)
+        electrodes = [("{}_Sns{}".format(name, s), ELTD_SELF, "self") for s in range(segments)]
+        widgets.append(Widget(name, WD_SLIDER, CSD, electrodes, segments, segments, 0))
+    for i in range(matrix):
+        name = "MatrixButton{}".format(i)
+        electrodes = ([("{}_Rx{}".format(name, r), ELTD_RX, "rx") for r in range(rx)] +
+                      [("{}_Tx{}".format(name, t), ELTD_TX, "tx") for t in range(tx)])
+        widgets.append(Widget(name, WD_MATRIX, CSX, electrodes, rx * tx, rx, tx))
+    if not widgets:
+        raise GenError("no widgets requested")
+    return widgets
+
+
+def counts(widgets):
+    return {
+        "WIDGET_COUNT": len(widgets),
+        "SENSOR_COUNT": sum(w.num_sns for w in widgets),
+        "ELTD_COUNT": sum(len(w.electrodes) for w in widgets),
+        "PIN_COUNT": sum(len(w.electrodes) for w in widgets),
+        "POSITION_SIZE": max(1, sum(w.positions for w in widgets)),
+        "DEBOUNCE_SIZE": sum(w.debounce for w in widgets),
+        "NOISE_ENVELOPE_SIZE": sum(w.noise_envelope for w in widgets),
+    }
+
+
+def tuner_size(total):
+    return (COMMON_CONTEXT_SIZE + total["WIDGET_COUNT"] * WIDGET_CONTEXT_SIZE +
+            total["SENSOR_COUNT"] * SENSOR_CONTEXT_SIZE + total["POSITION_SIZE"] * POSITION_SIZE)
+
+
+def replace(text, pattern, value):
+    result, n = re.subn(pattern, value, text)
+    if n != 1:
+        raise GenError("pattern {} matched {} times".format(pattern, n))
+    return result
+
+
+def render_source(template, widgets, total):
+    src = template.source
+    head_end = src.find("static const cy_stc_capsense_pin_config_t cy_capsense_pinConfig")
+    tail_start = src.find("#if (CY_CAPSENSE_BIST_SUPPORTED)\n#if (CY_CAPSENSE_BIST_EN != 0)\n#define")
+    if head_end < 0 or tail_start < 0:
+        raise GenError("unexpected cycfg_capsense.c layout")
+    head = src[:head_end]
+    for name, value in total.items():
+        head = replace(head, r"#define CY_CAPSENSE_{}\s+\(\d+u\)".format(name),
+                       define("CY_CAPSENSE_" + name, value))
+
+    next_pin = {key: 0 for key in template.pins}
+
+    def take(pool):
+        names = template.pins[pool]
+        name = names[next_pin[pool] % len(names)]
+        next_pin[pool] += 1
+        return name
+
+    pins = []
+    electrodes = []
+    for widget in widgets:
+        for name, eltd_type, pool in widget.electrodes:
+            pin = take(pool)
+            pins.append("    {{ /* {} */\n        {}_PORT,\n        {}_PIN,\n    }},".format(name, pin, pin))
+            electrodes.append("    {{ /* {} */\n        .ptrPin = &cy_capsense_pinConfig[{}u],\n"
+                              "        .type = {},\n        .numPins = 1u,\n    }},"
+                              .format(name, len(electrodes), eltd_type))
+
+    shield = src[slice(*between(src, "#if (CY_CAPSENSE_SHIELD_PIN_COUNT > 0)", "static const cy_stc_capsense_electrode_config_t"))]
+
+    configs = []
+    contexts = []
+    sns = eltd = debounce = noise = position = 0
+    for wd_id, widget in enumerate(widgets):
+        base = WD_BUTTON if widget.wd_type == WD_MATRIX else widget.wd_type
+        config = template.widget_config[base]
+        config = replace(config, r"\{ /\* \w+ \*/", "{{ /* {} */".format(widget.name))
+        config = replace(config, r"widgetContext\[\d+u\]", "widgetContext[{}u]".format(wd_id))
+        config = replace(config, r"sensorContext\[\d+u\]", "sensorContext[{}u]".format(sns))
+        config = replace(config, r"cy_capsense_electrodeConfig\[\d+u\]", "cy_capsense_electrodeConfig[{}u]".format(eltd))
+        config = replace(config, r"\.ptrDebounceArr = [^,]+,", ".ptrDebounceArr = &cy_capsense_debounce[{}u],".format(debounce))
+        config = replace(config, r"\.ptrNoiseEnvelope = [^,]+,", ".ptrNoiseEnvelope = {},".format(
+            "&cy_capsense_noiseEnvelope[{}u]".format(noise) if widget.noise_envelope else "NULL"))
+        config = replace(config, r"\.numSns = \d+u,", ".numSns = {}u,".format(widget.num_sns))
+        config = replace(config, r"\.numCols = \d+u,", ".numCols = {}u,".format(widget.cols))
+        config = replace(config, r"\.numRows = \d+u,", ".numRows = {}u,".format(widget.rows))
+        config = replace(config, r"\.senseMethod = \w+,", ".senseMethod = {},".format(widget.sense))
+        config = replace(config, r"\.wdType = \w+,", ".wdType = {},".format(widget.wd_type))
+        configs.append(config)
+
+        context = template.widget_context[base]
+        if widget.positions:
+            context = replace(context, r"position\[\d+u\]", "position[{}u]".format(position))
+        contexts.append(context)
+
+        sns += widget.num_sns
+        eltd += len(widget.electrodes)
+        debounce += widget.debounce
+        noise += widget.noise_envelope
+        position += widget.positions
+
+    tuner_head = src[slice(*between(src, "cy_stc_capsense_tuner_t cy_capsense_tuner =", "\n    .widgetContext = {"))]
+    position_block = src[slice(*between(src, "    .position = {", "\n};"))]
+    position_entry = re.search(r"\n(        \{.*?\n        \},)", position_block, re.S).group(1)
+
+    body = [
+        "static const cy_stc_capsense_pin_config_t cy_capsense_pinConfig[CY_CAPSENSE_PIN_COUNT] =\n{",
+        "\n".join(pins),
+        "};\n",
+        shield.rstrip("\n") + "\n",
+        "static const cy_stc_capsense_electrode_config_t cy_capsense_electrodeConfig[CY_CAPSENSE_ELTD_COUNT] =\n{",
+        "\n".join(electrodes),
+        "};\n",
+        "static const cy_stc_capsense_widget_config_t cy_capsense_widgetConfig[CY_CAPSENSE_WIDGET_COUNT] =\n{",
+        "\n".join(configs),
+        "};\n",
+        tuner_head,
+        "    .widgetContext = {",
+        "\n".join(contexts),
+        "    },",
+        "    .sensorContext = {",
+        "\n".join([template.sensor_context] * total["SENSOR_COUNT"]),
+        "    },",
+        "    .position = {",
+        "\n".join([position_entry] * total["POSITION_SIZE"]),
+        "    },",
+        "};\n",
+    ]
+    return head + "\n".join(body) + "\n" + src[tail_start:]
+
+
+def render_header(template, widgets, total):
+    hdr = template.header
+    ids_start, ids_end = between(hdr, "/*Widget names */", "/* Sensing Methods */")
+    names = ["/*Widget names */"]
+    for wd_id, widget in enumerate(widgets):
+        names.append(define("CY_CAPSENSE_{}_WDGT_ID".format(widget.name.upper()), wd_id))
+    names.append("")
+    for widget in widgets:
+        names.append("/* {} sensor names */".format(widget.name))
+        for s in range(widget.num_sns):
+            names.append(define("CY_CAPSENSE_{}_SNS{}_ID".format(widget.name.upper(), s), s))
+        names.append("")
+    hdr = hdr[:ids_start] + "\n".join(names) + "\n" + hdr[ids_end:]
+
+    def enable(flag, on):
+        return replace(hdr, r"#define CY_CAPSENSE_{}\s+\(\d+u\)".format(flag),
+                       define("CY_CAPSENSE_" + flag, 1 if on else 0))
+
+    types = {(w.sense, w.wd_type) for w in widgets}
+    hdr = enable("CSD_BUTTON_EN", (CSD, WD_BUTTON) in types)
+    hdr = enable("CSX_BUTTON_EN", (CSX, WD_BUTTON) in types)
+    hdr = enable("CSX_MATRIX_EN", (CSX, WD_MATRIX) in types)
+    hdr = enable("CSD_SLIDER_EN", (CSD, WD_SLIDER) in types)
+    hdr = enable("CSD_LINEAR_SLIDER_EN", (CSD, WD_SLIDER) in types)
+
+    hdr = replace(hdr, r"widgetContext\[\d+\];", "widgetContext[{}];".format(total["WIDGET_COUNT"]))
+    hdr = replace(hdr, r"sensorContext\[\d+\];", "sensorContext[{}];".format(total["SENSOR_COUNT"]))
+    hdr = replace(hdr, r"position\[\d+\];", "position[{}];".format(total["POSITION_SIZE"]))
+
+    # The register map describes the shipped layout only.
+    regs_start, regs_end = between(hdr, "/* RAM Data structure register definitions */",
+                                   "#if (CY_CAPSENSE_BIST_SUPPORTED)\n#if (CY_CAPSENSE_BIST_EN != 0)\nextern")
+    return hdr[:regs_start] + "/* Synthetic configuration: no Tuner register map */\n\n" + hdr[regs_end:]
+
+
+def banner(text, kit, args):
+    return replace(text, r"\* CapSense Middleware configuration\n\* This file should not be modified\. "
+                   r"It was automatically generated by\n\* CapSense Configurator [\d.]+\n",
+                   "* Synthetic CapSense Middleware configuration for benchmarking\n"
+                   "* Generated by tools/capsense_gen.py from the {} configuration\n"
+                   "* ({}). Not for use with the CapSense Tuner.\n".format(kit, args))
+
+
+def generate(kit=DEFAULT_KIT, buttons=0, sliders=0, segments=5, matrix=0, rx=2, tx=2):
+    """Returns the text of (cycfg_capsense.c, cycfg_capsense.h) and the widget counts."""
+    template = Template(kit)
+    widgets = layout(template, buttons, sliders, segments, matrix, rx, tx)
+    total = counts(widgets)
+    if tuner_size(total) > TUNER_ADDRESS_LIMIT:
+        raise GenError("cy_stc_capsense_tuner_t exceeds the EZI2C sub-address range")
+    args = "buttons={} sliders={}x{} matrix={}x{}x{}".format(buttons, sliders, segments, matrix, rx, tx)
+    source = banner(render_source(template, widgets, total), kit, args)
+    header = banner(render_header(template, widgets, total), kit, args)
+    return source, header, total
+
+
+def write(directory, source, header):
+    os.makedirs(directory, exist_ok=True)
+    for name, text in zip(GENERATED, (source, header)):
+        with open(os.path.join(directory, name), "w") as f:
+            f.write(text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--kit", default=DEFAULT_KIT, help="template kit (default %(default)s)")
+    parser.add_argument("--buttons", type=int, default=0, help="number of buttons, same sensing method as the kit")
+    parser.add_argument("--sliders", type=int, default=0, help="number of CSD linear sliders")
+    parser.add_argument("--segments", type=int, default=5, help="segments per slider (default %(default)s)")
+    parser.add_argument("--matrix", type=int, default=0, help="number of CSX matrix buttons")
+    parser.add_argument("--rx", type=int, default=2, help="Rx electrodes per matrix button (default %(default)s)")
+    parser.add_argument("--tx", type=int, default=2, help="Tx electrodes per matrix button (default %(default)s)")
+    output = parser.add_mutually_exclusive_group(required=True)
+    output.add_argument("--out", help="directory to write cycfg_capsense.c/.h to")
+    output.add_argument("--install", action="store_true", help="overwrite the kit's GeneratedSource")
+    args = parser.parse_args()
+
+    try:
+        source, header, total = generate(args.kit, args.buttons, args.sliders, args.segments,
+                                         args.matrix, args.rx, args.tx)
+    except GenError as e:
+        print("capsense_gen: " + str(e), file=sys.stderr)
+        return 1
+
+    directory = args.out or os.path.join(DESIGN_DIR, "TARGET_" + args.kit, "GeneratedSource")
+    write(directory, source, header)
+    print("{}: {} widgets, {} sensors, {} electrodes".format(
+        directory, total["WIDGET_COUNT"], total["SENSOR_COUNT"], total["ELTD_COUNT"]))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,450 @@
+/*******************************************************************************
+* File Name: capsense_gesture_replay.cpp
+*
+* Description:
+*   Host replay of the slider gesture engine, capsense_gesture.cpp. Scripted
+*   scenarios are sampled at the scan period with position noise and fed
+*   through the engine with the default configuration of the firmware; every
+*   scenario must give exactly its expected gestures. A recorded trace with
+*   the columns time_ms and position, empty for scans without touch, can be
+*   replayed with --csv to print its gestures.
+*
+*   Build with CMake from the tools directory, for example: cmake -S tools -B
+*   build-tools && cmake --build build-tools && build-
+*   tools/capsense_gesture_replay --jitter 3
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "../capsense_gesture.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define REPLAY_MAX_STROKES                      (3u)
+#define REPLAY_MAX_GESTURES                     (3u)
+
+static const char *const REPLAY_GESTURE_NAMES[] = { "none", "tap", "double_tap", "long_press", "swipe", "flick" };
+static const char *const REPLAY_DIR_NAMES[] = { "", "_right", "_left" };
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    const char *csv;
+    uint32_t range;         /* Slider resolution */
+    uint32_t periodMs;      /* Scan period */
+    uint32_t jitter;        /* Position noise, +/- positions */
+    uint32_t longPressMs;
+    uint32_t seed;
+} replay_args_t;
+
+/* One finger on the slider, moving at constant speed. Times in ms and
+ * positions in percent of the range.
+ */
+typedef struct
+{
+    uint32_t startMs;
+    uint32_t lengthMs;
+    uint32_t from;
+    uint32_t to;
+} replay_stroke_t;
+
+typedef struct
+{
+    uint32_t gesture;
+    uint32_t direction;
+} replay_expect_t;
+
+typedef struct
+{
+    const char *name;
+    replay_stroke_t strokes[REPLAY_MAX_STROKES];
+    replay_expect_t expect[REPLAY_MAX_GESTURES];
+} replay_scenario_t;
+
+/* Scan of a trace: touched, and the position if so */
+typedef struct
+{
+    uint32_t timeMs;
+    bool touched;
+    uint32_t position;
+} replay_scan_t;
+
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+/* Scripted touches of the default configuration and the gestures they must
+ * give, in order. Unused strokes and expectations are zero.
+ */
+static const replay_scenario_t replay_scenarios[] =
+{
+    { "tap",            { { 100u, 100u, 50u, 50u } },
+                        { { CAPSENSE_GESTURE_TAP, CAPSENSE_GESTURE_DIR_NONE } } },
+    { "double_tap",     { { 100u, 100u, 50u, 50u }, { 340u, 80u, 52u, 52u } },
+                        { { CAPSENSE_GESTURE_DOUBLE_TAP, CAPSENSE_GESTURE_DIR_NONE } } },
+    { "two_taps",       { { 100u, 100u, 20u, 20u }, { 800u, 100u, 80u, 80u } },
+                        { { CAPSENSE_GESTURE_TAP, CAPSENSE_GESTURE_DIR_NONE },
+                          { CAPSENSE_GESTURE_TAP, CAPSENSE_GESTURE_DIR_NONE } } },
+    { "long_press",     { { 100u, 1200u, 30u, 30u } },
+                        { { CAPSENSE_GESTURE_LONG_PRESS, CAPSENSE_GESTURE_DIR_NONE } } },
+    { "long_then_drag", { { 100u, 1600u, 30u, 30u }, { 1700u, 0u, 0u, 0u } },
+                        { { CAPSENSE_GESTURE_LONG_PRESS, CAPSENSE_GESTURE_DIR_NONE } } },
+    { "swipe_right",    { { 100u, 600u, 10u, 80u } },
+                        { { CAPSENSE_GESTURE_SWIPE, CAPSENSE_GESTURE_DIR_RIGHT } } },
+    { "swipe_left",     { { 100u, 600u, 90u, 20u } },
+                        { { CAPSENSE_GESTURE_SWIPE, CAPSENSE_GESTURE_DIR_LEFT } } },
+    { "flick_right",    { { 100u, 120u, 20u, 80u } },
+                        { { CAPSENSE_GESTURE_FLICK, CAPSENSE_GESTURE_DIR_RIGHT } } },
+    { "flick_left",     { { 100u, 120u, 85u, 25u } },
+                        { { CAPSENSE_GESTURE_FLICK, CAPSENSE_GESTURE_DIR_LEFT } } },
+    { "short_drag",     { { 100u, 400u, 40u, 55u } },
+                        { } },
+    { "tap_then_swipe", { { 100u, 100u, 50u, 50u }, { 350u, 500u, 10u, 90u } },
+                        { { CAPSENSE_GESTURE_TAP, CAPSENSE_GESTURE_DIR_NONE },
+                          { CAPSENSE_GESTURE_SWIPE, CAPSENSE_GESTURE_DIR_RIGHT } } },
+};
+
+
+/*******************************************************************************
+* Function Name: replay_synthesize
+********************************************************************************
+* Summary:
+*   Samples the strokes of a scenario at the scan period, with uniform
+*   position noise, until one second after the last stroke. A stroke of
+*   length 0 continues the previous one: it holds the finger down and moves
+*   it linearly to its end position over the next 400 ms.
+*******************************************************************************/
+static std::vector<replay_scan_t> replay_synthesize(const replay_args_t *args, const replay_scenario_t *scenario,
+                                                    std::mt19937 *rng)
+{
+    std::uniform_int_distribution<int32_t> noise(-(int32_t)args->jitter, (int32_t)args->jitter);
+    std::vector<replay_stroke_t> strokes;
+    std::vector<replay_scan_t> scans;
+    uint32_t endMs = 0u;
+
+    for (const replay_stroke_t &stroke : scenario->strokes)
+    {
+        if ((0u == stroke.lengthMs) && (0u != stroke.startMs) && !strokes.empty())
+        {
+            /* Drag on from where the previous stroke ended */
+            const replay_stroke_t &last = strokes.back();
+            strokes.push_back({ last.startMs + last.lengthMs, 400u, last.to, stroke.to });
+        }
+        else if (0u != stroke.lengthMs)
+        {
+            strokes.push_back(stroke);
+        }
+        if (!strokes.empty())
+        {
+            endMs = strokes.back().startMs + strokes.back().lengthMs;
+        }
+    }
+
+    for (uint32_t timeMs = 0u; timeMs < (endMs + 1000u); timeMs += args->periodMs)
+    {
+        replay_scan_t scan = { timeMs, false, 0u };
+
+        for (const replay_stroke_t &stroke : strokes)
+        {
+            if ((timeMs >= stroke.startMs) && (timeMs < (stroke.startMs + stroke.lengthMs)))
+            {
+                const double at = (double)(timeMs - stroke.startMs) / (double)stroke.lengthMs;
+                const double percent = stroke.from + (((double)stroke.to - (double)stroke.from) * at);
+                const int32_t position = (int32_t)((percent * args->range / 100.0) + 0.5) + noise(*rng);
+
+                scan.touched = true;
+                scan.position = (uint32_t)((position < 0) ? 0 : ((position > (int32_t)args->range) ?
+                                                                 (int32_t)args->range : position));
+            }
+        }
+        scans.push_back(scan);
+    }
+    return scans;
+}
+
+
+/*******************************************************************************
+* Function Name: replay_read_csv
+********************************************************************************
+* Summary:
+*   Reads a recorded trace with the columns time_ms and position. An empty
+*   or negative position is a scan without touch.
+*******************************************************************************/
+static bool replay_read_csv(const char *path, std::vector<replay_scan_t> *scans)
+{
+    FILE *file = fopen(path, "r");
+    char line[256];
+    int32_t timeColumn = -1;
+    int32_t positionColumn = -1;
+
+    if (NULL == file)
+    {
+        fprintf(stderr, "capsense_gesture_replay: cannot open %s\n", path);
+        return false;
+    }
+    while (NULL != fgets(line, sizeof(line), file))
+    {
+        std::vector<std::string> fields(1u);
+
+        for (const char *c = line; ('\0' != *c) && ('\n' != *c) && ('\r' != *c); c++)
+        {
+            if (',' == *c)
+            {
+                fields.emplace_back();
+            }
+            else
+            {
+                fields.back() += *c;
+            }
+        }
+        if (timeColumn < 0)
+        {
+            for (size_t i = 0u; i < fields.size(); i++)
+            {
+                timeColumn = ("time_ms" == fields[i]) ? (int32_t)i : timeColumn;
+                positionColumn = ("position" == fields[i]) ? (int32_t)i : positionColumn;
+            }
+            if ((timeColumn < 0) || (positionColumn < 0))
+            {
+                fprintf(stderr, "capsense_gesture_replay: %s needs the columns time_ms and position\n", path);
+                fclose(file);
+                return false;
+            }
+            continue;
+        }
+        if (fields.size() <= (size_t)((timeColumn > positionColumn) ? timeColumn : positionColumn))
+        {
+            continue;
+        }
+        const long position = fields[positionColumn].empty() ? -1 : strtol(fields[positionColumn].c_str(), NULL, 0);
+        scans->push_back({ (uint32_t)strtoul(fields[timeColumn].c_str(), NULL, 0), position >= 0,
+                          (position >= 0) ? (uint32_t)position : 0u });
+    }
+    fclose(file);
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: replay_run
+********************************************************************************
+* Summary:
+*   Feeds every scan of a trace through capsense_gesture_update() from a
+*   fresh state and returns the gestures. With print set, every gesture is
+*   printed as a gesture,<time_ms>,<name>,<position>,<speed> record.
+*******************************************************************************/
+static std::vector<capsense_gesture_event_t> replay_run(const capsense_gesture_config_t *cfg,
+                                                        const std::vector<replay_scan_t> &scans, bool print)
+{
+    std::vector<capsense_gesture_event_t> gestures;
+    capsense_gesture_t ctx;
+
+    capsense_gesture_init(&ctx);
+    for (const replay_scan_t &scan : scans)
+    {
+        capsense_gesture_event_t event;
+
+        if (capsense_gesture_update(&ctx, cfg, scan.timeMs, scan.touched, scan.position, &event))
+        {
+            gestures.push_back(event);
+            if (print)
+            {
+                printf("gesture,%lu,%s%s,%lu,%lu\n", (unsigned long)scan.timeMs, REPLAY_GESTURE_NAMES[event.gesture],
+                       REPLAY_DIR_NAMES[event.direction], (unsigned long)event.position, (unsigned long)event.speed);
+            }
+        }
+    }
+    return gestures;
+}
+
+
+/*******************************************************************************
+* Function Name: replay_names
+********************************************************************************
+* Summary:
+*   Gestures as one field, such as "tap swipe_right", or "-" for none.
+*******************************************************************************/
+static std::string replay_names(const std::vector<replay_expect_t> &gestures)
+{
+    std::string names;
+
+    for (const replay_expect_t &gesture : gestures)
+    {
+        names += names.empty() ? "" : " ";
+        names += std::string(REPLAY_GESTURE_NAMES[gesture.gesture]) + REPLAY_DIR_NAMES[gesture.direction];
+    }
+    return names.empty() ? "-" : names;
+}
+
+
+/*******************************************************************************
+* Function Name: replay_option
+********************************************************************************
+* Summary:
+*   Stores the value of a "--name value" option in the matching field.
+*
+* Return:
+*  false if the option is unknown.
+*******************************************************************************/
+static bool replay_option(replay_args_t *args, const char *name, const char *value)
+{
+    uint32_t number = (uint32_t)strtoul(value, NULL, 0);
+    struct
+    {
+        const char *name;
+        uint32_t *field;
+    } const options[] =
+    {
+        { "--range",         &args->range },
+        { "--period-ms",     &args->periodMs },
+        { "--jitter",        &args->jitter },
+        { "--long-press-ms", &args->longPressMs },
+        { "--seed",          &args->seed },
+    };
+
+    if (0 == strcmp(name, "--csv"))
+    {
+        args->csv = value;
+        return true;
+    }
+    for (const auto &option : options)
+    {
+        if (0 == strcmp(name, option.name))
+        {
+            *option.field = number;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   Replays the scripted scenarios and checks that each gives exactly its
+*   expected gestures, or replays a recorded trace given with --csv and
+*   prints its gestures.
+*
+* Return:
+*  0 if every scenario passes, 1 otherwise, 2 for a usage error.
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    replay_args_t args =
+    {
+        .csv         = NULL,
+        .range       = 300u,
+        .periodMs    = 20u,
+        .jitter      = 2u,
+        .longPressMs = 800u,
+        .seed        = 1u
+    };
+
+    for (int i = 1; i < argc; i += 2)
+    {
+        if ((i + 1 >= argc) || !replay_option(&args, argv[i], argv[i + 1]) || (0u == args.periodMs))
+        {
+            fprintf(stderr, "usage: %s [--range positions] [--period-ms ms] [--jitter positions]\n"
+                    "       [--long-press-ms ms] [--seed n] [--csv trace.csv]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const capsense_gesture_config_t cfg = capsense_gesture_config(args.range, (uint16_t)args.longPressMs);
+
+    if (NULL != args.csv)
+    {
+        std::vector<replay_scan_t> scans;
+
+        if (!replay_read_csv(args.csv, &scans))
+        {
+            return 1;
+        }
+        printf("record,time_ms,gesture,position,speed\n");
+        (void)replay_run(&cfg, scans, true);
+        return 0;
+    }
+
+    std::mt19937 rng(args.seed);
+    bool failed = false;
+
+    printf("scenario,scans,expected,got,result\n");
+    for (const replay_scenario_t &scenario : replay_scenarios)
+    {
+        const std::vector<replay_scan_t> scans = replay_synthesize(&args, &scenario, &rng);
+        std::vector<replay_expect_t> expected;
+        std::vector<replay_expect_t> got;
+
+        for (const replay_expect_t &expect : scenario.expect)
+        {
+            if (CAPSENSE_GESTURE_NONE != expect.gesture)
+            {
+                expected.push_back(expect);
+            }
+        }
+        for (const capsense_gesture_event_t &event : replay_run(&cfg, scans, false))
+        {
+            got.push_back({ event.gesture, event.direction });
+        }
+
+        const std::string want = replay_names(expected);
+        const std::string have = replay_names(got);
+        printf("%s,%lu,%s,%s,%s\n", scenario.name, (unsigned long)scans.size(), want.c_str(), have.c_str(),
+               (want == have) ? "ok" : "fail");
+        failed = failed || (want != have);
+    }
+    return failed ? 1 : 0;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,315 @@
+/*******************************************************************************
+* File Name: capsense_ipc_sim.cpp
+*
+* Description:
+*   Host simulation of the dual-core protocol of capsense_ipc.h. A producer
+*   thread stands in for the CM0+ and publishes numbered frames, a consumer
+*   thread stands in for the CM4 and stalls at random like a busy application.
+*   The consumer checks that frames arrive whole and in order, and that every
+*   lost frame was counted as an overflow.
+*
+*   Build with CMake from the tools directory, for example: cmake -S tools -B
+*   build-tools && cmake --build build-tools && build-tools/capsense_ipc_sim
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include "../capsense_ipc.h"
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    uint32_t frames;
+    uint32_t periodUs;      /* Producer scan period, 0 for back to back; 1000 times the kit by default */
+    uint32_t stallEvery;    /* Mean frames between consumer stalls, 0 for none */
+    uint32_t stallUs;       /* Consumer stall, e.g. a network or display update */
+    uint32_t seed;
+} sim_args_t;
+
+typedef struct
+{
+    uint32_t consumed;
+    uint32_t gaps;          /* Frames missing from the seq sequence */
+    uint32_t torn;          /* Frames whose contents do not match their seq */
+    uint32_t reordered;     /* Frames with a seq not above the previous one */
+} sim_result_t;
+
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static capsense_ipc_region_t sim_region;
+
+/* Stands in for the IPC interrupt and the thread flag it sets */
+static std::atomic<bool> sim_notify;
+static std::atomic<bool> sim_producer_done;
+
+
+/*******************************************************************************
+* Function Name: sim_pattern
+********************************************************************************
+* Summary:
+*   Fills a frame with contents derived from its seq, so the consumer can
+*   tell a torn frame from a whole one.
+*
+*******************************************************************************/
+static void sim_pattern(uint32_t seq, capsense_ipc_frame_t *frame)
+{
+    uint32_t hash = seq * 2654435761u;
+
+    frame->seq = seq;
+    frame->timeMs = seq * 20u;
+    frame->touched = hash >> 29;
+    for (uint32_t wdgtId = 0u; wdgtId < CAPSENSE_LAYOUT_WIDGET_COUNT; wdgtId++)
+    {
+        frame->value[wdgtId] = (uint16_t)(hash >> (wdgtId * 3u));
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: sim_same
+********************************************************************************
+* Summary:
+*   Compares two frames field by field; the padding is not copied.
+*
+*******************************************************************************/
+static bool sim_same(const capsense_ipc_frame_t *a, const capsense_ipc_frame_t *b)
+{
+    bool same = (a->seq == b->seq) && (a->timeMs == b->timeMs) && (a->touched == b->touched);
+
+    for (uint32_t wdgtId = 0u; wdgtId < CAPSENSE_LAYOUT_WIDGET_COUNT; wdgtId++)
+    {
+        same = same && (a->value[wdgtId] == b->value[wdgtId]);
+    }
+    return same;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_producer
+********************************************************************************
+* Summary:
+*   CM0+ side: waits for the region, then publishes the frames and notifies
+*   after each one, as capsense_cm0p.cpp does.
+*
+*******************************************************************************/
+static void sim_producer(const sim_args_t *args)
+{
+    capsense_ipc_frame_t frame;
+
+    while (!capsense_ipc_valid(&sim_region))
+    {
+        std::this_thread::yield();
+    }
+
+    for (uint32_t seq = 0u; seq < args->frames; seq++)
+    {
+        sim_pattern(seq, &frame);
+        if (capsense_ipc_publish(&sim_region, &frame))
+        {
+            sim_notify.store(true, std::memory_order_release);
+        }
+        if (0u != args->periodUs)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(args->periodUs));
+        }
+    }
+    sim_producer_done.store(true, std::memory_order_release);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_consumer
+********************************************************************************
+* Summary:
+*   CM4 side: drains the region after every notification, as
+*   capsense_remote.cpp does, checks every frame and stalls at random.
+*
+*******************************************************************************/
+static sim_result_t sim_consumer(const sim_args_t *args)
+{
+    sim_result_t result = {};
+    std::mt19937 rng(args->seed);
+    std::uniform_int_distribution<uint32_t> stall(0u, (0u != args->stallEvery) ? (args->stallEvery - 1u) : 0u);
+    capsense_ipc_frame_t frame;
+    capsense_ipc_frame_t expected;
+    uint32_t next = 0u;
+
+    while (true)
+    {
+        const bool done = sim_producer_done.load(std::memory_order_acquire);
+
+        if (!sim_notify.exchange(false, std::memory_order_acquire) && !done)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        while (capsense_ipc_consume(&sim_region, &frame))
+        {
+            sim_pattern(frame.seq, &expected);
+            result.torn += sim_same(&frame, &expected) ? 0u : 1u;
+            if ((frame.seq < next) && (0u != result.consumed))
+            {
+                result.reordered++;
+            }
+            else
+            {
+                result.gaps += frame.seq - next;
+                next = frame.seq + 1u;
+            }
+            result.consumed++;
+
+            if ((0u != args->stallEvery) && (0u == stall(rng)))
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(args->stallUs));
+            }
+        }
+        if (done)
+        {
+            break;
+        }
+    }
+    result.gaps += args->frames - next;
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_option
+********************************************************************************
+* Summary:
+*   Stores the value of a "--name value" option in the matching field.
+*
+* Return:
+*  false if the option is unknown.
+*
+*******************************************************************************/
+static bool sim_option(sim_args_t *args, const char *name, const char *value)
+{
+    uint32_t number = (uint32_t)strtoul(value, NULL, 0);
+    struct
+    {
+        const char *name;
+        uint32_t *field;
+    } const options[] =
+    {
+        { "--frames",      &args->frames },
+        { "--period-us",   &args->periodUs },
+        { "--stall-every", &args->stallEvery },
+        { "--stall-us",    &args->stallUs },
+        { "--seed",        &args->seed },
+    };
+
+    for (const auto &option : options)
+    {
+        if (0 == strcmp(name, option.name))
+        {
+            *option.field = number;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   Runs the producer and the consumer on two threads and checks the
+*   protocol: every frame arrives whole and in order, and every frame that
+*   did not arrive was counted as an overflow by the producer.
+*
+* Return:
+*  0 if the checks pass, 1 otherwise, 2 for a usage error.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    sim_args_t args =
+    {
+        .frames     = 50000u,
+        .periodUs   = 20u,
+        .stallEvery = 10000u,
+        .stallUs    = 2000u,
+        .seed       = 1u
+    };
+
+    for (int i = 1; i < argc; i += 2)
+    {
+        if ((i + 1 >= argc) || !sim_option(&args, argv[i], argv[i + 1]))
+        {
+            fprintf(stderr, "usage: %s [--frames n] [--period-us us] [--stall-every frames] [--stall-us us]\n"
+                    "       [--seed n]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    /* The CM4 sets up the region before the CM0+ may use it */
+    std::thread producer(sim_producer, &args);
+    capsense_ipc_init(&sim_region);
+    const sim_result_t result = sim_consumer(&args);
+    producer.join();
+
+    const bool ok = (0u == result.torn) && (0u == result.reordered) &&
+                    (result.gaps == sim_region.ring.overflows) &&
+                    ((result.consumed + sim_region.ring.overflows) == args.frames);
+
+    printf("frames,consumed,overflows,gaps,peak,torn,reordered,result\n");
+    printf("%lu,%lu,%lu,%lu,%lu,%lu,%lu,%s\n", (unsigned long)args.frames, (unsigned long)result.consumed,
+           (unsigned long)sim_region.ring.overflows, (unsigned long)result.gaps,
+           (unsigned long)sim_region.ring.peak, (unsigned long)result.torn, (unsigned long)result.reordered,
+           ok ? "ok" : "fail");
+    return ok ? 0 : 1;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,637 @@
+/*******************************************************************************
+* File Name: capsense_log_analyze.cpp
+*
+* Description:
+*   Analyzes long captures of the raw-count log on a Linux host. Maps an image
+*   of the log region into memory, indexes its sectors by sequence number,
+*   time and scan counter from their headers and first frames, and decodes the
+*   sectors of the requested range in one streaming pass with capsense_log.cpp
+*   and capsense_frame.cpp. Prints per sensor the baseline range, the noise
+*   envelope and RMS without touch, the average touch signal and SNR, and the
+*   touch count and duration, and can write the range as a CSV trace for
+*   capsense_trace.
+*
+*   Build with CMake from the tools directory, for example: cmake -S tools -B
+*   build-tools && cmake --build build-tools &&
+*   build-tools/capsense_log_analyze capsense_log.bin --from-ms 3600000
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "../capsense_frame.h"
+#include "../capsense_log.h"
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    const char *image;
+    const char *csv;
+    double sectorSize;
+    double fromMs;
+    double toMs;
+    double fromScan;
+    double toScan;
+    double fingerTh;        /* Touch threshold of the difference count */
+    double hysteresis;
+} analyze_args_t;
+
+/* Index entry of a sector, from its header and its first frame */
+typedef struct
+{
+    uint32_t sector;        /* Position in the image */
+    uint32_t seq;
+    bool key;               /* The first frame is an intact key frame */
+    uint32_t timeMs;
+    uint32_t scan;
+} analyze_sector_t;
+
+/* Streaming statistics of one sensor */
+typedef struct
+{
+    uint64_t quiet;         /* Frames without touch */
+    double noiseMean;       /* Raw count minus baseline without touch, Welford */
+    double noiseM2;
+    int32_t noiseMin;
+    int32_t noiseMax;
+    uint64_t touchFrames;
+    double signalSum;       /* Difference counts of touched frames */
+    uint32_t touches;
+    bool touched;
+    uint32_t touchStartMs;
+    uint64_t touchMsSum;
+    uint32_t touchMsMax;
+    uint16_t peak;
+    uint16_t baselineMin;
+    uint16_t baselineMax;
+} analyze_sensor_t;
+
+/* State of the streaming pass */
+typedef struct
+{
+    const analyze_args_t *args;
+    FILE *csv;
+    capsense_frame_state_t state;
+    capsense_frame_t frame;
+    uint32_t sensors;
+    uint64_t frames;        /* Frames inside the range */
+    uint64_t records;
+    uint64_t errors;        /* Records that do not decode */
+    uint64_t missed;        /* Scans between logged frames */
+    uint32_t resets;        /* Restarts of the scan counter */
+    bool started;
+    uint32_t firstMs;
+    uint32_t lastMs;
+    uint32_t lastScan;
+    analyze_sensor_t sensor[CAPSENSE_FRAME_MAX_SENSORS];
+} analyze_pass_t;
+
+
+/*******************************************************************************
+* Function Name: analyze_flash_read
+********************************************************************************
+* Summary:
+*   capsense_log_flash_t read function of one sector of the mapped image.
+*   capsense_log.cpp never reads past the sector it walks.
+*
+*******************************************************************************/
+static int32_t analyze_flash_read(void *arg, uint32_t addr, void *buf, uint32_t length)
+{
+    memcpy(buf, (const uint8_t *)arg + addr, length);
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: analyze_sector_view
+********************************************************************************
+* Summary:
+*   Makes a one-sector flash region of a sector of the image, so that
+*   capsense_log_read() checks and walks that sector alone, and offsets into
+*   images of more than 4 GB stay within 32 bits.
+*
+*******************************************************************************/
+static void analyze_sector_view(capsense_log_flash_t *view, const uint8_t *image, uint32_t sectorSize,
+                                uint32_t sector)
+{
+    view->sectorSize = sectorSize;
+    view->sectorCount = 1u;
+    view->pageSize = CAPSENSE_LOG_PAGE_MAX;
+    view->read = analyze_flash_read;
+    view->program = NULL;
+    view->erase = NULL;
+    view->arg = (void *)(image + ((uint64_t)sector * sectorSize));
+}
+
+
+/*******************************************************************************
+* Function Name: analyze_first
+********************************************************************************
+* Summary:
+*   capsense_log_reader_t of the index pass. Decodes the first record of a
+*   sector, which the logger always writes as a key frame, and stops.
+*
+*******************************************************************************/
+static bool analyze_first(void *arg, uint32_t seq, const uint8_t *data, uint32_t length)
+{
+    analyze_sector_t *entry = (analyze_sector_t *)arg;
+    capsense_frame_state_t state;
+    capsense_frame_t frame;
+    uint32_t streams;
+
+    capsense_frame_reset(&state);
+    entry->seq = seq;
+    entry->key = capsense_frame_decode(&state, data, length, &frame, &streams);
+    entry->timeMs = frame.timeMs;
+    entry->scan = frame.scan;
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: analyze_index
+********************************************************************************
+* Summary:
+*   Lists the sectors with a valid header and at least one record, ordered
+*   by sequence number. Only the header and the first record of every sector
+*   are read. A sector found twice, as in dumps of the log region taken one
+*   after another and concatenated, is kept in its last copy, which holds
+*   the most records.
+*
+*******************************************************************************/
+static std::vector<analyze_sector_t> analyze_index(const uint8_t *image, uint32_t sectorSize, uint32_t sectors)
+{
+    std::vector<analyze_sector_t> index;
+    capsense_log_flash_t view;
+
+    for (uint32_t sector = 0u; sector < sectors; sector++)
+    {
+        analyze_sector_t entry = { sector, 0u, false, 0u, 0u };
+
+        /* Sequence numbers start at 1, so 0 tells that there is no record */
+        analyze_sector_view(&view, image, sectorSize, sector);
+        (void)capsense_log_read(&view, analyze_first, &entry);
+        if (0u != entry.seq)
+        {
+            index.push_back(entry);
+        }
+    }
+
+    std::stable_sort(index.begin(), index.end(),
+                     [](const analyze_sector_t &a, const analyze_sector_t &b) { return a.seq < b.seq; });
+    std::vector<analyze_sector_t> unique;
+    for (const analyze_sector_t &entry : index)
+    {
+        if (!unique.empty() && (unique.back().seq == entry.seq))
+        {
+            unique.back() = entry;
+        }
+        else
+        {
+            unique.push_back(entry);
+        }
+    }
+    return unique;
+}
+
+
+/*******************************************************************************
+* Function Name: analyze_needed
+********************************************************************************
+* Summary:
+*   Tells whether a sector may hold frames of the requested range. The first
+*   frames of a sector and of the next one bound the frames between them,
+*   provided that the kit was not reset while the sector was written. Where
+*   the time or the scan counter of the next sector is lower, it was, and
+*   the sector is always read.
+*
+*******************************************************************************/
+static bool analyze_needed(const analyze_args_t *args, const analyze_sector_t *entry, const analyze_sector_t *next)
+{
+    if (!entry->key ||
+        ((NULL != next) && (!next->key || (next->timeMs < entry->timeMs) || (next->scan < entry->scan))))
+    {
+        return true;
+    }
+    if (((double)entry->timeMs > args->toMs) || ((double)entry->scan > args->toScan))
+    {
+        return false;
+    }
+    return (NULL == next) || (((double)next->timeMs >= args->fromMs) && ((double)next->scan > args->fromScan));
+}
+
+
+/*******************************************************************************
+* Function Name: analyze_write_csv
+********************************************************************************
+* Summary:
+*   Writes a frame as a row in the format that capsense_trace --csv reads,
+*   preceded by the header for the first frame.
+*
+*******************************************************************************/
+static void analyze_write_csv(analyze_pass_t *pass, const capsense_frame_t *frame)
+{
+    static const char *const names[CAPSENSE_FRAME_STREAMS] = { "raw", "baseline", "diff" };
+    const uint16_t *const values[CAPSENSE_FRAME_STREAMS] = { frame->raw, frame->baseline, frame->diff };
+
+    if (0u == pass->frames)
+    {
+        fprintf(pass->csv, "time_ms,scan");
+        for (uint32_t stream = 0u; stream < CAPSENSE_FRAME_STREAMS; stream++)
+        {
+            for (uint32_t i = 0u; i < frame->count; i++)
+            {
+                fprintf(pass->csv, ",%s%u", names[stream], (unsigned)i);
+            }
+        }
+        fprintf(pass->csv, "\n");
+    }
+
+    fprintf(pass->csv, "%lu,%lu", (unsigned long)frame->timeMs, (unsigned long)frame->scan);
+    for (uint32_t stream = 0u; stream < CAPSENSE_FRAME_STREAMS; stream++)
+    {
+        for (uint32_t i = 0u; i < frame->count; i++)
+        {
+            fprintf(pass->csv, ",%u", (unsigned)values[stream][i]);
+        }
+    }
+    fprintf(pass->csv, "\n");
+}
+
+
+/*******************************************************************************
+* Function Name: analyze_frame
+********************************************************************************
+* Summary:
+*   Adds a frame to the statistics. A sensor is touched from the frame whose
+*   difference count reaches the finger threshold plus the hysteresis until
+*   it falls below the finger threshold minus the hysteresis, as in the
+*   middleware. Frames below that lower bound outside a touch are quiet; their
+*   raw count minus the baseline is the noise.
+*
+*******************************************************************************/
+static void analyze_frame(analyze_pass_t *pass, const capsense_frame_t *frame)
+{
+    const double onTh = pass->args->fingerTh + pass->args->hysteresis;
+    const double offTh = pass->args->fingerTh - pass->args->hysteresis;
+
+    if (!pass->started)
+    {
+        pass->firstMs = frame->timeMs;
+    }
+    else if (frame->scan <= pass->lastScan)
+    {
+        /* The kit was reset; touches in progress are not counted */
+        pass->resets++;
+        for (uint32_t i = 0u; i < pass->sensors; i++)
+        {
+            pass->sensor[i].touched = false;
+        }
+    }
+    else
+    {
+        pass->missed += frame->scan - pass->lastScan - 1u;
+    }
+
+    if (NULL != pass->csv)
+    {
+        analyze_write_csv(pass, frame);
+    }
+
+    for (uint32_t i = 0u; i < frame->count; i++)
+    {
+        analyze_sensor_t *sensor = &pass->sensor[i];
+        const uint16_t diff = frame->diff[i];
+
+        if (i >= pass->sensors)
+        {
+            sensor->noiseMin = INT32_MAX;
+            sensor->noiseMax = INT32_MIN;
+            sensor->baselineMin = UINT16_MAX;
+        }
+        sensor->baselineMin = (frame->baseline[i] < sensor->baselineMin) ? frame->baseline[i] : sensor->baselineMin;
+        sensor->baselineMax = (frame->baseline[i] > sensor->baselineMax) ? frame->baseline[i] : sensor->baselineMax;
+
+        if (!sensor->touched && (diff >= onTh))
+        {
+            sensor->touched = true;
+            sensor->touches++;
+            sensor->touchStartMs = frame->timeMs;
+        }
+        else if (sensor->touched && (diff < offTh))
+        {
+            const uint32_t touchMs = frame->timeMs - sensor->touchStartMs;
+            sensor->touched = false;
+            sensor->touchMsSum += touchMs;
+            sensor->touchMsMax = (touchMs > sensor->touchMsMax) ? touchMs : sensor->touchMsMax;
+        }
+
+        if (sensor->touched)
+        {
+            sensor->touchFrames++;
+            sensor->signalSum += diff;
+            sensor->peak = (diff > sensor->peak) ? diff : sensor->peak;
+        }
+        else if (diff < offTh)
+        {
+            const int32_t noise = (int32_t)frame->raw[i] - (int32_t)frame->baseline[i];
+            const double delta = noise - sensor->noiseMean;
+            sensor->quiet++;
+            sensor->noiseMean += delta / (double)sensor->quiet;
+            sensor->noiseM2 += delta * (noise - sensor->noiseMean);
+            sensor->noiseMin = (noise < sensor->noiseMin) ? noise : sensor->noiseMin;
+            sensor->noiseMax = (noise > sensor->noiseMax) ? noise : sensor->noiseMax;
+        }
+    }
+
+    pass->sensors = (frame->count > pass->sensors) ? frame->count : pass->sensors;
+    pass->started = true;
+    pass->lastMs = frame->timeMs;
+    pass->lastScan = frame->scan;
+    pass->frames++;
+}
+
+
+/*******************************************************************************
+* Function Name: analyze_record
+********************************************************************************
+* Summary:
+*   capsense_log_reader_t of the streaming pass. Decodes every record of a
+*   sector and adds the frames inside the requested range.
+*
+*******************************************************************************/
+static bool analyze_record(void *arg, uint32_t seq, const uint8_t *data, uint32_t length)
+{
+    analyze_pass_t *pass = (analyze_pass_t *)arg;
+    const analyze_args_t *args = pass->args;
+    uint32_t streams;
+
+    (void)seq;
+    pass->records++;
+    if (!capsense_frame_decode(&pass->state, data, length, &pass->frame, &streams))
+    {
+        capsense_frame_reset(&pass->state);
+        pass->errors++;
+        return true;
+    }
+
+    if (((double)pass->frame.timeMs >= args->fromMs) && ((double)pass->frame.timeMs <= args->toMs) &&
+        ((double)pass->frame.scan >= args->fromScan) && ((double)pass->frame.scan <= args->toScan))
+    {
+        analyze_frame(pass, &pass->frame);
+    }
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: analyze_report
+********************************************************************************
+* Summary:
+*   Prints one row per sensor: baseline range, noise (RMS, envelope and
+*   peak-to-peak of the raw count minus the baseline without touch), average
+*   signal of the touched frames, SNR as signal over peak-to-peak noise, and
+*   the touch count, duration and peak difference count.
+*
+*******************************************************************************/
+static void analyze_report(const analyze_pass_t *pass)
+{
+    printf("sensor,baseline_min,baseline_max,noise_rms,noise_min,noise_max,noise_pp,signal,snr,"
+           "touches,touch_ms_avg,touch_ms_max,peak_diff\n");
+    for (uint32_t i = 0u; i < pass->sensors; i++)
+    {
+        const analyze_sensor_t *sensor = &pass->sensor[i];
+        const bool quiet = (0u != sensor->quiet);
+        const int32_t pp = quiet ? (sensor->noiseMax - sensor->noiseMin) : 0;
+        const double rms = quiet ? sqrt((sensor->noiseM2 / (double)sensor->quiet) +
+                                        (sensor->noiseMean * sensor->noiseMean)) : 0.0;
+        const double signal = (0u != sensor->touchFrames) ? (sensor->signalSum / (double)sensor->touchFrames) : 0.0;
+        const uint32_t ended = sensor->touches - (sensor->touched ? 1u : 0u);
+
+        printf("%u,%u,%u,%.2f,%d,%d,%d,%.1f,%.1f,%u,%.0f,%u,%u\n", (unsigned)i,
+               (unsigned)sensor->baselineMin, (unsigned)sensor->baselineMax, rms,
+               quiet ? (int)sensor->noiseMin : 0, quiet ? (int)sensor->noiseMax : 0, (int)pp, signal,
+               (pp > 0) ? (signal / pp) : 0.0, (unsigned)sensor->touches,
+               (0u != ended) ? ((double)sensor->touchMsSum / ended) : 0.0, (unsigned)sensor->touchMsMax,
+               (unsigned)sensor->peak);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: analyze_option
+********************************************************************************
+* Summary:
+*   Stores the value of a "--name value" option in the matching field.
+*
+* Return:
+*  false if the option is unknown.
+*
+*******************************************************************************/
+static bool analyze_option(analyze_args_t *args, const char *name, const char *value)
+{
+    const double number = strtod(value, NULL);
+    struct
+    {
+        const char *name;
+        double *field;
+    } const options[] =
+    {
+        { "--sector-size", &args->sectorSize },
+        { "--from-ms",     &args->fromMs },
+        { "--to-ms",       &args->toMs },
+        { "--from-scan",   &args->fromScan },
+        { "--to-scan",     &args->toScan },
+        { "--finger-th",   &args->fingerTh },
+        { "--hysteresis",  &args->hysteresis },
+    };
+
+    for (const auto &option : options)
+    {
+        if (0 == strcmp(name, option.name))
+        {
+            *option.field = number;
+            return true;
+        }
+    }
+
+    if (0 == strcmp(name, "--csv"))
+    {
+        args->csv = value;
+        return true;
+    }
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   Analyzes an image of the raw-count log region. The image is mapped into
+*   memory, so its size is limited by the address space only. An index of
+*   the sectors is built from their headers and first frames, the sectors
+*   that may hold the requested time and scan range are decoded in one pass
+*   with capsense_log.cpp and capsense_frame.cpp, and the per-sensor
+*   statistics are printed. With --csv the frames of the range are also
+*   written as a trace for capsense_trace. Returns 1 if the image holds no
+*   frame of the range or a record does not decode.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    analyze_args_t args =
+    {
+        .image      = NULL,
+        .csv        = NULL,
+        .sectorSize = 262144.0,
+        .fromMs     = 0.0,
+        .toMs       = (double)UINT32_MAX,
+        .fromScan   = 0.0,
+        .toScan     = (double)UINT32_MAX,
+        .fingerTh   = 100.0,
+        .hysteresis = 10.0
+    };
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (0 != strncmp(argv[i], "--", 2u))
+        {
+            args.image = (NULL == args.image) ? argv[i] : NULL;
+            continue;
+        }
+        if ((i + 1 >= argc) || !analyze_option(&args, argv[i], argv[i + 1]))
+        {
+            args.image = NULL;
+            break;
+        }
+        i++;
+    }
+    if (NULL == args.image)
+    {
+        fprintf(stderr, "usage: %s image [--sector-size bytes] [--from-ms ms] [--to-ms ms]\n"
+                "       [--from-scan n] [--to-scan n] [--finger-th counts] [--hysteresis counts] [--csv trace.csv]\n",
+                argv[0]);
+        return 2;
+    }
+
+    const uint32_t sectorSize = (uint32_t)args.sectorSize;
+    const int fd = open(args.image, O_RDONLY);
+    struct stat info;
+    if ((fd < 0) || (0 != fstat(fd, &info)) || (sectorSize <= CAPSENSE_LOG_HEADER_SIZE) ||
+        ((uint64_t)info.st_size < sectorSize) || (((uint64_t)info.st_size / sectorSize) > UINT32_MAX))
+    {
+        fprintf(stderr, "capsense_log_analyze: cannot read %s as sectors of %u bytes\n", args.image,
+                (unsigned)sectorSize);
+        return 2;
+    }
+    const uint64_t size = (uint64_t)info.st_size;
+    const uint32_t sectors = (uint32_t)(size / sectorSize);
+    const uint8_t *image = (const uint8_t *)mmap(NULL, (size_t)size, PROT_READ, MAP_PRIVATE, fd, 0);
+    (void)close(fd);
+    if (MAP_FAILED == (const void *)image)
+    {
+        fprintf(stderr, "capsense_log_analyze: cannot map %s\n", args.image);
+        return 2;
+    }
+
+    /* The index pass touches one page per sector; the streaming pass reads
+     * whole sectors in order.
+     */
+    const auto start = std::chrono::steady_clock::now();
+    (void)madvise((void *)image, (size_t)size, MADV_RANDOM);
+    const std::vector<analyze_sector_t> index = analyze_index(image, sectorSize, sectors);
+    (void)madvise((void *)image, (size_t)size, MADV_SEQUENTIAL);
+
+    static analyze_pass_t pass;
+    capsense_log_flash_t view;
+    uint32_t read = 0u;
+    pass.args = &args;
+    pass.csv = (NULL != args.csv) ? fopen(args.csv, "w") : NULL;
+    if ((NULL != args.csv) && (NULL == pass.csv))
+    {
+        fprintf(stderr, "capsense_log_analyze: cannot create %s\n", args.csv);
+        return 2;
+    }
+
+    for (size_t i = 0u; i < index.size(); i++)
+    {
+        if (analyze_needed(&args, &index[i], ((i + 1u) < index.size()) ? &index[i + 1u] : NULL))
+        {
+            /* Every sector starts with a key frame */
+            capsense_frame_reset(&pass.state);
+            analyze_sector_view(&view, image, sectorSize, index[i].sector);
+            (void)capsense_log_read(&view, analyze_record, &pass);
+            read++;
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+    (void)munmap((void *)image, (size_t)size);
+    if ((NULL != pass.csv) && (0 != fclose(pass.csv)))
+    {
+        fprintf(stderr, "capsense_log_analyze: writing %s failed\n", args.csv);
+        return 2;
+    }
+
+    analyze_report(&pass);
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    fprintf(stderr, "capsense_log_analyze: %u sectors, %u in the log, %u read; %llu records, %llu decode errors\n"
+            "capsense_log_analyze: %llu frames from %lu ms to %lu ms, %llu scans missing, %u resets\n"
+            "capsense_log_analyze: %.2f s, %.0f MB/s of log read\n",
+            (unsigned)sectors, (unsigned)index.size(), (unsigned)read, (unsigned long long)pass.records,
+            (unsigned long long)pass.errors, (unsigned long long)pass.frames, (unsigned long)pass.firstMs,
+            (unsigned long)pass.lastMs, (unsigned long long)pass.missed, (unsigned)pass.resets, seconds,
+            (seconds > 0.0) ? ((double)read * sectorSize / seconds / 1e6) : 0.0);
+
+    return ((0u == pass.frames) || (0u != pass.errors)) ? 1 : 0;
+}
@@ -0,0 +1,424 @@
+/*******************************************************************************
+* File Name: capsense_log_sim.cpp
+*
+* Description:
+*   Host test of the raw-count log. Writes simulated raw counts through
+*   capsense_frame.cpp and capsense_log.cpp to the file-backed flash emulator
+*   of flash_emu.cpp, cutting the power at random operations, then reads the
+*   log back and checks it. Reports the encoded size per scan, the erase count
+*   spread and the history the log region of the kit holds.
+*
+*   Build with CMake from the tools directory, for example: cmake -S tools -B
+*   build-tools && cmake --build build-tools && build-tools/capsense_log_sim
+*   --frames 100000
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+#include "../capsense_frame.h"
+#include "../capsense_log.h"
+#include "flash_emu.h"
+#include "trace_model.h"
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    const char *file;
+    double frames;
+    double sectorSize;
+    double sectors;
+    double pageSize;
+    double cutEveryOps;     /* Mean program and erase operations between power cuts, 0 for none */
+    double flushEvery;      /* Frames between flushes of the logger thread, 0 for none */
+    double deviceSectors;   /* Log region of the kit, for the history estimate */
+    double deviceSectorSize;
+    trace_model_args_t trace;
+} sim_args_t;
+
+/* State of the read-back pass */
+typedef struct
+{
+    trace_model_t model;    /* Second run of the written trace */
+    capsense_frame_t expected;
+    capsense_frame_state_t state;
+    uint32_t frames;
+    uint32_t seq;
+    uint32_t read;
+    uint32_t first;
+    uint32_t last;
+    uint32_t errors;
+} sim_reader_t;
+
+
+/*******************************************************************************
+* Function Name: sim_same
+********************************************************************************
+* Summary:
+*   Compares the time, the scan counter and all streams of two frames.
+*
+*******************************************************************************/
+static bool sim_same(const capsense_frame_t *a, const capsense_frame_t *b)
+{
+    return (a->timeMs == b->timeMs) && (a->scan == b->scan) && (a->count == b->count) &&
+           (0 == memcmp(a->raw, b->raw, a->count * sizeof(a->raw[0]))) &&
+           (0 == memcmp(a->baseline, b->baseline, a->count * sizeof(a->baseline[0]))) &&
+           (0 == memcmp(a->diff, b->diff, a->count * sizeof(a->diff[0])));
+}
+
+
+/*******************************************************************************
+* Function Name: sim_record
+********************************************************************************
+* Summary:
+*   capsense_log_reader_t of the read-back pass. Decodes a frame and compares
+*   it with the frame written at the same time, generated again by the trace
+*   model. Frames must come back in order; frames may only be missing, never
+*   altered.
+*
+*******************************************************************************/
+static bool sim_record(void *arg, uint32_t seq, const uint8_t *data, uint32_t length)
+{
+    sim_reader_t *reader = (sim_reader_t *)arg;
+    const uint32_t periodMs = reader->model.args.periodMs;
+    capsense_frame_t frame;
+    uint32_t streams;
+
+    if ((0u == reader->read) || (seq != reader->seq))
+    {
+        capsense_frame_reset(&reader->state);
+        reader->seq = seq;
+    }
+
+    if (!capsense_frame_decode(&reader->state, data, length, &frame, &streams))
+    {
+        capsense_frame_reset(&reader->state);
+        reader->errors++;
+        return true;
+    }
+
+    const uint32_t index = frame.timeMs / periodMs;
+    if ((CAPSENSE_FRAME_ALL != streams) || (0u != (frame.timeMs % periodMs)) || (index >= reader->frames) ||
+        ((0u != reader->read) && (index <= reader->last)))
+    {
+        reader->errors++;
+        return true;
+    }
+    while (reader->model.index <= index)
+    {
+        trace_model_next(&reader->model, &reader->expected);
+    }
+    if (!sim_same(&frame, &reader->expected))
+    {
+        reader->errors++;
+        return true;
+    }
+
+    if (0u == reader->read)
+    {
+        reader->first = index;
+    }
+    reader->last = index;
+    reader->read++;
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_option
+********************************************************************************
+* Summary:
+*   Stores the value of a "--name value" option in the matching field.
+*
+* Return:
+*  false if the option is unknown.
+*
+*******************************************************************************/
+static bool sim_option(sim_args_t *args, const char *name, const char *value)
+{
+    const double number = strtod(value, NULL);
+    struct
+    {
+        const char *name;
+        double *field;
+    } const options[] =
+    {
+        { "--frames",             &args->frames },
+        { "--sector-size",        &args->sectorSize },
+        { "--sectors",            &args->sectors },
+        { "--page-size",          &args->pageSize },
+        { "--cut-every-ops",      &args->cutEveryOps },
+        { "--flush-every",        &args->flushEvery },
+        { "--device-sectors",     &args->deviceSectors },
+        { "--device-sector-size", &args->deviceSectorSize },
+        { "--raw",                &args->trace.raw },
+        { "--signal",             &args->trace.signal },
+        { "--noise",              &args->trace.noise },
+        { "--touches-per-hour",   &args->trace.touchesPerHour },
+    };
+
+    for (const auto &option : options)
+    {
+        if (0 == strcmp(name, option.name))
+        {
+            *option.field = number;
+            return true;
+        }
+    }
+
+    if (0 == strcmp(name, "--file"))
+    {
+        args->file = value;
+    }
+    else if (0 == strcmp(name, "--sensors"))
+    {
+        args->trace.sensors = (uint32_t)number;
+    }
+    else if (0 == strcmp(name, "--period-ms"))
+    {
+        args->trace.periodMs = (uint32_t)number;
+    }
+    else if (0 == strcmp(name, "--seed"))
+    {
+        args->trace.seed = (uint32_t)number;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   Writes the frames of a simulated trace to an emulated flash through
+*   capsense_log.cpp, the same way capsense_logger.cpp does on the kit, with
+*   power cuts at random program and erase operations followed by a mount,
+*   and flushes as the logger thread does when the queue goes idle.
+*   Then reads the log back and checks that every frame decodes to what was
+*   written, in order, and that only frames still in the page buffer at a
+*   cut are missing. Prints the encoded size, the spread of the erase counts
+*   and the history that fits into the log region of the kit. Returns 1 if a
+*   check fails.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    sim_args_t args =
+    {
+        .file             = "capsense_log.bin",
+        .frames           = 200000.0,
+        .sectorSize       = 16384.0,
+        .sectors          = 16.0,
+        .pageSize         = 512.0,
+        .cutEveryOps      = 500.0,
+        .flushEvery       = 50.0,
+        .deviceSectors    = 256.0,
+        .deviceSectorSize = 262144.0,
+        .trace            = {}
+    };
+    trace_model_defaults(&args.trace);
+
+    for (int i = 1; i < argc; i += 2)
+    {
+        if ((i + 1 >= argc) || !sim_option(&args, argv[i], argv[i + 1]))
+        {
+            fprintf(stderr, "usage: %s [--file image] [--frames n] [--sensors n] [--period-ms ms] [--seed n]\n"
+                    "       [--sector-size bytes] [--sectors n] [--page-size bytes] [--cut-every-ops n]\n"
+                    "       [--flush-every frames]\n"
+                    "       [--raw counts] [--signal counts] [--noise counts] [--touches-per-hour n]\n"
+                    "       [--device-sectors n] [--device-sector-size bytes]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const uint32_t sensors = args.trace.sensors;
+    const uint32_t frames = (uint32_t)args.frames;
+    if ((0u == sensors) || (sensors > CAPSENSE_FRAME_MAX_SENSORS) || (0u == args.trace.periodMs))
+    {
+        fprintf(stderr, "capsense_log_sim: 1 to %u sensors and a period of at least 1 ms\n",
+                (unsigned)CAPSENSE_FRAME_MAX_SENSORS);
+        return 2;
+    }
+
+    /* Start from an erased flash; the image is kept for inspection */
+    flash_emu_t emu;
+    capsense_log_flash_t flash;
+    (void)remove(args.file);
+    if (!flash_emu_open(&emu, args.file, (uint32_t)args.sectorSize, (uint32_t)args.sectors,
+                        (uint32_t)args.pageSize))
+    {
+        fprintf(stderr, "capsense_log_sim: cannot create %s\n", args.file);
+        return 2;
+    }
+    flash_emu_bind(&emu, &flash);
+
+    std::mt19937 rng(args.trace.seed ^ 0xC0DEu);
+    std::uniform_int_distribution<uint32_t> cutAfter(1u, (uint32_t)(2.0 * args.cutEveryOps) + 1u);
+    trace_model_t model;
+    capsense_frame_t frame;
+    capsense_log_t log;
+    capsense_frame_state_t state;
+    uint8_t encoded[CAPSENSE_FRAME_MAX_SIZE(CAPSENSE_FRAME_MAX_SENSORS)];
+    uint64_t written = 0u;
+    uint32_t appended = 0u;
+    uint32_t cuts = 0u;
+    bool failed = false;
+
+    trace_model_init(&model, &args.trace);
+    trace_model_next(&model, &frame);
+
+    /* Every pass of the outer loop is one power cycle of the kit */
+    while ((model.index <= frames) && !failed)
+    {
+        flash_emu_power_on(&emu);
+        if (args.cutEveryOps > 0.0)
+        {
+            flash_emu_cut(&emu, cutAfter(rng));
+        }
+        if (CAPSENSE_LOG_OK != capsense_log_mount(&log, &flash))
+        {
+            failed = !emu.off;
+            cuts += emu.off ? 1u : 0u;
+            continue;
+        }
+        capsense_frame_reset(&state);
+
+        while (model.index <= frames)
+        {
+            bool key = !capsense_log_fits(&log, CAPSENSE_FRAME_MAX_SIZE(sensors));
+            uint32_t length = capsense_frame_encode(&state, key, CAPSENSE_FRAME_ALL, &frame, encoded);
+
+            if (CAPSENSE_LOG_OK != capsense_log_append(&log, encoded, length))
+            {
+                failed = !emu.off;
+                break;
+            }
+            written += CAPSENSE_LOG_RECORD_HEADER_SIZE + length;
+            appended++;
+            trace_model_next(&model, &frame);
+
+            /* The padding of a flush counts as written */
+            if ((args.flushEvery >= 1.0) && (0u == (appended % (uint32_t)args.flushEvery)))
+            {
+                const uint32_t offset = log.offset;
+
+                if (CAPSENSE_LOG_OK != capsense_log_flush(&log))
+                {
+                    failed = !emu.off;
+                    break;
+                }
+                written += log.offset - offset;
+            }
+        }
+
+        if (emu.off)
+        {
+            /* The frame being appended when the power failed is gone */
+            cuts++;
+            trace_model_next(&model, &frame);
+        }
+    }
+
+    flash_emu_cut(&emu, 0u);
+    if (failed || (CAPSENSE_LOG_OK != capsense_log_flush(&log)))
+    {
+        fprintf(stderr, "capsense_log_sim: the log failed without a power cut\n");
+        flash_emu_close(&emu);
+        return 1;
+    }
+
+    sim_reader_t reader = {};
+    trace_model_init(&reader.model, &args.trace);
+    reader.frames = frames;
+    if (CAPSENSE_LOG_OK != capsense_log_read(&flash, sim_record, &reader))
+    {
+        fprintf(stderr, "capsense_log_sim: reading %s failed\n", args.file);
+        flash_emu_close(&emu);
+        return 1;
+    }
+
+    uint32_t eraseMin = emu.erases[0];
+    uint32_t eraseMax = emu.erases[0];
+    for (uint32_t s = 1u; s < emu.sectorCount; s++)
+    {
+        eraseMin = (emu.erases[s] < eraseMin) ? emu.erases[s] : eraseMin;
+        eraseMax = (emu.erases[s] > eraseMax) ? emu.erases[s] : eraseMax;
+    }
+    flash_emu_close(&emu);
+
+    /* A cut loses at most the records of one unprogrammed page and the
+     * record being appended. A delta frame takes at least 2 bytes plus
+     * one bitmap byte per stream.
+     */
+    const uint32_t lost = (0u == reader.read) ? 0u : ((reader.last - reader.first + 1u) - reader.read);
+    const uint32_t lostPerCut = ((uint32_t)args.pageSize / (CAPSENSE_LOG_RECORD_HEADER_SIZE + 3u + CAPSENSE_FRAME_STREAMS)) + 2u;
+    const double bytesPerFrame = (appended > 0u) ? ((double)written / appended) : 0.0;
+    const double historyHours = (bytesPerFrame > 0.0) ?
+        ((args.deviceSectors - 1.0) * (args.deviceSectorSize - CAPSENSE_LOG_HEADER_SIZE) / bytesPerFrame *
+         args.trace.periodMs / 3600000.0) : 0.0;
+
+    printf("frames,appended,read,lost,cuts,decode_errors,bytes_per_frame,plain_bytes_per_frame,"
+           "erase_min,erase_max,history_hours\n");
+    printf("%u,%u,%u,%u,%u,%u,%.2f,%u,%u,%u,%.1f\n", (unsigned)frames, (unsigned)appended,
+           (unsigned)reader.read, (unsigned)lost, (unsigned)cuts, (unsigned)reader.errors, bytesPerFrame,
+           (unsigned)(4u + (2u * CAPSENSE_FRAME_STREAMS * sensors)), (unsigned)eraseMin, (unsigned)eraseMax,
+           historyHours);
+
+    if ((0u != reader.errors) || (0u == reader.read) || (reader.last != (frames - 1u)) ||
+        (lost > (cuts * lostPerCut)) || ((eraseMax - eraseMin) > (cuts + 1u)))
+    {
+        fprintf(stderr, "capsense_log_sim: read-back check failed\n");
+        return 1;
+    }
+    return 0;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,429 @@
+/*******************************************************************************
+* File Name: capsense_power_sim.cpp
+*
+* Description:
+*   Host model of the wake-on-touch power mode. Drives capsense_power.cpp, the
+*   state machine used by main.cpp, with randomly timed touches and a noisy
+*   ganged raw count, and reports the modelled average current and wake
+*   latency against the default 20 ms scan loop. Currents and scan times are
+*   parameters, so measured figures of a kit can be plugged in.
+*
+*   Build with CMake from the tools directory, for example: cmake -S tools -B
+*   build-tools && cmake --build build-tools && build-tools/capsense_power_sim
+*   --touches-per-hour 120
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+#include <vector>
+#include "../capsense_layout.h"
+#include "../capsense_power.h"
+#include "../capsense_sched.h"
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    double durationS;
+    double touchesPerHour;
+    double touchMs;
+    uint32_t seed;
+    double sleepUa;         /* Deep sleep current */
+    double scanUa;          /* CSD block and CPU current while scanning */
+    double sensorScanUs;    /* Scan time of one sensor, also of the ganged sensor */
+    double cpuUa;           /* CPU current while processing */
+    double processUs;       /* Cy_CapSense_ProcessAllWidgets() and touch handling */
+    double tickHz;          /* RTOS tick rate of a build without MBED_TICKLESS */
+    double tickUs;          /* CPU time of one tick wakeup, including deep sleep exit */
+    double rawBaseline;     /* Ganged raw count without touch */
+    double signal;          /* Ganged raw count increase of a touch */
+    double noise;           /* Ganged raw count noise, standard deviation */
+    capsense_power_config_t power;
+} sim_args_t;
+
+typedef struct
+{
+    double chargeUaUs;
+    uint64_t activeUs;
+    uint64_t wotUs;
+    uint64_t wakeups;
+    uint32_t overruns;
+    double latencySumMs;
+    double latencyMaxMs;
+    uint32_t touches;
+    uint32_t missed;
+    uint32_t falseWakes;
+} sim_result_t;
+
+typedef struct
+{
+    double startMs;
+    double endMs;
+} sim_touch_t;
+
+/* Virtual low-power timer of capsense_sched.cpp */
+typedef struct
+{
+    uint64_t nowUs;
+    uint64_t expiryUs;
+} sim_timer_t;
+
+
+/*******************************************************************************
+* Function Name: sim_timer_now
+********************************************************************************
+* Summary:
+*   capsense_sched_timer_t::now on virtual time. Truncated to 32 bits like the
+*   device timer, so the scheduler also runs through wrap-arounds.
+*
+*******************************************************************************/
+static uint32_t sim_timer_now(void *arg)
+{
+    return (uint32_t)((const sim_timer_t *)arg)->nowUs;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_timer_start
+********************************************************************************
+* Summary:
+*   capsense_sched_timer_t::start on virtual time.
+*
+*******************************************************************************/
+static void sim_timer_start(void *arg, uint32_t delayUs)
+{
+    sim_timer_t *timer = (sim_timer_t *)arg;
+
+    timer->expiryUs = timer->nowUs + delayUs;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_touches
+********************************************************************************
+* Summary:
+*   Draws touch start times from a Poisson process. Both modes are simulated
+*   with the same touches.
+*
+*******************************************************************************/
+static std::vector<sim_touch_t> sim_touches(const sim_args_t *args)
+{
+    std::mt19937 rng(args->seed);
+    std::exponential_distribution<double> gap(args->touchesPerHour / 3600000.0);
+    std::vector<sim_touch_t> touches;
+    double t = gap(rng);
+
+    while (t < (args->durationS * 1000.0))
+    {
+        touches.push_back({t, t + args->touchMs});
+        t += args->touchMs + gap(rng);
+    }
+    return touches;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_run
+********************************************************************************
+* Summary:
+*   Runs the scan loop of RunCapSenseScan() against the touches, scheduled by
+*   capsense_sched.cpp on a virtual timer. With wakeOnTouch false every frame
+*   is a full scan at power.activePeriodMs, as in the default build. The wake
+*   latency of a touch runs from its start to the end of the first full scan
+*   that sees it. The device is assumed to be in deep sleep whenever it does
+*   not scan or process, which is the tickless case.
+*
+*******************************************************************************/
+static sim_result_t sim_run(const sim_args_t *args, const std::vector<sim_touch_t> &touches, bool wakeOnTouch)
+{
+    sim_result_t result = {};
+    std::mt19937 rng(args->seed ^ 0x5A5Au);
+    std::normal_distribution<double> noise(0.0, args->noise);
+    const uint64_t endUs = (uint64_t)(args->durationS * 1000000.0);
+    const uint64_t fullScanUs = (uint64_t)((capsense_layout_sensor_count() * args->sensorScanUs) + 0.5);
+    const uint64_t processUs = (uint64_t)(args->processUs + 0.5);
+    const uint64_t gangedScanUs = (uint64_t)(args->sensorScanUs + 0.5);
+    sim_timer_t clock = {0u, 0u};
+    const capsense_sched_timer_t timer = {sim_timer_now, sim_timer_start, &clock};
+    capsense_sched_t sched;
+    capsense_power_t power;
+    size_t next = 0u;
+    bool detected = false;
+
+    capsense_power_init(&power);
+    capsense_sched_init(&sched, &timer, capsense_power_period_ms(&power, &args->power) * 1000u);
+
+    while (clock.expiryUs < endUs)
+    {
+        clock.nowUs = clock.expiryUs;
+        const double tMs = clock.nowUs / 1000.0;
+
+        /* Skip touches that are over, counting the ones no full scan saw */
+        while ((next < touches.size()) && (touches[next].endMs <= tMs))
+        {
+            result.missed += detected ? 0u : 1u;
+            detected = false;
+            next++;
+        }
+        const bool touched = (next < touches.size()) && (touches[next].startMs <= tMs);
+
+        if (wakeOnTouch && (CAPSENSE_POWER_WAKE_ON_TOUCH == power.mode))
+        {
+            double raw = args->rawBaseline + noise(rng) + (touched ? args->signal : 0.0);
+
+            raw = (raw < 0.0) ? 0.0 : ((raw > 65535.0) ? 65535.0 : raw);
+            result.chargeUaUs += args->scanUa * gangedScanUs;
+            clock.nowUs += gangedScanUs;
+            if (!capsense_power_ganged(&power, &args->power, (uint16_t)raw))
+            {
+                result.wotUs += args->power.wotPeriodMs * 1000u;
+                capsense_sched_done(&sched, capsense_power_period_ms(&power, &args->power) * 1000u);
+                continue;
+            }
+            result.falseWakes += touched ? 0u : 1u;
+        }
+
+        result.chargeUaUs += (args->scanUa * fullScanUs) + (args->cpuUa * processUs);
+        clock.nowUs += fullScanUs;
+        if (touched && !detected)
+        {
+            const double latencyMs = (clock.nowUs / 1000.0) - touches[next].startMs;
+
+            result.latencySumMs += latencyMs;
+            result.latencyMaxMs = (latencyMs > result.latencyMaxMs) ? latencyMs : result.latencyMaxMs;
+            result.touches++;
+            detected = true;
+        }
+        clock.nowUs += processUs;
+
+        if (wakeOnTouch)
+        {
+            capsense_power_active(&power, &args->power, touched);
+        }
+        capsense_sched_done(&sched, capsense_power_period_ms(&power, &args->power) * 1000u);
+    }
+
+    result.missed += (uint32_t)(touches.size() - next) - (detected ? 1u : 0u);
+    result.wakeups = sched.wakeups;
+    result.overruns = sched.overruns;
+    result.activeUs = sched.activeUs;
+    result.chargeUaUs += args->sleepUa * (double)(endUs - result.activeUs);
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_ticked
+********************************************************************************
+* Summary:
+*   Adds the wakeups of a periodic RTOS tick to a tickless result, as in a
+*   build without MBED_TICKLESS. Every tick costs args->tickUs of CPU time
+*   that would otherwise be spent in deep sleep.
+*
+*******************************************************************************/
+static sim_result_t sim_ticked(const sim_args_t *args, const sim_result_t *tickless)
+{
+    sim_result_t result = *tickless;
+    const uint64_t ticks = (uint64_t)(args->durationS * args->tickHz);
+    const uint64_t tickActiveUs = (uint64_t)(ticks * args->tickUs);
+
+    result.wakeups += ticks;
+    result.activeUs += tickActiveUs;
+    result.chargeUaUs += (args->cpuUa - args->sleepUa) * (double)tickActiveUs;
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_report
+********************************************************************************
+* Summary:
+*   Prints one CSV record of a simulated mode.
+*
+*******************************************************************************/
+static void sim_report(const char *name, const sim_args_t *args, const sim_result_t *result)
+{
+    const double endUs = args->durationS * 1000000.0;
+
+    printf("%s,%.2f,%.1f,%.2f,%.1f,%.1f,%.1f,%lu,%lu,%lu,%lu\n", name, result->chargeUaUs / endUs,
+           result->wakeups / args->durationS, 100.0 * (1.0 - (result->activeUs / endUs)),
+           (result->touches > 0u) ? (result->latencySumMs / result->touches) : 0.0,
+           result->latencyMaxMs, 100.0 * result->wotUs / endUs,
+           (unsigned long)result->touches, (unsigned long)result->missed,
+           (unsigned long)result->falseWakes, (unsigned long)result->overruns);
+}
+
+
+/*******************************************************************************
+* Function Name: sim_option
+********************************************************************************
+* Summary:
+*   Stores the value of a "--name value" option in the matching field.
+*
+* Return:
+*  false if the option is unknown.
+*
+*******************************************************************************/
+static bool sim_option(sim_args_t *args, const char *name, const char *value)
+{
+    double number = strtod(value, NULL);
+    struct
+    {
+        const char *name;
+        double *field;
+    } const options[] =
+    {
+        { "--duration-s",       &args->durationS },
+        { "--touches-per-hour", &args->touchesPerHour },
+        { "--touch-ms",         &args->touchMs },
+        { "--sleep-ua",         &args->sleepUa },
+        { "--scan-ua",          &args->scanUa },
+        { "--sensor-scan-us",   &args->sensorScanUs },
+        { "--cpu-ua",           &args->cpuUa },
+        { "--process-us",       &args->processUs },
+        { "--tick-hz",          &args->tickHz },
+        { "--tick-us",          &args->tickUs },
+        { "--raw",              &args->rawBaseline },
+        { "--signal",           &args->signal },
+        { "--noise",            &args->noise },
+    };
+
+    for (const auto &option : options)
+    {
+        if (0 == strcmp(name, option.name))
+        {
+            *option.field = number;
+            return true;
+        }
+    }
+
+    if (0 == strcmp(name, "--seed"))
+    {
+        args->seed = (uint32_t)number;
+    }
+    else if (0 == strcmp(name, "--wot-period-ms"))
+    {
+        args->power.wotPeriodMs = (uint32_t)number;
+    }
+    else if (0 == strcmp(name, "--wot-timeout-ms"))
+    {
+        args->power.timeoutMs = (uint32_t)number;
+    }
+    else if (0 == strcmp(name, "--wot-threshold"))
+    {
+        args->power.threshold = (uint16_t)number;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   Simulates the default scan loop and the wake-on-touch scan loop with the
+*   same touches and prints the modelled average current, wakeups, sleep
+*   residency and wake latency of both, tickless and with a periodic RTOS
+*   tick. The defaults follow mbed_app.json and typical PSoC 6 figures; pass
+*   measured currents and scan times of a kit to model it.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    sim_args_t args =
+    {
+        .durationS      = 3600.0,
+        .touchesPerHour = 60.0,
+        .touchMs        = 300.0,
+        .seed           = 1u,
+        .sleepUa        = 7.0,
+        .scanUa         = 1000.0,
+        .sensorScanUs   = 150.0,
+        .cpuUa          = 4000.0,
+        .processUs      = 200.0,
+        .tickHz         = 1000.0,
+        .tickUs         = 15.0,
+        .rawBaseline    = 1500.0,
+        .signal         = 150.0,
+        .noise          = 8.0,
+        .power          = { 20u, 200u, 5000u, 40u, 4u }
+    };
+
+    for (int i = 1; i < argc; i += 2)
+    {
+        if ((i + 1 >= argc) || !sim_option(&args, argv[i], argv[i + 1]))
+        {
+            fprintf(stderr, "usage: %s [--duration-s s] [--touches-per-hour n] [--touch-ms ms] [--seed n]\n"
+                    "       [--sleep-ua uA] [--scan-ua uA] [--sensor-scan-us us] [--cpu-ua uA] [--process-us us]\n"
+                    "       [--tick-hz Hz] [--tick-us us]\n"
+                    "       [--raw counts] [--signal counts] [--noise counts]\n"
+                    "       [--wot-period-ms ms] [--wot-timeout-ms ms] [--wot-threshold counts]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const std::vector<sim_touch_t> touches = sim_touches(&args);
+    const sim_result_t active = sim_run(&args, touches, false);
+    const sim_result_t wot = sim_run(&args, touches, true);
+
+    const sim_result_t activeTicked = sim_ticked(&args, &active);
+    const sim_result_t wotTicked = sim_ticked(&args, &wot);
+
+    printf("mode,avg_ua,wakeups_per_s,sleep_percent,latency_avg_ms,latency_max_ms,wot_percent,"
+           "touches,missed,false_wakes,overruns\n");
+    sim_report("active", &args, &active);
+    sim_report("active_ticked", &args, &activeTicked);
+    sim_report("wake_on_touch", &args, &wot);
+    sim_report("wake_on_touch_ticked", &args, &wotTicked);
+    return 0;
+}
+
+
+/* [] END OF FILE */
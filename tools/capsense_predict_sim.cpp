@@ -0,0 +1,256 @@
+/*******************************************************************************
+* File Name: capsense_predict_sim.cpp
+*
+* Description:
+*   Host check of the predicted slider position, capsense_predict.cpp.
+*   Scripted finger paths (sweeps, an ease in and out, a reversal, a wiggle
+*   and a hold) are scanned at the scan period with a reporting lag and
+*   position noise, and the predicted position must be closer to the finger
+*   than the measured one.
+*
+*   Build with CMake from the tools directory, for example: cmake -S tools -B
+*   build-tools && cmake --build build-tools && build-
+*   tools/capsense_predict_sim
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <random>
+#include "../capsense_predict.h"
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    uint32_t range;
+    uint32_t periodMs;
+    uint32_t lagMs;         /* Age of a measured position when it is reported */
+    uint32_t jitter;        /* Largest position noise */
+    uint32_t seed;
+} sim_args_t;
+
+/* Finger position in fractions of the range at a time since the touch */
+typedef double (*sim_path_t)(double ms);
+
+typedef struct
+{
+    const char *name;
+    uint32_t durationMs;
+    sim_path_t path;
+} sim_scenario_t;
+
+
+/*******************************************************************************
+* Function Name: sim_<path>
+********************************************************************************
+* Summary:
+*   Finger paths of the scenarios.
+*
+*******************************************************************************/
+static double sim_slow(double ms)
+{
+    return 0.1 + (0.8 * ms / 2000.0);
+}
+
+static double sim_fast(double ms)
+{
+    return 0.1 + (0.8 * ms / 400.0);
+}
+
+static double sim_ease(double ms)
+{
+    return 0.1 + (0.4 * (1.0 - cos(M_PI * ms / 800.0)));
+}
+
+static double sim_reversal(double ms)
+{
+    return (ms < 600.0) ? (0.2 + (0.6 * ms / 600.0)) : (0.8 - (0.6 * (ms - 600.0) / 600.0));
+}
+
+static double sim_wiggle(double ms)
+{
+    return 0.5 + (0.1 * sin(2.0 * M_PI * ms / 400.0));
+}
+
+static double sim_hold(double ms)
+{
+    (void)ms;
+    return 0.5;
+}
+
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static const sim_scenario_t sim_scenarios[] =
+{
+    { "slow_sweep", 2000u, sim_slow },
+    { "fast_sweep", 400u,  sim_fast },
+    { "ease",       800u,  sim_ease },
+    { "reversal",   1200u, sim_reversal },
+    { "wiggle",     1200u, sim_wiggle },
+    { "hold",       1000u, sim_hold },
+};
+
+
+/*******************************************************************************
+* Function Name: sim_option
+********************************************************************************
+* Summary:
+*   Stores the value of a "--name value" option in the matching field.
+*
+* Return:
+*  false if the option is unknown.
+*******************************************************************************/
+static bool sim_option(sim_args_t *args, const char *name, const char *value)
+{
+    uint32_t number = (uint32_t)strtoul(value, NULL, 0);
+    struct
+    {
+        const char *name;
+        uint32_t *field;
+    } const options[] =
+    {
+        { "--range",     &args->range },
+        { "--period-ms", &args->periodMs },
+        { "--lag-ms",    &args->lagMs },
+        { "--jitter",    &args->jitter },
+        { "--seed",      &args->seed },
+    };
+
+    for (const auto &option : options)
+    {
+        if (0 == strcmp(name, option.name))
+        {
+            *option.field = number;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   Runs every scenario through capsense_predict_update() with the firmware
+*   defaults. Each scan measures the finger as it was --lag-ms earlier, with
+*   noise, and both the measured and the predicted position are compared
+*   with where the finger is at the scan. A scenario passes if the
+*   prediction is on average within 5% of the measurement or closer, and
+*   never farther off than the measurement ever is plus the travel of one
+*   scan period: a finger that turns around is overshot by up to that much
+*   before the reversal shows.
+*
+* Return:
+*  0 if every scenario passes, 1 otherwise, 2 for a usage error.
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    sim_args_t args =
+    {
+        .range    = 300u,
+        .periodMs = 20u,
+        .lagMs    = 20u,
+        .jitter   = 2u,
+        .seed     = 1u
+    };
+
+    for (int i = 1; i < argc; i += 2)
+    {
+        if ((i + 1 >= argc) || !sim_option(&args, argv[i], argv[i + 1]) || (0u == args.periodMs))
+        {
+            fprintf(stderr, "usage: %s [--range positions] [--period-ms ms] [--lag-ms ms] [--jitter positions]\n"
+                    "       [--seed n]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    const capsense_predict_config_t cfg = capsense_predict_config(args.range);
+    std::mt19937 rng(args.seed);
+    std::uniform_int_distribution<int32_t> noise(-(int32_t)args.jitter, (int32_t)args.jitter);
+    bool failed = false;
+
+    printf("scenario,scans,measured_avg,measured_max,predicted_avg,predicted_max,result\n");
+    for (const sim_scenario_t &scenario : sim_scenarios)
+    {
+        capsense_predict_t ctx = {};
+        double measuredSum = 0.0;
+        double measuredMax = 0.0;
+        double predictedSum = 0.0;
+        double predictedMax = 0.0;
+        double travelMax = 0.0;
+        uint32_t scans = 0u;
+
+        for (uint32_t ms = 0u; ms <= scenario.durationMs; ms += args.periodMs)
+        {
+            const double finger = scenario.path(ms) * args.range;
+            const double seen = scenario.path(fmax(0.0, (double)ms - args.lagMs)) * args.range;
+            const double before = scenario.path(fmax(0.0, (double)ms - args.periodMs)) * args.range;
+            const int32_t noisy = (int32_t)lround(seen) + noise(rng);
+            const uint32_t measured = (uint32_t)((noisy < 0) ? 0 : ((noisy > (int32_t)args.range) ? args.range :
+                                                                    (uint32_t)noisy));
+            const uint32_t predicted = capsense_predict_update(&ctx, &cfg, 1000u + ms, true, measured);
+
+            measuredSum += fabs(measured - finger);
+            measuredMax = fmax(measuredMax, fabs(measured - finger));
+            predictedSum += fabs(predicted - finger);
+            predictedMax = fmax(predictedMax, fabs(predicted - finger));
+            travelMax = fmax(travelMax, fabs(finger - before));
+            scans++;
+        }
+
+        const bool pass = (predictedSum <= (measuredSum * 1.05)) && (predictedMax <= (measuredMax + travelMax));
+        printf("%s,%lu,%.2f,%.1f,%.2f,%.1f,%s\n", scenario.name, (unsigned long)scans, measuredSum / scans,
+               measuredMax, predictedSum / scans, predictedMax, pass ? "ok" : "fail");
+        failed = failed || !pass;
+    }
+    return failed ? 1 : 0;
+}
+
+
+/* [] END OF FILE */
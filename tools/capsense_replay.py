@@ -0,0 +1,473 @@
+#!/usr/bin/env python3
+"""
+Replays golden traces on the kit and checks touch decisions and processing cost.
+
+The corpus holds synthesized traces, generated here for the widgets of the
+kit, and recorded ones: every CSV file in --golden with the columns raw<n>
+for each sensor, as written by capsense_log_analyze --csv. The traces are
+compiled into the firmware, which is built with the "capsense-replay"
+application option and flashed. capsense_replay_run() feeds every scan
+through Cy_CapSense_ProcessAllWidgets() and the touch reporting of the demo
+and prints the events and the processing cost in CPU cycles.
+
+The golden file of each kit is --golden/<kit>.json. For a synthesized
+trace it holds the event windows derived from the synthesis parameters:
+every tap must give one press and one release, and every swipe position
+events from its start to its end, within --latency scans of the finger and
+--position-tolerance of the slider resolution. No other event may occur.
+--expect writes these windows for every kit and --expect --check verifies
+the committed ones, as the host build does. A recorded trace must give the
+same events as when it was accepted with --update. The check also fails if
+a trace changed since the golden file was written, if the kit has no golden
+file, or if the average processing cost rose by more than --tolerance over
+the cost accepted with --update. Run it before changing thresholds, filters
+or the middleware version; after an intended change, review the differences
+and accept them with --update.
+
+Usage:
+    python tools/capsense_replay.py --port /dev/ttyACM0
+    python tools/capsense_replay.py --port /dev/ttyACM0 --update
+    python tools/capsense_replay.py --expect
+    python tools/capsense_replay.py --corpus corpus/capsense_replay_corpus.cpp
+"""
+
+import argparse
+import csv
+import glob
+import hashlib
+import json
+import math
+import os
+import random
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+import tuner_map
+
+ROOT = tuner_map.ROOT
+DEFAULT_KIT = "CY8CPROTO_062_4343W"
+RECORD = "replay,"
+CORPUS_NAME = "capsense_replay_corpus.cpp"
+SYNTHESIZED = ("button_taps", "slider_swipe", "idle_drift")
+
+
+class ReplayError(Exception):
+    pass
+
+
+def sensor_levels(sensors):
+    """Raw count of every sensor without touch."""
+    return [1500.0 + 37.0 * s for s in range(sensors)]
+
+
+def schedule(widgets, name):
+    """Returns the scans and the touches of a synthesized scenario.
+
+    button_taps: every button is tapped three times for 200 ms.
+    slider_swipe: a finger swipes every slider end to end and back, twice.
+    idle_drift: 30 s without touch, with a slow drift.
+    """
+    touches = []        # (first frame, frames, widget, start position, end position)
+    frames = 0
+
+    if name == "button_taps":
+        for widget in (w for w in widgets if w["button"]):
+            for _ in range(3):
+                touches.append((frames + 25, 10, widget, 0.0, 0.0))
+                frames += 50
+    elif name == "slider_swipe":
+        for widget in (w for w in widgets if not w["button"]):
+            end = widget["numSns"] - 1.0
+            for _ in range(2):
+                touches.append((frames + 25, 50, widget, 0.0, end))
+                touches.append((frames + 100, 50, widget, end, 0.0))
+                frames += 175
+    elif name == "idle_drift":
+        frames = 1500
+    return frames + 25, touches
+
+
+def synthesize(widgets, name, args):
+    """Returns the raw counts of a synthesized scenario, one row per scan.
+
+    idle_drift has twice the noise of the others.
+    """
+    rng = random.Random(args.seed + sum(map(ord, name)))
+    sensors = sum(w["numSns"] for w in widgets)
+    level = sensor_levels(sensors)
+    noise = args.noise * (2.0 if name == "idle_drift" else 1.0)
+    frames, touches = schedule(widgets, name)
+
+    rows = []
+    for frame in range(frames):
+        drift = (args.drift * frame / frames) if name == "idle_drift" else 0.0
+        signal = [0.0] * sensors
+        for first, length, widget, start, end in touches:
+            if first <= frame < first + length:
+                if widget["button"]:
+                    signal[widget["snsContext"]] += args.signal
+                else:
+                    x = start + (end - start) * (frame - first) / (length - 1.0)
+                    for segment in range(widget["numSns"]):
+                        share = max(0.0, 1.0 - abs(x - segment))
+                        signal[widget["snsContext"] + segment] += args.signal * share
+        rows.append([max(0, min(0xFFFF, int(round(level[s] + drift + signal[s] + rng.gauss(0.0, noise)))))
+                     for s in range(sensors)])
+    return rows
+
+
+def path_span(path, first, last):
+    """Positions a slider may report for the finger of path during scans first to last."""
+    (start_frame, end_frame), (start, end) = path["scans"], path["values"]
+    ends = []
+    for frame in (first, last):
+        frame = max(start_frame, min(end_frame, frame))
+        ends.append(start + (end - start) * (frame - start_frame) / float(end_frame - start_frame))
+    return [max(0, int(math.floor(min(ends) - path["tolerance"]))),
+            min(path["resolution"], int(math.ceil(max(ends) + path["tolerance"])))]
+
+
+def expect(widgets, name, args):
+    """Returns the event windows of a synthesized scenario.
+
+    A window holds the events of one widget within a range of scans; their
+    number and values must stay within its limits. A slider window also
+    bounds the scan and value of its first event and the value of its last,
+    and every position must lie on the path of the finger. Every event must
+    fall into a window. A decision may lag the finger by --latency scans,
+    which covers debounce and filtering.
+    """
+    _, touches = schedule(widgets, name)
+    latency = args.latency
+    windows = []
+    for first, length, widget, start, end in touches:
+        last = first + length - 1
+        if widget["button"]:
+            windows.append({"widget": widget["wdContext"], "scans": [first, first + latency],
+                            "values": [1, 1], "count": [1, 1]})
+            windows.append({"widget": widget["wdContext"], "scans": [last + 1, last + 1 + latency],
+                            "values": [0, 0], "count": [1, 1]})
+        else:
+            scale = widget["xResolution"] / (widget["numSns"] - 1.0)
+            path = {"scans": [first, last], "values": [round(start * scale), round(end * scale)],
+                    "resolution": widget["xResolution"], "latency": latency,
+                    "tolerance": int(math.ceil(args.position_tolerance * widget["xResolution"]))}
+            windows.append({"widget": widget["wdContext"], "scans": [first, last + latency],
+                            "values": path_span(path, first, last), "count": [1, length + latency],
+                            "first": {"scans": [first, first + latency],
+                                      "values": path_span(path, first, first + latency)},
+                            "last": {"values": path_span(path, last - latency, last)},
+                            "path": path})
+    return windows
+
+
+def check_windows(windows, events):
+    """Returns the events that break the windows of a trace as a list of messages."""
+    problems = []
+    claimed = set()
+    for number, window in enumerate(windows):
+        first, last = window["scans"]
+        inside = [event for event in events if event[1] == window["widget"] and first <= event[0] <= last]
+        claimed.update(map(tuple, inside))
+        where = "window {} (widget {}, scans {} to {})".format(number, window["widget"], first, last)
+        low, high = window["count"]
+        if not low <= len(inside) <= high:
+            problems.append("{}: {} events, expected {} to {}".format(where, len(inside), low, high))
+        for event in inside:
+            if not window["values"][0] <= event[2] <= window["values"][1]:
+                problems.append("{}: event {} outside the values {}".format(where, event, window["values"]))
+                break
+        if "path" in window:
+            path = window["path"]
+            for event in inside:
+                values = path_span(path, event[0] - path["latency"], event[0])
+                if not values[0] <= event[2] <= values[1]:
+                    problems.append("{}: event {} off the path of the finger, expected values {}"
+                                    .format(where, event, values))
+                    break
+        if inside and "first" in window:
+            scans, values = window["first"]["scans"], window["first"]["values"]
+            if not (scans[0] <= inside[0][0] <= scans[1] and values[0] <= inside[0][2] <= values[1]):
+                problems.append("{}: first event {}, expected scans {} and values {}"
+                                .format(where, inside[0], scans, values))
+        if inside and "last" in window:
+            values = window["last"]["values"]
+            if not values[0] <= inside[-1][2] <= values[1]:
+                problems.append("{}: last event {}, expected values {}".format(where, inside[-1], values))
+    unexpected = [event for event in events if tuple(event) not in claimed]
+    if unexpected:
+        problems.append("{} events outside every window, the first {} (scan, widget, value)"
+                        .format(len(unexpected), unexpected[0]))
+    return problems
+
+
+def golden_path(args, kit):
+    return os.path.join(args.golden, kit + ".json")
+
+
+def derive(args):
+    """Writes or, with --check, verifies the event windows in the golden file of every kit.
+
+    The costs and events accepted with --update are kept as long as the
+    trace is unchanged.
+    """
+    status = 0
+    for kit in tuner_map.kits():
+        _, widgets, _ = tuner_map.load(kit)
+        path = golden_path(args, kit)
+        golden = {}
+        if os.path.exists(path):
+            with open(path) as f:
+                golden = json.load(f)
+        derived = dict(golden)
+        for name in SYNTHESIZED:
+            rows = synthesize(widgets, name, args)
+            entry = {"digest": digest(rows), "frames": len(rows), "expected": expect(widgets, name, args)}
+            kept = golden.get(name, {})
+            if kept.get("digest") == entry["digest"]:
+                entry = dict(kept, **entry)
+            derived[name] = entry
+        if args.check:
+            if derived != golden:
+                print("capsense_replay: {} is out of date; run --expect".format(path), file=sys.stderr)
+                status = 1
+        elif derived != golden:
+            os.makedirs(args.golden, exist_ok=True)
+            with open(path, "w") as f:
+                json.dump(derived, f, indent=1, sort_keys=True)
+                f.write("\n")
+            print("capsense_replay: wrote " + path, file=sys.stderr)
+    return status
+
+
+def read_trace(path, sensors):
+    """Raw counts of a recorded trace CSV."""
+    with open(path, newline="") as f:
+        reader = csv.reader(f)
+        header = next(reader, [])
+        columns = [header.index("raw{}".format(s)) if "raw{}".format(s) in header else None
+                   for s in range(sensors)]
+        if None in columns:
+            raise ReplayError("{}: needs the columns raw0 to raw{}".format(path, sensors - 1))
+        return [[int(row[c]) for c in columns] for row in reader if row]
+
+
+def corpus(args, widgets):
+    """Returns [(name, rows)]: the synthesized scenarios, then the recorded traces."""
+    sensors = sum(w["numSns"] for w in widgets)
+    traces = [(name, synthesize(widgets, name, args)) for name in ("button_taps", "slider_swipe", "idle_drift")]
+    for path in sorted(glob.glob(os.path.join(args.golden, "*.csv"))):
+        traces.append((os.path.splitext(os.path.basename(path))[0], read_trace(path, sensors)))
+    return [(name, rows) for name, rows in traces if rows]
+
+
+def digest(rows):
+    return hashlib.sha1(json.dumps(rows).encode("ascii")).hexdigest()
+
+
+def render(traces):
+    """C++ source of the corpus for capsense_replay.h."""
+    lines = ["/* Generated by tools/capsense_replay.py, do not edit */",
+             '#include "capsense_replay.h"', ""]
+    for index, (name, rows) in enumerate(traces):
+        lines.append("static const uint16_t capsense_replay_raw_{}[] =".format(index))
+        lines.append("{")
+        lines += ["    " + ", ".join("{}u".format(v) for v in row) + "," for row in rows]
+        lines += ["};", ""]
+    lines.append("const capsense_replay_trace_t capsense_replay_traces[] =")
+    lines.append("{")
+    for index, (name, rows) in enumerate(traces):
+        lines.append('    {{ "{}", {}u, {}u, capsense_replay_raw_{} }},'.format(name, len(rows[0]), len(rows), index))
+    lines += ["};", "",
+              "const uint32_t capsense_replay_trace_count = {}u;".format(len(traces)), ""]
+    return "\n".join(lines)
+
+
+def app_config():
+    """Writes mbed_app.json with the replay enabled to a temporary file."""
+    with open(os.path.join(ROOT, "mbed_app.json")) as f:
+        config = json.load(f)
+    config["config"]["capsense-replay"]["value"] = 1
+    handle, path = tempfile.mkstemp(suffix=".json", prefix="mbed_app_replay_")
+    with os.fdopen(handle, "w") as f:
+        json.dump(config, f, indent=4)
+    return path
+
+
+def build(args, config, source):
+    build_dir = os.path.join(ROOT, "BUILD", "capsense_replay", args.kit)
+    command = ["mbed", "compile", "-m", args.kit, "-t", args.toolchain, "--app-config", config,
+               "--source", ROOT, "--source", source, "--build", build_dir, "--flash"]
+    if subprocess.call(command, cwd=ROOT) != 0:
+        raise ReplayError("build failed: " + " ".join(command))
+
+
+def read_results(args):
+    """Resets the board and returns {trace: {"events": [...], cost fields}}."""
+    import serial
+
+    results = {}
+    with serial.Serial(args.port, args.baud, timeout=1) as port:
+        port.reset_input_buffer()
+        port.send_break()
+        deadline = time.time() + args.timeout
+        while time.time() < deadline:
+            line = port.readline().decode("ascii", "replace").strip()
+            if not line.startswith(RECORD):
+                continue
+            fields = line[len(RECORD):].split(",")
+            if fields[0] == "done":
+                return results
+            if fields[0] == "error":
+                raise ReplayError("board rejected trace {}: {}".format(fields[1], ",".join(fields[2:])))
+            trace = results.setdefault(fields[1], {"events": []})
+            if fields[0] == "event":
+                trace["events"].append([int(v) for v in fields[2:5]])
+            elif fields[0] == "trace":
+                keys = ("frames", "cpu_hz", "process_min", "process_avg", "process_max")
+                trace.update(zip(keys, (int(v) for v in fields[2:7])))
+    raise ReplayError("no replay,done on {} within {} s".format(args.port, args.timeout))
+
+
+def compare(name, golden, result, args):
+    """Returns the differences of one trace as a list of messages.
+
+    With --update only the event windows of a synthesized trace are checked.
+    """
+    if name in SYNTHESIZED:
+        if golden is None or "expected" not in golden:
+            return ["no event windows in the golden file; derive them with --expect"]
+        if golden["digest"] != result["digest"]:
+            return ["the synthesis parameters differ from the golden file; derive it with --expect"]
+        problems = check_windows(golden["expected"], result["events"])
+    else:
+        if golden is None:
+            return [] if args.update else ["no golden events; record them with --update"]
+        if golden["digest"] != result["digest"]:
+            return [] if args.update else ["the trace changed since the golden events were recorded; "
+                                           "review and --update"]
+        problems = [] if args.update else compare_events(golden["events"], result["events"])
+
+    if args.update:
+        return problems
+    if "process_avg" not in golden:
+        return problems + ["no golden cost; record it with --update"]
+    limit = golden["process_avg"] * (1.0 + args.tolerance)
+    if result["process_avg"] > limit:
+        problems.append("processing takes {} cycles per scan on average, {} before (limit {:.0f})"
+                        .format(result["process_avg"], golden["process_avg"], limit))
+    return problems
+
+
+def compare_events(expected, actual):
+    """Returns the differences of the events of a recorded trace as a list of messages."""
+    problems = []
+    for index in range(max(len(expected), len(actual))):
+        want = expected[index] if index < len(expected) else None
+        got = actual[index] if index < len(actual) else None
+        if want != got:
+            problems.append("event {}: expected {}, got {} (scan, widget, value)".format(index, want, got))
+            break
+    if len(expected) != len(actual):
+        problems.append("{} events, expected {}".format(len(actual), len(expected)))
+    return problems
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--kit", default=DEFAULT_KIT, help="kit (default %(default)s)")
+    parser.add_argument("--toolchain", default="GCC_ARM")
+    parser.add_argument("--port", help="serial port of the kit")
+    parser.add_argument("--corpus", help="only write the corpus source to this file")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=120.0, help="seconds to wait for the replay")
+    parser.add_argument("--golden", default=os.path.join(ROOT, "tools", "golden"),
+                        help="directory of recorded traces and golden files (default %(default)s)")
+    parser.add_argument("--tolerance", type=float, default=0.10, help="allowed rise of the average cost")
+    parser.add_argument("--update", action="store_true", help="accept the results as the new golden file")
+    parser.add_argument("--expect", action="store_true",
+                        help="only derive the event windows of the synthesized traces for every kit")
+    parser.add_argument("--check", action="store_true", help="with --expect, verify the golden files instead")
+    parser.add_argument("--latency", type=int, default=8, help="scans an event may lag the finger")
+    parser.add_argument("--position-tolerance", type=float, default=0.10,
+                        help="allowed slider position error, a fraction of the resolution")
+    parser.add_argument("--seed", type=int, default=1, help="noise seed of the synthesized traces")
+    parser.add_argument("--noise", type=float, default=5.0, help="raw count noise of the synthesized traces")
+    parser.add_argument("--signal", type=float, default=200.0, help="raw count increase of a touch")
+    parser.add_argument("--drift", type=float, default=40.0, help="raw count drift of idle_drift")
+    args = parser.parse_args()
+
+    if args.check and not args.expect:
+        parser.error("--check needs --expect")
+    if args.expect:
+        try:
+            return derive(args)
+        except tuner_map.MapError as e:
+            print("capsense_replay: " + str(e), file=sys.stderr)
+            return 1
+    if args.corpus is None and args.port is None:
+        parser.error("--port, --corpus or --expect is required")
+    if args.corpus is None and shutil.which("mbed") is None:
+        parser.error("mbed-cli is not on PATH")
+
+    path = golden_path(args, args.kit)
+    try:
+        _, widgets, _ = tuner_map.load(args.kit)
+        traces = corpus(args, widgets)
+        if args.corpus:
+            with open(args.corpus, "w") as f:
+                f.write(render(traces))
+            return 0
+        if not os.path.exists(path):
+            raise ReplayError("no golden file {}; derive it with --expect".format(path))
+        with open(path) as f:
+            golden = json.load(f)
+        source = tempfile.mkdtemp(prefix="capsense_replay_")
+        config = app_config()
+        try:
+            with open(os.path.join(source, CORPUS_NAME), "w") as f:
+                f.write(render(traces))
+            build(args, config, source)
+            results = read_results(args)
+        finally:
+            shutil.rmtree(source)
+            os.remove(config)
+    except (ReplayError, tuner_map.MapError) as e:
+        print("capsense_replay: " + str(e), file=sys.stderr)
+        return 1
+
+    failed = False
+    print("trace,frames,events,process_avg,process_max,us_per_scan,result")
+    for name, rows in traces:
+        result = results.get(name)
+        if result is None or "process_avg" not in result:
+            print("{},{},,,,,missing".format(name, len(rows)))
+            failed = True
+            continue
+        result["digest"] = digest(rows)
+        problems = compare(name, golden.get(name), result, args)
+        us = result["process_avg"] * 1e6 / result["cpu_hz"] if result["cpu_hz"] else math.nan
+        print("{},{},{},{},{},{:.1f},{}".format(name, result["frames"], len(result["events"]),
+                                                result["process_avg"], result["process_max"], us,
+                                                "fail" if problems else "ok"))
+        for problem in problems:
+            print("capsense_replay: {}: {}".format(name, problem), file=sys.stderr)
+        failed = failed or bool(problems)
+        accepted = ("process_avg", "process_max") if name in SYNTHESIZED else ("frames", "process_avg",
+                                                                                "process_max", "events")
+        golden[name] = dict(golden.get(name, {}), digest=result["digest"], **{key: result[key] for key in accepted})
+
+    if args.update and not failed:
+        with open(path, "w") as f:
+            json.dump(golden, f, indent=1, sort_keys=True)
+            f.write("\n")
+        print("capsense_replay: wrote " + path, file=sys.stderr)
+        return 0
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,346 @@
+/*******************************************************************************
+* File Name: capsense_seqlock_bench.cpp
+*
+* Description:
+*   Host contention benchmark of capsense_seqlock.h. One writer thread stands
+*   in for the scan thread and publishes touch-state records, a number of
+*   reader threads read them as fast as they can. The same load runs once with
+*   the seqlock and once with a mutex; the write times show how long the
+*   readers hold up the writer, and every record read is checked for
+*   consistency.
+*
+*   Build with CMake from the tools directory, for example: cmake -S tools -B
+*   build-tools && cmake --build build-tools && build-
+*   tools/capsense_seqlock_bench --readers 4
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../capsense_layout.h"
+#include "../capsense_seqlock.h"
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    uint32_t durationMs;
+    uint32_t readers;
+    uint32_t periodUs;      /* Writer period, 0 for back to back */
+} bench_args_t;
+
+/* Same size as capsense_touch_state_t, plus a sequence number */
+typedef struct
+{
+    uint32_t seq;
+    uint32_t timeMs;
+    uint32_t touched;
+    uint32_t twoTouch;
+    uint16_t value[CAPSENSE_LAYOUT_WIDGET_COUNT];
+    uint16_t second[CAPSENSE_LAYOUT_WIDGET_COUNT];
+} bench_record_t;
+
+typedef struct
+{
+    uint64_t writes;
+    uint64_t writeSumNs;
+    uint64_t writeMaxNs;
+    uint64_t reads;
+    uint64_t retries;
+    uint64_t torn;
+} bench_result_t;
+
+typedef enum
+{
+    BENCH_SEQLOCK,
+    BENCH_MUTEX
+} bench_scheme_t;
+
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static std::atomic<uint32_t> bench_words[CAPSENSE_SEQLOCK_WORDS(bench_record_t)];
+static capsense_seqlock_t bench_lock;
+
+static std::mutex bench_mutex;
+static bench_record_t bench_shared;
+
+static std::atomic<bool> bench_stop;
+
+
+/*******************************************************************************
+* Function Name: bench_fill
+********************************************************************************
+* Summary:
+*   Fills a record with contents derived from its seq.
+*
+*******************************************************************************/
+static void bench_fill(uint32_t seq, bench_record_t *record)
+{
+    memset(record, 0, sizeof(*record));
+    record->seq = seq;
+    record->timeMs = seq * 20u;
+    record->touched = ~seq;
+    record->twoTouch = seq >> 1u;
+    for (uint32_t wdgtId = 0u; wdgtId < CAPSENSE_LAYOUT_WIDGET_COUNT; wdgtId++)
+    {
+        record->value[wdgtId] = (uint16_t)(seq + wdgtId);
+        record->second[wdgtId] = (uint16_t)(seq - wdgtId);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: bench_whole
+********************************************************************************
+* Summary:
+*   Returns true if every field of a record belongs to the same seq.
+*
+*******************************************************************************/
+static bool bench_whole(const bench_record_t *record)
+{
+    bench_record_t expected;
+
+    bench_fill(record->seq, &expected);
+    return 0 == memcmp(record, &expected, sizeof(expected));
+}
+
+
+/*******************************************************************************
+* Function Name: bench_writer
+********************************************************************************
+* Summary:
+*   Stands in for the scan thread: publishes a record per period and times
+*   every publication, including any wait for the readers.
+*
+*******************************************************************************/
+static void bench_writer(bench_scheme_t scheme, const bench_args_t *args, bench_result_t *result)
+{
+    bench_record_t record;
+
+    for (uint32_t seq = 1u; !bench_stop.load(std::memory_order_relaxed); seq++)
+    {
+        bench_fill(seq, &record);
+        const auto start = std::chrono::steady_clock::now();
+        if (BENCH_SEQLOCK == scheme)
+        {
+            capsense_seqlock_write(&bench_lock, &record);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(bench_mutex);
+            bench_shared = record;
+        }
+        const uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - start).count();
+
+        result->writes++;
+        result->writeSumNs += ns;
+        result->writeMaxNs = (ns > result->writeMaxNs) ? ns : result->writeMaxNs;
+        if (0u != args->periodUs)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(args->periodUs));
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: bench_reader
+********************************************************************************
+* Summary:
+*   Stands in for an application thread that reads the touch state as fast
+*   as it can.
+*
+*******************************************************************************/
+static void bench_reader(bench_scheme_t scheme, bench_result_t *result)
+{
+    bench_record_t record;
+
+    while (!bench_stop.load(std::memory_order_relaxed))
+    {
+        if (BENCH_SEQLOCK == scheme)
+        {
+            result->retries += capsense_seqlock_read(&bench_lock, &record);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(bench_mutex);
+            record = bench_shared;
+        }
+        result->reads++;
+        result->torn += bench_whole(&record) ? 0u : 1u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: bench_run
+********************************************************************************
+* Summary:
+*   Runs one writer and the readers for the duration and prints one row.
+*
+* Return:
+*  Number of torn records seen.
+*
+*******************************************************************************/
+static uint64_t bench_run(bench_scheme_t scheme, const bench_args_t *args)
+{
+    bench_result_t writer = {};
+    std::vector<bench_result_t> readers(args->readers, bench_result_t());
+    std::vector<std::thread> threads;
+    bench_record_t first;
+
+    bench_fill(0u, &first);
+    capsense_seqlock_init(&bench_lock, bench_words, CAPSENSE_SEQLOCK_WORDS(bench_record_t));
+    capsense_seqlock_write(&bench_lock, &first);
+    bench_shared = first;
+    bench_stop.store(false);
+
+    for (uint32_t i = 0u; i < args->readers; i++)
+    {
+        threads.emplace_back(bench_reader, scheme, &readers[i]);
+    }
+    threads.emplace_back(bench_writer, scheme, args, &writer);
+    std::this_thread::sleep_for(std::chrono::milliseconds(args->durationMs));
+    bench_stop.store(true);
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    bench_result_t total = writer;
+    for (const auto &reader : readers)
+    {
+        total.reads += reader.reads;
+        total.retries += reader.retries;
+        total.torn += reader.torn;
+    }
+    printf("%s,%lu,%llu,%llu,%.4f,%llu,%llu,%llu\n", (BENCH_SEQLOCK == scheme) ? "seqlock" : "mutex",
+           (unsigned long)args->readers, (unsigned long long)total.writes, (unsigned long long)total.reads,
+           (0u != total.reads) ? ((double)total.retries / total.reads) : 0.0,
+           (unsigned long long)((0u != total.writes) ? (total.writeSumNs / total.writes) : 0u),
+           (unsigned long long)total.writeMaxNs, (unsigned long long)total.torn);
+    return total.torn;
+}
+
+
+/*******************************************************************************
+* Function Name: bench_option
+********************************************************************************
+* Summary:
+*   Stores the value of a "--name value" option in the matching field.
+*
+* Return:
+*  false if the option is unknown.
+*
+*******************************************************************************/
+static bool bench_option(bench_args_t *args, const char *name, const char *value)
+{
+    uint32_t number = (uint32_t)strtoul(value, NULL, 0);
+    struct
+    {
+        const char *name;
+        uint32_t *field;
+    } const options[] =
+    {
+        { "--duration-ms", &args->durationMs },
+        { "--readers",     &args->readers },
+        { "--period-us",   &args->periodUs },
+    };
+
+    for (const auto &option : options)
+    {
+        if (0 == strcmp(name, option.name))
+        {
+            *option.field = number;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   Runs the seqlock and a mutex under the same load. The write times show
+*   how much the readers delay the writer, the stand-in for the scan thread.
+*
+* Return:
+*  0 if no reader saw a torn record, 1 otherwise, 2 for a usage error.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    bench_args_t args =
+    {
+        .durationMs = 1000u,
+        .readers    = 4u,
+        .periodUs   = 0u
+    };
+
+    for (int i = 1; i < argc; i += 2)
+    {
+        if ((i + 1 >= argc) || !bench_option(&args, argv[i], argv[i + 1]))
+        {
+            fprintf(stderr, "usage: %s [--duration-ms ms] [--readers n] [--period-us us]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    printf("scheme,readers,writes,reads,retries_per_read,write_avg_ns,write_max_ns,torn\n");
+    const uint64_t torn = bench_run(BENCH_SEQLOCK, &args) + bench_run(BENCH_MUTEX, &args);
+    return (0u == torn) ? 0 : 1;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,384 @@
+/*******************************************************************************
+* File Name: capsense_stuck_sim.cpp
+*
+* Description:
+*   Host check of the stuck-sensor supervisor, capsense_stuck.cpp. A sensor
+*   with a simplified baseline of the CapSense middleware is scanned through
+*   taps, a long hold, an object resting on it, a baseline latched above the
+*   raw count with and without the low baseline reset of the middleware, a
+*   raw count that sinks faster than that reset follows, and slow drift. Each scenario must give its number of touches and of baseline
+*   resets. The cost per sensor and scan is then timed.
+*
+*   Build with CMake from the tools directory, for example: cmake -S tools -B
+*   build-tools && cmake --build build-tools && build-tools/capsense_stuck_sim
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include "../capsense_stuck.h"
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+/* Sensor model, in counts */
+#define SIM_LEVEL                               (1500)
+#define SIM_FINGER                              (200)
+#define SIM_OBJECT                              (150)
+#define SIM_FINGER_TH                           (100)
+#define SIM_NOISE_TH                            (40)
+#define SIM_NEG_NOISE_TH                        (40)
+
+/* Scans timed per call of capsense_stuck_update() */
+#define SIM_TIMING_SCANS                        (10000000u)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    uint32_t periodMs;
+    uint32_t maxOnMs;
+    uint32_t lowBslnRst;
+    uint32_t noise;         /* Largest raw count noise */
+    uint32_t seed;
+} sim_args_t;
+
+/* Sensor with a simplified baseline of the middleware: it follows the raw
+ * count by one count per scan within the noise thresholds and stops under a
+ * touch. Below the negative noise threshold it counts negBslnRstCnt as
+ * Cy_CapSense_FtUpdateBaseline() does: a scan that finds the count at
+ * lowBslnRst resets the baseline to the raw count and zeroes the count
+ * instead, unless lowReset is off.
+ */
+typedef struct
+{
+    int32_t bsln;
+    uint32_t negBslnRstCnt;
+    bool lowReset;
+} sim_sensor_t;
+
+typedef struct
+{
+    const char *name;
+    uint32_t durationMs;
+    int32_t (*signal)(uint32_t ms);     /* Counts added to the raw count */
+    int32_t latched;                    /* Baseline above the raw count at the start, left by an object */
+    bool lowReset;                      /* Low baseline reset of the middleware works */
+    uint32_t onResets;                  /* Expected CAPSENSE_STUCK_ON */
+    uint32_t negativeResets;            /* Expected CAPSENSE_STUCK_NEGATIVE */
+    uint32_t touches;                   /* Expected touches reported */
+} sim_scenario_t;
+
+typedef struct
+{
+    uint32_t scans;
+    uint32_t touches;
+    uint32_t onResets;
+    uint32_t negativeResets;
+    uint32_t stuckMs;       /* Time touched without a finger */
+} sim_result_t;
+
+
+/*******************************************************************************
+* Function Name: sim_<signal>
+********************************************************************************
+* Summary:
+*   Signals of the scenarios.
+*
+*******************************************************************************/
+static int32_t sim_taps(uint32_t ms)
+{
+    return ((ms % 1000u) < 300u) ? SIM_FINGER : 0;
+}
+
+static int32_t sim_hold(uint32_t ms)
+{
+    return ((ms >= 1000u) && (ms < 21000u)) ? SIM_FINGER : 0;
+}
+
+/* An object rests on the sensor for two minutes, then is taken away */
+static int32_t sim_object(uint32_t ms)
+{
+    return ((ms >= 1000u) && (ms < 121000u)) ? SIM_OBJECT : 0;
+}
+
+static int32_t sim_none(uint32_t ms)
+{
+    (void)ms;
+    return 0;
+}
+
+/* The raw count sinks by 400 counts per second for 1 s, faster than the
+ * low baseline reset of the middleware can follow at the default scan period
+ * and lowBslnRst, then stays
+ */
+static int32_t sim_sink(uint32_t ms)
+{
+    const uint32_t sinkMs = (ms < 1000u) ? 0u : ((ms < 2000u) ? (ms - 1000u) : 1000u);
+
+    return -(int32_t)((sinkMs * 2u) / 5u);
+}
+
+static int32_t sim_drift(uint32_t ms)
+{
+    return (int32_t)((ms % 60000u) / 1000u) - 30;
+}
+
+
+/*******************************************************************************
+* Global variables
+*******************************************************************************/
+static const sim_scenario_t sim_scenarios[] =
+{
+    { "taps",             30000u,  sim_taps,   0,          true,  0u, 0u, 30u },
+    { "long_hold",        30000u,  sim_hold,   0,          true,  0u, 0u, 1u },
+    { "object_rest",      180000u, sim_object, 0,          true,  1u, 0u, 1u },
+    { "latched",          10000u,  sim_none,   SIM_OBJECT, true,  0u, 0u, 0u },
+    { "latched_no_reset", 10000u,  sim_none,   SIM_OBJECT, false, 0u, 1u, 0u },
+    { "sinking",          20000u,  sim_sink,   0,          true,  0u, 1u, 0u },
+    { "drift",            180000u, sim_drift,  0,          true,  0u, 0u, 0u },
+};
+
+
+/*******************************************************************************
+* Function Name: sim_process
+********************************************************************************
+* Summary:
+*   Updates the baseline model with one raw count.
+*
+* Return:
+*  Difference count, 0 below the baseline.
+*
+*******************************************************************************/
+static int32_t sim_process(sim_sensor_t *sns, const sim_args_t *args, int32_t raw)
+{
+    if (raw < (sns->bsln - SIM_NEG_NOISE_TH))
+    {
+        if (sns->lowReset && (sns->negBslnRstCnt >= args->lowBslnRst))
+        {
+            sns->bsln = raw;
+            sns->negBslnRstCnt = 0u;
+        }
+        else
+        {
+            sns->negBslnRstCnt++;
+        }
+    }
+    else
+    {
+        sns->negBslnRstCnt = 0u;
+        if (raw < (sns->bsln + SIM_NOISE_TH))
+        {
+            sns->bsln += (raw > sns->bsln) ? 1 : ((raw < sns->bsln) ? -1 : 0);
+        }
+    }
+    return (raw > sns->bsln) ? (raw - sns->bsln) : 0;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_run
+********************************************************************************
+* Summary:
+*   Scans one scenario at the scan period through the baseline model and the
+*   supervisor, and resets the baseline of the model on every report.
+*
+*******************************************************************************/
+static sim_result_t sim_run(const sim_args_t *args, const sim_scenario_t *scenario, std::mt19937 *rng)
+{
+    std::uniform_int_distribution<int32_t> noise(-(int32_t)args->noise, (int32_t)args->noise);
+    sim_sensor_t sns = { SIM_LEVEL + scenario->latched, 0u, scenario->lowReset };
+    capsense_stuck_t stuck = {};
+    sim_result_t result = {};
+    bool wasOn = false;
+
+    for (uint32_t ms = 0u; ms < scenario->durationMs; ms += args->periodMs)
+    {
+        const int32_t signal = scenario->signal(ms);
+        const int32_t raw = SIM_LEVEL + signal + noise(*rng);
+        const bool on = (sim_process(&sns, args, raw) >= SIM_FINGER_TH);
+
+        switch (capsense_stuck_update(&stuck, args->maxOnMs, 1000u + ms, on, 0u != sns.negBslnRstCnt,
+                                      args->lowBslnRst))
+        {
+            case CAPSENSE_STUCK_ON:
+                result.onResets++;
+                sns.bsln = raw;
+                break;
+            case CAPSENSE_STUCK_NEGATIVE:
+                result.negativeResets++;
+                sns.bsln = raw;
+                sns.negBslnRstCnt = 0u;
+                break;
+            default:
+                break;
+        }
+        result.touches += (on && !wasOn) ? 1u : 0u;
+        result.stuckMs += (on && (SIM_FINGER != signal)) ? args->periodMs : 0u;
+        wasOn = on;
+        result.scans++;
+    }
+    return result;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_time
+********************************************************************************
+* Summary:
+*   Average time of one capsense_stuck_update() call, that is the cost per
+*   sensor and scan, in ns.
+*
+*******************************************************************************/
+static double sim_time(const sim_args_t *args)
+{
+    capsense_stuck_t stuck = {};
+    volatile uint32_t sink = 0u;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (uint32_t scan = 0u; scan < SIM_TIMING_SCANS; scan++)
+    {
+        sink = sink + capsense_stuck_update(&stuck, args->maxOnMs, scan * args->periodMs, 0u != (scan & 64u),
+                                            0u != (scan & 128u), args->lowBslnRst);
+    }
+    const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::steady_clock::now() - start).count();
+    return ns / SIM_TIMING_SCANS;
+}
+
+
+/*******************************************************************************
+* Function Name: sim_option
+********************************************************************************
+* Summary:
+*   Stores the value of a "--name value" option in the matching field.
+*
+* Return:
+*  false if the option is unknown.
+*******************************************************************************/
+static bool sim_option(sim_args_t *args, const char *name, const char *value)
+{
+    uint32_t number = (uint32_t)strtoul(value, NULL, 0);
+    struct
+    {
+        const char *name;
+        uint32_t *field;
+    } const options[] =
+    {
+        { "--period-ms",    &args->periodMs },
+        { "--max-on-ms",    &args->maxOnMs },
+        { "--low-bsln-rst", &args->lowBslnRst },
+        { "--noise",        &args->noise },
+        { "--seed",         &args->seed },
+    };
+
+    for (const auto &option : options)
+    {
+        if (0 == strcmp(name, option.name))
+        {
+            *option.field = number;
+            return true;
+        }
+    }
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   Runs every scenario and checks the number of touches and of resets of
+*   each kind, then times the supervisor per sensor and scan.
+*
+* Return:
+*  0 if every scenario passes, 1 otherwise, 2 for a usage error.
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    sim_args_t args =
+    {
+        .periodMs   = 20u,
+        .maxOnMs    = 30000u,
+        .lowBslnRst = 30u,
+        .noise      = 10u,
+        .seed       = 1u
+    };
+
+    for (int i = 1; i < argc; i += 2)
+    {
+        if ((i + 1 >= argc) || !sim_option(&args, argv[i], argv[i + 1]) || (0u == args.periodMs))
+        {
+            fprintf(stderr, "usage: %s [--period-ms ms] [--max-on-ms ms] [--low-bsln-rst scans] [--noise counts]\n"
+                    "       [--seed n]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    std::mt19937 rng(args.seed);
+    bool failed = false;
+
+    printf("scenario,scans,touches,on_resets,negative_resets,stuck_ms,result\n");
+    for (const sim_scenario_t &scenario : sim_scenarios)
+    {
+        const sim_result_t result = sim_run(&args, &scenario, &rng);
+        const bool pass = (result.touches == scenario.touches) && (result.onResets == scenario.onResets) &&
+                          (result.negativeResets == scenario.negativeResets);
+
+        printf("%s,%lu,%lu,%lu,%lu,%lu,%s\n", scenario.name, (unsigned long)result.scans,
+               (unsigned long)result.touches, (unsigned long)result.onResets, (unsigned long)result.negativeResets,
+               (unsigned long)result.stuckMs, pass ? "ok" : "fail");
+        failed = failed || !pass;
+    }
+
+    printf("\nscans,update_ns\n");
+    printf("%u,%.1f\n", SIM_TIMING_SCANS, sim_time(&args));
+    return failed ? 1 : 0;
+}
+
+
+/* [] END OF FILE */
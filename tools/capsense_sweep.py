@@ -0,0 +1,215 @@
+#!/usr/bin/env python3
+"""
+Sweeps the CapSense widget count and records processing cost, RAM and flash.
+
+For every button count the sweep generates a synthetic configuration with
+tools/capsense_gen.py, installs it into the kit's GeneratedSource, builds the
+firmware with the "capsense-benchmark" application option and reads flash and
+RAM from the GCC_ARM map file. With --port the firmware is also flashed and
+the "bench," record printed by capsense_bench_run() is read from the serial
+port. The original GeneratedSource is restored afterwards, also on failure.
+
+The marginal column is the processing cost of each added sensor since the
+previous point, in CPU cycles. It stays flat while processing is linear in the
+sensor count; the sweep reports the first point where it rises by more than
+--tolerance over the first step.
+
+Usage:
+    python tools/capsense_sweep.py --buttons 1,2,4,8,16,32,48 --csv sweep.csv
+    python tools/capsense_sweep.py --port /dev/ttyACM0 --sliders 2 --plot sweep.png
+"""
+
+import argparse
+import csv
+import glob
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+import capsense_gen
+import mapfile
+
+ROOT = capsense_gen.ROOT
+RECORD = "bench,"
+COLUMNS = ("buttons", "sliders", "matrix", "widgets", "sensors", "flash", "ram",
+           "capsense_flash", "capsense_ram", "cpu_hz", "process_min", "process_avg",
+           "process_max", "marginal", "scan_avg", "encode_avg", "encode_bytes_avg")
+
+
+class SweepError(Exception):
+    pass
+
+
+def app_config(frames):
+    """Writes mbed_app.json with the benchmark enabled to a temporary file."""
+    with open(os.path.join(ROOT, "mbed_app.json")) as f:
+        config = json.load(f)
+    config["config"]["capsense-benchmark"]["value"] = 1
+    config["config"]["capsense-benchmark-frames"]["value"] = frames
+    handle, path = tempfile.mkstemp(suffix=".json", prefix="mbed_app_bench_")
+    with os.fdopen(handle, "w") as f:
+        json.dump(config, f, indent=4)
+    return path
+
+
+def build(args, config, flash):
+    build_dir = os.path.join(ROOT, "BUILD", "capsense_sweep", args.kit)
+    command = ["mbed", "compile", "-m", args.kit, "-t", args.toolchain,
+               "--app-config", config, "--build", build_dir]
+    if flash:
+        command.append("--flash")
+    if subprocess.call(command, cwd=ROOT) != 0:
+        raise SweepError("build failed: " + " ".join(command))
+    maps = glob.glob(os.path.join(build_dir, "*.map"))
+    if len(maps) != 1:
+        raise SweepError("expected one map file in " + build_dir)
+    return maps[0]
+
+
+def read_record(args):
+    """Resets the board and returns the fields of its "bench," record."""
+    import serial
+
+    with serial.Serial(args.port, args.baud, timeout=1) as port:
+        port.reset_input_buffer()
+        port.send_break()
+        deadline = time.time() + args.timeout
+        while time.time() < deadline:
+            line = port.readline().decode("ascii", "replace").strip()
+            if line.startswith(RECORD) and line[len(RECORD):][:1].isdigit():
+                fields = line[len(RECORD):].split(",")
+                keys = ("widgets", "sensors", "frames", "cpu_hz", "process_min", "process_avg",
+                        "process_max", "scan_avg", "encode_avg", "encode_bytes_avg")
+                return dict(zip(keys, (int(v) for v in fields)))
+    raise SweepError("no benchmark record on {} within {} s".format(args.port, args.timeout))
+
+
+def measure(args, config, buttons):
+    source, header, total = capsense_gen.generate(args.kit, buttons, args.sliders, args.segments,
+                                                  args.matrix, args.rx, args.tx)
+    capsense_gen.write(generated_dir(args.kit), source, header)
+
+    sections = mapfile.parse(build(args, config, args.port is not None))
+    flash, ram = mapfile.usage(sections)
+    capsense_flash, capsense_ram = mapfile.by_object(sections).get("cycfg_capsense.o", (0, 0))
+    row = {
+        "buttons": buttons, "sliders": args.sliders, "matrix": args.matrix,
+        "widgets": total["WIDGET_COUNT"], "sensors": total["SENSOR_COUNT"],
+        "flash": flash, "ram": ram, "capsense_flash": capsense_flash, "capsense_ram": capsense_ram,
+    }
+    if args.port:
+        record = read_record(args)
+        if (record["widgets"], record["sensors"]) != (row["widgets"], row["sensors"]):
+            raise SweepError("board runs {} widgets, expected {}".format(record["widgets"], row["widgets"]))
+        row.update(record)
+        del row["frames"]
+    return row
+
+
+def generated_dir(kit):
+    return os.path.join(capsense_gen.DESIGN_DIR, "TARGET_" + kit, "GeneratedSource")
+
+
+def add_marginal(rows):
+    """Cycles per added sensor between consecutive points."""
+    for previous, row in zip([None] + rows, rows):
+        if previous is None or "process_avg" not in row or row["sensors"] == previous["sensors"]:
+            continue
+        row["marginal"] = ((row["process_avg"] - previous["process_avg"]) /
+                           float(row["sensors"] - previous["sensors"]))
+
+
+def knee(rows, tolerance):
+    """First row whose marginal cost exceeds the first one by tolerance."""
+    marginal = [row for row in rows if "marginal" in row]
+    for row in marginal[1:]:
+        if row["marginal"] > marginal[0]["marginal"] * (1.0 + tolerance):
+            return row
+    return None
+
+
+def plot(rows, path):
+    import matplotlib
+    matplotlib.use("Agg")
+    import matplotlib.pyplot as plt
+
+    widgets = [row["widgets"] for row in rows]
+    figure, (cost, memory) = plt.subplots(2, 1, sharex=True, figsize=(7, 7))
+    if "process_avg" in rows[0]:
+        cost.plot(widgets, [row["process_avg"] for row in rows], "o-", label="average")
+        cost.plot(widgets, [row["process_max"] for row in rows], "x--", label="maximum")
+        cost.legend()
+    cost.set_ylabel("Cy_CapSense_ProcessAllWidgets [cycles]")
+    memory.plot(widgets, [row["flash"] for row in rows], "o-", label="flash")
+    memory.plot(widgets, [row["ram"] for row in rows], "s-", label="RAM")
+    memory.set_ylabel("bytes")
+    memory.set_xlabel("widgets")
+    memory.legend()
+    figure.tight_layout()
+    figure.savefig(path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--kit", default=capsense_gen.DEFAULT_KIT, help="kit (default %(default)s)")
+    parser.add_argument("--toolchain", default="GCC_ARM", help="only GCC_ARM map files are supported")
+    parser.add_argument("--buttons", default="1,2,4,8,16,24,32,48", help="button counts to sweep")
+    parser.add_argument("--sliders", type=int, default=0, help="linear sliders in every point")
+    parser.add_argument("--segments", type=int, default=5, help="segments per slider")
+    parser.add_argument("--matrix", type=int, default=0, help="CSX matrix buttons in every point")
+    parser.add_argument("--rx", type=int, default=2, help="Rx electrodes per matrix button")
+    parser.add_argument("--tx", type=int, default=2, help="Tx electrodes per matrix button")
+    parser.add_argument("--frames", type=int, default=200, help="frames measured per point")
+    parser.add_argument("--port", help="serial port of the kit; without it only memory is measured")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=60.0, help="seconds to wait for a record")
+    parser.add_argument("--tolerance", type=float, default=0.25, help="allowed rise of the marginal cost")
+    parser.add_argument("--csv", help="write the results to this file instead of stdout")
+    parser.add_argument("--plot", help="save a plot (requires matplotlib)")
+    args = parser.parse_args()
+
+    if args.toolchain != "GCC_ARM":
+        parser.error("only GCC_ARM map files are supported")
+    if shutil.which("mbed") is None:
+        parser.error("mbed-cli is not on PATH")
+
+    counts = [int(n) for n in args.buttons.split(",")]
+    directory = generated_dir(args.kit)
+    originals = {name: capsense_gen.read(os.path.join(directory, name)) for name in capsense_gen.GENERATED}
+    config = app_config(args.frames)
+    rows = []
+    try:
+        for buttons in counts:
+            rows.append(measure(args, config, buttons))
+    except (SweepError, capsense_gen.GenError) as e:
+        print("capsense_sweep: " + str(e), file=sys.stderr)
+        return 1
+    finally:
+        for name, text in originals.items():
+            with open(os.path.join(directory, name), "w") as f:
+                f.write(text)
+        os.remove(config)
+
+    add_marginal(rows)
+    output = open(args.csv, "w", newline="") if args.csv else sys.stdout
+    writer = csv.DictWriter(output, COLUMNS, extrasaction="ignore")
+    writer.writeheader()
+    writer.writerows(rows)
+    if args.csv:
+        output.close()
+
+    if args.plot:
+        plot(rows, args.plot)
+    row = knee(rows, args.tolerance)
+    if row:
+        print("Processing stops being linear at {} widgets ({} sensors): {:.0f} cycles per added sensor"
+              .format(row["widgets"], row["sensors"], row["marginal"]), file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,481 @@
+/*******************************************************************************
+* File Name: capsense_trace.cpp
+*
+* Description:
+*   Reports how well capsense_frame.cpp compresses sensor traces. Reads a
+*   recorded trace from a CSV file, or generates one of the 7-sensor layout
+*   with trace_model.cpp, encodes every stream on its own and all streams
+*   together, checks that every frame decodes to the original, and prints the
+*   bytes per frame and per second against plain 16-bit frames.
+*
+*   Build with CMake from the tools directory, for example: cmake -S tools -B
+*   build-tools && cmake --build build-tools && build-tools/capsense_trace
+*   --csv trace.csv
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "../capsense_frame.h"
+#include "trace_model.h"
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    const char *csv;
+    uint32_t frames;
+    uint32_t keyEvery;      /* Key frame interval, 0 for the first frame only */
+    trace_model_args_t trace;
+} trace_args_t;
+
+/* Column of a trace CSV: stream index and sensor, the time or the scan */
+typedef struct
+{
+    int32_t stream;         /* -1 for time_ms, -2 for an unknown column, -3 for scan */
+    uint32_t sensor;
+} trace_column_t;
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+static const char *const TRACE_STREAM_NAMES[CAPSENSE_FRAME_STREAMS] = { "raw", "baseline", "diff" };
+
+
+/*******************************************************************************
+* Function Name: trace_value
+********************************************************************************
+* Summary:
+*   Value of a stream of a frame, by stream index.
+*
+*******************************************************************************/
+static uint16_t *trace_value(capsense_frame_t *frame, uint32_t stream)
+{
+    return (0u == stream) ? frame->raw : ((1u == stream) ? frame->baseline : frame->diff);
+}
+
+
+/*******************************************************************************
+* Function Name: trace_read_csv
+********************************************************************************
+* Summary:
+*   Reads a recorded trace. The header names the columns time_ms and
+*   raw<n>, baseline<n> and diff<n> for sensor n, and optionally scan;
+*   without it, the scan counter is the row number. Other columns are
+*   ignored.
+*
+* Return:
+*  false if the file cannot be read or has no time_ms column.
+*
+*******************************************************************************/
+static bool trace_read_csv(const char *path, std::vector<capsense_frame_t> *frames, uint32_t *streams)
+{
+    FILE *file = fopen(path, "r");
+    std::vector<trace_column_t> columns;
+    char line[4096];
+    uint32_t sensors = 0u;
+    bool hasTime = false;
+
+    if ((NULL == file) || (NULL == fgets(line, sizeof(line), file)))
+    {
+        if (NULL != file)
+        {
+            fclose(file);
+        }
+        return false;
+    }
+
+    *streams = 0u;
+    for (char *name = strtok(line, ",\r\n"); NULL != name; name = strtok(NULL, ",\r\n"))
+    {
+        trace_column_t column = { -2, 0u };
+        if (0 == strcmp(name, "time_ms"))
+        {
+            column.stream = -1;
+            hasTime = true;
+        }
+        else if (0 == strcmp(name, "scan"))
+        {
+            column.stream = -3;
+        }
+        for (uint32_t stream = 0u; stream < CAPSENSE_FRAME_STREAMS; stream++)
+        {
+            size_t prefix = strlen(TRACE_STREAM_NAMES[stream]);
+            if ((0 == strncmp(name, TRACE_STREAM_NAMES[stream], prefix)) &&
+                (name[prefix] >= '0') && (name[prefix] <= '9'))
+            {
+                column.stream = (int32_t)stream;
+                column.sensor = (uint32_t)strtoul(&name[prefix], NULL, 10);
+            }
+        }
+        if ((column.stream >= 0) && (column.sensor < CAPSENSE_FRAME_MAX_SENSORS))
+        {
+            *streams |= CAPSENSE_FRAME_RAW << column.stream;
+            sensors = (column.sensor >= sensors) ? (column.sensor + 1u) : sensors;
+        }
+        else if (column.stream >= 0)
+        {
+            column.stream = -2;
+        }
+        columns.push_back(column);
+    }
+
+    while (hasTime && (NULL != fgets(line, sizeof(line), file)))
+    {
+        capsense_frame_t frame = {};
+        size_t index = 0u;
+
+        frame.count = sensors;
+        frame.scan = (uint32_t)frames->size();
+        for (char *field = strtok(line, ",\r\n"); (NULL != field) && (index < columns.size());
+             field = strtok(NULL, ",\r\n"), index++)
+        {
+            uint32_t value = (uint32_t)strtoul(field, NULL, 10);
+            if (-1 == columns[index].stream)
+            {
+                frame.timeMs = value;
+            }
+            else if (-3 == columns[index].stream)
+            {
+                frame.scan = value;
+            }
+            else if (columns[index].stream >= 0)
+            {
+                trace_value(&frame, (uint32_t)columns[index].stream)[columns[index].sensor] = (uint16_t)value;
+            }
+        }
+        if (index > 0u)
+        {
+            frames->push_back(frame);
+        }
+    }
+    fclose(file);
+    return hasTime && (0u != *streams);
+}
+
+
+/*******************************************************************************
+* Function Name: trace_same
+********************************************************************************
+* Summary:
+*   Compares the time, the scan counter and the given streams of two frames.
+*
+*******************************************************************************/
+static bool trace_same(capsense_frame_t *a, capsense_frame_t *b, uint32_t streams)
+{
+    if ((a->timeMs != b->timeMs) || (a->scan != b->scan) || (a->count != b->count))
+    {
+        return false;
+    }
+    for (uint32_t stream = 0u; stream < CAPSENSE_FRAME_STREAMS; stream++)
+    {
+        if ((0u != (streams & (CAPSENSE_FRAME_RAW << stream))) &&
+            (0 != memcmp(trace_value(a, stream), trace_value(b, stream), a->count * sizeof(uint16_t))))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: trace_rejects
+********************************************************************************
+* Summary:
+*   Feeds two corrupted copies of an encoded frame to the decoder: one cut
+*   short by a byte and one with a trailing byte. Both must be rejected
+*   without touching the decoder state, which the caller checks by decoding
+*   the intact frame next.
+*
+* Parameters:
+*  state: decoder state before the frame.
+*  in: encoded frame, followed by at least one readable byte.
+*  length: length of the encoded frame.
+*
+* Return:
+*  false if a corrupted copy decodes.
+*
+*******************************************************************************/
+static bool trace_rejects(capsense_frame_state_t *state, const uint8_t *in, uint32_t length)
+{
+    capsense_frame_t decoded;
+    uint32_t present;
+
+    return !capsense_frame_decode(state, in, length - 1u, &decoded, &present) &&
+           !capsense_frame_decode(state, in, length + 1u, &decoded, &present);
+}
+
+
+/*******************************************************************************
+* Function Name: trace_measure
+********************************************************************************
+* Summary:
+*   Encodes the trace with the given streams, decodes it again and prints one
+*   row: encoded and plain bytes per frame and per second, the compression
+*   ratio, the largest frame and the host encode time. Every frame is
+*   decoded after corrupted copies of it, see trace_rejects().
+*
+* Return:
+*  false if a frame does not decode to the original.
+*
+*******************************************************************************/
+static bool trace_measure(const trace_args_t *args, std::vector<capsense_frame_t> &frames, uint32_t streams)
+{
+    std::vector<uint8_t> encoded((frames.size() * CAPSENSE_FRAME_MAX_SIZE(CAPSENSE_FRAME_MAX_SENSORS)) + 1u);
+    std::vector<uint32_t> lengths(frames.size());
+    capsense_frame_state_t state;
+    uint64_t total = 0u;
+    uint32_t largest = 0u;
+    uint32_t streamCount = 0u;
+    std::string name;
+
+    for (uint32_t stream = 0u; stream < CAPSENSE_FRAME_STREAMS; stream++)
+    {
+        if (0u != (streams & (CAPSENSE_FRAME_RAW << stream)))
+        {
+            name += (name.empty() ? "" : "+") + std::string(TRACE_STREAM_NAMES[stream]);
+            streamCount++;
+        }
+    }
+
+    capsense_frame_reset(&state);
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0u; i < frames.size(); i++)
+    {
+        bool key = (0u != args->keyEvery) && (0u == (i % args->keyEvery));
+        lengths[i] = capsense_frame_encode(&state, key, streams, &frames[i], &encoded[total]);
+        total += lengths[i];
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    capsense_frame_reset(&state);
+    total = 0u;
+    for (size_t i = 0u; i < frames.size(); i++)
+    {
+        capsense_frame_t decoded;
+        uint32_t present;
+        if (!trace_rejects(&state, &encoded[total], lengths[i]) ||
+            !capsense_frame_decode(&state, &encoded[total], lengths[i], &decoded, &present) ||
+            (present != streams) || !trace_same(&decoded, &frames[i], streams))
+        {
+            fprintf(stderr, "capsense_trace: frame %u of %s does not decode to the original after corrupted copies\n",
+                    (unsigned)i, name.c_str());
+            return false;
+        }
+        total += lengths[i];
+        largest = (lengths[i] > largest) ? lengths[i] : largest;
+    }
+
+    /* Plain frames: 32-bit time and 16 bits per value */
+    const double count = (double)frames.size();
+    const double plain = 4.0 + (2.0 * streamCount * frames[0].count);
+    const double bytes = (double)total / count;
+    const double seconds = ((frames.size() > 1u) && (frames.back().timeMs > frames[0].timeMs)) ?
+                           ((frames.back().timeMs - frames[0].timeMs) / 1000.0 * count / (count - 1.0)) :
+                           (count * args->trace.periodMs / 1000.0);
+    const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / count;
+
+    printf("%s,%u,%u,%.2f,%.0f,%.2f,%u,%.0f,%.0f,%.0f\n", name.c_str(), (unsigned)frames.size(),
+           (unsigned)frames[0].count, bytes, plain, plain / bytes, (unsigned)largest,
+           (double)total / seconds, plain * count / seconds, ns);
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: trace_option
+********************************************************************************
+* Summary:
+*   Stores the value of a "--name value" option in the matching field.
+*
+* Return:
+*  false if the option is unknown.
+*
+*******************************************************************************/
+static bool trace_option(trace_args_t *args, const char *name, const char *value)
+{
+    const double number = strtod(value, NULL);
+    struct
+    {
+        const char *name;
+        double *field;
+    } const options[] =
+    {
+        { "--raw",              &args->trace.raw },
+        { "--signal",           &args->trace.signal },
+        { "--noise",            &args->trace.noise },
+        { "--touches-per-hour", &args->trace.touchesPerHour },
+        { "--drift",            &args->trace.driftCounts },
+    };
+
+    for (const auto &option : options)
+    {
+        if (0 == strcmp(name, option.name))
+        {
+            *option.field = number;
+            return true;
+        }
+    }
+
+    if (0 == strcmp(name, "--csv"))
+    {
+        args->csv = value;
+    }
+    else if (0 == strcmp(name, "--frames"))
+    {
+        args->frames = (uint32_t)number;
+    }
+    else if (0 == strcmp(name, "--key-every"))
+    {
+        args->keyEvery = (uint32_t)number;
+    }
+    else if (0 == strcmp(name, "--sensors"))
+    {
+        args->trace.sensors = (uint32_t)number;
+    }
+    else if (0 == strcmp(name, "--period-ms"))
+    {
+        args->trace.periodMs = (uint32_t)number;
+    }
+    else if (0 == strcmp(name, "--seed"))
+    {
+        args->trace.seed = (uint32_t)number;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+*   Measures capsense_frame.cpp on a trace: a recorded trace given with --csv,
+*   or by default one hour of the 7-sensor layout from trace_model.cpp. Every
+*   stream is measured on its own and all together, and every frame is
+*   decoded and checked. Returns 1 if a frame does not decode to the
+*   original.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    trace_args_t args =
+    {
+        .csv      = NULL,
+        .frames   = 180000u,
+        .keyEvery = 0u,
+        .trace    = {}
+    };
+    std::vector<capsense_frame_t> frames;
+    uint32_t streams = CAPSENSE_FRAME_ALL;
+
+    trace_model_defaults(&args.trace);
+    for (int i = 1; i < argc; i += 2)
+    {
+        if ((i + 1 >= argc) || !trace_option(&args, argv[i], argv[i + 1]))
+        {
+            fprintf(stderr, "usage: %s [--csv trace.csv] [--key-every frames]\n"
+                    "       [--frames n] [--sensors n] [--period-ms ms] [--seed n]\n"
+                    "       [--raw counts] [--signal counts] [--noise counts] [--touches-per-hour n] [--drift counts]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    if (NULL != args.csv)
+    {
+        if (!trace_read_csv(args.csv, &frames, &streams) || frames.empty())
+        {
+            fprintf(stderr, "capsense_trace: %s is not a trace CSV with time_ms and raw<n>, baseline<n> or diff<n>\n",
+                    args.csv);
+            return 2;
+        }
+    }
+    else
+    {
+        trace_model_t model;
+
+        if ((0u == args.trace.sensors) || (args.trace.sensors > CAPSENSE_FRAME_MAX_SENSORS) ||
+            (0u == args.trace.periodMs) || (0u == args.frames))
+        {
+            fprintf(stderr, "capsense_trace: 1 to %u sensors, a period and frames are needed\n",
+                    (unsigned)CAPSENSE_FRAME_MAX_SENSORS);
+            return 2;
+        }
+        trace_model_init(&model, &args.trace);
+        frames.resize(args.frames);
+        for (capsense_frame_t &frame : frames)
+        {
+            trace_model_next(&model, &frame);
+        }
+    }
+
+    printf("streams,frames,sensors,bytes_per_frame,plain_bytes_per_frame,ratio,max_frame_bytes,"
+           "bytes_per_s,plain_bytes_per_s,encode_ns\n");
+    for (uint32_t stream = 0u; stream < CAPSENSE_FRAME_STREAMS; stream++)
+    {
+        if ((0u != (streams & (CAPSENSE_FRAME_RAW << stream))) &&
+            !trace_measure(&args, frames, CAPSENSE_FRAME_RAW << stream))
+        {
+            return 1;
+        }
+    }
+    if ((CAPSENSE_FRAME_RAW != streams) && (CAPSENSE_FRAME_BASELINE != streams) &&
+        (CAPSENSE_FRAME_DIFF != streams) && !trace_measure(&args, frames, streams))
+    {
+        return 1;
+    }
+    return 0;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,355 @@
+/*******************************************************************************
+* File Name: flash_emu.cpp
+*
+* Description:
+*   File-backed NOR flash emulator for the host tools, see flash_emu.h.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include "flash_emu.h"
+
+
+/*******************************************************************************
+* Function Name: flash_emu_random
+********************************************************************************
+* Summary:
+*   xorshift32, decides how much of an interrupted operation is done.
+*
+*******************************************************************************/
+static uint32_t flash_emu_random(flash_emu_t *emu)
+{
+    emu->rng ^= emu->rng << 13u;
+    emu->rng ^= emu->rng >> 17u;
+    emu->rng ^= emu->rng << 5u;
+    return emu->rng;
+}
+
+
+/*******************************************************************************
+* Function Name: flash_emu_cutting
+********************************************************************************
+* Summary:
+*   Counts a program or erase operation.
+*
+* Return:
+*  true if the power is cut during this operation.
+*
+*******************************************************************************/
+static bool flash_emu_cutting(flash_emu_t *emu)
+{
+    if ((0u != emu->cutAfter) && (0u == --emu->cutAfter))
+    {
+        emu->off = true;
+        return true;
+    }
+    return false;
+}
+
+
+/*******************************************************************************
+* Function Name: flash_emu_io
+********************************************************************************
+* Summary:
+*   Reads or writes bytes of the image file.
+*
+*******************************************************************************/
+static bool flash_emu_io(flash_emu_t *emu, uint32_t addr, void *buf, uint32_t length, bool write)
+{
+    if (0 != fseek(emu->file, (long)addr, SEEK_SET))
+    {
+        return false;
+    }
+    return write ? (length == fwrite(buf, 1u, length, emu->file)) :
+                   (length == fread(buf, 1u, length, emu->file));
+}
+
+
+/*******************************************************************************
+* Function Name: flash_emu_read
+********************************************************************************
+* Summary:
+*   capsense_log_flash_t read function.
+*
+*******************************************************************************/
+static int32_t flash_emu_read(void *arg, uint32_t addr, void *buf, uint32_t length)
+{
+    flash_emu_t *emu = (flash_emu_t *)arg;
+
+    if (emu->off || ((uint64_t)addr + length > (uint64_t)emu->sectorSize * emu->sectorCount) ||
+        !flash_emu_io(emu, addr, buf, length, false))
+    {
+        return -1;
+    }
+    return 0;
+}
+
+
+/*******************************************************************************
+* Function Name: flash_emu_program
+********************************************************************************
+* Summary:
+*   capsense_log_flash_t program function. Clears the bits that are zero in
+*   buf. Fails on anything but one whole erased page: the S25FL512S sets the
+*   ECC of a page when it is programmed and does not allow it to be
+*   programmed again. A cut program writes part of the bytes and clears
+*   random bits of the next one.
+*
+*******************************************************************************/
+static int32_t flash_emu_program(void *arg, uint32_t addr, const void *buf, uint32_t length)
+{
+    flash_emu_t *emu = (flash_emu_t *)arg;
+    const uint8_t *data = (const uint8_t *)buf;
+    uint8_t cell[CAPSENSE_LOG_PAGE_MAX];
+
+    if (emu->off || (length != emu->pageSize) || (0u != (addr % emu->pageSize)) ||
+        ((uint64_t)addr + length > (uint64_t)emu->sectorSize * emu->sectorCount) ||
+        !flash_emu_io(emu, addr, cell, length, false))
+    {
+        return -1;
+    }
+    for (uint32_t i = 0u; i < length; i++)
+    {
+        if (0xFFu != cell[i])
+        {
+            return -1;
+        }
+    }
+
+    uint32_t done = length;
+    bool cut = flash_emu_cutting(emu);
+    if (cut)
+    {
+        done = flash_emu_random(emu) % length;
+        cell[done] &= (uint8_t)(data[done] | flash_emu_random(emu));
+    }
+    for (uint32_t i = 0u; i < done; i++)
+    {
+        cell[i] &= data[i];
+    }
+
+    if (!flash_emu_io(emu, addr, cell, length, true))
+    {
+        return -1;
+    }
+    emu->programs++;
+    return cut ? -1 : 0;
+}
+
+
+/*******************************************************************************
+* Function Name: flash_emu_erase
+********************************************************************************
+* Summary:
+*   capsense_log_flash_t erase function. A cut erase sets only the start of
+*   the sector to 0xFF.
+*
+*******************************************************************************/
+static int32_t flash_emu_erase(void *arg, uint32_t addr)
+{
+    flash_emu_t *emu = (flash_emu_t *)arg;
+    uint8_t erased[CAPSENSE_LOG_PAGE_MAX];
+
+    if (emu->off || (0u != (addr % emu->sectorSize)) || ((addr / emu->sectorSize) >= emu->sectorCount))
+    {
+        return -1;
+    }
+
+    uint32_t done = emu->sectorSize;
+    bool cut = flash_emu_cutting(emu);
+    if (cut)
+    {
+        done = flash_emu_random(emu) % emu->sectorSize;
+    }
+
+    memset(erased, 0xFF, sizeof(erased));
+    for (uint32_t offset = 0u; offset < done; offset += sizeof(erased))
+    {
+        uint32_t piece = ((done - offset) < sizeof(erased)) ? (done - offset) : (uint32_t)sizeof(erased);
+        if (!flash_emu_io(emu, addr + offset, erased, piece, true))
+        {
+            return -1;
+        }
+    }
+    emu->erases[addr / emu->sectorSize]++;
+    return cut ? -1 : 0;
+}
+
+
+/*******************************************************************************
+* Function Name: flash_emu_open
+********************************************************************************
+* Summary:
+*   Opens the image file. An image of the same size keeps its contents, so a
+*   log can be mounted again by a later run; otherwise the file is created
+*   erased.
+*
+* Parameters:
+*  emu: emulator state.
+*  path: image file.
+*  sectorSize: erase sector size.
+*  sectorCount: number of sectors.
+*  pageSize: program page size, at most CAPSENSE_LOG_PAGE_MAX.
+*
+* Return:
+*  false if the file cannot be used.
+*
+*******************************************************************************/
+bool flash_emu_open(flash_emu_t *emu, const char *path, uint32_t sectorSize, uint32_t sectorCount,
+                    uint32_t pageSize)
+{
+    const long size = (long)sectorSize * (long)sectorCount;
+
+    memset(emu, 0, sizeof(*emu));
+    emu->sectorSize = sectorSize;
+    emu->sectorCount = sectorCount;
+    emu->pageSize = pageSize;
+    emu->rng = 0x2545F491u;
+    if ((pageSize > CAPSENSE_LOG_PAGE_MAX) || (0u == pageSize) || (0u != (sectorSize % pageSize)))
+    {
+        return false;
+    }
+
+    emu->file = fopen(path, "r+b");
+    if ((NULL != emu->file) && ((0 != fseek(emu->file, 0, SEEK_END)) || (size != ftell(emu->file))))
+    {
+        fclose(emu->file);
+        emu->file = NULL;
+    }
+    if (NULL == emu->file)
+    {
+        uint8_t erased[CAPSENSE_LOG_PAGE_MAX];
+
+        emu->file = fopen(path, "w+b");
+        if (NULL == emu->file)
+        {
+            return false;
+        }
+        memset(erased, 0xFF, sizeof(erased));
+        for (long offset = 0; offset < size; offset += pageSize)
+        {
+            if (pageSize != fwrite(erased, 1u, pageSize, emu->file))
+            {
+                flash_emu_close(emu);
+                return false;
+            }
+        }
+    }
+
+    emu->erases = (uint32_t *)calloc(sectorCount, sizeof(uint32_t));
+    if (NULL == emu->erases)
+    {
+        flash_emu_close(emu);
+        return false;
+    }
+    return true;
+}
+
+
+/*******************************************************************************
+* Function Name: flash_emu_close
+********************************************************************************
+* Summary:
+*   Closes the image file.
+*
+*******************************************************************************/
+void flash_emu_close(flash_emu_t *emu)
+{
+    if (NULL != emu->file)
+    {
+        fclose(emu->file);
+        emu->file = NULL;
+    }
+    free(emu->erases);
+    emu->erases = NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: flash_emu_bind
+********************************************************************************
+* Summary:
+*   Fills a capsense_log_flash_t that covers the whole emulated flash.
+*
+*******************************************************************************/
+void flash_emu_bind(flash_emu_t *emu, capsense_log_flash_t *flash)
+{
+    flash->sectorSize = emu->sectorSize;
+    flash->sectorCount = emu->sectorCount;
+    flash->pageSize = emu->pageSize;
+    flash->read = flash_emu_read;
+    flash->program = flash_emu_program;
+    flash->erase = flash_emu_erase;
+    flash->arg = emu;
+}
+
+
+/*******************************************************************************
+* Function Name: flash_emu_cut
+********************************************************************************
+* Summary:
+*   Cuts the power during the afterOps-th program or erase operation from
+*   now. 0 cancels a pending cut.
+*
+*******************************************************************************/
+void flash_emu_cut(flash_emu_t *emu, uint32_t afterOps)
+{
+    emu->cutAfter = afterOps;
+}
+
+
+/*******************************************************************************
+* Function Name: flash_emu_power_on
+********************************************************************************
+* Summary:
+*   Restores the power after a cut. The image keeps what the cut
+*   operation left behind.
+*
+*******************************************************************************/
+void flash_emu_power_on(flash_emu_t *emu)
+{
+    emu->off = false;
+    emu->cutAfter = 0u;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,91 @@
+/*******************************************************************************
+* File Name: flash_emu.h
+*
+* Description:
+*   File-backed emulation of a NOR flash for the host tools. Programming only
+*   clears bits, takes one whole erased page and erasing sets a whole sector
+*   to 0xFF, as on the S25FL512S with its ECC.
+*   A power cut can be scheduled after a number of program and erase
+*   operations; the interrupted operation is left half done.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef FLASH_EMU_H
+#define FLASH_EMU_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "../capsense_log.h"
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    FILE *file;
+    uint32_t sectorSize;
+    uint32_t sectorCount;
+    uint32_t pageSize;
+    uint32_t *erases;       /* Erase count of every sector */
+    uint32_t programs;
+    uint32_t cutAfter;      /* Program and erase operations left before the power cut, 0 for none */
+    bool off;               /* Power is cut; every access fails until flash_emu_power_on() */
+    uint32_t rng;
+} flash_emu_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool flash_emu_open(flash_emu_t *emu, const char *path, uint32_t sectorSize, uint32_t sectorCount,
+                    uint32_t pageSize);
+void flash_emu_close(flash_emu_t *emu);
+void flash_emu_bind(flash_emu_t *emu, capsense_log_flash_t *flash);
+void flash_emu_cut(flash_emu_t *emu, uint32_t afterOps);
+void flash_emu_power_on(flash_emu_t *emu);
+
+#endif /* FLASH_EMU_H */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,148 @@
+/*******************************************************************************
+* File Name: cycfg_capsense.h
+*
+* Description:
+*   Host stand-in for the generated CapSense configuration header. It declares
+*   the subset of the CapSense middleware types and constants that
+*   tools/capsense_calib_check.cpp needs to build capsense_calib.cpp on the
+*   host; the values match the middleware.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef CYCFG_CAPSENSE_H
+#define CYCFG_CAPSENSE_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <stddef.h>
+
+
+/*******************************************************************************
+* Global constants
+*******************************************************************************/
+#define CY_RET_SUCCESS                          (0x00u)
+
+#define CY_CAPSENSE_DISABLE                     (0u)
+#define CY_CAPSENSE_ENABLE                      (1u)
+
+#define CY_CAPSENSE_CSD_SS_DIS                  (0x00u)
+#define CY_CAPSENSE_CSD_SS_HW_EN                (0x01u)
+#define CY_CAPSENSE_CSD_SS_TH_EN                (0x02u)
+#define CY_CAPSENSE_CSD_SS_HWTH_EN              (CY_CAPSENSE_CSD_SS_HW_EN | CY_CAPSENSE_CSD_SS_TH_EN)
+
+#define CY_CAPSENSE_FREQ_CHANNELS_NUM           (3u)
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef uint32_t cy_status;
+
+/* Only the fields used by the modules built for the host */
+typedef struct
+{
+    uint16_t raw;
+    uint16_t bsln;
+    uint16_t diff;
+    uint8_t status;
+    uint8_t negBslnRstCnt;
+    uint8_t idacComp;
+} cy_stc_capsense_sensor_context_t;
+
+typedef struct
+{
+    uint16_t fingerCap;
+    uint16_t sigPFC;
+    uint16_t resolution;
+    uint16_t maxRawCount;
+    uint16_t fingerTh;
+    uint16_t proxTh;
+    uint16_t lowBslnRst;
+    uint16_t snsClk;
+    uint16_t rowSnsClk;
+    uint16_t noiseTh;
+    uint16_t nNoiseTh;
+    uint16_t hysteresis;
+    uint8_t idacMod[CY_CAPSENSE_FREQ_CHANNELS_NUM];
+    uint8_t idacGainIndex;
+    uint8_t rowIdacMod[CY_CAPSENSE_FREQ_CHANNELS_NUM];
+} cy_stc_capsense_widget_context_t;
+
+typedef struct
+{
+    cy_stc_capsense_widget_context_t *ptrWdContext;
+    cy_stc_capsense_sensor_context_t *ptrSnsContext;
+    uint16_t numSns;
+} cy_stc_capsense_widget_config_t;
+
+typedef struct
+{
+    uint8_t numWd;
+    uint16_t numSns;
+    uint8_t csdAutotuneEn;
+    uint8_t csdIdacAutocalEn;
+    uint8_t csdIdacAutoGainEn;
+    uint8_t csxIdacAutocalEn;
+} cy_stc_capsense_common_config_t;
+
+typedef struct
+{
+    uint16_t configId;
+} cy_stc_capsense_common_context_t;
+
+typedef struct
+{
+    const cy_stc_capsense_common_config_t *ptrCommonConfig;
+    cy_stc_capsense_common_context_t *ptrCommonContext;
+    const cy_stc_capsense_widget_config_t *ptrWdConfig;
+} cy_stc_capsense_context_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+/* Defined by the host tool */
+void Cy_CapSense_InitializeAllStatuses(const cy_stc_capsense_context_t *context);
+
+#endif /* CYCFG_CAPSENSE_H */
+
+
+/* [] END OF FILE */
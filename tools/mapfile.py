@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+"""
+Reads the GNU ld map file of a GCC_ARM build.
+
+Only the "Linker script and memory map" part is parsed, so sections dropped
+by --gc-sections are not counted. Every input section is classified by name:
+code and constants take flash, initialized data takes flash and RAM, and
+zero-initialized data takes RAM only.
+
+Usage:
+    python tools/mapfile.py BUILD/CY8CPROTO_062_4343W/GCC_ARM/mbed-os-example-capsense.map
+"""
+
+import collections
+import os
+import re
+import sys
+
+FLASH = "flash"
+RAM = "ram"
+BOTH = "both"
+
+MAP_START = "Linker script and memory map"
+
+Section = collections.namedtuple("Section", "name address size obj kind")
+
+INPUT_RE = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+NAME_RE = re.compile(r"^ (\S+)$")
+WRAPPED_RE = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+
+KINDS = (
+    (re.compile(r"^\.(text|rodata|ARM\.ex|init_array|fini_array|preinit_array|cy_)"), FLASH),
+    (re.compile(r"^\.(data|ramfunc)"), BOTH),
+    (re.compile(r"^(\.bss|\.noinit|\.heap|\.stack|COMMON)"), RAM),
+)
+
+
+def kind_of(name):
+    for pattern, kind in KINDS:
+        if pattern.match(name):
+            return kind
+    return None
+
+
+def object_name(path):
+    """Strips the build directory: "libfoo.a(bar.o)" or "bar.o"."""
+    return os.path.basename(path.strip())
+
+
+def parse(path):
+    """Returns the allocated input sections of a map file."""
+    with open(path) as f:
+        lines = f.read().splitlines()
+    try:
+        lines = lines[lines.index(MAP_START) + 1:]
+    except ValueError:
+        raise ValueError("{}: not a GNU ld map file".format(path))
+
+    sections = []
+    pending = None
+    for line in lines:
+        match = INPUT_RE.match(line)
+        if match:
+            name, address, size, obj = match.groups()
+        elif pending and WRAPPED_RE.match(line):
+            name = pending
+            address, size, obj = WRAPPED_RE.match(line).groups()
+        else:
+            match = NAME_RE.match(line)
+            pending = match.group(1) if match else None
+            continue
+        pending = None
+
+        kind = kind_of(name)
+        size = int(size, 16)
+        if kind is None or size == 0 or name == "*fill*":
+            continue
+        sections.append(Section(name, int(address, 16), size, object_name(obj), kind))
+    return sections
+
+
+def usage(sections):
+    """Returns (flash, ram) in bytes."""
+    flash = sum(s.size for s in sections if s.kind in (FLASH, BOTH))
+    ram = sum(s.size for s in sections if s.kind in (RAM, BOTH))
+    return flash, ram
+
+
+def by_object(sections):
+    """Returns {object: (flash, ram)}."""
+    objects = collections.defaultdict(list)
+    for section in sections:
+        objects[section.obj].append(section)
+    return {obj: usage(items) for obj, items in objects.items()}
+
+
+def symbol_of(section):
+    """Symbol of a -ffunction-sections/-fdata-sections input section."""
+    parts = section.name.split(".", 2)
+    return parts[2] if len(parts) == 3 else section.name
+
+
+def main():
+    if len(sys.argv) != 2:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+    sections = parse(sys.argv[1])
+    print("{:>8} {:>8}  object".format("flash", "ram"))
+    for obj, (flash, ram) in sorted(by_object(sections).items(), key=lambda i: -sum(i[1])):
+        print("{:8d} {:8d}  {}".format(flash, ram, obj))
+    flash, ram = usage(sections)
+    print("{:8d} {:8d}  total".format(flash, ram))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,158 @@
+/*******************************************************************************
+* File Name: trace_model.cpp
+*
+* Description:
+*   Synthetic sensor traces for the host tools, see trace_model.h.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <math.h>
+#include "../capsense_layout.h"
+#include "trace_model.h"
+
+
+/*******************************************************************************
+* Function Name: trace_model_defaults
+********************************************************************************
+* Summary:
+*   Defaults: the sensors of capsense_layout.h at the 20 ms scan period of
+*   main.cpp, with noiseTh and bslnCoeff of the generated configuration.
+*
+*******************************************************************************/
+void trace_model_defaults(trace_model_args_t *args)
+{
+    args->sensors = capsense_layout_sensor_count();
+    args->periodMs = 20u;
+    args->seed = 1u;
+    args->raw = 1500.0;
+    args->signal = 150.0;
+    args->noise = 8.0;
+    args->touchesPerHour = 600.0;
+    args->touchMs = 300.0;
+    args->driftCounts = 30.0;
+    args->driftPeriodS = 600.0;
+    args->noiseTh = 40u;
+    args->bslnCoeff = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: trace_model_init
+********************************************************************************
+* Summary:
+*   Starts a trace at time zero.
+*
+*******************************************************************************/
+void trace_model_init(trace_model_t *model, const trace_model_args_t *args)
+{
+    model->args = *args;
+    model->rng.seed(args->seed);
+    model->noise = std::normal_distribution<double>(0.0, args->noise);
+    model->uniform = std::uniform_real_distribution<double>(0.0, 1.0);
+    model->baselineQ8.assign(args->sensors, 0u);
+    model->index = 0u;
+    model->touchLeft = 0u;
+    model->touched = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: trace_model_next
+********************************************************************************
+* Summary:
+*   Generates the next scan. The baseline starts at the first raw count and
+*   follows the raw count by bslnCoeff/256 of the difference per scan, except
+*   while the raw count is more than noiseTh above it. The difference count
+*   is the raw count above the baseline, or zero.
+*
+*******************************************************************************/
+void trace_model_next(trace_model_t *model, capsense_frame_t *frame)
+{
+    const trace_model_args_t *args = &model->args;
+    const double timeS = (double)model->index * args->periodMs / 1000.0;
+    const double drift = args->driftCounts * sin(2.0 * M_PI * timeS / args->driftPeriodS);
+
+    if ((0u == model->touchLeft) && (args->sensors > 0u) &&
+        (model->uniform(model->rng) < (args->touchesPerHour * args->periodMs / 3600000.0)))
+    {
+        model->touchLeft = (uint32_t)(args->touchMs / args->periodMs) + 1u;
+        model->touched = (uint32_t)(model->uniform(model->rng) * args->sensors) % args->sensors;
+    }
+
+    frame->timeMs = model->index * args->periodMs;
+    frame->scan = model->index;
+    frame->count = args->sensors;
+    for (uint32_t s = 0u; s < args->sensors; s++)
+    {
+        /* Sensors differ in size, so their raw counts differ */
+        double value = args->raw + (37.0 * s) + drift + model->noise(model->rng);
+        if ((0u != model->touchLeft) && (s == model->touched))
+        {
+            value += args->signal;
+        }
+        const uint16_t raw = (uint16_t)((value < 0.0) ? 0.0 : ((value > 65535.0) ? 65535.0 : value));
+
+        uint32_t *baselineQ8 = &model->baselineQ8[s];
+        if (0u == model->index)
+        {
+            *baselineQ8 = (uint32_t)raw << 8u;
+        }
+        else if ((uint32_t)raw <= ((*baselineQ8 >> 8u) + args->noiseTh))
+        {
+            int32_t error = (int32_t)((uint32_t)raw << 8u) - (int32_t)*baselineQ8;
+            *baselineQ8 = (uint32_t)((int32_t)*baselineQ8 + ((error * (int32_t)args->bslnCoeff) / 256));
+        }
+
+        const uint16_t baseline = (uint16_t)(*baselineQ8 >> 8u);
+        frame->raw[s] = raw;
+        frame->baseline[s] = baseline;
+        frame->diff[s] = (raw > baseline) ? (uint16_t)(raw - baseline) : 0u;
+    }
+
+    if (0u != model->touchLeft)
+    {
+        model->touchLeft--;
+    }
+    model->index++;
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,104 @@
+/*******************************************************************************
+* File Name: trace_model.h
+*
+* Description:
+*   Synthetic sensor traces for the host tools. Generates the raw counts of a
+*   slider and button layout with noise, a slow common drift and random
+*   touches, and derives baselines and difference counts the way the CapSense
+*   middleware does with the filter settings of the shipped configuration. The
+*   same arguments and seed always give the same trace, so a trace can be
+*   generated again to check what a decoder returns.
+*
+* Related Document: README.md
+*
+*
+********************************************************************************
+* (c) 2020, Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software"), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+
+#ifndef TRACE_MODEL_H
+#define TRACE_MODEL_H
+
+
+/*******************************************************************************
+* Header files including
+*******************************************************************************/
+#include <stdint.h>
+#include <random>
+#include <vector>
+#include "../capsense_frame.h"
+
+
+/*******************************************************************************
+* Data structure definitions
+*******************************************************************************/
+typedef struct
+{
+    uint32_t sensors;
+    uint32_t periodMs;
+    uint32_t seed;
+    double raw;             /* Raw count of the first sensor without touch */
+    double signal;          /* Raw count increase of a touch */
+    double noise;           /* Raw count noise, standard deviation */
+    double touchesPerHour;
+    double touchMs;
+    double driftCounts;     /* Amplitude of the common raw count drift, e.g. with temperature */
+    double driftPeriodS;
+    uint32_t noiseTh;       /* The baseline holds while the difference count exceeds it */
+    uint32_t bslnCoeff;     /* Baseline filter coefficient, in 1/256 per scan */
+} trace_model_args_t;
+
+typedef struct
+{
+    trace_model_args_t args;
+    std::mt19937 rng;
+    std::normal_distribution<double> noise;
+    std::uniform_real_distribution<double> uniform;
+    std::vector<uint32_t> baselineQ8;
+    uint32_t index;
+    uint32_t touchLeft;
+    uint32_t touched;
+} trace_model_t;
+
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void trace_model_defaults(trace_model_args_t *args);
+void trace_model_init(trace_model_t *model, const trace_model_args_t *args);
+void trace_model_next(trace_model_t *model, capsense_frame_t *frame);
+
+#endif /* TRACE_MODEL_H */
+
+
+/* [] END OF FILE */
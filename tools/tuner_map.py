@@ -0,0 +1,236 @@
+#!/usr/bin/env python3
+"""
+Generates the CapSense Tuner register map of every kit and validates the
+buffer indices of cy_capsense_widgetConfig[].
+
+For each COMPONENT_CUSTOM_DESIGN_MODUS/TARGET_<kit> the tool reads
+GeneratedSource/cycfg_capsense.h and GeneratedSource/cycfg_capsense.c and
+writes TARGET_<kit>/capsense_tuner_regs.h. capsense_tuner_map.cpp uses that
+header to check every register offset and size against
+cy_stc_capsense_tuner_t with static_assert, and the widget buffer indices
+against capsense_layout.h.
+
+Usage:
+    python tools/tuner_map.py            regenerate all kits
+    python tools/tuner_map.py --check    fail if a header is stale or invalid
+    python tools/tuner_map.py --csv KIT  print the register map of one kit
+"""
+
+import argparse
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DESIGN_DIR = os.path.join(ROOT, "COMPONENT_CUSTOM_DESIGN_MODUS")
+OUTPUT_NAME = "capsense_tuner_regs.h"
+NO_INDEX = 0xFF
+
+VALUE_RE = re.compile(r"#define\s+CY_CAPSENSE_(\w+)_VALUE\s+\(cy_capsense_tuner\.([\w\[\]\.]+)\)")
+DEFINE_RE = r"#define\s+CY_CAPSENSE_{}_{}\s+\((0x[0-9a-fA-F]+|\d+)u?\)"
+SIZE_RE = re.compile(r"#define\s+CY_CAPSENSE_(\w+_SIZE)\s+\((\d+)u\)")
+
+
+class MapError(Exception):
+    pass
+
+
+def read(path):
+    with open(path) as f:
+        return f.read()
+
+
+def parse_registers(header):
+    """Returns [(name, member, offset, size, param_id)] in header order."""
+    registers = []
+    for name, member in VALUE_RE.findall(header):
+        fields = []
+        for field in ("OFFSET", "SIZE", "PARAM_ID"):
+            match = re.search(DEFINE_RE.format(name, field), header)
+            if match is None:
+                raise MapError("CY_CAPSENSE_{}_{} is missing".format(name, field))
+            fields.append(int(match.group(1), 0))
+        registers.append((name, member) + tuple(fields))
+    if not registers:
+        raise MapError("no tuner registers found")
+    return registers
+
+
+def parse_widgets(source):
+    """Returns the buffer indices of every entry of cy_capsense_widgetConfig[]."""
+    sizes = dict(SIZE_RE.findall(source))
+    start = source.find("cy_capsense_widgetConfig[CY_CAPSENSE_WIDGET_COUNT]")
+    end = source.find("cy_stc_capsense_tuner_t cy_capsense_tuner", start)
+    if start < 0 or end < 0:
+        raise MapError("cy_capsense_widgetConfig[] not found")
+
+    widgets = []
+    for block in re.split(r"\n    \{ /\* ", source[start:end])[1:]:
+        name = block.split(" ", 1)[0]
+
+        def index(pattern, default=None):
+            match = re.search(pattern, block)
+            if match is None:
+                if default is None:
+                    raise MapError("{}: {} not found".format(name, pattern))
+                return default
+            return int(match.group(1))
+
+        widgets.append({
+            "name": name,
+            "wdContext": index(r"\.ptrWdContext = &cy_capsense_tuner\.widgetContext\[(\d+)u\]"),
+            "snsContext": index(r"\.ptrSnsContext = &cy_capsense_tuner\.sensorContext\[(\d+)u\]"),
+            "eltdConfig": index(r"\.ptrEltdConfig = &cy_capsense_electrodeConfig\[(\d+)u\]"),
+            "debounce": index(r"\.ptrDebounceArr = &cy_capsense_debounce\[(\d+)u\]", NO_INDEX),
+            "noiseEnvelope": index(r"\.ptrNoiseEnvelope = &cy_capsense_noiseEnvelope\[(\d+)u\]", NO_INDEX),
+            "numSns": index(r"\.numSns = (\d+)u"),
+            "xResolution": index(r"\.xResolution = (\d+)u", 0),
+            "button": "CY_CAPSENSE_WD_BUTTON_E" in block,
+        })
+
+    def size(name):
+        if name not in sizes:
+            raise MapError("CY_CAPSENSE_{} is missing".format(name))
+        return int(sizes[name])
+
+    limits = {
+        "debounce": size("DEBOUNCE_SIZE"),
+        "noiseEnvelope": size("NOISE_ENVELOPE_SIZE"),
+        "sensors": int(re.search(r"#define\s+CY_CAPSENSE_SENSOR_COUNT\s+\((\d+)u\)", source).group(1)),
+        "electrodes": int(re.search(r"#define\s+CY_CAPSENSE_ELTD_COUNT\s+\((\d+)u\)", source).group(1)),
+        "pins": int(re.search(r"#define\s+CY_CAPSENSE_PIN_COUNT\s+\((\d+)u\)", source).group(1)),
+        "rawHistory": size("RAW_HISTORY_SIZE"),
+        "iirHistoryLow": size("IIR_HISTORY_LOW_SIZE"),
+        "positionFilterHistory": size("POSITION_FILTER_HISTORY_SIZE"),
+    }
+
+    for position, widget in enumerate(widgets):
+        name = widget["name"]
+        if widget["wdContext"] != position:
+            raise MapError("{}: widget context {} is not its widget ID {}".format(name, widget["wdContext"], position))
+        if widget["snsContext"] + widget["numSns"] > limits["sensors"]:
+            raise MapError("{}: sensor contexts overrun CY_CAPSENSE_SENSOR_COUNT".format(name))
+        if widget["eltdConfig"] >= limits["electrodes"]:
+            raise MapError("{}: electrode index overruns CY_CAPSENSE_ELTD_COUNT".format(name))
+        debounce = widget["numSns"] if widget["button"] else 1
+        if widget["debounce"] != NO_INDEX and widget["debounce"] + debounce > limits["debounce"]:
+            raise MapError("{}: cy_capsense_debounce[] index overruns CY_CAPSENSE_DEBOUNCE_SIZE".format(name))
+        if widget["noiseEnvelope"] != NO_INDEX and widget["noiseEnvelope"] + widget["numSns"] > limits["noiseEnvelope"]:
+            raise MapError("{}: cy_capsense_noiseEnvelope[] index overruns CY_CAPSENSE_NOISE_ENVELOPE_SIZE".format(name))
+    return widgets, limits
+
+
+def check_registers(registers):
+    """Registers must be in offset order, naturally aligned and not overlap."""
+    end = 0
+    for name, _, offset, size, _ in sorted(registers, key=lambda r: r[2]):
+        if offset < end:
+            raise MapError("{} overlaps the previous register".format(name))
+        if offset % size:
+            raise MapError("{} is not aligned to its size".format(name))
+        end = offset + size
+
+
+def render(kit, registers, widgets, limits):
+    lines = [
+        "/" + "*" * 79,
+        "* File Name: " + OUTPUT_NAME,
+        "*",
+        "* Description:",
+        "*   CapSense Tuner register map of cy_capsense_tuner for " + kit + ".",
+        "*   This file was automatically generated by tools/tuner_map.py from",
+        "*   GeneratedSource/cycfg_capsense.h and GeneratedSource/cycfg_capsense.c.",
+        "*   Do not modify it; run the tool again after saving design.cycapsense.",
+        "*",
+        "*" * 80 + "/",
+        "",
+        "#if !defined(CAPSENSE_TUNER_REGS_H)",
+        "#define CAPSENSE_TUNER_REGS_H",
+        "",
+        "/* Register map: ENTRY(register name, member of cy_stc_capsense_tuner_t) */",
+        "#define CAPSENSE_TUNER_REGS(ENTRY) \\",
+    ]
+    for name, member, _, _, _ in registers:
+        lines.append("    ENTRY({}, {}) \\".format(name, member))
+    lines[-1] = lines[-1][:-2]
+    lines += [
+        "",
+        "#define CAPSENSE_TUNER_REGS_COUNT{}({}u)".format(" " * 20, len(registers)),
+        "#define CAPSENSE_TUNER_REGS_END{}({}u)".format(" " * 22, max(r[2] + r[3] for r in registers)),
+        "",
+        "/* Buffer sizes, and indices written by hand in cy_capsense_widgetConfig[] */",
+        "#define CAPSENSE_TUNER_REGS_DEBOUNCE_SIZE{}({}u)".format(" " * 12, limits["debounce"]),
+        "#define CAPSENSE_TUNER_REGS_NOISE_ENVELOPE_SIZE{}({}u)".format(" " * 6, limits["noiseEnvelope"]),
+        "#define CAPSENSE_TUNER_REGS_ELTD_COUNT{}({}u)".format(" " * 15, limits["electrodes"]),
+        "#define CAPSENSE_TUNER_REGS_PIN_COUNT{}({}u)".format(" " * 16, limits["pins"]),
+        "#define CAPSENSE_TUNER_REGS_RAW_HISTORY_SIZE{}({}u)".format(" " * 9, limits["rawHistory"]),
+        "#define CAPSENSE_TUNER_REGS_IIR_HISTORY_LOW_SIZE{}({}u)".format(" " * 5, limits["iirHistoryLow"]),
+        "#define CAPSENSE_TUNER_REGS_POSITION_FILTER_HISTORY_SIZE{}({}u)".format(" ", limits["positionFilterHistory"]),
+        "#define CAPSENSE_TUNER_REGS_NO_INDEX{}(0x{:02X}u)".format(" " * 17, NO_INDEX),
+        "",
+        "/* ENTRY(widget ID, sensor context, electrode, debounce, noise envelope) */",
+        "#define CAPSENSE_TUNER_REGS_WIDGETS(ENTRY) \\",
+    ]
+    for position, widget in enumerate(widgets):
+        lines.append("    ENTRY({}u, {}u, {}u, {}, {}) /* {} */ \\".format(
+            position, widget["snsContext"], widget["eltdConfig"],
+            "{}u".format(widget["debounce"]) if widget["debounce"] != NO_INDEX else "CAPSENSE_TUNER_REGS_NO_INDEX",
+            "{}u".format(widget["noiseEnvelope"]) if widget["noiseEnvelope"] != NO_INDEX else "CAPSENSE_TUNER_REGS_NO_INDEX",
+            widget["name"]))
+    lines[-1] = lines[-1][:-2]
+    lines += [
+        "",
+        "#endif /* CAPSENSE_TUNER_REGS_H */",
+        "",
+        "/* [] END OF FILE */",
+        "",
+    ]
+    return "\n".join(lines)
+
+
+def kits():
+    return sorted(d[len("TARGET_"):] for d in os.listdir(DESIGN_DIR) if d.startswith("TARGET_"))
+
+
+def load(kit):
+    generated = os.path.join(DESIGN_DIR, "TARGET_" + kit, "GeneratedSource")
+    registers = parse_registers(read(os.path.join(generated, "cycfg_capsense.h")))
+    check_registers(registers)
+    widgets, limits = parse_widgets(read(os.path.join(generated, "cycfg_capsense.c")))
+    return registers, widgets, limits
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    parser.add_argument("--check", action="store_true", help="verify the committed headers instead of writing them")
+    parser.add_argument("--csv", metavar="KIT", help="print the register map of KIT as CSV")
+    args = parser.parse_args()
+
+    if args.csv:
+        registers, _, _ = load(args.csv)
+        print("register,member,offset,size,param_id")
+        for name, member, offset, size, param_id in registers:
+            print("{},{},{},{},0x{:08x}".format(name, member, offset, size, param_id))
+        return 0
+
+    status = 0
+    for kit in kits():
+        path = os.path.join(DESIGN_DIR, "TARGET_" + kit, OUTPUT_NAME)
+        try:
+            text = render(kit, *load(kit))
+        except MapError as error:
+            print("{}: {}".format(kit, error), file=sys.stderr)
+            status = 1
+            continue
+        if args.check:
+            if not os.path.exists(path) or read(path) != text:
+                print("{}: {} is out of date".format(kit, OUTPUT_NAME), file=sys.stderr)
+                status = 1
+        else:
+            with open(path, "w") as f:
+                f.write(text)
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())